@@ -0,0 +1,108 @@
+/**
+ * @file bench_clock_sources.cpp
+ * @brief Compare the cost of all Time::ClockSource options
+ *
+ * For each clock source:
+ * - Cost per call (tight loop of Time::get_timestamp)
+ * - Smallest non-zero step between consecutive readings (resolution)
+ *
+ * Usage: bench_clock_sources [iterations]
+ */
+
+#include "commrat/platform/timestamp.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+using namespace commrat;
+
+namespace {
+
+struct ClockResult {
+    double ns_per_call;
+    uint64_t min_step_ns;
+};
+
+ClockResult measure(Time::ClockSource source, uint64_t iterations) {
+    // Warm up (page in vDSO data, trigger TSC calibration)
+    for (int i = 0; i < 10'000; ++i) {
+        (void)Time::get_timestamp(source);
+    }
+
+    uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        sink += Time::get_timestamp(source);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Keep the loop from being optimized away
+    if (sink == 42) {
+        std::cout << "";
+    }
+
+    uint64_t min_step = UINT64_MAX;
+    uint64_t last = Time::get_timestamp(source);
+    for (int i = 0; i < 100'000; ++i) {
+        uint64_t t = Time::get_timestamp(source);
+        if (t > last) {
+            min_step = std::min(min_step, t - last);
+        }
+        last = t;
+    }
+
+    double total_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    return ClockResult{total_ns / static_cast<double>(iterations), min_step};
+}
+
+const char* name(Time::ClockSource source) {
+    switch (source) {
+        case Time::ClockSource::SYSTEM_CLOCK:    return "SYSTEM_CLOCK";
+        case Time::ClockSource::STEADY_CLOCK:    return "STEADY_CLOCK";
+        case Time::ClockSource::HIGH_RES_CLOCK:  return "HIGH_RES_CLOCK";
+        case Time::ClockSource::REALTIME_CLOCK:  return "REALTIME_CLOCK";
+        case Time::ClockSource::MONOTONIC_CLOCK: return "MONOTONIC_CLOCK";
+        case Time::ClockSource::TSC:             return "TSC";
+        case Time::ClockSource::SIMULATED:       return "SIMULATED";
+    }
+    return "?";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t iterations = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+    std::cout << "=== Clock Source Benchmark ===\n\n";
+
+    TscClock::calibrate();
+    std::cout << "TSC: " << (TscClock::is_reliable() ? "reliable" : "unreliable (fallback to CLOCK_MONOTONIC)");
+    if (TscClock::is_reliable()) {
+        std::cout << ", " << TscClock::frequency_hz() / 1'000'000 << " MHz";
+    }
+    std::cout << "\nIterations: " << iterations << "\n\n";
+
+    std::cout << std::left << std::setw(18) << "Clock source"
+              << std::right << std::setw(14) << "ns/call"
+              << std::setw(16) << "min step (ns)" << "\n";
+    std::cout << std::string(48, '-') << "\n";
+
+    for (auto source : {Time::ClockSource::SYSTEM_CLOCK,
+                        Time::ClockSource::STEADY_CLOCK,
+                        Time::ClockSource::HIGH_RES_CLOCK,
+                        Time::ClockSource::REALTIME_CLOCK,
+                        Time::ClockSource::MONOTONIC_CLOCK,
+                        Time::ClockSource::TSC}) {
+        ClockResult result = measure(source, iterations);
+        std::cout << std::left << std::setw(18) << name(source)
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(2) << result.ns_per_call
+                  << std::setw(16) << result.min_step_ns << "\n";
+    }
+
+    std::cout << "\nTSC resyncs during run: " << TscClock::resync_count()
+              << " (last error " << TscClock::last_resync_error_ns() << "ns)\n";
+    return 0;
+}
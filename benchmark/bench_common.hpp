@@ -0,0 +1,155 @@
+/**
+ * @file bench_common.hpp
+ * @brief Result table and JSON output shared by the CommRaT benchmarks
+ *
+ * All benchmarks report BenchResult rows: a latency distribution (ns) per
+ * message or operation plus throughput, and write the same JSON format
+ * (see docs/BENCHMARKS.md).
+ */
+
+#pragma once
+
+#include "commrat/messaging/system/stats_messages.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace commrat::bench {
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations{0};
+    std::size_t payload_bytes{0};      ///< Serialized message size (0 = n/a)
+    uint32_t subscribers{0};           ///< Fan-out / reader threads (0 = n/a)
+    double throughput{0.0};            ///< Messages (or operations) per second
+    LatencyStats latency;              ///< Per message / operation (ns)
+    bool complete{true};               ///< false: messages lost or timed out
+    double success_rate{-1.0};         ///< Lookup / sync / delivery success in [0, 1] (< 0 = n/a)
+    std::vector<std::pair<std::string, double>> module_cpu;  ///< CPU % of one core per module
+};
+
+/// Keep a computed value alive without a side effect
+template<typename T>
+inline void do_not_optimize(T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+/**
+ * @brief Collects results, prints one table row per result, writes JSON
+ */
+class ResultTable {
+public:
+    explicit ResultTable(std::string benchmark) : benchmark_(std::move(benchmark)) {}
+
+    void print_header() const {
+        std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+                  << std::setw(9) << "iters" << std::setw(13) << "ops/s"
+                  << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns"
+                  << std::setw(10) << "p999 ns" << std::setw(11) << "max ns"
+                  << std::setw(8) << "ok %" << "\n";
+        std::cout << std::string(111, '-') << "\n";
+    }
+
+    void report(BenchResult result) {
+        std::cout << std::left << std::setw(40) << result.name << std::right
+                  << std::setw(9) << result.iterations
+                  << std::setw(13) << std::fixed << std::setprecision(0) << result.throughput
+                  << std::setw(10) << result.latency.p50_ns
+                  << std::setw(10) << result.latency.p99_ns
+                  << std::setw(10) << result.latency.p999_ns
+                  << std::setw(11) << result.latency.max_ns;
+        if (result.success_rate >= 0.0) {
+            std::cout << std::setw(8) << std::setprecision(1) << result.success_rate * 100.0;
+        }
+        std::cout << (result.complete ? "" : "  INCOMPLETE") << "\n";
+        if (!result.module_cpu.empty()) {
+            std::cout << "    cpu %:";
+            for (const auto& [module, percent] : result.module_cpu) {
+                std::cout << " " << module << "=" << std::setprecision(1) << percent;
+            }
+            std::cout << "\n";
+        }
+        results_.push_back(std::move(result));
+    }
+
+    const std::vector<BenchResult>& results() const { return results_; }
+
+    bool write_json(const std::string& path, const std::string& transport) const {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fprintf(file, "{\n  \"benchmark\": \"%s\",\n  \"transport\": \"%s\",\n"
+                           "  \"timestamp_ns\": %llu,\n  \"results\": [",
+                     benchmark_.c_str(), transport.c_str(),
+                     static_cast<unsigned long long>(Time::get_timestamp(Time::ClockSource::SYSTEM_CLOCK)));
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const auto& r = results_[i];
+            std::fprintf(file, "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"payload_bytes\": %zu, "
+                               "\"subscribers\": %u, \"throughput_per_s\": %.1f, \"complete\": %s, ",
+                         i == 0 ? "" : ",", r.name.c_str(),
+                         static_cast<unsigned long long>(r.iterations), r.payload_bytes, r.subscribers,
+                         r.throughput, r.complete ? "true" : "false");
+            if (r.success_rate >= 0.0) {
+                std::fprintf(file, "\"success_rate\": %.6f, ", r.success_rate);
+            }
+            if (!r.module_cpu.empty()) {
+                std::fprintf(file, "\"module_cpu_percent\": {");
+                for (std::size_t m = 0; m < r.module_cpu.size(); ++m) {
+                    std::fprintf(file, "%s\"%s\": %.2f", m == 0 ? "" : ", ",
+                                 r.module_cpu[m].first.c_str(), r.module_cpu[m].second);
+                }
+                std::fprintf(file, "}, ");
+            }
+            std::fprintf(file, "\"latency_ns\": {\"count\": %llu, \"min\": %llu, \"mean\": %llu, \"p50\": %llu, "
+                               "\"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}}",
+                         static_cast<unsigned long long>(r.latency.count),
+                         static_cast<unsigned long long>(r.latency.min_ns),
+                         static_cast<unsigned long long>(r.latency.mean_ns),
+                         static_cast<unsigned long long>(r.latency.p50_ns),
+                         static_cast<unsigned long long>(r.latency.p90_ns),
+                         static_cast<unsigned long long>(r.latency.p99_ns),
+                         static_cast<unsigned long long>(r.latency.p999_ns),
+                         static_cast<unsigned long long>(r.latency.max_ns));
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+
+private:
+    std::string benchmark_;
+    std::vector<BenchResult> results_;
+};
+
+/**
+ * @brief Mutes module logging (std::cout / std::cerr) while modules run
+ */
+class QuietScope {
+public:
+    QuietScope() : cout_(std::cout.rdbuf(&null_)), cerr_(std::cerr.rdbuf(&null_)) {}
+    ~QuietScope() {
+        std::cout.rdbuf(cout_);
+        std::cerr.rdbuf(cerr_);
+    }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return traits_type::not_eof(c); }
+    };
+    NullBuffer null_;
+    std::streambuf* cout_;
+    std::streambuf* cerr_;
+};
+
+/// Operations per second for count operations in elapsed_ns
+inline double per_second(uint64_t count, uint64_t elapsed_ns) {
+    return static_cast<double>(count) * 1e9 / static_cast<double>(elapsed_ns > 0 ? elapsed_ns : 1);
+}
+
+} // namespace commrat::bench
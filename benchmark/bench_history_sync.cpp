@@ -0,0 +1,532 @@
+/**
+ * @file bench_history_sync.cpp
+ * @brief History buffer and multi-input synchronization benchmarks
+ *
+ * Measures:
+ * - TimestampedRingBuffer under one writer and 1..8 concurrent readers for
+ *   capacities 10..10000 and every InterpolationMode: getData() lookup
+ *   latency and hit rate, push() latency (writer stall behind readers)
+ * - MultiInputProcessor::gather_all_inputs() on HistoricalMailbox inputs fed
+ *   by synthetic producers at configurable rates and jitter: sync latency,
+ *   sync success rate and the timestamp skew of the matched secondaries
+ *
+ * Usage: bench_history_sync [--transport loopback|tims] [--duration-ms N]
+ *                           [--write-rate HZ] [--lookback-ms N]
+ *                           [--tolerance-ms N] [--max-readers N]
+ *                           [--sync-tolerance-ms N]
+ *                           [--rates P,S1,S2] [--jitter-us N]
+ *                           [--sync-duration-ms N] [--filter SUBSTRING]
+ *                           [--json FILE]
+ */
+
+#include "bench_common.hpp"
+#include "commrat/commrat.hpp"
+#include "commrat/mailbox/historical_mailbox.hpp"
+#include "commrat/module/io/multi_input_processor.hpp"
+#include "commrat/module/metadata/input_metadata.hpp"
+#include "commrat/module/metadata/input_metadata_manager.hpp"
+#include "commrat/module/metrics/module_metrics.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace commrat;
+using commrat::bench::BenchResult;
+using commrat::bench::do_not_optimize;
+
+namespace {
+
+// ============================================================================
+// Options
+// ============================================================================
+
+struct Options {
+    std::string transport{"loopback"};
+    uint64_t duration_ms{100};            ///< Per ring buffer configuration
+    uint64_t write_rate{10'000};          ///< Writer pushes per second (0 = unthrottled)
+    uint64_t lookback_ms{50};             ///< Readers query [now - lookback, now]
+    uint64_t tolerance_ms{1};             ///< getData() tolerance (ring buffer)
+    uint32_t max_readers{8};
+    std::array<uint64_t, 3> rates{100, 50, 20};  ///< Primary, secondary 1, secondary 2 (Hz)
+    uint64_t jitter_us{500};              ///< Producer send time jitter (uniform +-)
+    uint64_t sync_duration_ms{2000};
+    uint64_t sync_tolerance_ms{20};       ///< gather_all_inputs() tolerance
+    std::string filter;
+    std::string json_file;
+};
+
+bench::ResultTable g_table{"bench_history_sync"};
+Options g_options;
+
+bool selected(const std::string& name) {
+    return g_options.filter.empty() || name.find(g_options.filter) != std::string::npos;
+}
+
+const char* mode_name(InterpolationMode mode) {
+    switch (mode) {
+        case InterpolationMode::NEAREST:     return "nearest";
+        case InterpolationMode::BEFORE:      return "before";
+        case InterpolationMode::AFTER:       return "after";
+        case InterpolationMode::INTERPOLATE: return "interpolate";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// Ring Buffer: one writer, N readers
+// ============================================================================
+
+struct HistorySample {
+    uint64_t seq{0};
+    std::array<double, 4> values{};
+};
+
+using HistoryMessage = TimsMessage<HistorySample>;
+
+template<std::size_t Capacity>
+void bench_ring_buffer(uint32_t readers, InterpolationMode mode) {
+    const std::string prefix = "history.cap" + std::to_string(Capacity) + ".r" +
+                               std::to_string(readers) + "." + mode_name(mode);
+    const bool want_lookup = selected(prefix + ".lookup");
+    const bool want_push = selected(prefix + ".push");
+    if (!want_lookup && !want_push) {
+        return;
+    }
+
+    const auto tolerance = std::chrono::milliseconds(g_options.tolerance_ms);
+    const uint64_t period_ns = g_options.write_rate > 0 ? 1'000'000'000 / g_options.write_rate : 0;
+    auto buffer = std::make_unique<TimestampedRingBuffer<HistoryMessage, Capacity>>(tolerance);
+
+    // Pre-fill to capacity so lookups scan a full buffer from the start
+    const uint64_t spacing_ns = period_ns > 0 ? period_ns : 1'000;
+    const uint64_t fill_start = Time::now() - Capacity * spacing_ns;
+    for (std::size_t i = 0; i < Capacity; ++i) {
+        HistoryMessage msg{};
+        msg.header.timestamp = fill_start + i * spacing_ns;
+        msg.payload.seq = i;
+        buffer->push(msg);
+    }
+
+    std::atomic<bool> stop{false};
+    auto push_histogram = std::make_unique<LatencyHistogram>();
+    uint64_t pushes = 0;
+
+    std::thread writer([&]() {
+        uint64_t next = Time::now();
+        while (!stop.load(std::memory_order_relaxed)) {
+            HistoryMessage msg{};
+            msg.payload.seq = Capacity + pushes;
+            const uint64_t start = Time::now();
+            msg.header.timestamp = start;
+            buffer->push(msg);
+            push_histogram->record(Time::now() - start);
+            ++pushes;
+            if (period_ns > 0) {
+                next += period_ns;
+                while (Time::now() < next && !stop.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    });
+
+    std::vector<std::unique_ptr<LatencyHistogram>> lookup_histograms;
+    std::vector<uint64_t> hits(readers, 0);
+    std::vector<uint64_t> lookups(readers, 0);
+    std::vector<std::thread> reader_threads;
+    for (uint32_t r = 0; r < readers; ++r) {
+        lookup_histograms.push_back(std::make_unique<LatencyHistogram>());
+    }
+    for (uint32_t r = 0; r < readers; ++r) {
+        reader_threads.emplace_back([&, r]() {
+            std::mt19937_64 rng(0x5EED + r);
+            std::uniform_int_distribution<uint64_t> lookback(0, g_options.lookback_ms * 1'000'000);
+            auto& histogram = *lookup_histograms[r];
+            uint64_t local_hits = 0;
+            uint64_t local_lookups = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const uint64_t target = Time::now() - lookback(rng);
+                const uint64_t start = Time::now();
+                auto result = buffer->getData(target, tolerance, mode);
+                histogram.record(Time::now() - start);
+                do_not_optimize(result);
+                local_hits += result.has_value() ? 1 : 0;
+                ++local_lookups;
+            }
+            hits[r] = local_hits;
+            lookups[r] = local_lookups;
+        });
+    }
+
+    const uint64_t start = Time::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_options.duration_ms));
+    stop = true;
+    writer.join();
+    for (auto& thread : reader_threads) {
+        thread.join();
+    }
+    const uint64_t elapsed = Time::now() - start;
+
+    auto lookup_histogram = std::make_unique<LatencyHistogram>();
+    uint64_t total_hits = 0;
+    uint64_t total_lookups = 0;
+    for (uint32_t r = 0; r < readers; ++r) {
+        lookup_histogram->merge(*lookup_histograms[r]);
+        total_hits += hits[r];
+        total_lookups += lookups[r];
+    }
+
+    if (want_lookup) {
+        g_table.report(BenchResult{
+            .name = prefix + ".lookup",
+            .iterations = total_lookups,
+            .payload_bytes = sizeof(HistoryMessage),
+            .subscribers = readers,
+            .throughput = bench::per_second(total_lookups, elapsed),
+            .latency = lookup_histogram->summary(),
+            .complete = total_lookups > 0,
+            .success_rate = static_cast<double>(total_hits) / static_cast<double>(std::max<uint64_t>(total_lookups, 1))
+        });
+    }
+    if (want_push) {
+        g_table.report(BenchResult{
+            .name = prefix + ".push",
+            .iterations = pushes,
+            .payload_bytes = sizeof(HistoryMessage),
+            .subscribers = readers,
+            .throughput = bench::per_second(pushes, elapsed),
+            .latency = push_histogram->summary(),
+            .complete = pushes > 0
+        });
+    }
+}
+
+template<std::size_t Capacity>
+void bench_ring_buffer_capacity() {
+    constexpr std::array<InterpolationMode, 4> modes{
+        InterpolationMode::NEAREST, InterpolationMode::BEFORE,
+        InterpolationMode::AFTER, InterpolationMode::INTERPOLATE
+    };
+    for (uint32_t readers = 1; readers <= g_options.max_readers; readers *= 2) {
+        for (auto mode : modes) {
+            bench_ring_buffer<Capacity>(readers, mode);
+        }
+    }
+}
+
+// ============================================================================
+// Multi-Input Synchronization
+// ============================================================================
+
+struct SyncPrimary {
+    uint64_t seq{0};
+    std::array<double, 6> imu{};
+};
+
+struct SyncSecondaryA {
+    uint64_t seq{0};
+    double latitude{0.0};
+    double longitude{0.0};
+};
+
+struct SyncSecondaryB {
+    uint64_t seq{0};
+    std::array<float, 32> ranges{};
+};
+
+struct SyncOutput {
+    uint64_t seq{0};
+};
+
+using SyncRegistry = MessageRegistry<
+    MessageDefinition<SyncPrimary, MessagePrefix::UserDefined, UserSubPrefix::Data, 0>,
+    MessageDefinition<SyncSecondaryA, MessagePrefix::UserDefined, UserSubPrefix::Data, 1>,
+    MessageDefinition<SyncSecondaryB, MessagePrefix::UserDefined, UserSubPrefix::Data, 2>,
+    MessageDefinition<SyncOutput, MessagePrefix::UserDefined, UserSubPrefix::Data, 3>
+>;
+
+using SyncInputs = std::tuple<SyncPrimary, SyncSecondaryA, SyncSecondaryB>;
+using SyncHistory = HistoricalMailbox<SyncRegistry, 100>;  // Same depth as Module inputs
+
+/**
+ * @brief Minimal stand-in for a 3-input Module
+ *
+ * Provides exactly what MultiInputProcessor and InputMetadataManager
+ * expect from the derived Module, so the real gather_all_inputs() runs
+ * without the module lifecycle around it.
+ */
+class SyncHarness
+    : public MultiInputProcessor<SyncHarness, SyncInputs, SyncOutput, std::tuple<SyncOutput>, 3>
+    , public InputMetadataManager<SyncHarness> {
+public:
+    static constexpr std::size_t num_inputs = 3;
+
+    struct Config {
+        std::chrono::milliseconds tolerance;
+        std::chrono::milliseconds sync_tolerance() const { return tolerance; }
+    };
+
+    explicit SyncHarness(std::chrono::milliseconds tolerance) : config_{tolerance} {}
+
+    using MultiInputProcessor::gather_all_inputs;
+    using MultiInputProcessor::receive_primary_input;
+    using InputMetadataManager::mark_input_invalid;
+    using InputMetadataManager::update_input_metadata;
+
+    Config config_;
+    std::optional<std::tuple<SyncHistory, SyncHistory, SyncHistory>> input_mailboxes_;
+    std::array<InputMetadataStorage, num_inputs> input_metadata_{};
+};
+
+MailboxConfig sync_mailbox_config(uint32_t id, const std::string& name) {
+    return MailboxConfig{
+        .mailbox_id = id,
+        .message_slots = 10,
+        .max_message_size = SyncRegistry::max_message_size,
+        .send_priority = 10,
+        .realtime = false,
+        .mailbox_name = name
+    };
+}
+
+/**
+ * @brief Send T to dest at rate_hz, each send shifted by uniform +-jitter
+ */
+template<typename T>
+void run_producer(uint32_t id, uint32_t dest, uint64_t rate_hz, const std::atomic<bool>& stop) {
+    RegistryMailbox<SyncRegistry> tx(sync_mailbox_config(id, "sync_producer"));
+    if (!tx.start()) {
+        std::cerr << "Failed to start producer mailbox " << id << "\n";
+        return;
+    }
+    const uint64_t period_ns = 1'000'000'000 / std::max<uint64_t>(rate_hz, 1);
+    const int64_t jitter_ns = static_cast<int64_t>(g_options.jitter_us) * 1'000;
+    std::mt19937_64 rng(id);
+    std::uniform_int_distribution<int64_t> jitter(-jitter_ns, jitter_ns);
+
+    T payload{};
+    const uint64_t start = Time::now();
+    for (uint64_t k = 1; !stop.load(std::memory_order_relaxed); ++k) {
+        const int64_t due = static_cast<int64_t>(start + k * period_ns) + jitter(rng);
+        const int64_t wait = due - static_cast<int64_t>(Time::now());
+        if (wait > 0) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+        }
+        payload.seq = k;
+        tx.send(payload, dest, Time::now());
+    }
+    tx.stop();
+}
+
+void bench_sync() {
+    const auto& rates = g_options.rates;
+    const std::string prefix = "sync.p" + std::to_string(rates[0]) + ".s" + std::to_string(rates[1]) +
+                               "_" + std::to_string(rates[2]) + ".j" + std::to_string(g_options.jitter_us) +
+                               "us.t" + std::to_string(g_options.sync_tolerance_ms) + "ms";
+    const bool want_gather = selected(prefix + ".gather");
+    const bool want_skew = selected(prefix + ".skew");
+    if (!want_gather && !want_skew) {
+        return;
+    }
+
+    constexpr uint32_t base_id = 0x00D00000;
+    const auto tolerance = std::chrono::milliseconds(g_options.sync_tolerance_ms);
+    SyncHarness harness(tolerance);
+    harness.input_mailboxes_.emplace(
+        SyncHistory(sync_mailbox_config(base_id + 0, "sync_primary"), tolerance),
+        SyncHistory(sync_mailbox_config(base_id + 1, "sync_secondary_a"), tolerance),
+        SyncHistory(sync_mailbox_config(base_id + 2, "sync_secondary_b"), tolerance));
+    auto& [primary, secondary_a, secondary_b] = *harness.input_mailboxes_;
+    if (!primary.start() || !secondary_a.start() || !secondary_b.start()) {
+        std::cerr << "Failed to start sync input mailboxes\n";
+        std::exit(1);
+    }
+
+    std::atomic<bool> stop{false};
+    // Secondary inputs fill their history like MultiInputInfrastructure does
+    std::thread receive_a([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            secondary_a.receive<SyncSecondaryA>();
+        }
+    });
+    std::thread receive_b([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            secondary_b.receive<SyncSecondaryB>();
+        }
+    });
+    std::thread produce_primary([&]() { run_producer<SyncPrimary>(base_id + 3, base_id + 0, rates[0], stop); });
+    std::thread produce_a([&]() { run_producer<SyncSecondaryA>(base_id + 4, base_id + 1, rates[1], stop); });
+    std::thread produce_b([&]() { run_producer<SyncSecondaryB>(base_id + 5, base_id + 2, rates[2], stop); });
+
+    // Skip the first 100ms: secondary history is still empty
+    const uint64_t warmup_end = Time::now() + 100'000'000;
+    const uint64_t end = warmup_end + g_options.sync_duration_ms * 1'000'000;
+    auto gather_histogram = std::make_unique<LatencyHistogram>();
+    auto skew_histogram = std::make_unique<LatencyHistogram>();
+    uint64_t attempts = 0;
+    uint64_t synced = 0;
+
+    while (Time::now() < end) {
+        auto primary_msg = harness.receive_primary_input<0>();
+        if (!primary_msg || Time::now() < warmup_end) {
+            continue;
+        }
+        const uint64_t start = Time::now();
+        auto inputs = harness.gather_all_inputs<0>(primary_msg.value());
+        gather_histogram->record(Time::now() - start);
+        ++attempts;
+        if (inputs) {
+            ++synced;
+            const uint64_t primary_ts = primary_msg.value().header.timestamp;
+            for (std::size_t i = 1; i < SyncHarness::num_inputs; ++i) {
+                const uint64_t ts = harness.input_metadata_[i].timestamp;
+                skew_histogram->record(ts > primary_ts ? ts - primary_ts : primary_ts - ts);
+            }
+        }
+        do_not_optimize(inputs);
+    }
+    const uint64_t elapsed = Time::now() - warmup_end;
+
+    stop = true;
+    produce_primary.join();
+    produce_a.join();
+    produce_b.join();
+    secondary_a.stop();  // Wakes the blocked receivers
+    secondary_b.stop();
+    receive_a.join();
+    receive_b.join();
+    primary.stop();
+
+    const double success_rate = static_cast<double>(synced) / static_cast<double>(std::max<uint64_t>(attempts, 1));
+    const bool complete = attempts > 0;
+    if (want_gather) {
+        g_table.report(BenchResult{
+            .name = prefix + ".gather",
+            .iterations = attempts,
+            .payload_bytes = sizeof(TimsMessage<SyncPrimary>),
+            .subscribers = 0,
+            .throughput = bench::per_second(attempts, elapsed),
+            .latency = gather_histogram->summary(),
+            .complete = complete,
+            .success_rate = success_rate
+        });
+    }
+    if (want_skew) {
+        g_table.report(BenchResult{
+            .name = prefix + ".skew",
+            .iterations = skew_histogram->count(),
+            .payload_bytes = 0,
+            .subscribers = 0,
+            .throughput = bench::per_second(synced, elapsed),
+            .latency = skew_histogram->summary(),
+            .complete = complete,
+            .success_rate = success_rate
+        });
+    }
+}
+
+// ============================================================================
+// Command Line
+// ============================================================================
+
+bool parse_rates(const std::string& text, std::array<uint64_t, 3>& rates) {
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < rates.size(); ++i) {
+        std::size_t comma = text.find(',', pos);
+        if ((comma == std::string::npos) != (i + 1 == rates.size())) {
+            return false;
+        }
+        rates[i] = std::strtoull(text.substr(pos, comma - pos).c_str(), nullptr, 10);
+        if (rates[i] == 0) {
+            return false;
+        }
+        pos = comma + 1;
+    }
+    return true;
+}
+
+bool parse_options(int argc, char** argv) {
+    auto number = [](const char* text) { return std::strtoull(text, nullptr, 10); };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--transport" && has_value) {
+            g_options.transport = argv[++i];
+        } else if (arg == "--duration-ms" && has_value) {
+            g_options.duration_ms = std::max<uint64_t>(number(argv[++i]), 10);
+        } else if (arg == "--write-rate" && has_value) {
+            g_options.write_rate = number(argv[++i]);
+        } else if (arg == "--lookback-ms" && has_value) {
+            g_options.lookback_ms = number(argv[++i]);
+        } else if (arg == "--tolerance-ms" && has_value) {
+            g_options.tolerance_ms = number(argv[++i]);
+        } else if (arg == "--sync-tolerance-ms" && has_value) {
+            g_options.sync_tolerance_ms = number(argv[++i]);
+        } else if (arg == "--max-readers" && has_value) {
+            g_options.max_readers = static_cast<uint32_t>(number(argv[++i]));
+        } else if (arg == "--rates" && has_value) {
+            if (!parse_rates(argv[++i], g_options.rates)) {
+                return false;
+            }
+        } else if (arg == "--jitter-us" && has_value) {
+            g_options.jitter_us = number(argv[++i]);
+        } else if (arg == "--sync-duration-ms" && has_value) {
+            g_options.sync_duration_ms = std::max<uint64_t>(number(argv[++i]), 100);
+        } else if (arg == "--filter" && has_value) {
+            g_options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            g_options.json_file = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return g_options.transport == "loopback" || g_options.transport == "tims";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parse_options(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--transport loopback|tims] [--duration-ms N]\n"
+                  << "       [--write-rate HZ] [--lookback-ms N] [--tolerance-ms N] [--max-readers N]\n"
+                  << "       [--rates P,S1,S2] [--jitter-us N] [--sync-tolerance-ms N]\n"
+                  << "       [--sync-duration-ms N] [--filter SUBSTRING] [--json FILE]\n";
+        return 1;
+    }
+
+    TimsWrapper::set_transport(g_options.transport == "tims" ? TimsTransport::Router : TimsTransport::Loopback);
+
+    std::cout << "=== CommRaT History and Sync Benchmark ===\n"
+              << "Write rate: " << g_options.write_rate << " Hz, lookback: " << g_options.lookback_ms
+              << " ms, tolerance: " << g_options.tolerance_ms << " ms\n"
+              << "Sync rates: " << g_options.rates[0] << "/" << g_options.rates[1] << "/" << g_options.rates[2]
+              << " Hz, jitter: " << g_options.jitter_us << " us, tolerance: "
+              << g_options.sync_tolerance_ms << " ms\n\n";
+    g_table.print_header();
+
+    bench_ring_buffer_capacity<10>();
+    bench_ring_buffer_capacity<100>();
+    bench_ring_buffer_capacity<1000>();
+    bench_ring_buffer_capacity<10000>();
+
+    bench_sync();
+
+    if (!g_options.json_file.empty()) {
+        if (!g_table.write_json(g_options.json_file, g_options.transport)) {
+            std::cerr << "Failed to write " << g_options.json_file << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to " << g_options.json_file << "\n";
+    }
+    return 0;
+}
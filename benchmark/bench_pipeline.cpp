@@ -0,0 +1,457 @@
+/**
+ * @file bench_pipeline.cpp
+ * @brief End-to-end pipeline benchmark with synthetic load generators
+ *
+ * Builds real Module pipelines from the modules in pipeline_modules.hpp:
+ * - chain:  LoadGenerator -> N x Passthrough -> LatencySink
+ * - fanout: LoadGenerator -> N x LatencySink
+ * - fanin:  3 x LoadGenerator -> FanInSink (Inputs<P, S1, S2>)
+ *
+ * Each topology runs at increasing rates (doubling from --min-rate to
+ * --max-rate) and reports end-to-end latency percentiles, delivery ratio
+ * (1 - drop rate) and CPU per module. The sweep stops at the first rate that
+ * drops more than --max-drop or that the generator cannot sustain; the last
+ * passing rate is reported as the saturation point.
+ *
+ * Usage: bench_pipeline [--transport loopback|tims] [--topology chain|fanout|fanin|all]
+ *                       [--stages N] [--fanout N] [--payload-bytes 64|256|1024|4096]
+ *                       [--jitter-us N] [--burst N] [--min-rate HZ] [--max-rate HZ]
+ *                       [--step-ms N] [--max-drop RATIO] [--filter SUBSTRING]
+ *                       [--json FILE]
+ */
+
+#include "bench_common.hpp"
+#include "pipeline_modules.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+using commrat::bench::BenchResult;
+using commrat::bench::FanInSink;
+using commrat::bench::LatencySink;
+using commrat::bench::LoadGenerator;
+using commrat::bench::LoadPayload;
+using commrat::bench::LoadProfile;
+using commrat::bench::Passthrough;
+using commrat::bench::QuietScope;
+
+namespace {
+
+// ============================================================================
+// Application
+// ============================================================================
+
+template<std::size_t N>
+using Primary = LoadPayload<N, 0>;
+template<std::size_t N>
+using SecondaryA = LoadPayload<N, 1>;
+template<std::size_t N>
+using SecondaryB = LoadPayload<N, 2>;
+
+template<std::size_t... Sizes>
+using PipelineAppFor = CommRaT<
+    Message::Data<Primary<Sizes>>...,
+    Message::Data<SecondaryA<Sizes>>...,
+    Message::Data<SecondaryB<Sizes>>...
+>;
+
+using PipelineApp = PipelineAppFor<64, 256, 1024, 4096>;
+
+// ============================================================================
+// Options
+// ============================================================================
+
+struct Options {
+    std::string transport{"loopback"};
+    std::string topology{"all"};
+    uint32_t stages{4};
+    uint32_t fanout{4};
+    std::size_t payload_bytes{64};
+    uint64_t jitter_us{0};
+    uint32_t burst{1};
+    double min_rate{500.0};
+    double max_rate{64'000.0};
+    uint64_t step_ms{500};
+    double max_drop{0.01};
+    std::string filter;
+    std::string json_file;
+};
+
+bench::ResultTable g_table{"bench_pipeline"};
+Options g_options;
+
+constexpr uint64_t settle_ms = 200;   ///< After start: subscriptions complete
+constexpr uint64_t drain_ms = 100;    ///< After disarm: in-flight messages arrive
+
+bool selected(const std::string& name) {
+    return g_options.filter.empty() || name.find(g_options.filter) != std::string::npos;
+}
+
+ModuleConfig source_config(const std::string& name, uint8_t system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 1},
+        .inputs = NoInputConfig{},
+        .max_subscribers = std::max<std::size_t>(8, g_options.fanout)
+    };
+}
+
+ModuleConfig stage_config(const std::string& name, uint8_t system_id, uint8_t source_system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 1},
+        .inputs = SingleInputConfig{.source_system_id = source_system_id, .source_instance_id = 1}
+    };
+}
+
+// ============================================================================
+// Pipeline
+// ============================================================================
+
+struct RunResult {
+    double target_rate{0.0};
+    double offered_rate{0.0};         ///< Numbered messages released per second
+    uint64_t expected{0};             ///< Deliveries if nothing is dropped
+    uint64_t delivered{0};
+    uint64_t elapsed_ns{0};
+    LatencyStats latency;
+    std::vector<std::pair<std::string, double>> module_cpu;
+
+    double delivery_ratio() const {
+        return expected == 0 ? 0.0 : std::min(1.0, static_cast<double>(delivered) / static_cast<double>(expected));
+    }
+};
+
+/**
+ * @brief Owns the modules of one pipeline and runs one measurement
+ *
+ * Modules are started in the order they were added (sources first, so
+ * subscribe requests find their source) and stopped in the same order, so
+ * downstream stages drain before they stop.
+ */
+class Pipeline {
+public:
+    template<typename M, typename... Args>
+    M& add(const ModuleConfig& config, Args&&... args) {
+        auto module = std::make_unique<M>(config, std::forward<Args>(args)...);
+        M& ref = *module;
+        entries_.push_back(Entry{
+            .name = config.name,
+            .start = [&ref]() { ref.start(); },
+            .stop = [&ref]() { ref.stop(); },
+            .cpu_ns = [&ref]() {
+                uint64_t total = 0;
+                for (const auto& thread : ref.collect_stats().threads) {
+                    total += thread.cpu_time_ns;
+                }
+                return total;
+            },
+            .owner = std::shared_ptr<void>(std::move(module))
+        });
+        return ref;
+    }
+
+    template<typename G>
+    G& add_generator(const ModuleConfig& config, const LoadProfile& load) {
+        G& ref = add<G>(config, load);
+        arm_.push_back([&ref](bool armed) { armed ? ref.arm() : ref.disarm(); });
+        if (!emitted_) {
+            emitted_ = [&ref]() { return ref.emitted(); };  // First generator drives delivery
+        }
+        return ref;
+    }
+
+    template<typename S>
+    S& add_sink(const ModuleConfig& config) {
+        S& ref = add<S>(config);
+        sinks_.push_back(&ref.recorder());
+        return ref;
+    }
+
+    RunResult run(double rate) {
+        RunResult result;
+        result.target_rate = rate;
+
+        for (auto& entry : entries_) {
+            entry.start();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(settle_ms));
+
+        std::vector<uint64_t> cpu_start;
+        for (auto& entry : entries_) {
+            cpu_start.push_back(entry.cpu_ns());
+        }
+        const uint64_t start = Time::now();
+        for (auto& arm : arm_) {
+            arm(true);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(g_options.step_ms));
+        for (auto& arm : arm_) {
+            arm(false);
+        }
+        result.elapsed_ns = Time::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(drain_ms));
+
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            const uint64_t cpu = entries_[i].cpu_ns() - cpu_start[i];
+            result.module_cpu.emplace_back(entries_[i].name,
+                                           100.0 * static_cast<double>(cpu) / static_cast<double>(result.elapsed_ns));
+        }
+
+        const uint64_t emitted = emitted_ ? emitted_() : 0;
+        result.offered_rate = bench::per_second(emitted, result.elapsed_ns);
+        result.expected = emitted * sinks_.size();
+        auto latency = std::make_unique<LatencyHistogram>();
+        for (const auto* sink : sinks_) {
+            result.delivered += sink->delivered();
+            latency->merge(sink->latency());
+        }
+        result.latency = latency->summary();
+
+        for (auto& entry : entries_) {
+            entry.stop();
+        }
+        return result;
+    }
+
+    ~Pipeline() {
+        // Destroy downstream first
+        while (!entries_.empty()) {
+            entries_.pop_back();
+        }
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::function<void()> start;
+        std::function<void()> stop;
+        std::function<uint64_t()> cpu_ns;
+        std::shared_ptr<void> owner;
+    };
+
+    std::vector<Entry> entries_;
+    std::vector<std::function<void(bool)>> arm_;
+    std::function<uint64_t()> emitted_;
+    std::vector<const bench::DeliveryRecorder*> sinks_;
+};
+
+LoadProfile profile(double rate) {
+    return LoadProfile{
+        .rate_hz = rate,
+        .jitter_ns = g_options.jitter_us * 1'000,
+        .burst = g_options.burst
+    };
+}
+
+// ============================================================================
+// Topologies
+// ============================================================================
+
+template<std::size_t N>
+RunResult run_chain(double rate) {
+    using P = Primary<N>;
+    QuietScope quiet;
+    Pipeline pipeline;
+    pipeline.add_generator<LoadGenerator<PipelineApp, P>>(source_config("Gen", 10), profile(rate));
+    uint8_t upstream = 10;
+    for (uint32_t i = 0; i < g_options.stages; ++i) {
+        const auto system_id = static_cast<uint8_t>(20 + i);
+        pipeline.add<Passthrough<PipelineApp, P>>(stage_config("Pass" + std::to_string(i + 1), system_id, upstream));
+        upstream = system_id;
+    }
+    pipeline.add_sink<LatencySink<PipelineApp, P>>(stage_config("Sink", 200, upstream));
+    return pipeline.run(rate);
+}
+
+template<std::size_t N>
+RunResult run_fanout(double rate) {
+    using P = Primary<N>;
+    QuietScope quiet;
+    Pipeline pipeline;
+    pipeline.add_generator<LoadGenerator<PipelineApp, P>>(source_config("Gen", 10), profile(rate));
+    for (uint32_t i = 0; i < g_options.fanout; ++i) {
+        pipeline.add_sink<LatencySink<PipelineApp, P>>(
+            stage_config("Sink" + std::to_string(i + 1), static_cast<uint8_t>(100 + i), 10));
+    }
+    return pipeline.run(rate);
+}
+
+template<std::size_t N>
+RunResult run_fanin(double rate) {
+    QuietScope quiet;
+    Pipeline pipeline;
+    pipeline.add_generator<LoadGenerator<PipelineApp, Primary<N>>>(source_config("GenP", 10), profile(rate));
+    pipeline.add_generator<LoadGenerator<PipelineApp, SecondaryA<N>>>(source_config("GenA", 11), profile(rate));
+    pipeline.add_generator<LoadGenerator<PipelineApp, SecondaryB<N>>>(source_config("GenB", 12), profile(rate));
+
+    // Two periods of slack, at least 1ms (config resolution)
+    const auto tolerance = std::chrono::milliseconds(std::max<int64_t>(1, static_cast<int64_t>(2000.0 / rate) + 1));
+    pipeline.add_sink<FanInSink<PipelineApp, Primary<N>, SecondaryA<N>, SecondaryB<N>>>(ModuleConfig{
+        .name = "FanIn",
+        .outputs = SimpleOutputConfig{.system_id = 200, .instance_id = 1},
+        .inputs = MultiInputConfig{
+            .sources = {
+                {.system_id = 10, .instance_id = 1},
+                {.system_id = 11, .instance_id = 1},
+                {.system_id = 12, .instance_id = 1}
+            },
+            .history_buffer_size = 100,
+            .sync_tolerance = tolerance
+        }
+    });
+    return pipeline.run(rate);
+}
+
+// ============================================================================
+// Rate Sweep
+// ============================================================================
+
+using RunFn = RunResult (*)(double);
+
+void sweep(const std::string& topology, RunFn run) {
+    const std::string prefix = "pipeline." + topology + "." + std::to_string(g_options.payload_bytes) + "B";
+    if (!selected(prefix)) {
+        return;
+    }
+
+    bool saturated = false;
+    std::optional<RunResult> last_pass;
+    for (double rate = g_options.min_rate; rate <= g_options.max_rate && !saturated; rate *= 2) {
+        RunResult result = run(rate);
+        const bool sustained = result.offered_rate >= 0.9 * rate;
+        const bool delivered = 1.0 - result.delivery_ratio() <= g_options.max_drop;
+        saturated = !sustained || !delivered;
+
+        g_table.report(BenchResult{
+            .name = prefix + ".r" + std::to_string(static_cast<uint64_t>(rate)),
+            .iterations = result.delivered,
+            .payload_bytes = g_options.payload_bytes,
+            .subscribers = static_cast<uint32_t>(topology.rfind("fanout", 0) == 0 ? g_options.fanout : 1),
+            .throughput = bench::per_second(result.delivered, result.elapsed_ns),
+            .latency = result.latency,
+            .complete = !saturated,
+            .success_rate = result.delivery_ratio(),
+            .module_cpu = result.module_cpu
+        });
+        if (!saturated) {
+            last_pass = std::move(result);
+        }
+    }
+
+    // Saturation: highest rate that was sustained without drops above --max-drop
+    BenchResult saturation;
+    saturation.name = prefix + ".saturation";
+    saturation.payload_bytes = g_options.payload_bytes;
+    if (last_pass) {
+        saturation.iterations = last_pass->delivered;
+        saturation.throughput = last_pass->target_rate;
+        saturation.latency = last_pass->latency;
+        saturation.success_rate = last_pass->delivery_ratio();
+    }
+    saturation.complete = saturated;  // false: --max-rate reached before saturating
+    g_table.report(std::move(saturation));
+}
+
+template<std::size_t N>
+void run_topologies() {
+    const bool all = g_options.topology == "all";
+    if (all || g_options.topology == "chain") {
+        sweep("chain" + std::to_string(g_options.stages), &run_chain<N>);
+    }
+    if (all || g_options.topology == "fanout") {
+        sweep("fanout" + std::to_string(g_options.fanout), &run_fanout<N>);
+    }
+    if (all || g_options.topology == "fanin") {
+        sweep("fanin3", &run_fanin<N>);
+    }
+}
+
+// ============================================================================
+// Command Line
+// ============================================================================
+
+bool parse_options(int argc, char** argv) {
+    auto number = [](const char* text) { return std::strtoull(text, nullptr, 10); };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--transport" && has_value) {
+            g_options.transport = argv[++i];
+        } else if (arg == "--topology" && has_value) {
+            g_options.topology = argv[++i];
+        } else if (arg == "--stages" && has_value) {
+            g_options.stages = static_cast<uint32_t>(std::clamp<uint64_t>(number(argv[++i]), 0, 64));
+        } else if (arg == "--fanout" && has_value) {
+            g_options.fanout = static_cast<uint32_t>(std::clamp<uint64_t>(number(argv[++i]), 1, 64));
+        } else if (arg == "--payload-bytes" && has_value) {
+            g_options.payload_bytes = number(argv[++i]);
+        } else if (arg == "--jitter-us" && has_value) {
+            g_options.jitter_us = number(argv[++i]);
+        } else if (arg == "--burst" && has_value) {
+            g_options.burst = static_cast<uint32_t>(std::max<uint64_t>(number(argv[++i]), 1));
+        } else if (arg == "--min-rate" && has_value) {
+            g_options.min_rate = std::max(1.0, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--max-rate" && has_value) {
+            g_options.max_rate = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--step-ms" && has_value) {
+            g_options.step_ms = std::max<uint64_t>(number(argv[++i]), 50);
+        } else if (arg == "--max-drop" && has_value) {
+            g_options.max_drop = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--filter" && has_value) {
+            g_options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            g_options.json_file = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    const auto& t = g_options.topology;
+    const auto p = g_options.payload_bytes;
+    return (g_options.transport == "loopback" || g_options.transport == "tims") &&
+           (t == "all" || t == "chain" || t == "fanout" || t == "fanin") &&
+           (p == 64 || p == 256 || p == 1024 || p == 4096);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parse_options(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--transport loopback|tims] [--topology chain|fanout|fanin|all]\n"
+                  << "       [--stages N] [--fanout N] [--payload-bytes 64|256|1024|4096]\n"
+                  << "       [--jitter-us N] [--burst N] [--min-rate HZ] [--max-rate HZ]\n"
+                  << "       [--step-ms N] [--max-drop RATIO] [--filter SUBSTRING] [--json FILE]\n";
+        return 1;
+    }
+
+    TimsWrapper::set_transport(g_options.transport == "tims" ? TimsTransport::Router : TimsTransport::Loopback);
+
+    std::cout << "=== CommRaT Pipeline Benchmark ===\n"
+              << "Transport: " << g_options.transport << ", payload: " << g_options.payload_bytes
+              << " B, jitter: " << g_options.jitter_us << " us, burst: " << g_options.burst
+              << ", step: " << g_options.step_ms << " ms, max drop: " << g_options.max_drop * 100.0 << " %\n\n";
+    g_table.print_header();
+
+    switch (g_options.payload_bytes) {
+        case 64:   run_topologies<64>(); break;
+        case 256:  run_topologies<256>(); break;
+        case 1024: run_topologies<1024>(); break;
+        case 4096: run_topologies<4096>(); break;
+    }
+
+    if (!g_options.json_file.empty()) {
+        if (!g_table.write_json(g_options.json_file, g_options.transport)) {
+            std::cerr << "Failed to write " << g_options.json_file << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to " << g_options.json_file << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,451 @@
+/**
+ * @file bench_recorder.cpp
+ * @brief Recording throughput benchmarks (MmapLogWriter and Recorder)
+ *
+ * Measures:
+ * - MmapLogWriter::append() from 1 and 4 threads for 256 B, 4 KiB and
+ *   64 KiB records: append latency and sustained records/s and MB/s
+ * - Recorder<App> recording N LoadGenerator streams through the regular
+ *   subscription path: recorded share of emitted messages (success rate),
+ *   publish-to-log latency and MB/s
+ * - Replayer<App> replaying N streams as fast as possible to one sink
+ *   module per stream: delivered messages/s, delivered share and MB/s
+ *
+ * Logs are written to --dir (default: system temp directory) and deleted
+ * after each case. Each append case stops after --max-mb MiB.
+ *
+ * Usage: bench_recorder [--transport loopback|tims] [--dir PATH]
+ *                       [--duration-ms N] [--max-mb N] [--streams N]
+ *                       [--rate HZ] [--filter SUBSTRING] [--json FILE]
+ */
+
+#include "bench_common.hpp"
+#include "pipeline_modules.hpp"
+#include "commrat/recording/log_reader.hpp"
+#include "commrat/recording/recorder.hpp"
+#include "commrat/recording/replayer.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace commrat;
+using commrat::bench::BenchResult;
+using commrat::bench::LatencySink;
+using commrat::bench::LoadGenerator;
+using commrat::bench::LoadPayload;
+using commrat::bench::LoadProfile;
+using commrat::bench::QuietScope;
+
+namespace {
+
+// ============================================================================
+// Application
+// ============================================================================
+
+constexpr std::size_t stream_payload_bytes = 4096;
+constexpr std::size_t max_streams = 4;
+
+template<std::size_t... Streams>
+using RecorderAppFor = CommRaT<Message::Data<LoadPayload<stream_payload_bytes, Streams>>...>;
+
+using RecorderApp = RecorderAppFor<0, 1, 2, 3>;
+
+// ============================================================================
+// Options
+// ============================================================================
+
+struct Options {
+    std::string transport{"loopback"};
+    std::string dir{(std::filesystem::temp_directory_path() /
+                     ("commrat_bench_recorder_" + std::to_string(::getpid()))).string()};
+    uint64_t duration_ms{1000};
+    uint64_t max_mb{512};
+    uint32_t streams{2};
+    double rate{20'000.0};
+    std::string filter;
+    std::string json_file;
+};
+
+bench::ResultTable g_table{"bench_recorder"};
+Options g_options;
+
+bool selected(const std::string& name) {
+    return g_options.filter.empty() || name.find(g_options.filter) != std::string::npos;
+}
+
+void print_bandwidth(uint64_t bytes, uint64_t elapsed_ns) {
+    std::cout << "    MB/s: " << std::fixed << std::setprecision(1)
+              << static_cast<double>(bytes) * 1e3 / static_cast<double>(std::max<uint64_t>(elapsed_ns, 1))
+              << "\n";
+}
+
+// ============================================================================
+// MmapLogWriter::append()
+// ============================================================================
+
+void bench_append(std::size_t record_bytes, uint32_t threads) {
+    const std::string name = "append." + std::to_string(record_bytes) + "B." + std::to_string(threads) + "t";
+    if (!selected(name)) {
+        return;
+    }
+
+    const std::string dir = g_options.dir + "/" + name;
+    auto writer = std::make_unique<MmapLogWriter>(LogWriterConfig{
+        .directory = dir, .prefix = "bench", .segment_size = 64 * 1024 * 1024
+    }, std::vector<LogStreamInfo>{}, "[]");
+
+    const uint64_t byte_budget = g_options.max_mb * 1024 * 1024 / threads;
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+    std::vector<uint64_t> appended(threads, 0);
+    for (uint32_t t = 0; t < threads; ++t) {
+        histograms.push_back(std::make_unique<LatencyHistogram>());
+    }
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::vector<std::byte> record(record_bytes, static_cast<std::byte>(t));
+            while (!go.load(std::memory_order_acquire)) {}
+            const uint64_t end = Time::now() + g_options.duration_ms * 1'000'000;
+            uint64_t bytes = 0;
+            uint64_t now = Time::now();
+            while (now < end && bytes < byte_budget) {
+                const uint64_t before = now;
+                if (writer->append(static_cast<uint16_t>(t), before, record)) {
+                    ++appended[t];
+                    bytes += record_bytes;
+                }
+                now = Time::now();
+                histograms[t]->record(now - before);
+            }
+        });
+    }
+
+    const uint64_t start = Time::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const uint64_t elapsed = Time::now() - start;
+    writer->close();
+    const auto stats = writer->stats();
+    writer.reset();
+    std::filesystem::remove_all(dir);
+
+    auto histogram = std::make_unique<LatencyHistogram>();
+    uint64_t total = 0;
+    for (uint32_t t = 0; t < threads; ++t) {
+        histogram->merge(*histograms[t]);
+        total += appended[t];
+    }
+
+    g_table.report(BenchResult{
+        .name = name,
+        .iterations = total,
+        .payload_bytes = record_bytes,
+        .subscribers = threads,
+        .throughput = bench::per_second(total, elapsed),
+        .latency = histogram->summary(),
+        .complete = stats.dropped == 0
+    });
+    print_bandwidth(total * record_bytes, elapsed);
+}
+
+// ============================================================================
+// Recorder<App> on LoadGenerator streams
+// ============================================================================
+
+using Generator0 = LoadGenerator<RecorderApp, LoadPayload<stream_payload_bytes, 0>>;
+using Generator1 = LoadGenerator<RecorderApp, LoadPayload<stream_payload_bytes, 1>>;
+using Generator2 = LoadGenerator<RecorderApp, LoadPayload<stream_payload_bytes, 2>>;
+using Generator3 = LoadGenerator<RecorderApp, LoadPayload<stream_payload_bytes, 3>>;
+
+ModuleConfig generator_config(uint32_t index) {
+    return ModuleConfig{
+        .name = "RecGen" + std::to_string(index),
+        .outputs = SimpleOutputConfig{.system_id = static_cast<uint8_t>(10 + index), .instance_id = 1},
+        .inputs = NoInputConfig{}
+    };
+}
+
+void bench_recorder_streams() {
+    const uint32_t streams = std::clamp<uint32_t>(g_options.streams, 1, max_streams);
+    const std::string name = "recorder." + std::to_string(streams) + "x" +
+                             std::to_string(stream_payload_bytes) + "B@" +
+                             std::to_string(static_cast<uint64_t>(g_options.rate));
+    if (!selected(name)) {
+        return;
+    }
+
+    const std::string dir = g_options.dir + "/recorder";
+    const LoadProfile profile{.rate_hz = g_options.rate};
+    uint64_t emitted = 0;
+    LogWriterStats stats;
+    uint64_t elapsed = 0;
+    {
+        QuietScope quiet;
+        Generator0 gen0(generator_config(0), profile);
+        Generator1 gen1(generator_config(1), profile);
+        Generator2 gen2(generator_config(2), profile);
+        Generator3 gen3(generator_config(3), profile);
+
+        Recorder<RecorderApp> recorder(RecorderConfig{
+            .name = "BenchRecorder", .system_id = 90, .instance_id = 1,
+            .log = {.directory = dir, .prefix = "rec"},
+            .mailbox_slots = 1024
+        });
+        if (streams > 0) recorder.record<LoadPayload<stream_payload_bytes, 0>>(10, 1);
+        if (streams > 1) recorder.record<LoadPayload<stream_payload_bytes, 1>>(11, 1);
+        if (streams > 2) recorder.record<LoadPayload<stream_payload_bytes, 2>>(12, 1);
+        if (streams > 3) recorder.record<LoadPayload<stream_payload_bytes, 3>>(13, 1);
+
+        if (streams > 0) gen0.start();
+        if (streams > 1) gen1.start();
+        if (streams > 2) gen2.start();
+        if (streams > 3) gen3.start();
+        recorder.start();
+        recorder.wait_for_subscriptions(std::chrono::milliseconds(2000));
+
+        const uint64_t start = Time::now();
+        if (streams > 0) gen0.arm();
+        if (streams > 1) gen1.arm();
+        if (streams > 2) gen2.arm();
+        if (streams > 3) gen3.arm();
+        std::this_thread::sleep_for(std::chrono::milliseconds(g_options.duration_ms));
+        gen0.disarm();
+        gen1.disarm();
+        gen2.disarm();
+        gen3.disarm();
+        elapsed = Time::now() - start;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Drain
+
+        recorder.stop();
+        gen0.stop();
+        gen1.stop();
+        gen2.stop();
+        gen3.stop();
+        emitted = gen0.emitted() + gen1.emitted() + gen2.emitted() + gen3.emitted();
+        stats = recorder.stats();
+    }
+
+    // Numbered messages in the log; latency = generator release -> log append
+    auto histogram = std::make_unique<LatencyHistogram>();
+    uint64_t recorded = 0;
+    for (const auto& path : list_log_segments(dir, "rec")) {
+        LogSegmentReader reader(path);
+        while (auto record = reader.next()) {
+            RecorderApp::visit(record->header().msg_type, record->wire, [&](auto& msg) {
+                if (msg.payload.seq != 0) {
+                    ++recorded;
+                    histogram->record(record->receive_ns - msg.payload.origin_ns);
+                }
+            });
+        }
+    }
+    std::filesystem::remove_all(dir);
+
+    g_table.report(BenchResult{
+        .name = name,
+        .iterations = recorded,
+        .payload_bytes = stream_payload_bytes,
+        .subscribers = streams,
+        .throughput = bench::per_second(recorded, elapsed),
+        .latency = histogram->summary(),
+        .complete = recorded == emitted && stats.dropped == 0,
+        .success_rate = static_cast<double>(recorded) / static_cast<double>(std::max<uint64_t>(emitted, 1))
+    });
+    print_bandwidth(recorded * stream_payload_bytes, elapsed);
+}
+
+// ============================================================================
+// Replayer<App> as fast as possible
+// ============================================================================
+
+template<std::size_t Stream>
+using ReplaySink = LatencySink<RecorderApp, LoadPayload<stream_payload_bytes, Stream>>;
+
+ModuleConfig replay_sink_config(uint32_t index) {
+    return ModuleConfig{
+        .name = "ReplaySink" + std::to_string(index),
+        .outputs = SimpleOutputConfig{.system_id = static_cast<uint8_t>(30 + index), .instance_id = 1},
+        .inputs = SingleInputConfig{.source_system_id = static_cast<uint8_t>(10 + index), .source_instance_id = 1}
+    };
+}
+
+/// Log with `per_stream` numbered messages per stream, interleaved 50us apart
+template<std::size_t... Streams>
+void write_replay_log(const std::string& dir, uint32_t streams, uint64_t per_stream,
+                      std::index_sequence<Streams...>) {
+    std::vector<LogStreamInfo> table;
+    ((Streams < streams ? table.push_back(LogStreamInfo{
+        .message_id = RecorderApp::get_message_id<LoadPayload<stream_payload_bytes, Streams>>(),
+        .stream_id = static_cast<uint16_t>(Streams),
+        .system_id = static_cast<uint8_t>(10 + Streams),
+        .instance_id = 1,
+        .name = {}}) : void()), ...);
+
+    MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "replay"}, table,
+                         RecorderApp::Introspection::export_all());
+    uint64_t receive_ns = 0;
+    for (uint64_t seq = 1; seq <= per_stream; ++seq) {
+        ([&] {
+            if (Streams < streams) {
+                TimsMessage<LoadPayload<stream_payload_bytes, Streams>> msg{};
+                msg.header.timestamp = receive_ns;
+                msg.payload.seq = seq;
+                auto wire = RecorderApp::serialize(msg);
+                writer.append(static_cast<uint16_t>(Streams), receive_ns, wire.view());
+                receive_ns += 50'000;
+            }
+        }(), ...);
+    }
+    writer.close();
+}
+
+void bench_replay() {
+    const uint32_t streams = std::clamp<uint32_t>(g_options.streams, 1, max_streams);
+    const std::string name = "replay." + std::to_string(streams) + "x" +
+                             std::to_string(stream_payload_bytes) + "B.afap";
+    if (!selected(name)) {
+        return;
+    }
+
+    const std::string dir = g_options.dir + "/replay";
+    const uint64_t per_stream = g_options.max_mb * 1024 * 1024 / stream_payload_bytes / streams;
+    write_replay_log(dir, streams, per_stream, std::make_index_sequence<max_streams>{});
+
+    uint64_t delivered = 0;
+    uint64_t elapsed = 0;
+    ReplayStats stats;
+    {
+        QuietScope quiet;
+        Replayer<RecorderApp> replay(ReplayConfig{
+            .name = "BenchReplay", .system_id = 91, .instance_id = 1,
+            .directory = dir, .prefix = "replay",
+            .pacing = ReplayPacing::AsFastAsPossible
+        });
+        replay.start();
+
+        ReplaySink<0> sink0(replay_sink_config(0));
+        ReplaySink<1> sink1(replay_sink_config(1));
+        ReplaySink<2> sink2(replay_sink_config(2));
+        ReplaySink<3> sink3(replay_sink_config(3));
+        if (streams > 0) sink0.start();
+        if (streams > 1) sink1.start();
+        if (streams > 2) sink2.start();
+        if (streams > 3) sink3.start();
+        replay.wait_for_subscribers(streams, std::chrono::milliseconds(2000));
+
+        const uint64_t start = Time::now();
+        replay.play();
+        replay.wait_until_finished(std::chrono::milliseconds(600'000));
+        auto total = [&]() {
+            return sink0.recorder().delivered() + sink1.recorder().delivered() +
+                   sink2.recorder().delivered() + sink3.recorder().delivered();
+        };
+        // Sinks drain their queues after the last send
+        for (int i = 0; i < 200 && total() < per_stream * streams; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        elapsed = Time::now() - start;
+        delivered = total();
+        stats = replay.stats();
+
+        replay.stop();
+        sink0.stop();
+        sink1.stop();
+        sink2.stop();
+        sink3.stop();
+    }
+    std::filesystem::remove_all(dir);
+
+    const uint64_t expected = per_stream * streams;
+    g_table.report(BenchResult{
+        .name = name,
+        .iterations = delivered,
+        .payload_bytes = stream_payload_bytes,
+        .subscribers = streams,
+        .throughput = bench::per_second(delivered, elapsed),
+        .complete = delivered == expected && stats.dropped == 0,
+        .success_rate = static_cast<double>(delivered) / static_cast<double>(std::max<uint64_t>(expected, 1))
+    });
+    print_bandwidth(delivered * stream_payload_bytes, elapsed);
+    std::cout << "    blocked on consumers: " << std::fixed << std::setprecision(1)
+              << 100.0 * static_cast<double>(stats.blocked_ns) / static_cast<double>(std::max<uint64_t>(elapsed, 1))
+              << " %\n";
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+bool parse_options(int argc, char** argv) {
+    auto number = [](const char* text) { return std::strtoull(text, nullptr, 10); };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--transport" && has_value) {
+            g_options.transport = argv[++i];
+        } else if (arg == "--dir" && has_value) {
+            g_options.dir = argv[++i];
+        } else if (arg == "--duration-ms" && has_value) {
+            g_options.duration_ms = std::max<uint64_t>(number(argv[++i]), 10);
+        } else if (arg == "--max-mb" && has_value) {
+            g_options.max_mb = std::max<uint64_t>(number(argv[++i]), 1);
+        } else if (arg == "--streams" && has_value) {
+            g_options.streams = static_cast<uint32_t>(number(argv[++i]));
+        } else if (arg == "--rate" && has_value) {
+            g_options.rate = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--filter" && has_value) {
+            g_options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            g_options.json_file = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return (g_options.transport == "loopback" || g_options.transport == "tims") && g_options.rate > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parse_options(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--transport loopback|tims] [--dir PATH]\n"
+                  << "       [--duration-ms N] [--max-mb N] [--streams N] [--rate HZ]\n"
+                  << "       [--filter SUBSTRING] [--json FILE]\n";
+        return 1;
+    }
+
+    TimsWrapper::set_transport(g_options.transport == "tims" ? TimsTransport::Router : TimsTransport::Loopback);
+
+    std::cout << "=== CommRaT Recorder Benchmark ===\n"
+              << "Log directory: " << g_options.dir << ", duration: " << g_options.duration_ms
+              << " ms, recorder streams: " << g_options.streams << " x " << g_options.rate << " Hz\n\n";
+    g_table.print_header();
+
+    for (std::size_t bytes : {std::size_t{256}, std::size_t{4096}, std::size_t{65536}}) {
+        for (uint32_t threads : {1u, 4u}) {
+            bench_append(bytes, threads);
+        }
+    }
+    bench_recorder_streams();
+    bench_replay();
+    std::filesystem::remove_all(g_options.dir);
+
+    if (!g_options.json_file.empty()) {
+        if (!g_table.write_json(g_options.json_file, g_options.transport)) {
+            std::cerr << "Failed to write " << g_options.json_file << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to " << g_options.json_file << "\n";
+    }
+    return 0;
+}
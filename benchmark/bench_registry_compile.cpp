@@ -0,0 +1,102 @@
+/**
+ * @file bench_registry_compile.cpp
+ * @brief Compile-time cost of large message registries
+ *
+ * Builds a CommRaT registry of COMMRAT_BENCH_REGISTRY_SIZE distinct payload
+ * types and uses everything an application instantiates per type: ID
+ * assignment and collision check, type -> ID and ID -> type lookups, reply
+ * and coalescing lookups, and visit() dispatch over all types.
+ *
+ * The result is the compile time and memory of this file. CMake builds it
+ * for 16..512 types with `cmake --build . --target bench_registry_compile`
+ * and prints time and peak memory per size (benchmark/time_compile.sh).
+ * The executable itself reports the runtime cost of visit().
+ *
+ * Usage: bench_registry_compile_<N> [iterations]
+ */
+
+#include "commrat/commrat.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#ifndef COMMRAT_BENCH_REGISTRY_SIZE
+#define COMMRAT_BENCH_REGISTRY_SIZE 64
+#endif
+
+using namespace commrat;
+
+namespace {
+
+constexpr std::size_t registry_size = COMMRAT_BENCH_REGISTRY_SIZE;
+
+/// One distinct payload type per index
+template<std::size_t I>
+struct Payload {
+    uint64_t value{0};
+    uint32_t index{static_cast<uint32_t>(I)};
+};
+
+/// Every fourth message is a command with a reply, every eighth coalesced
+template<std::size_t I>
+using Definition = std::conditional_t<
+    I % 4 == 1,
+    Message::Reply<Message::Command<Payload<I - 1>>, Payload<I>>,
+    std::conditional_t<I % 8 == 4, Message::Command<Payload<I>, Coalesce::Latest>, Message::Data<Payload<I>>>
+>;
+
+template<std::size_t... Is>
+auto make_app(std::index_sequence<Is...>) -> CommRaT<Definition<Is>...>;
+
+using BenchApp = decltype(make_app(std::make_index_sequence<registry_size>{}));
+
+/// Type <-> ID round trip for every type
+template<std::size_t... Is>
+constexpr bool lookups_consistent(std::index_sequence<Is...>) {
+    return (std::is_same_v<BenchApp::PayloadTypeFor<BenchApp::get_message_id<Payload<Is>>()>, Payload<Is>> && ...) &&
+           (BenchApp::has_message_id<BenchApp::get_message_id<Payload<Is>>()> && ...);
+}
+
+static_assert(lookups_consistent(std::make_index_sequence<registry_size>{}));
+static_assert(std::is_same_v<BenchApp::reply_type_for<Payload<0>>, Payload<1>>);
+static_assert(BenchApp::coalesce_policy_for<Payload<4>> == Coalesce::Latest);
+static_assert(BenchApp::size() == registry_size);
+
+/// Serialized message of type I
+template<std::size_t I>
+auto serialized() {
+    TimsMessage<Payload<I>> msg{};
+    msg.payload.value = I;
+    return BenchApp::serialize(msg);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    // First, middle and last registered type
+    const auto first = serialized<0>();
+    const auto middle = serialized<registry_size / 2>();
+    const auto last = serialized<registry_size - 1>();
+    const std::pair<uint32_t, std::span<const std::byte>> messages[] = {
+        {BenchApp::get_message_id<Payload<0>>(), first.view()},
+        {BenchApp::get_message_id<Payload<registry_size / 2>>(), middle.view()},
+        {BenchApp::get_message_id<Payload<registry_size - 1>>(), last.view()},
+    };
+
+    uint64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        const auto& [id, wire] = messages[i % 3];
+        BenchApp::visit(id, wire, [&sink](const auto& msg) { sink += msg.payload.index; });
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << registry_size << " types: " << std::fixed << std::setprecision(1)
+              << ns / static_cast<double>(iterations) << " ns per visit() (checksum " << sink << ")\n";
+    return sink == 0 ? 1 : 0;
+}
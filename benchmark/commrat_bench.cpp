@@ -0,0 +1,520 @@
+/**
+ * @file commrat_bench.cpp
+ * @brief Transport and mailbox microbenchmarks
+ *
+ * Measures:
+ * - One-way latency (lockstep, unloaded) and throughput (back-to-back) of
+ *   the Mailbox, RegistryMailbox and TypedMailbox send/receive paths,
+ *   receive_any() visitor dispatch and try_receive() polling
+ * - Serialization / deserialization cost per payload size
+ * - Fan-out: publish cost and delivery latency for 1..64 subscribers
+ *
+ * Runs against the TiMS router (--transport tims) or the in-process
+ * loopback stand-in (default), so it works on any Linux machine.
+ *
+ * Usage: commrat_bench [--transport loopback|tims] [--iterations N]
+ *                      [--max-subscribers N] [--filter SUBSTRING]
+ *                      [--json FILE]
+ */
+
+#include "bench_common.hpp"
+#include "commrat/commrat.hpp"
+#include "commrat/module/metrics/module_metrics.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+using commrat::bench::BenchResult;
+using commrat::bench::do_not_optimize;
+
+namespace {
+
+// ============================================================================
+// Benchmark Messages
+// ============================================================================
+
+struct BenchSample {
+    uint64_t seq{0};
+    uint64_t value{0};
+};
+
+struct BenchOther {
+    uint32_t value{0};
+};
+
+template<std::size_t N>
+struct BenchBlob {
+    uint64_t seq{0};
+    std::array<uint8_t, N> data{};
+};
+
+template<typename... Defs>
+struct BenchTypes {
+    using Registry = MessageRegistry<Defs...>;
+    using RawMailbox = Mailbox<Defs...>;
+};
+
+using Bench = BenchTypes<
+    MessageDefinition<BenchSample, MessagePrefix::UserDefined, UserSubPrefix::Data, 0>,
+    MessageDefinition<BenchOther, MessagePrefix::UserDefined, UserSubPrefix::Data, 1>,
+    MessageDefinition<BenchBlob<16>, MessagePrefix::UserDefined, UserSubPrefix::Data, 2>,
+    MessageDefinition<BenchBlob<64>, MessagePrefix::UserDefined, UserSubPrefix::Data, 3>,
+    MessageDefinition<BenchBlob<256>, MessagePrefix::UserDefined, UserSubPrefix::Data, 4>,
+    MessageDefinition<BenchBlob<1024>, MessagePrefix::UserDefined, UserSubPrefix::Data, 5>,
+    MessageDefinition<BenchBlob<4096>, MessagePrefix::UserDefined, UserSubPrefix::Data, 6>
+>;
+
+using BenchRegistry = Bench::Registry;
+using BenchRegistryMailbox = RegistryMailbox<BenchRegistry>;
+using BenchTypedMailbox = TypedMailbox<BenchRegistry, BenchSample>;
+
+// ============================================================================
+// Options
+// ============================================================================
+
+struct Options {
+    std::string transport{"loopback"};
+    uint64_t iterations{20'000};
+    uint32_t max_subscribers{64};
+    std::string filter;
+    std::string json_file;
+};
+
+bench::ResultTable g_table{"commrat_bench"};
+Options g_options;
+uint32_t g_next_mailbox_id = 0x00C00000;
+
+constexpr uint64_t lockstep_timeout_ns = 1'000'000'000;
+
+bool selected(const std::string& name) {
+    return g_options.filter.empty() || name.find(g_options.filter) != std::string::npos;
+}
+
+MailboxConfig mailbox_config(const std::string& name) {
+    return MailboxConfig{
+        .mailbox_id = g_next_mailbox_id++,
+        .message_slots = 10,
+        .max_message_size = BenchRegistry::max_message_size,
+        .send_priority = 10,
+        .realtime = false,
+        .mailbox_name = name
+    };
+}
+
+template<typename MailboxT>
+void start_or_exit(MailboxT& mailbox) {
+    auto result = mailbox.start();
+    if (!result) {
+        std::cerr << "Failed to start mailbox " << mailbox.mailbox_id() << ": "
+                  << to_string(result.get_error()) << "\n";
+        if (g_options.transport == "tims") {
+            std::cerr << "Is the TiMS router running? Use --transport loopback otherwise.\n";
+        }
+        std::exit(1);
+    }
+}
+
+/// Send until the destination has a free slot
+template<typename SendFn>
+bool send_retry(SendFn&& send) {
+    while (true) {
+        auto result = send();
+        if (result) {
+            return true;
+        }
+        if (result.get_error() != MailboxError::QueueFull) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool wait_until(const std::atomic<uint64_t>& counter, uint64_t target) {
+    uint64_t deadline = Time::now() + lockstep_timeout_ns;
+    while (counter.load(std::memory_order_acquire) < target) {
+        if (Time::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void report(BenchResult result) {
+    g_table.report(std::move(result));
+}
+
+// ============================================================================
+// Send/Receive Paths
+// ============================================================================
+
+/**
+ * @brief One-way latency (lockstep) and throughput (back-to-back) of a path
+ *
+ * @param rx      Receiving mailbox (stopped at the end to wake the receiver)
+ * @param send    send(seq, timestamp) -> MailboxResult<void>
+ * @param receive receive() -> std::optional<TimsHeader> (nullopt = nothing received)
+ */
+template<typename RxMailbox, typename SendFn, typename ReceiveFn>
+void run_path(const std::string& name, RxMailbox& rx, SendFn send, ReceiveFn receive) {
+    const uint64_t iterations = g_options.iterations;
+    const uint64_t warmup = std::min<uint64_t>(1'000, iterations / 10);
+
+    auto histogram = std::make_unique<LatencyHistogram>();
+    std::atomic<uint64_t> received{0};
+    std::atomic<bool> stop{false};
+    std::atomic<bool> measure_latency{true};
+
+    std::thread receiver([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::optional<TimsHeader> header = receive();
+            if (!header) {
+                std::this_thread::yield();  // try_receive: nothing pending
+                continue;
+            }
+            uint64_t now = Time::now();
+            if (measure_latency.load(std::memory_order_relaxed) &&
+                received.load(std::memory_order_relaxed) >= warmup) {
+                histogram->record(now - header->timestamp);
+            }
+            received.fetch_add(1, std::memory_order_release);
+        }
+    });
+
+    bool complete = true;
+
+    // Phase 1: lockstep, one message in flight
+    for (uint64_t i = 0; i < warmup + iterations && complete; ++i) {
+        complete = send_retry([&]() { return send(i, Time::now()); }) && wait_until(received, i + 1);
+    }
+    LatencyStats latency = histogram->summary();
+
+    // Phase 2: back-to-back
+    measure_latency = false;
+    uint64_t base = received.load();
+    uint64_t start = Time::now();
+    for (uint64_t i = 0; i < iterations && complete; ++i) {
+        complete = send_retry([&]() { return send(i, Time::now()); });
+    }
+    complete = complete && wait_until(received, base + iterations);
+    uint64_t elapsed = Time::now() - start;
+
+    stop = true;
+    rx.stop();  // Wakes a blocked receiver
+    receiver.join();
+
+    report(BenchResult{
+        .name = name,
+        .iterations = iterations,
+        .payload_bytes = sizeof(TimsHeader) + sizeof(BenchSample),
+        .subscribers = 1,
+        .throughput = bench::per_second(iterations, elapsed),
+        .latency = latency,
+        .complete = complete
+    });
+}
+
+void bench_paths() {
+    // Mailbox: full TimsMessage<T> on both sides
+    if (selected("mailbox.send_receive")) {
+        Bench::RawMailbox tx(mailbox_config("bench_tx"));
+        Bench::RawMailbox rx(mailbox_config("bench_rx"));
+        start_or_exit(tx);
+        start_or_exit(rx);
+        run_path("mailbox.send_receive", rx,
+            [&](uint64_t seq, uint64_t timestamp) {
+                TimsMessage<BenchSample> msg{};
+                msg.header.timestamp = timestamp;
+                msg.payload.seq = seq;
+                return tx.send(msg, rx.mailbox_id());
+            },
+            [&]() -> std::optional<TimsHeader> {
+                auto result = rx.template receive<BenchSample>();
+                return result ? std::optional<TimsHeader>(result->header) : std::nullopt;
+            });
+    }
+
+    // RegistryMailbox: payload-only API
+    if (selected("registry_mailbox.send_receive")) {
+        BenchRegistryMailbox tx(mailbox_config("bench_tx"));
+        BenchRegistryMailbox rx(mailbox_config("bench_rx"));
+        start_or_exit(tx);
+        start_or_exit(rx);
+        run_path("registry_mailbox.send_receive", rx,
+            [&](uint64_t seq, uint64_t timestamp) {
+                BenchSample sample{.seq = seq, .value = 0};
+                return tx.send(sample, rx.mailbox_id(), timestamp);
+            },
+            [&]() -> std::optional<TimsHeader> {
+                auto result = rx.template receive<BenchSample>();
+                return result ? std::optional<TimsHeader>(result->header) : std::nullopt;
+            });
+    }
+
+    // TypedMailbox: compile-time restricted payloads
+    if (selected("typed_mailbox.send_receive")) {
+        BenchTypedMailbox tx(mailbox_config("bench_tx"));
+        BenchTypedMailbox rx(mailbox_config("bench_rx"));
+        start_or_exit(tx);
+        start_or_exit(rx);
+        run_path("typed_mailbox.send_receive", rx,
+            [&](uint64_t seq, uint64_t timestamp) {
+                BenchSample sample{.seq = seq, .value = 0};
+                return tx.send(sample, rx.mailbox_id(), timestamp);
+            },
+            [&]() -> std::optional<TimsHeader> {
+                auto result = rx.template receive<BenchSample>();
+                return result ? std::optional<TimsHeader>(result->header) : std::nullopt;
+            });
+    }
+
+    // receive_any: runtime dispatch over all registered types
+    if (selected("registry_mailbox.receive_any")) {
+        BenchRegistryMailbox tx(mailbox_config("bench_tx"));
+        BenchRegistryMailbox rx(mailbox_config("bench_rx"));
+        start_or_exit(tx);
+        start_or_exit(rx);
+        run_path("registry_mailbox.receive_any", rx,
+            [&](uint64_t seq, uint64_t timestamp) {
+                BenchSample sample{.seq = seq, .value = 0};
+                return tx.send(sample, rx.mailbox_id(), timestamp);
+            },
+            [&]() -> std::optional<TimsHeader> {
+                std::optional<TimsHeader> header;
+                rx.receive_any([&](auto&& msg) {
+                    using MsgT = std::decay_t<decltype(msg)>;
+                    if constexpr (std::is_same_v<MsgT, TimsMessage<BenchSample>>) {
+                        header = msg.header;
+                    }
+                });
+                return header;
+            });
+    }
+
+    // try_receive: receiver busy-polls
+    if (selected("registry_mailbox.try_receive")) {
+        BenchRegistryMailbox tx(mailbox_config("bench_tx"));
+        BenchRegistryMailbox rx(mailbox_config("bench_rx"));
+        start_or_exit(tx);
+        start_or_exit(rx);
+        run_path("registry_mailbox.try_receive", rx,
+            [&](uint64_t seq, uint64_t timestamp) {
+                BenchSample sample{.seq = seq, .value = 0};
+                return tx.send(sample, rx.mailbox_id(), timestamp);
+            },
+            [&]() -> std::optional<TimsHeader> {
+                auto result = rx.template try_receive<BenchSample>();
+                return result ? std::optional<TimsHeader>(result->header) : std::nullopt;
+            });
+    }
+}
+
+// ============================================================================
+// Serialization
+// ============================================================================
+
+template<std::size_t N>
+void bench_serialization() {
+    using MsgT = TimsMessage<BenchBlob<N>>;
+    constexpr uint64_t batch = 32;
+    const uint64_t samples = std::max<uint64_t>(g_options.iterations / batch, 100);
+    const std::string suffix = "." + std::to_string(N);
+
+    auto message = std::make_unique<MsgT>();
+    for (std::size_t i = 0; i < N; ++i) {
+        message->payload.data[i] = static_cast<uint8_t>(i);
+    }
+    auto serialized = BenchRegistry::serialize(*message);
+    const std::size_t size = serialized.size;
+
+    auto run = [&](const std::string& name, auto&& op) {
+        if (!selected(name)) {
+            return;
+        }
+        auto histogram = std::make_unique<LatencyHistogram>();
+        uint64_t total = 0;
+        for (uint64_t s = 0; s < samples; ++s) {
+            uint64_t start = Time::now();
+            for (uint64_t b = 0; b < batch; ++b) {
+                op();
+            }
+            uint64_t elapsed = Time::now() - start;
+            histogram->record(elapsed / batch);
+            total += elapsed;
+        }
+        report(BenchResult{
+            .name = name,
+            .iterations = samples * batch,
+            .payload_bytes = size,
+            .subscribers = 0,
+            .throughput = bench::per_second(samples * batch, total),
+            .latency = histogram->summary(),
+            .complete = true
+        });
+    };
+
+    run("serialize" + suffix, [&]() {
+        auto result = BenchRegistry::serialize(*message);
+        do_not_optimize(result);
+    });
+    run("deserialize" + suffix, [&]() {
+        auto result = BenchRegistry::template deserialize<MsgT>(serialized.view());
+        do_not_optimize(result);
+    });
+}
+
+// ============================================================================
+// Fan-out
+// ============================================================================
+
+void bench_fanout(uint32_t subscribers) {
+    const std::string prefix = "fanout." + std::to_string(subscribers);
+    if (!selected(prefix + ".publish") && !selected(prefix + ".delivery")) {
+        return;
+    }
+
+    const uint64_t iterations = std::max<uint64_t>(g_options.iterations / 10, 1'000);
+
+    BenchRegistryMailbox publisher(mailbox_config("bench_pub"));
+    start_or_exit(publisher);
+
+    std::vector<std::unique_ptr<BenchRegistryMailbox>> mailboxes;
+    std::vector<std::vector<uint64_t>> latencies(subscribers);
+    for (uint32_t i = 0; i < subscribers; ++i) {
+        mailboxes.push_back(std::make_unique<BenchRegistryMailbox>(mailbox_config("bench_sub")));
+        start_or_exit(*mailboxes.back());
+        latencies[i].reserve(iterations);
+    }
+
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> receivers;
+    for (uint32_t i = 0; i < subscribers; ++i) {
+        receivers.emplace_back([&, i]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto result = mailboxes[i]->template receive<BenchSample>();
+                if (!result) {
+                    continue;
+                }
+                latencies[i].push_back(Time::now() - result->header.timestamp);
+                delivered.fetch_add(1, std::memory_order_release);
+            }
+        });
+    }
+
+    // Publish like Publisher: one send per subscriber, same timestamp
+    auto publish_histogram = std::make_unique<LatencyHistogram>();
+    bool complete = true;
+    uint64_t start = Time::now();
+    for (uint64_t seq = 0; seq < iterations && complete; ++seq) {
+        BenchSample sample{.seq = seq, .value = 0};
+        uint64_t timestamp = Time::now();
+        for (auto& mailbox : mailboxes) {
+            complete = complete && send_retry([&]() {
+                return publisher.send(sample, mailbox->mailbox_id(), timestamp);
+            });
+        }
+        publish_histogram->record(Time::now() - timestamp);
+        complete = complete && wait_until(delivered, (seq + 1) * subscribers);
+    }
+    uint64_t elapsed = Time::now() - start;
+
+    stop = true;
+    for (auto& mailbox : mailboxes) {
+        mailbox->stop();  // Wakes blocked receivers
+    }
+    for (auto& receiver : receivers) {
+        receiver.join();
+    }
+
+    auto delivery_histogram = std::make_unique<LatencyHistogram>();
+    for (const auto& per_subscriber : latencies) {
+        for (uint64_t latency : per_subscriber) {
+            delivery_histogram->record(latency);
+        }
+    }
+
+    const double publishes_per_s = bench::per_second(iterations, elapsed);
+    const std::size_t size = sizeof(TimsHeader) + sizeof(BenchSample);
+    if (selected(prefix + ".publish")) {
+        report(BenchResult{prefix + ".publish", iterations, size, subscribers,
+                           publishes_per_s, publish_histogram->summary(), complete});
+    }
+    if (selected(prefix + ".delivery")) {
+        report(BenchResult{prefix + ".delivery", iterations * subscribers, size, subscribers,
+                           publishes_per_s * subscribers, delivery_histogram->summary(), complete});
+    }
+}
+
+// ============================================================================
+// Command Line
+// ============================================================================
+
+bool parse_options(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--transport" && has_value) {
+            g_options.transport = argv[++i];
+        } else if (arg == "--iterations" && has_value) {
+            g_options.iterations = std::max<uint64_t>(std::strtoull(argv[++i], nullptr, 10), 100);
+        } else if (arg == "--max-subscribers" && has_value) {
+            g_options.max_subscribers = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--filter" && has_value) {
+            g_options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            g_options.json_file = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return g_options.transport == "loopback" || g_options.transport == "tims";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!parse_options(argc, argv)) {
+        std::cerr << "Usage: " << argv[0] << " [--transport loopback|tims] [--iterations N]\n"
+                  << "       [--max-subscribers N] [--filter SUBSTRING] [--json FILE]\n";
+        return 1;
+    }
+
+    TimsWrapper::set_transport(g_options.transport == "tims" ? TimsTransport::Router : TimsTransport::Loopback);
+
+    std::cout << "=== CommRaT Transport Benchmark ===\n"
+              << "Transport: " << g_options.transport
+              << ", iterations: " << g_options.iterations << "\n\n";
+    g_table.print_header();
+
+    bench_paths();
+
+    bench_serialization<16>();
+    bench_serialization<64>();
+    bench_serialization<256>();
+    bench_serialization<1024>();
+    bench_serialization<4096>();
+
+    for (uint32_t subscribers = 1; subscribers <= g_options.max_subscribers; subscribers *= 2) {
+        bench_fanout(subscribers);
+    }
+
+    if (!g_options.json_file.empty()) {
+        if (!g_table.write_json(g_options.json_file, g_options.transport)) {
+            std::cerr << "Failed to write " << g_options.json_file << "\n";
+            return 1;
+        }
+        std::cout << "\nResults written to " << g_options.json_file << "\n";
+    }
+    return 0;
+}
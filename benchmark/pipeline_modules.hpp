@@ -0,0 +1,196 @@
+/**
+ * @file pipeline_modules.hpp
+ * @brief Synthetic load modules for end-to-end pipeline benchmarks
+ *
+ * - LoadGenerator<App, T>: LoopInput source emitting T at a configurable
+ *   rate with jitter and bursts (LoadProfile)
+ * - Passthrough<App, T>: Input<T> -> Output<T> copy stage
+ * - LatencySink<App, T>: terminal stage recording end-to-end latency
+ * - FanInSink<App, Primary, Secondaries...>: multi-input terminal stage
+ *
+ * End-to-end latency is measured from LoadPayload::origin_ns (set when the
+ * generator releases a message) to the sink's process() call. Header
+ * timestamps are not used: LoopInput takes them before process(), i.e.
+ * before the generator waits for its next tick.
+ *
+ * Generators only emit numbered messages while armed. Unarmed they send a
+ * seq 0 message every 1ms (keeps secondary histories warm), which all
+ * stages forward and the sinks ignore.
+ */
+
+#pragma once
+
+#include "commrat/commrat.hpp"
+#include "commrat/module/metrics/module_metrics.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+
+namespace commrat::bench {
+
+/**
+ * @brief Payload of N bytes carrying sequence number and release time
+ * @tparam Stream Distinguishes otherwise identical streams (fan-in inputs)
+ */
+template<std::size_t N, std::size_t Stream = 0>
+struct LoadPayload {
+    static_assert(N >= 16, "LoadPayload needs room for seq and origin_ns");
+    uint64_t seq{0};          ///< 1, 2, ... while armed; 0 = warm-up / idle
+    uint64_t origin_ns{0};    ///< Time::now() when the generator released it
+    std::array<uint8_t, N - 16> data{};
+};
+
+/**
+ * @brief Emission pattern of a LoadGenerator
+ *
+ * Messages are released in bursts of `burst` back-to-back messages, one
+ * burst every burst / rate_hz seconds, so the average rate is rate_hz.
+ * Each burst is shifted by a uniform random offset in [-jitter, +jitter].
+ */
+struct LoadProfile {
+    double rate_hz{1000.0};
+    uint64_t jitter_ns{0};
+    uint32_t burst{1};
+};
+
+template<typename App, typename T>
+class LoadGenerator : public App::template Module<Output<T>, LoopInput> {
+    using Base = typename App::template Module<Output<T>, LoopInput>;
+
+public:
+    LoadGenerator(const ModuleConfig& config, const LoadProfile& profile)
+        : Base(config)
+        , profile_(profile)
+        , tick_ns_(static_cast<uint64_t>(1e9 * profile.burst / profile.rate_hz))
+        , rng_(config.system_id()) {}
+
+    void arm() { armed_.store(true, std::memory_order_release); }
+    void disarm() { armed_.store(false, std::memory_order_release); }
+
+    /// Numbered messages released since the first arm()
+    uint64_t emitted() const { return emitted_.load(std::memory_order_acquire); }
+
+protected:
+    void process(T& output) override {
+        if (!armed_.load(std::memory_order_acquire)) {
+            was_armed_ = false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            output.origin_ns = Time::now();
+            return;  // seq 0
+        }
+        if (!was_armed_) {
+            was_armed_ = true;
+            next_tick_ = Time::now();
+            burst_left_ = 0;
+        }
+        if (burst_left_ == 0) {
+            next_tick_ += tick_ns_;
+            const int64_t jitter = profile_.jitter_ns == 0 ? 0 :
+                std::uniform_int_distribution<int64_t>(-static_cast<int64_t>(profile_.jitter_ns),
+                                                       static_cast<int64_t>(profile_.jitter_ns))(rng_);
+            const int64_t wait = static_cast<int64_t>(next_tick_) + jitter - static_cast<int64_t>(Time::now());
+            if (wait > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(wait));
+            }
+            burst_left_ = profile_.burst;
+        }
+        --burst_left_;
+        output.seq = emitted_.load(std::memory_order_relaxed) + 1;
+        output.origin_ns = Time::now();
+        emitted_.store(output.seq, std::memory_order_release);
+    }
+
+private:
+    LoadProfile profile_;
+    uint64_t tick_ns_;
+    std::mt19937_64 rng_;
+    std::atomic<bool> armed_{false};
+    std::atomic<uint64_t> emitted_{0};
+    // Data thread only
+    bool was_armed_{false};
+    uint64_t next_tick_{0};
+    uint32_t burst_left_{0};
+};
+
+template<typename App, typename T>
+class Passthrough : public App::template Module<Output<T>, Input<T>> {
+    using Base = typename App::template Module<Output<T>, Input<T>>;
+
+public:
+    using Base::Base;
+
+protected:
+    void process(const T& input, T& output) override {
+        output = input;
+    }
+};
+
+/**
+ * @brief Delivery counter and latency histogram shared by the sinks
+ *
+ * Written by the sink's data thread only; read after the generators are
+ * disarmed and the pipeline drained.
+ */
+class DeliveryRecorder {
+public:
+    void record(uint64_t seq, uint64_t origin_ns) {
+        if (seq == 0) {
+            return;
+        }
+        latency_.record(Time::now() - origin_ns);
+        delivered_.store(delivered_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    uint64_t delivered() const { return delivered_.load(std::memory_order_acquire); }
+    const LatencyHistogram& latency() const { return latency_; }
+
+private:
+    LatencyHistogram latency_;
+    std::atomic<uint64_t> delivered_{0};
+};
+
+template<typename App, typename T>
+class LatencySink : public App::template Module<Output<T>, Input<T>> {
+    using Base = typename App::template Module<Output<T>, Input<T>>;
+
+public:
+    using Base::Base;
+
+    const DeliveryRecorder& recorder() const { return recorder_; }
+
+protected:
+    void process(const T& input, T& output) override {
+        recorder_.record(input.seq, input.origin_ns);
+        output = input;  // No subscribers, not sent
+    }
+
+private:
+    DeliveryRecorder recorder_;
+};
+
+/**
+ * @brief Multi-input sink; latency and delivery follow the primary input
+ */
+template<typename App, typename Primary, typename... Secondaries>
+class FanInSink : public App::template Module<Output<Primary>, Inputs<Primary, Secondaries...>> {
+    using Base = typename App::template Module<Output<Primary>, Inputs<Primary, Secondaries...>>;
+
+public:
+    using Base::Base;
+
+    const DeliveryRecorder& recorder() const { return recorder_; }
+
+protected:
+    void process(const Primary& primary, const Secondaries&..., Primary& output) override {
+        recorder_.record(primary.seq, primary.origin_ns);
+        output = primary;
+    }
+
+private:
+    DeliveryRecorder recorder_;
+};
+
+} // namespace commrat::bench
@@ -0,0 +1,29 @@
+#!/bin/bash
+# Compiler launcher for bench_registry_compile_<N>
+# Usage: time_compile.sh <label> <compiler command...>
+# Runs the compile command and prints its wall time and peak memory
+
+label="$1"
+shift
+
+# Link steps go through the same launcher; only report compiling
+if [[ " $* " != *" -c "* ]]; then
+    exec "$@"
+fi
+
+if [ -x /usr/bin/time ]; then
+    report=$(mktemp)
+    /usr/bin/time -f "%e %M" -o "$report" "$@"
+    exit_code=$?
+    read -r seconds peak_kb < "$report"
+    rm -f "$report"
+    printf "registry %4s types: %7.2f s, %6d MiB peak\n" "$label" "$seconds" "$((peak_kb / 1024))"
+else
+    start=$(date +%s.%N)
+    "$@"
+    exit_code=$?
+    end=$(date +%s.%N)
+    printf "registry %4s types: %7.2f s (install GNU time for peak memory)\n" "$label" "$(echo "$end - $start" | bc)"
+fi
+
+exit $exit_code
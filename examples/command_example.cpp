@@ -1,12 +1,20 @@
 /**
  * @file command_example.cpp
  * @brief Demonstrates variadic command handling in modules
+ * 
+ * Also shows request/reply commands: GetStatusCmd is paired with a
+ * SensorStatus reply, the module returns it from on_command() and the
+ * RequestClient receives it through a future.
+ * 
+ * SetpointCmd is registered as latest-wins (Coalesce::Latest): a burst of
+ * setpoints faster than the handler only delivers the newest one.
  */
 
 #include "messages/messages.hpp"
 #include <iostream>
 #include <thread>
 #include <cmath>
+#include <array>
 
 using namespace user_app;
 
@@ -26,14 +34,35 @@ struct SetModeCmd {
     uint32_t mode{0};
 };
 
+// Setpoint-style command: only the newest pending one matters
+struct SetpointCmd {
+    float target{0.0f};
+};
+
+// Request/reply: GetStatusCmd is answered with SensorStatus
+struct GetStatusCmd {
+    uint32_t request_token{0};
+};
+
+struct SensorStatus {
+    uint32_t request_token{0};
+    uint32_t mode{0};
+    float calibration_offset{0.0f};
+};
+
 // Add commands to registry (in real code, this goes in user_messages.hpp)
 namespace user_app {
+    using GetStatusReq = commrat::Message::Command<GetStatusCmd>;
+    
     // Extended CommRaT application with commands
     using ExtendedApp = commrat::CommRaT<
         commrat::Message::Data<TemperatureData>,
         commrat::Message::Command<ResetCmd>,
         commrat::Message::Command<CalibrateCmd>,
-        commrat::Message::Command<SetModeCmd>
+        commrat::Message::Command<SetModeCmd>,
+        commrat::Message::Command<SetpointCmd, commrat::Coalesce::Latest>,
+        GetStatusReq,
+        commrat::Message::Reply<GetStatusReq, SensorStatus>
     >;
 }
 
@@ -50,10 +79,10 @@ namespace user_app {
  * The module automatically dispatches commands to the correct on_command() handler.
  */
 class CommandableSensor : public ExtendedApp::Module<Output<TemperatureData>, PeriodicInput, 
-                                                       ResetCmd, CalibrateCmd, SetModeCmd> {
+                                                       ResetCmd, CalibrateCmd, SetModeCmd, SetpointCmd, GetStatusCmd> {
 public:
     explicit CommandableSensor(const ModuleConfig& config) 
-        : ExtendedApp::Module<Output<TemperatureData>, PeriodicInput, ResetCmd, CalibrateCmd, SetModeCmd>(config) {}
+        : ExtendedApp::Module<Output<TemperatureData>, PeriodicInput, ResetCmd, CalibrateCmd, SetModeCmd, SetpointCmd, GetStatusCmd>(config) {}
     
 protected:
     void process(TemperatureData& output) override {
@@ -71,7 +100,7 @@ protected:
     
     // Command handlers - framework calls the right one automatically!
     
-    void on_command(const ResetCmd& cmd) {
+    void on_command(const ResetCmd& cmd) override {
         std::cout << "[Sensor] Reset command received (hard=" 
                   << cmd.hard_reset << ")\n";
         
@@ -82,19 +111,36 @@ protected:
         }
     }
     
-    void on_command(const CalibrateCmd& cmd) {
+    void on_command(const CalibrateCmd& cmd) override {
         std::cout << "[Sensor] Calibrate command received (offset=" 
                   << cmd.offset << ")\n";
         
         calibration_offset_ = cmd.offset;
     }
     
-    void on_command(const SetModeCmd& cmd) {
+    void on_command(const SetModeCmd& cmd) override {
         std::cout << "[Sensor] SetMode command received (mode=" 
                   << cmd.mode << ")\n";
         
         mode_ = cmd.mode;
     }
+    
+    // Latest-wins handler - slow on purpose, stale setpoints are dropped
+    void on_command(const SetpointCmd& cmd) override {
+        std::cout << "[Sensor] Setpoint command received (target=" 
+                  << cmd.target << ")\n";
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    
+    // Request handler - return value is sent back to the requester
+    SensorStatus on_command(const GetStatusCmd& cmd) override {
+        return SensorStatus{
+            .request_token = cmd.request_token,
+            .mode = mode_,
+            .calibration_offset = calibration_offset_
+        };
+    }
 
 private:
     float calibration_offset_ = 0.0f;
@@ -141,7 +187,8 @@ int main() {
         commrat::MessageDefinition<TemperatureData, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Data, 65535>,
         commrat::MessageDefinition<ResetCmd, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Commands, 65535>,
         commrat::MessageDefinition<CalibrateCmd, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Commands, 65535>,
-        commrat::MessageDefinition<SetModeCmd, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Commands, 65535>
+        commrat::MessageDefinition<SetModeCmd, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Commands, 65535>,
+        commrat::MessageDefinition<SetpointCmd, commrat::MessagePrefix::UserDefined, commrat::UserSubPrefix::Commands, 65535>
     >;
     commrat::RegistryMailbox<AppRegistry> control(control_config);
     control.start();
@@ -168,6 +215,44 @@ int main() {
     control.send(set_mode, sensor_cmd_mailbox);
     std::this_thread::sleep_for(std::chrono::seconds(1));
     
+    // Latest-wins: burst of setpoints, handler only sees the newest ones
+    std::cout << "\n>>> Sending 20x Setpoint burst (latest-wins)\n";
+    for (int i = 1; i <= 20; ++i) {
+        SetpointCmd setpoint{.target = static_cast<float>(i)};
+        control.send(setpoint, sensor_cmd_mailbox);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::cout << "[Sensor] Dropped stale setpoints: " 
+              << sensor.dropped_commands<SetpointCmd>() << "\n";
+    
+    // Request/reply: pipeline several status requests, then collect replies
+    std::cout << "\n>>> Sending 3x GetStatus (pipelined request/reply)\n";
+    ExtendedApp::RequestClient<> client(commrat::MailboxConfig{
+        .mailbox_id = 201,
+        .message_slots = 10,
+        .max_message_size = ExtendedApp::max_message_size,
+        .send_priority = 10,
+        .realtime = false,
+        .mailbox_name = "RequestClient"
+    });
+    client.start();
+    
+    std::array<ExtendedApp::RequestClient<>::ReplyFuture<GetStatusCmd>, 3> replies;
+    for (uint32_t i = 0; i < replies.size(); ++i) {
+        replies[i] = client.send_request(GetStatusCmd{.request_token = i}, sensor_cmd_mailbox,
+                                         std::chrono::milliseconds(500));
+    }
+    for (auto& future : replies) {
+        auto reply = future.get();
+        if (reply) {
+            std::cout << "[Client] Status reply token=" << reply->request_token
+                      << " mode=" << reply->mode
+                      << " offset=" << reply->calibration_offset << "\n";
+        } else {
+            std::cout << "[Client] Status request failed: " << commrat::to_string(reply.error()) << "\n";
+        }
+    }
+    
     // Send Reset command
     std::cout << "\n>>> Sending Reset(hard=true)\n";
     ResetCmd reset{.hard_reset = true};
@@ -176,6 +261,7 @@ int main() {
     
     // Cleanup
     std::cout << "\n=== Stopping ===\n";
+    client.stop();
     control.stop();
     sensor.stop();
     
@@ -186,6 +272,8 @@ int main() {
     std::cout << "✓ Type-safe command handling at compile-time\n";
     std::cout << "✓ Commands sent as payload types (ResetCmd, CalibrateCmd, etc.)\n";
     std::cout << "✓ No manual command ID checking or casting!\n";
+    std::cout << "✓ Request/reply via Reply<> + RequestClient futures\n";
+    std::cout << "✓ Latest-wins setpoints via Command<T, Coalesce::Latest>\n";
     
     return 0;
 }
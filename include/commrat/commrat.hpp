@@ -24,6 +24,7 @@
 #include "commrat/mailbox/mailbox.hpp"
 #include "commrat/mailbox/registry_mailbox.hpp"
 #include "commrat/mailbox/typed_mailbox.hpp"
+#include "commrat/mailbox/request_client.hpp"
 #include "commrat/registry_module.hpp"
 #include "commrat/introspection/introspection_helper.hpp"
 
@@ -223,6 +224,35 @@ public:
     template<std::size_t HistorySize>
     using HistoricalMailbox = commrat::HistoricalMailbox<Registry, HistorySize>;
     
+    /**
+     * @brief RequestClient template - pipelined request/reply to module commands
+     * 
+     * Sends commands that have a registered Reply<> and returns a std::future
+     * for each reply. Requests are paired with replies by correlation ID, so
+     * many requests can be in flight at once, each with its own timeout.
+     * 
+     * @tparam MaxInFlight Maximum number of outstanding requests
+     * 
+     * **Usage:**
+     * @code
+     * using GetGainReq = Message::Command<GetGainCmd>;
+     * using MyApp = CommRaT<..., GetGainReq, Message::Reply<GetGainReq, GainStatus>>;
+     * 
+     * // Module side: return the reply from on_command
+     * GainStatus on_command(const GetGainCmd& cmd) override { return {.gain = gain_}; }
+     * 
+     * // Client side
+     * MyApp::RequestClient<> client(MailboxConfig{.mailbox_id = 200});
+     * client.start();
+     * auto future = client.send_request(GetGainCmd{}, sensor_cmd_mailbox, Milliseconds(100));
+     * auto reply = future.get();  // MailboxResult<GainStatus>
+     * @endcode
+     * 
+     * @see RequestClient for details
+     */
+    template<std::size_t MaxInFlight = 64>
+    using RequestClient = commrat::RequestClient<Registry, MaxInFlight>;
+    
     /**
      * @brief Introspection helper - export message schemas to any format
      * 
@@ -0,0 +1,328 @@
+/**
+ * @file decode_plan.hpp
+ * @brief Flat wire layout of a message type for decoding without its C++ type
+ *
+ * DecodePlan lists every leaf field of TimsMessage<T> (same flattening as
+ * columnar_layout<T>(): dotted names, std::array extents, fixed_vector and
+ * fixed_string lists) with its position in the serialized bytes. It is
+ * part of MessageSchema, so IntrospectionHelper::export_all() carries it
+ * and SchemaDecoder can decode any exported type at runtime.
+ *
+ * Positions are measured on SeRTial's own output rather than assumed: each
+ * leaf of a default message is changed and serialized, and the first byte
+ * that differs is the leaf's position. Lists are probed with one and two
+ * elements to find the length field, the element stride and whether the
+ * encoding is variable (the wire grows with the length). Fields behind a
+ * variable list are positioned relative to the end of that list's data.
+ * Plans are built once per type, at schema export.
+ */
+
+#pragma once
+
+#include "commrat/messages.hpp"
+#include "commrat/recording/columnar_export.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace commrat {
+
+/**
+ * @brief Leaf field on the wire
+ *
+ * Value i of a row is `size` bytes at `start + offset + i * stride`, where
+ * start is the message start, the end of list `anchor`'s data, or the list
+ * element if `list` >= 0.
+ */
+struct DecodeField {
+    std::string name;           ///< Dotted path relative to the payload (header: timestamp, seq_number)
+    std::string dtype;          ///< NumPy type string ("<f8", "<u4", "|b1", ...)
+    uint32_t size{0};           ///< Bytes per value
+    uint32_t count{1};          ///< Values per row or list element (std::array extent)
+    uint32_t stride{0};         ///< Wire bytes between those values
+    int32_t list{-1};           ///< Index into DecodePlan::lists, -1 = not in a list
+    int32_t anchor{-1};         ///< Variable list the offset follows, -1 = message start
+    uint32_t offset{0};
+};
+
+/**
+ * @brief fixed_vector / fixed_string on the wire
+ */
+struct DecodeList {
+    std::string name;
+    bool string{false};         ///< Elements are characters
+    bool counted{true};         ///< Length field present; otherwise NUL-terminated within capacity
+    bool variable{false};       ///< Only `length` elements are on the wire
+    int32_t anchor{-1};         ///< Variable list the offsets follow, -1 = message start
+    uint32_t count_offset{0};   ///< Little-endian length field
+    uint32_t count_size{0};
+    uint32_t data_offset{0};    ///< First element
+    uint32_t element_size{0};   ///< Wire bytes per element
+    uint32_t capacity{0};
+};
+
+/**
+ * @brief Wire layout of one message type
+ *
+ * Lists are ordered by position, so each anchor precedes its users.
+ */
+struct DecodePlan {
+    uint32_t min_size{0};                ///< Wire size with all lists empty
+    std::vector<DecodeField> fields;
+    std::vector<DecodeList> lists;
+    std::vector<std::string> skipped;    ///< Fields not decodable (see ColumnarLayout::skipped)
+};
+
+namespace decode_plan_detail {
+
+template<typename Msg>
+std::vector<std::byte> wire_of(const Msg& msg) {
+    auto result = sertial::Message<Msg>::serialize(msg);
+    auto view = result.view();
+    return std::vector<std::byte>(view.begin(), view.end());
+}
+
+inline std::optional<std::size_t> first_difference(const std::vector<std::byte>& a, const std::vector<std::byte>& b) {
+    const std::size_t n = std::min(a.size(), b.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    if (a.size() != b.size()) {
+        return n;
+    }
+    return std::nullopt;
+}
+
+/// Change every byte of a value (bools stay valid)
+inline void perturb(std::byte* value, const ColumnSpec& column) {
+    if (std::strcmp(column.dtype, "|b1") == 0) {
+        *value = *value == std::byte{0} ? std::byte{1} : std::byte{0};
+        return;
+    }
+    for (uint32_t i = 0; i < column.size; ++i) {
+        value[i] = ~value[i];
+    }
+}
+
+/// Wire position of value `index` of a column, in a message prepared by `prepare`
+template<typename Msg, typename Prepare>
+std::optional<std::size_t> probe(const ColumnarLayout& layout, const ColumnSpec& column, uint32_t element,
+                                 uint32_t index, Prepare&& prepare) {
+    Msg reference{};
+    prepare(reference);
+    Msg changed = reference;
+    auto* row = reinterpret_cast<std::byte*>(&changed);
+    std::byte* base = row;
+    if (column.list >= 0) {
+        const ListSpec& list = layout.lists[column.list];
+        base = const_cast<std::byte*>(list.elements(row + list.offset)) + element * list.element_size;
+    }
+    perturb(base + column.offset + index * column.stride, column);
+    return first_difference(wire_of(reference), wire_of(changed));
+}
+
+} // namespace decode_plan_detail
+
+/**
+ * @brief Build the wire layout of TimsMessage<PayloadT> by probing its serializer
+ */
+template<typename PayloadT>
+DecodePlan make_decode_plan() {
+    using Msg = TimsMessage<PayloadT>;
+    using namespace decode_plan_detail;
+
+    const ColumnarLayout& layout = columnar_layout<PayloadT>();
+    DecodePlan plan;
+    plan.skipped = layout.skipped;
+    const auto empty = wire_of(Msg{});
+    plan.min_size = static_cast<uint32_t>(empty.size());
+
+    auto with_length = [&](std::size_t list, std::size_t length) {
+        return [&layout, list, length](Msg& msg) {
+            layout.lists[list].resize(reinterpret_cast<std::byte*>(&msg) + layout.lists[list].offset, length);
+        };
+    };
+    auto unchanged = [](Msg&) {};
+
+    // Absolute positions with all lists empty; anchors are resolved below
+    struct Probed {
+        DecodeField field;
+        std::size_t position;
+    };
+    std::vector<Probed> fields;
+    std::vector<DecodeList> lists;
+    std::vector<std::size_t> list_index(layout.lists.size(), SIZE_MAX);   // layout list -> lists
+
+    for (std::size_t l = 0; l < layout.lists.size(); ++l) {
+        const ListSpec& spec = layout.lists[l];
+        if (spec.capacity < 2) {
+            plan.skipped.push_back(spec.name);
+            continue;
+        }
+        DecodeList list{.name = spec.name, .string = spec.string, .capacity = spec.capacity};
+        Msg one{};
+        with_length(l, 1)(one);
+        Msg two{};
+        with_length(l, 2)(two);
+        const auto w1 = wire_of(one);
+        const auto w2 = wire_of(two);
+        list.variable = w1.size() != empty.size();
+
+        std::vector<Probed> leaves;
+        std::optional<std::size_t> data;
+        std::size_t stride = 0;
+        bool ok = true;
+        for (const ColumnSpec& column : layout.columns) {
+            if (column.list != static_cast<int32_t>(l)) {
+                continue;
+            }
+            auto first = probe<Msg>(layout, column, 0, 0, with_length(l, 1));
+            auto second = probe<Msg>(layout, column, 1, 0, with_length(l, 2));
+            std::optional<std::size_t> next;
+            if (column.count > 1) {
+                next = probe<Msg>(layout, column, 0, 1, with_length(l, 1));
+            }
+            if (!first || !second || *second <= *first || (column.count > 1 && (!next || *next <= *first))) {
+                ok = false;
+                break;
+            }
+            if (!data || *first < *data) {
+                data = *first;
+                stride = *second - *first;
+            }
+            leaves.push_back(Probed{DecodeField{
+                .name = column.name, .dtype = column.dtype, .size = column.size, .count = column.count,
+                .stride = column.count > 1 ? static_cast<uint32_t>(*next - *first) : 0
+            }, *first});
+        }
+
+        // Length field: the first byte that differs between one and two elements
+        const auto count = first_difference(w1, w2);
+        list.counted = count && w1[*count] == std::byte{1} && w2[*count] == std::byte{2};
+        if (!ok || !data || (!list.counted && (!list.string || list.variable))) {
+            plan.skipped.push_back(spec.name);
+            continue;
+        }
+        list.data_offset = static_cast<uint32_t>(*data);
+        list.element_size = static_cast<uint32_t>(stride);
+        if (list.counted) {
+            // Up to the next known position, at most 8 bytes, rounded down to a power of two
+            std::size_t boundary = w1.size();
+            auto limit = [&](std::size_t position) {
+                if (position > *count) {
+                    boundary = std::min(boundary, position);
+                }
+            };
+            limit(*data);
+            for (const ColumnSpec& column : layout.columns) {
+                if (column.list < 0) {
+                    if (auto p = probe<Msg>(layout, column, 0, 0, unchanged)) {
+                        limit(*p);
+                    }
+                }
+            }
+            std::size_t width = std::min<std::size_t>(8, boundary - *count);
+            while (width & (width - 1)) {
+                width &= width - 1;
+            }
+            list.count_offset = static_cast<uint32_t>(*count);
+            list.count_size = static_cast<uint32_t>(width);
+        }
+        for (auto& leaf : leaves) {
+            leaf.field.offset = static_cast<uint32_t>(leaf.position - *data);
+        }
+        list_index[l] = lists.size();
+        lists.push_back(list);
+        for (auto& leaf : leaves) {
+            leaf.field.list = static_cast<int32_t>(list_index[l]);
+            fields.push_back(leaf);
+        }
+    }
+
+    for (const ColumnSpec& column : layout.columns) {
+        if (column.list >= 0) {
+            continue;
+        }
+        auto first = probe<Msg>(layout, column, 0, 0, unchanged);
+        std::optional<std::size_t> next;
+        if (column.count > 1) {
+            next = probe<Msg>(layout, column, 0, 1, unchanged);
+        }
+        if (!first || (column.count > 1 && (!next || *next <= *first))) {
+            plan.skipped.push_back(column.name);
+            continue;
+        }
+        fields.push_back(Probed{DecodeField{
+            .name = column.name, .dtype = column.dtype, .size = column.size, .count = column.count,
+            .stride = column.count > 1 ? static_cast<uint32_t>(*next - *first) : 0
+        }, *first});
+    }
+
+    // Order lists by position and make every position relative to the closest
+    // preceding variable list (its end equals its data offset while empty)
+    std::vector<std::size_t> order(lists.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return lists[a].data_offset < lists[b].data_offset;
+    });
+    std::vector<int32_t> renumber(lists.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        renumber[order[i]] = static_cast<int32_t>(i);
+    }
+    auto anchor_of = [&](std::size_t position, int32_t self) {
+        int32_t anchor = -1;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const DecodeList& list = lists[order[i]];
+            if (static_cast<int32_t>(i) != self && list.variable && list.data_offset <= position) {
+                anchor = static_cast<int32_t>(i);
+            }
+        }
+        return anchor;
+    };
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        DecodeList list = lists[order[i]];
+        list.anchor = anchor_of(list.counted ? list.count_offset : list.data_offset, static_cast<int32_t>(i));
+        if (list.anchor >= 0) {
+            const uint32_t start = lists[order[list.anchor]].data_offset;
+            list.count_offset -= list.counted ? start : 0;
+            list.data_offset -= start;
+        }
+        plan.lists.push_back(list);
+    }
+    for (auto& probed : fields) {
+        DecodeField field = probed.field;
+        if (field.list >= 0) {
+            field.list = renumber[field.list];
+        } else {
+            field.anchor = anchor_of(probed.position, -1);
+            field.offset = static_cast<uint32_t>(probed.position);
+            if (field.anchor >= 0) {
+                field.offset -= lists[order[field.anchor]].data_offset;
+            }
+        }
+        plan.fields.push_back(field);
+    }
+    // Declaration order for the fields (lists were probed first)
+    std::stable_sort(plan.fields.begin(), plan.fields.end(), [&](const DecodeField& a, const DecodeField& b) {
+        auto rank = [&](const DecodeField& f) {
+            for (std::size_t c = 0; c < layout.columns.size(); ++c) {
+                if (layout.columns[c].name == f.name) {
+                    return c;
+                }
+            }
+            return layout.columns.size();
+        };
+        return rank(a) < rank(b);
+    });
+    return plan;
+}
+
+} // namespace commrat
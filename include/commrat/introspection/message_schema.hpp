@@ -5,6 +5,7 @@
  * Provides MessageSchema<T, Registry> that includes:
  * - CommRaT compile-time metadata (message IDs, type names, size bounds)
  * - SeRTial structural layout (fields, types, offsets, sizes)
+ * - Flat wire layout of every leaf field (DecodePlan, used by SchemaDecoder)
  * 
  * This structure is rfl-reflectable and can be exported to JSON/YAML/TOML/etc.
  * for use in logger, viewer, and debugging tools.
@@ -16,6 +17,7 @@
 #pragma once
 
 #include "commrat/messages.hpp"
+#include "commrat/introspection/decode_plan.hpp"
 #include <sertial/core/layout/struct_layout.hpp>
 #include <rfl.hpp>
 #include <string_view>
@@ -68,6 +70,7 @@ struct MessageSchema {
     
     CommRaTMetadata commrat;
     sertial::StructLayout<TimsMessage<PayloadT>> layout;
+    DecodePlan decode = make_decode_plan<PayloadT>();
 };
 
 } // namespace commrat
@@ -0,0 +1,457 @@
+/**
+ * @file schema_decoder.hpp
+ * @brief Decode messages of any exported type at runtime, without the registry
+ *
+ * SchemaDecoder loads the JSON written by IntrospectionHelper::export_all()
+ * (or a recording's embedded schema) and decodes raw wire bytes - from
+ * Mailbox::receive_any_raw(), a LogSegmentReader record or a socket - into
+ * a DecodedMessage: one FieldValue per leaf field pointing into the wire
+ * bytes. Tools link against nothing but this header and rfl.
+ *
+ * Each type's DecodePlan is compiled once into a flat table of offsets and
+ * value kinds; decoding a message is a header lookup plus one bounds check
+ * per field, with no allocation once the DecodedMessage has grown to the
+ * largest type. append_json() / append_csv() format straight into a
+ * caller-owned string with std::to_chars.
+ */
+
+#pragma once
+
+#include "commrat/introspection/decode_plan.hpp"
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace commrat {
+
+/**
+ * @brief Value kind of a decoded field
+ */
+enum class FieldKind : uint8_t {
+    Bool,
+    Int,        ///< Signed integer (1, 2, 4 or 8 bytes)
+    UInt,       ///< Unsigned integer
+    Float,      ///< 4 or 8 bytes
+    String      ///< Characters of a fixed_string
+};
+
+/**
+ * @brief One decoded leaf field: a view into the wire bytes
+ *
+ * Lists and arrays hold `count` values; value i is at
+ * `data + (i / per_element) * element_stride + (i % per_element) * stride`.
+ */
+struct FieldValue {
+    const DecodeField* field{nullptr};
+    FieldKind kind{FieldKind::UInt};
+    const std::byte* data{nullptr};
+    uint32_t count{0};
+    uint32_t per_element{1};
+    uint32_t stride{0};
+    uint32_t element_stride{0};
+    bool array{false};          ///< std::array or list field (JSON array / quoted CSV cell)
+
+    std::string_view name() const { return field->name; }
+
+    const std::byte* at(uint32_t i) const {
+        return data + (i / per_element) * element_stride + (i % per_element) * stride;
+    }
+
+    uint64_t as_uint(uint32_t i = 0) const {
+        uint64_t value = 0;
+        std::memcpy(&value, at(i), field->size);   // Little-endian hosts
+        return value;
+    }
+
+    int64_t as_int(uint32_t i = 0) const {
+        const uint64_t raw = as_uint(i);
+        const unsigned shift = 64 - 8 * field->size;
+        return static_cast<int64_t>(raw << shift) >> shift;
+    }
+
+    double as_double(uint32_t i = 0) const {
+        switch (kind) {
+            case FieldKind::Float:
+                if (field->size == 4) {
+                    float value;
+                    std::memcpy(&value, at(i), 4);
+                    return value;
+                } else {
+                    double value;
+                    std::memcpy(&value, at(i), 8);
+                    return value;
+                }
+            case FieldKind::Int:
+                return static_cast<double>(as_int(i));
+            default:
+                return static_cast<double>(as_uint(i));
+        }
+    }
+
+    /// Characters of a fixed_string field
+    std::string_view text() const {
+        return {reinterpret_cast<const char*>(data), count};
+    }
+};
+
+/**
+ * @brief A decoded message; reuse one instance to avoid allocations
+ */
+struct DecodedMessage {
+    uint32_t message_id{0};
+    const std::string* type{nullptr};      ///< Payload type name from the schema
+    std::vector<FieldValue> fields;        ///< Declaration order, header fields first
+
+    const FieldValue* find(std::string_view name) const {
+        for (const auto& field : fields) {
+            if (field.name() == name) {
+                return &field;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief Runtime decoder built from exported schemas
+ *
+ * @code
+ * SchemaDecoder decoder(reader.schema());          // or a schemas.json file's content
+ * DecodedMessage msg;
+ * std::string line;
+ * while (auto record = reader.next()) {
+ *     if (decoder.decode(record->wire, msg)) {
+ *         line.clear();
+ *         SchemaDecoder::append_json(msg, line);
+ *         std::puts(line.c_str());
+ *     }
+ * }
+ * @endcode
+ */
+class SchemaDecoder {
+public:
+    SchemaDecoder() = default;
+
+    /**
+     * @brief Load the output of IntrospectionHelper::export_all()
+     * @throws std::runtime_error if the JSON cannot be parsed
+     */
+    explicit SchemaDecoder(const std::string& schema_json) {
+        for (auto& entry : rfl::json::read<std::vector<SchemaEntry>>(schema_json).value()) {
+            add(entry.commrat.message_id, std::move(entry.commrat.payload_type), std::move(entry.decode));
+        }
+    }
+
+    /**
+     * @brief Add or replace the plan of one message type
+     * @throws std::invalid_argument if the plan is inconsistent
+     */
+    void add(uint32_t message_id, std::string type, DecodePlan plan) {
+        validate(type, plan);
+        Compiled compiled{.type = std::move(type), .plan = std::move(plan), .kinds = {}};
+        for (const auto& field : compiled.plan.fields) {
+            const bool text = field.list >= 0 && static_cast<std::size_t>(field.list) < compiled.plan.lists.size() &&
+                              compiled.plan.lists[field.list].string;
+            compiled.kinds.push_back(text ? FieldKind::String : kind_of(field.dtype));
+        }
+        types_.insert_or_assign(message_id, std::move(compiled));
+    }
+
+    bool knows(uint32_t message_id) const { return types_.contains(message_id); }
+    std::size_t size() const { return types_.size(); }
+
+    /// Type name of a message ID (nullptr if unknown)
+    const std::string* type_name(uint32_t message_id) const {
+        auto it = types_.find(message_id);
+        return it == types_.end() ? nullptr : &it->second.type;
+    }
+
+    /**
+     * @brief Decode wire bytes; the message ID is taken from the header
+     * @return false for unknown types and truncated or malformed buffers
+     */
+    bool decode(std::span<const std::byte> wire, DecodedMessage& out) const {
+        if (wire.size() < sizeof(TimsHeader)) {
+            return false;
+        }
+        uint32_t message_id;
+        std::memcpy(&message_id, wire.data() + offsetof(TimsHeader, msg_type), sizeof(message_id));
+        return decode(message_id, wire, out);
+    }
+
+    bool decode(uint32_t message_id, std::span<const std::byte> wire, DecodedMessage& out) const {
+        auto it = types_.find(message_id);
+        if (it == types_.end()) {
+            return false;
+        }
+        const Compiled& type = it->second;
+        const DecodePlan& plan = type.plan;
+        if (wire.size() < plan.min_size) {
+            return false;
+        }
+
+        // Lists in wire order: length, then end of data for the anchors that follow
+        std::size_t lengths[max_lists];
+        std::size_t data_starts[max_lists];
+        std::size_t ends[max_lists];
+        if (plan.lists.size() > max_lists) {
+            return false;
+        }
+        for (std::size_t l = 0; l < plan.lists.size(); ++l) {
+            const DecodeList& list = plan.lists[l];
+            const std::size_t start = list.anchor >= 0 ? ends[list.anchor] : 0;
+            const std::size_t data = start + list.data_offset;
+            std::size_t length = 0;
+            if (list.counted) {
+                const std::size_t at = start + list.count_offset;
+                if (at + list.count_size > wire.size()) {
+                    return false;
+                }
+                uint64_t value = 0;
+                std::memcpy(&value, wire.data() + at, list.count_size);
+                length = static_cast<std::size_t>(value);
+            } else {
+                const std::size_t available = data < wire.size() ? wire.size() - data : 0;
+                const auto* chars = reinterpret_cast<const char*>(wire.data() + data);
+                length = ::strnlen(chars, std::min<std::size_t>(list.capacity, available));
+            }
+            if (length > list.capacity) {
+                return false;
+            }
+            const std::size_t extent = list.variable ? length : list.capacity;
+            if (data + extent * list.element_size > wire.size()) {
+                return false;
+            }
+            lengths[l] = length;
+            data_starts[l] = data;
+            ends[l] = data + extent * list.element_size;
+        }
+
+        out.message_id = message_id;
+        out.type = &type.type;
+        out.fields.clear();
+        for (std::size_t f = 0; f < plan.fields.size(); ++f) {
+            const DecodeField& field = plan.fields[f];
+            FieldValue value{.field = &field, .kind = type.kinds[f], .per_element = field.count,
+                             .stride = field.stride, .array = field.count > 1};
+            std::size_t position;
+            std::size_t last;   // One past the last byte read
+            if (field.list >= 0) {
+                const DecodeList& list = plan.lists[field.list];
+                const std::size_t length = lengths[field.list];
+                position = data_starts[field.list] + field.offset;
+                value.count = static_cast<uint32_t>(length * field.count);
+                value.element_stride = list.element_size;
+                value.array = !list.string;
+                last = length == 0 ? position
+                                   : position + (length - 1) * list.element_size +
+                                         (field.count - 1) * field.stride + field.size;
+            } else {
+                position = (field.anchor >= 0 ? ends[field.anchor] : 0) + field.offset;
+                value.count = field.count;
+                last = position + (field.count - 1) * field.stride + field.size;
+            }
+            if (last > wire.size()) {
+                return false;
+            }
+            value.data = wire.data() + position;
+            out.fields.push_back(value);
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // Emitters
+    // ========================================================================
+
+    /// One flat JSON object: {"type":..., "message_id":..., "<field>": value | [values] | "text", ...}
+    static void append_json(const DecodedMessage& msg, std::string& out) {
+        out += "{\"type\":\"";
+        append_escaped(out, *msg.type, '\\');
+        out += "\",\"message_id\":";
+        append_number(out, msg.message_id);
+        for (const auto& field : msg.fields) {
+            out += ",\"";
+            out += field.name();
+            out += "\":";
+            if (field.kind == FieldKind::String) {
+                out += '"';
+                append_escaped(out, field.text(), '\\');
+                out += '"';
+                continue;
+            }
+            if (field.array) {
+                out += '[';
+            }
+            for (uint32_t i = 0; i < field.count; ++i) {
+                if (i > 0) {
+                    out += ',';
+                }
+                append_value(out, field, i, "null");
+            }
+            if (field.array) {
+                out += ']';
+            }
+        }
+        out += '}';
+    }
+
+    /// CSV header line (no newline) for a message type
+    void append_csv_header(uint32_t message_id, std::string& out) const {
+        auto it = types_.find(message_id);
+        if (it == types_.end()) {
+            return;
+        }
+        bool first = true;
+        for (const auto& field : it->second.plan.fields) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += field.name;
+        }
+    }
+
+    /// CSV row (no newline); arrays and lists are one quoted cell of space-separated values
+    static void append_csv(const DecodedMessage& msg, std::string& out) {
+        bool first = true;
+        for (const auto& field : msg.fields) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            if (field.kind == FieldKind::String) {
+                out += '"';
+                append_escaped(out, field.text(), '"');
+                out += '"';
+                continue;
+            }
+            if (field.array) {
+                out += '"';
+            }
+            for (uint32_t i = 0; i < field.count; ++i) {
+                if (i > 0) {
+                    out += ' ';
+                }
+                append_value(out, field, i, "nan");
+            }
+            if (field.array) {
+                out += '"';
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t max_lists = 64;
+
+    /// The parts of a MessageSchema entry the decoder needs (others are ignored)
+    struct SchemaEntry {
+        struct Metadata {
+            uint32_t message_id{0};
+            std::string payload_type;
+        };
+        Metadata commrat;
+        DecodePlan decode;
+    };
+
+    struct Compiled {
+        std::string type;
+        DecodePlan plan;
+        std::vector<FieldKind> kinds;
+    };
+
+    static void validate(const std::string& type, const DecodePlan& plan) {
+        auto fail = [&](const std::string& what) {
+            throw std::invalid_argument("[SchemaDecoder] " + type + ": " + what);
+        };
+        const auto lists = static_cast<int32_t>(plan.lists.size());
+        if (plan.lists.size() > max_lists) {
+            fail("too many lists");
+        }
+        for (int32_t l = 0; l < lists; ++l) {
+            const DecodeList& list = plan.lists[l];
+            if (list.anchor >= l || list.count_size > 8 || (list.counted && list.count_size == 0)) {
+                fail("invalid list " + list.name);
+            }
+        }
+        for (const auto& field : plan.fields) {
+            const bool sized = field.size == 1 || field.size == 2 || field.size == 4 || field.size == 8;
+            if (!sized || field.count == 0 || field.list >= lists || field.anchor >= lists) {
+                fail("invalid field " + field.name);
+            }
+        }
+    }
+
+    static FieldKind kind_of(const std::string& dtype) {
+        const char code = dtype.size() >= 2 ? dtype[1] : 'u';
+        switch (code) {
+            case 'b': return FieldKind::Bool;
+            case 'i': return FieldKind::Int;
+            case 'f': return FieldKind::Float;
+            default: return FieldKind::UInt;
+        }
+    }
+
+    template<typename T>
+    static void append_number(std::string& out, T value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    static void append_value(std::string& out, const FieldValue& field, uint32_t i, const char* non_finite) {
+        switch (field.kind) {
+            case FieldKind::Bool:
+                out += field.as_uint(i) ? "true" : "false";
+                break;
+            case FieldKind::Int:
+                append_number(out, field.as_int(i));
+                break;
+            case FieldKind::Float: {
+                const double value = field.as_double(i);
+                if (!std::isfinite(value)) {
+                    out += non_finite;
+                } else if (field.field->size == 4) {
+                    append_number(out, static_cast<float>(value));
+                } else {
+                    append_number(out, value);
+                }
+                break;
+            }
+            default:
+                append_number(out, field.as_uint(i));
+        }
+    }
+
+    /// JSON (escape = '\\') or CSV (escape = '"') string contents
+    static void append_escaped(std::string& out, std::string_view text, char escape) {
+        for (char c : text) {
+            if (c == '"' || (escape == '\\' && c == '\\')) {
+                out += escape;
+                out += c;
+            } else if (escape == '\\' && static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                out += buffer;
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    std::unordered_map<uint32_t, Compiled> types_;
+};
+
+} // namespace commrat
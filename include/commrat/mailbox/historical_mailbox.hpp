@@ -35,8 +35,8 @@ namespace commrat {
  * @tparam HistorySize Maximum messages to buffer per type (default: 100)
  * 
  * Thread Safety:
- * - receive() and getData() can be called concurrently (reader-writer lock)
- * - Multiple getData() calls are lock-free readers
+ * - receive() and getData() can be called concurrently (SharedMutex)
+ * - Multiple getData() calls can run concurrently (shared lock)
  * - receive() is exclusive writer
  * 
  * Usage Pattern:
@@ -148,6 +148,23 @@ public:
         return result;
     }
     
+    /**
+     * @brief Receive a pending message without blocking, store it in history
+     * 
+     * Used when the primary input is polled instead of driving a thread
+     * (CyclicExecutive). Returns MailboxError::Timeout if nothing is pending.
+     */
+    template<typename T>
+    auto try_receive() -> MailboxResult<TimsMessage<T>> {
+        auto result = mailbox_.template try_receive<T>();
+        
+        if (result) {
+            store_in_history(result.value());
+        }
+        
+        return result;
+    }
+    
     // ========================================================================
     // Secondary Input API (Non-Blocking getData)
     // ========================================================================
@@ -198,6 +215,33 @@ public:
         return buffer.getTimestampRange();
     }
     
+    /**
+     * @brief Number of messages currently buffered for type T
+     */
+    template<typename T>
+    std::size_t history_size() const {
+        return get_history_buffer<T>().size();
+    }
+    
+    /**
+     * @brief History buffer capacity (messages per type)
+     */
+    static constexpr std::size_t history_capacity() {
+        return HistorySize;
+    }
+    
+    /**
+     * @brief Add a message to the history without receiving it
+     * 
+     * Used when messages come from somewhere other than the mailbox, e.g.
+     * a recording during offline reprocessing (the mailbox need not be
+     * started).
+     */
+    template<typename T>
+    void store(const TimsMessage<T>& tims_msg) {
+        store_in_history(tims_msg);
+    }
+    
     /**
      * @brief Clear history for type T
      */
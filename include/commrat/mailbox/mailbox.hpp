@@ -5,6 +5,8 @@
 #include "../messaging/message_registry.hpp"
 #include "../messaging/message_id.hpp"
 #include "../platform/threading.hpp"
+#include "../platform/tracing.hpp"
+#include <array>
 #include <expected>
 #include <optional>
 #include <chrono>  // Keep for std::chrono::milliseconds in API
@@ -115,9 +117,15 @@ public:
 // Raw Message Receipt (for unknown message types)
 // ============================================================================
 
-/// Raw received message with type info
+/**
+ * @brief Raw received message with type info
+ * 
+ * Fixed-capacity buffer, so receiving does not allocate. Mailboxes use their
+ * registry's max_message_size as capacity (Mailbox::RawMessage).
+ */
+template<std::size_t Capacity>
 struct RawReceivedMessage {
-    std::vector<std::byte> buffer;  // Message data including header
+    std::array<std::byte, Capacity> buffer;  // Message data including header (first `size` bytes)
     int32_t type;                    // Message type ID
     uint32_t sender_id;              // Sender mailbox ID
     size_t size;                     // Total message size
@@ -129,6 +137,9 @@ struct RawReceivedMessage {
     } header;
     
     RawReceivedMessage() : type(0), sender_id(0), size(0), timestamp(0), header{0} {}
+    
+    /// Received bytes (header + payload)
+    std::span<const std::byte> data() const { return {buffer.data(), size}; }
 };
 // ============================================================================
 // Mailbox Configuration
@@ -179,18 +190,14 @@ private:
     // Internal registry for this mailbox's supported types
     using Registry = MessageRegistry<MessageDefs...>;
     
-    // Helper to check if type is a MessageDefinition
-    template<typename T>
-    struct is_message_definition : std::false_type {};
-    
-    template<typename PayloadT, MessagePrefix Prefix, auto SubPrefix, uint16_t ID>
-    struct is_message_definition<MessageDefinition<PayloadT, Prefix, SubPrefix, ID>> : std::true_type {};
-    
-    // Validate that all types are MessageDefinition
-    static_assert((is_message_definition<MessageDefs>::value && ...),
+    // Validate that all types are MessageDefinition (or Request<>/Reply<>)
+    static_assert((MessageDefinitionType<MessageDefs> && ...),
                   "All template parameters must be MessageDefinition types");
     
 public:
+    /// Result of receive_any_raw(): sized for the largest registered message
+    using RawMessage = RawReceivedMessage<Registry::max_message_size>;
+    
     // ========================================================================
     // Construction and Lifecycle
     // ========================================================================
@@ -323,12 +330,24 @@ public:
             return MailboxError::InvalidDestination;
         }
         
+        // Stamp the sending thread's trace context (explicitly set ids are kept)
+        if constexpr (requires { message.header.trace_id; }) {
+            if (message.header.trace_id == 0) {
+                const TraceContext& trace = Tracer::current();
+                message.header.trace_id = trace.trace_id;
+                message.header.span_id = trace.span_id;
+            }
+        }
+        
         // Registry::serialize expects TimsMessage<PayloadT>& (full message with header)
         [[maybe_unused]] auto result = Registry::serialize(message);
         
         // Send via TiMS
         auto tims_result = tims_.send(message, dest_mailbox);
         
+        if (tims_result == TimsResult::ERROR_QUEUE_FULL) {
+            return MailboxError::QueueFull;  // Receiver overloaded - counted as drop by callers
+        }
         if (tims_result != TimsResult::SUCCESS) {
             std::cerr << "[Mailbox] TiMS send failed with code: " << static_cast<int>(tims_result) << std::endl;
             return MailboxError::NetworkError;
@@ -337,6 +356,41 @@ public:
         return MailboxResult<void>();
     }
     
+    /**
+     * @brief Send already serialized message bytes unchanged
+     * 
+     * For forwarding recorded or received messages: the header (type,
+     * timestamp, sequence number, trace context) is sent as stored.
+     * 
+     * @param wire TimsHeader + serialized payload
+     * @param dest_mailbox Destination mailbox ID
+     * @return Success or error (QueueFull if the receiver has no free slot)
+     */
+    auto send_raw(std::span<const std::byte> wire, uint32_t dest_mailbox) -> MailboxResult<void> {
+        if (!running_) {
+            return MailboxError::NotRunning;
+        }
+        
+        if (dest_mailbox == 0) {
+            return MailboxError::InvalidDestination;
+        }
+        
+        if (wire.size() < sizeof(TimsHeader)) {
+            return MailboxError::InvalidMessage;
+        }
+        
+        auto tims_result = tims_.send_raw_bytes(wire, dest_mailbox);
+        
+        if (tims_result == TimsResult::ERROR_QUEUE_FULL) {
+            return MailboxError::QueueFull;
+        }
+        if (tims_result != TimsResult::SUCCESS) {
+            return MailboxError::NetworkError;
+        }
+        
+        return MailboxResult<void>();
+    }
+    
     // ========================================================================
     // Receive Operations
     // ========================================================================
@@ -442,14 +496,34 @@ public:
      * @return Raw message with type info, or error
      */
     auto receive_any_raw(std::chrono::milliseconds timeout = std::chrono::milliseconds{-1}) 
-        -> MailboxResult<RawReceivedMessage> {
+        -> MailboxResult<RawMessage> {
+        RawMessage raw;
+        auto result = receive_any_raw(raw, timeout);
+        if (!result) {
+            return result.get_error();
+        }
+        return raw;
+    }
+    
+    /**
+     * @brief Receive any message into a caller-owned buffer
+     * 
+     * Same as receive_any_raw(timeout) without copying the message out;
+     * receive loops keep one RawMessage and reuse it.
+     * 
+     * @param raw Receives the message (contents unspecified on error)
+     * @param timeout Maximum time to wait for a message
+     * @return Success or error
+     */
+    auto receive_any_raw(RawMessage& raw,
+                         std::chrono::milliseconds timeout = std::chrono::milliseconds{-1})
+        -> MailboxResult<void> {
         if (!running_) {
             return MailboxError::NotRunning;
         }
         
-        // Receive raw bytes
-        constexpr size_t buffer_size = Registry::max_message_size;
-        std::array<std::byte, buffer_size> buffer;
+        // Receive raw bytes directly into the message buffer
+        auto& buffer = raw.buffer;
         ssize_t bytes = tims_.receive_raw_bytes(buffer, timeout);
         
         if (bytes < 0) {
@@ -471,16 +545,13 @@ public:
         // TODO: Extract sender ID from TIMS (not currently exposed in API)
         uint32_t sender_id = 0;  // Placeholder
         
-        // Copy to vector for easy handling
-        RawReceivedMessage raw;
-        raw.buffer = std::vector<std::byte>(buffer.begin(), buffer.begin() + bytes);
         raw.type = static_cast<int32_t>(header.msg_type);
         raw.sender_id = sender_id;
         raw.size = bytes;
         raw.timestamp = header.timestamp;
         raw.header.msg_type = header.msg_type;
         
-        return raw;
+        return MailboxResult<void>::ok();
     }
     
     /**
@@ -518,28 +589,36 @@ public:
             return MailboxError::NetworkError;
         }
         
-        // Parse header to get message type
-        if (static_cast<size_t>(bytes) < sizeof(TimsHeader)) {
-            return MailboxError::InvalidMessage;
+        return visit_received(std::span<const std::byte>(buffer.data(), bytes),
+                              std::forward<Visitor>(visitor));
+    }
+    
+    /**
+     * @brief Receive any registered message type without blocking
+     * 
+     * Same as receive_any(), but returns MailboxError::Timeout immediately
+     * if no message is pending. Used to drain a mailbox.
+     * 
+     * @param visitor Callable that accepts any registered message type
+     * @return Success, Timeout if the mailbox is empty, or error
+     */
+    template<typename Visitor>
+    auto try_receive_any(Visitor&& visitor) -> MailboxResult<void> {
+        if (!running_) {
+            return MailboxError::NotRunning;
         }
         
-        TimsHeader header;
-        std::memcpy(&header, buffer.data(), sizeof(TimsHeader));
-        MessageType msg_type = static_cast<MessageType>(header.msg_type);
-        
-        // Use registry to dispatch based on runtime type
-        bool success = Registry::visit(msg_type, 
-            std::span<const std::byte>(buffer.data(), bytes),
-            [&visitor](auto&& tims_msg) {
-                // Visitor receives TimsMessage<PayloadType> directly
-                std::forward<Visitor>(visitor)(std::forward<decltype(tims_msg)>(tims_msg));
-            });
+        constexpr size_t buffer_size = Registry::max_message_size;
+        std::array<std::byte, buffer_size> buffer;
+        // -1ms is converted to TIMS_NONBLOCK
+        auto bytes = tims_.receive_raw_bytes(buffer, std::chrono::milliseconds(-1));
         
-        if (!success) {
-            return MailboxError::InvalidMessage;
+        if (bytes <= 0) {
+            return MailboxError::Timeout;
         }
         
-        return MailboxResult<void>();
+        return visit_received(std::span<const std::byte>(buffer.data(), bytes),
+                              std::forward<Visitor>(visitor));
     }
     
     // ========================================================================
@@ -588,6 +667,32 @@ public:
     }
     
 private:
+    // Deserialize a received buffer by its header type and pass it to the visitor
+    template<typename Visitor>
+    auto visit_received(std::span<const std::byte> data, Visitor&& visitor) -> MailboxResult<void> {
+        // Parse header to get message type
+        if (data.size() < sizeof(TimsHeader)) {
+            return MailboxError::InvalidMessage;
+        }
+        
+        TimsHeader header;
+        std::memcpy(&header, data.data(), sizeof(TimsHeader));
+        MessageType msg_type = static_cast<MessageType>(header.msg_type);
+        
+        // Use registry to dispatch based on runtime type
+        bool success = Registry::visit(msg_type, data,
+            [&visitor](auto&& tims_msg) {
+                // Visitor receives TimsMessage<PayloadType> directly
+                std::forward<Visitor>(visitor)(std::forward<decltype(tims_msg)>(tims_msg));
+            });
+        
+        if (!success) {
+            return MailboxError::InvalidMessage;
+        }
+        
+        return MailboxResult<void>();
+    }
+    
     // Convert MailboxConfig to TimsConfig
     static TimsConfig create_tims_config(const MailboxConfig& config) {
         TimsConfig tims_config;
@@ -596,6 +701,7 @@ private:
             ? ("mailbox_" + std::to_string(config.mailbox_id))
             : config.mailbox_name;
         tims_config.max_msg_size = config.max_message_size;
+        tims_config.message_slots = config.message_slots;
         tims_config.priority = config.send_priority;
         tims_config.realtime = config.realtime;
         return tims_config;
@@ -47,6 +47,9 @@ private:
     UnderlyingMailbox mailbox_;
     
 public:
+    /// Raw message buffer for underlying().receive_any_raw()
+    using RawMessage = typename UnderlyingMailbox::RawMessage;
+    
     // ========================================================================
     // Construction and Lifecycle (Same as Mailbox)
     // ========================================================================
@@ -134,18 +137,19 @@ public:
      * @param payload Payload to send
      * @param dest_mailbox Destination mailbox ID
      * @param timestamp Timestamp to set in header (nanoseconds since epoch)
+     * @param seq_number Publisher sequence number (0 = unsequenced)
      * @return Success or error
      */
     template<typename PayloadT>
         requires is_registered<PayloadT>
-    auto send(PayloadT& payload, uint32_t dest_mailbox, uint64_t timestamp) -> MailboxResult<void> {
+    auto send(PayloadT& payload, uint32_t dest_mailbox, uint64_t timestamp, uint32_t seq_number = 0) -> MailboxResult<void> {
         // Create TimsMessage wrapper with explicit timestamp
         TimsMessage<PayloadT> msg{
             .header = {
                 .msg_type = Registry::template get_message_id<PayloadT>(),
                 .msg_size = 0,  // Will be set by serialization
                 .timestamp = timestamp, // USER-PROVIDED timestamp
-                .seq_number = 0, // Will be set by TiMS
+                .seq_number = seq_number,
                 .flags = 0
             },
             .payload = payload
@@ -173,7 +177,11 @@ public:
     template<typename PayloadT>
         requires is_registered<PayloadT>
     auto try_receive() -> MailboxResult<TimsMessage<PayloadT>> {
-        return mailbox_.template try_receive<PayloadT>();
+        auto message = mailbox_.template try_receive<PayloadT>();
+        if (!message) {
+            return MailboxError::Timeout;  // Nothing pending
+        }
+        return std::move(*message);
     }
     
     /**
@@ -211,7 +219,7 @@ public:
                 // Use Registry::visit to deserialize and dispatch
                 bool handled = Registry::visit(
                     static_cast<uint32_t>(result->type),
-                    std::span{result->buffer.data(), result->buffer.size()},
+                    result->data(),
                     [&](auto& tims_msg) {
                         // Registry::visit deserializes to TimsMessage<PayloadT>
                         // Pass it directly to visitor
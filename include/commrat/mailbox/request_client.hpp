@@ -0,0 +1,347 @@
+/**
+ * @file request_client.hpp
+ * @brief Pipelined request/reply client for module commands
+ *
+ * Sends requests to a module's CMD mailbox and returns a std::future for the
+ * reply. Requests and replies are paired by TimsHeader::correlation_id, so any
+ * number of requests (up to MaxInFlight) can be outstanding at once, to one or
+ * many modules, each with its own timeout.
+ *
+ * The reply type is looked up from the registry's Reply<RequestDef, ReplyT>
+ * entry at compile time - sending a request without a registered reply is a
+ * compile error.
+ *
+ * @author CommRaT Development Team
+ */
+
+#pragma once
+
+#include "registry_mailbox.hpp"
+#include "../platform/threading.hpp"
+#include "../platform/timestamp.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace commrat {
+
+/**
+ * @brief Request/reply client with correlation IDs and futures
+ *
+ * Owns its own mailbox (replies are addressed to it via TimsHeader::reply_to)
+ * and a receive thread that matches replies to pending requests and expires
+ * requests whose deadline passed.
+ *
+ * @tparam Registry Message registry containing the Request and Reply<> definitions
+ * @tparam MaxInFlight Maximum number of outstanding requests (fixed-size table,
+ *         any free slot takes a request; slots are looked up by correlation ID)
+ *
+ * Example:
+ * @code
+ * using GetGainReq = Message::Command<GetGainCmd>;
+ * using App = CommRaT<GetGainReq, Message::Reply<GetGainReq, GainStatus>>;
+ *
+ * App::RequestClient<> client(MailboxConfig{.mailbox_id = 200});
+ * client.start();
+ *
+ * // Pipeline: issue all requests, then collect
+ * std::vector<std::future<MailboxResult<GainStatus>>> replies;
+ * for (uint32_t module_cmd : module_cmd_mailboxes) {
+ *     replies.push_back(client.send_request(GetGainCmd{}, module_cmd, Milliseconds(200)));
+ * }
+ * for (auto& f : replies) {
+ *     auto reply = f.get();
+ *     if (reply) { use(reply->gain); }
+ *     else { std::cerr << to_string(reply.error()) << "\n"; }
+ * }
+ * @endcode
+ *
+ * @note Not real-time safe: each request allocates its promise/handler.
+ *       Intended for configuration and tooling, not for module hot paths.
+ */
+template<typename Registry, std::size_t MaxInFlight = 64>
+class RequestClient {
+    static_assert(MaxInFlight > 0, "RequestClient needs at least one in-flight slot");
+
+public:
+    /// Reply payload type for a request payload
+    template<typename RequestT>
+    using ReplyFor = typename Registry::template reply_type_for<RequestT>;
+
+    /// Future returned by send_request()
+    template<typename RequestT>
+    using ReplyFuture = std::future<MailboxResult<ReplyFor<RequestT>>>;
+
+    // Receive loop wakes up at least this often to expire timed-out requests
+    static constexpr Milliseconds timeout_check_interval{10};
+
+    explicit RequestClient(const MailboxConfig& config)
+        : mailbox_(config) {}
+
+    ~RequestClient() {
+        stop();
+    }
+
+    RequestClient(const RequestClient&) = delete;
+    RequestClient& operator=(const RequestClient&) = delete;
+    RequestClient(RequestClient&&) = delete;
+    RequestClient& operator=(RequestClient&&) = delete;
+
+    // ========================================================================
+    // Lifecycle
+    // ========================================================================
+
+    /**
+     * @brief Start mailbox and reply receive thread
+     */
+    auto start() -> MailboxResult<void> {
+        if (running_) {
+            return MailboxError::AlreadyRunning;
+        }
+
+        auto result = mailbox_.start();
+        if (!result) {
+            return result;
+        }
+
+        running_ = true;
+        receive_thread_.emplace(
+            ThreadConfig{.name = "req_client_" + std::to_string(mailbox_.mailbox_id())},
+            [this]() { receive_loop(); });
+        return MailboxResult<void>();
+    }
+
+    /**
+     * @brief Stop receive thread; pending requests complete with NotRunning
+     */
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        if (receive_thread_) {
+            receive_thread_->join();
+            receive_thread_.reset();
+        }
+        mailbox_.stop();
+
+        Lock lock(pending_mutex_);
+        for (auto& slot : pending_) {
+            if (slot.correlation_id != 0) {
+                slot.fail(MailboxError::NotRunning);
+                slot = PendingRequest{};
+            }
+        }
+    }
+
+    bool is_running() const { return running_; }
+    uint32_t mailbox_id() const { return mailbox_.mailbox_id(); }
+
+    // ========================================================================
+    // Requests
+    // ========================================================================
+
+    /**
+     * @brief Send a request and return a future for its reply
+     *
+     * Never blocks on the reply. The future becomes ready when:
+     * - the reply arrives (value), or
+     * - the timeout expires (MailboxError::Timeout), or
+     * - the send fails (error from the mailbox), or
+     * - all MaxInFlight slots are busy (MailboxError::QueueFull), or
+     * - the client is stopped (MailboxError::NotRunning)
+     *
+     * @tparam RequestT Request payload type (must have a registered Reply<>)
+     * @param request Request payload
+     * @param dest_mailbox Module CMD mailbox address
+     * @param timeout Maximum time to wait for the reply
+     */
+    template<typename RequestT>
+        requires Registry::template has_reply<RequestT>
+    auto send_request(const RequestT& request, uint32_t dest_mailbox,
+                      Milliseconds timeout = Milliseconds(1000)) -> ReplyFuture<RequestT> {
+        using ReplyT = ReplyFor<RequestT>;
+
+        auto promise = std::make_shared<std::promise<MailboxResult<ReplyT>>>();
+        auto future = promise->get_future();
+
+        if (!running_) {
+            promise->set_value(MailboxError::NotRunning);
+            return future;
+        }
+
+        const uint32_t correlation_id = next_correlation_id();
+
+        {
+            Lock lock(pending_mutex_);
+            PendingRequest* free_slot = find_slot(0);
+            if (free_slot == nullptr) {
+                promise->set_value(MailboxError::QueueFull);
+                return future;
+            }
+
+            auto& slot = *free_slot;
+            slot.correlation_id = correlation_id;
+            slot.reply_type = Registry::template get_message_id<ReplyT>();
+            slot.deadline = Time::now() + Time::to_nanoseconds(timeout);
+            slot.complete = [promise](std::span<const std::byte> data) {
+                auto msg = Registry::template deserialize<TimsMessage<ReplyT>>(data);
+                if (msg) {
+                    promise->set_value(MailboxResult<ReplyT>(std::move(msg->payload)));
+                } else {
+                    promise->set_value(MailboxError::SerializationError);
+                }
+            };
+            slot.fail = [promise](MailboxError error) {
+                promise->set_value(error);
+            };
+        }
+
+        TimsMessage<RequestT> msg{
+            .header = {
+                .msg_type = Registry::template get_message_id<RequestT>(),
+                .msg_size = 0,
+                .timestamp = Time::now(),
+                .seq_number = 0,
+                .flags = 0,
+                .correlation_id = correlation_id,
+                .reply_to = mailbox_.mailbox_id()
+            },
+            .payload = request
+        };
+
+        auto result = mailbox_.underlying().send(msg, dest_mailbox);
+        if (!result) {
+            complete_with_error(correlation_id, result.get_error());
+        }
+
+        return future;
+    }
+
+    /**
+     * @brief Blocking convenience wrapper: send_request(...).get()
+     */
+    template<typename RequestT>
+        requires Registry::template has_reply<RequestT>
+    auto request(const RequestT& request, uint32_t dest_mailbox,
+                 Milliseconds timeout = Milliseconds(1000)) -> MailboxResult<ReplyFor<RequestT>> {
+        return send_request(request, dest_mailbox, timeout).get();
+    }
+
+    // ========================================================================
+    // Statistics
+    // ========================================================================
+
+    /// Number of requests waiting for a reply
+    std::size_t in_flight() const {
+        Lock lock(pending_mutex_);
+        std::size_t count = 0;
+        for (const auto& slot : pending_) {
+            count += (slot.correlation_id != 0) ? 1 : 0;
+        }
+        return count;
+    }
+
+    /// Requests that expired without a reply
+    uint64_t timeouts() const { return timeouts_.load(std::memory_order_relaxed); }
+
+    /// Replies that arrived after their request expired (or were never requested)
+    uint64_t unmatched_replies() const { return unmatched_replies_.load(std::memory_order_relaxed); }
+
+private:
+    using RawMessage = typename RegistryMailbox<Registry>::RawMessage;
+
+    struct PendingRequest {
+        uint32_t correlation_id{0};   // 0 = free slot
+        uint32_t reply_type{0};       // Expected reply message ID
+        Timestamp deadline{0};
+        std::function<void(std::span<const std::byte>)> complete;
+        std::function<void(MailboxError)> fail;
+    };
+
+    uint32_t next_correlation_id() {
+        uint32_t id = next_correlation_id_.fetch_add(1, std::memory_order_relaxed);
+        if (id == 0) {
+            // 0 marks one-way messages, skip it on wrap-around
+            id = next_correlation_id_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return id;
+    }
+
+    /// Slot holding correlation_id (0 = a free slot), nullptr if none; caller holds pending_mutex_
+    PendingRequest* find_slot(uint32_t correlation_id) {
+        for (auto& slot : pending_) {
+            if (slot.correlation_id == correlation_id) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    void complete_with_error(uint32_t correlation_id, MailboxError error) {
+        Lock lock(pending_mutex_);
+        PendingRequest* slot = find_slot(correlation_id);
+        if (slot != nullptr) {
+            slot->fail(error);
+            *slot = PendingRequest{};
+        }
+    }
+
+    /**
+     * @brief Receive replies and expire timed-out requests
+     */
+    void receive_loop() {
+        while (running_) {
+            if (mailbox_.underlying().receive_any_raw(reply_buffer_, timeout_check_interval)) {
+                dispatch_reply(reply_buffer_);
+            }
+            expire_timed_out(Time::now());
+        }
+    }
+
+    void dispatch_reply(const RawMessage& raw) {
+        TimsHeader header;
+        std::memcpy(&header, raw.buffer.data(), sizeof(TimsHeader));
+
+        Lock lock(pending_mutex_);
+        PendingRequest* slot = header.correlation_id != 0 ? find_slot(header.correlation_id) : nullptr;
+        if (slot == nullptr || slot->reply_type != header.msg_type) {
+            unmatched_replies_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        slot->complete(raw.data());
+        *slot = PendingRequest{};
+    }
+
+    void expire_timed_out(Timestamp now) {
+        Lock lock(pending_mutex_);
+        for (auto& slot : pending_) {
+            if (slot.correlation_id != 0 && now >= slot.deadline) {
+                slot.fail(MailboxError::Timeout);
+                slot = PendingRequest{};
+                timeouts_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    RegistryMailbox<Registry> mailbox_;
+    RawMessage reply_buffer_;  // Receive thread only
+    std::atomic<bool> running_{false};
+    std::optional<Thread> receive_thread_;
+
+    mutable Mutex pending_mutex_;
+    std::array<PendingRequest, MaxInFlight> pending_{};
+    std::atomic<uint32_t> next_correlation_id_{1};
+
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> unmatched_replies_{0};
+};
+
+} // namespace commrat
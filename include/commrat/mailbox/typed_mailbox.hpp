@@ -231,10 +231,11 @@ public:
      * @param message Message to send
      * @param dest_mailbox Destination mailbox ID
      * @param timestamp Explicit timestamp to set in TimsHeader
+     * @param seq_number Publisher sequence number (0 = unsequenced)
      * @return Success or error
      */
     template<typename PayloadT>
-    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp) 
+    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp, uint32_t seq_number = 0) 
         -> MailboxResult<void> {
         
         static_assert(is_sendable_type<PayloadT>,
@@ -250,7 +251,7 @@ public:
                 .msg_type = Registry::template get_message_id<PayloadT>(),
                 .msg_size = 0,  // Will be set by serialization
                 .timestamp = timestamp, // USER-PROVIDED timestamp
-                .seq_number = 0, // Will be set by TiMS
+                .seq_number = seq_number,
                 .flags = 0
             },
             .payload = message
@@ -337,6 +338,17 @@ public:
         return mailbox_.receive_any(std::forward<Visitor>(visitor));
     }
     
+    /**
+     * @brief Non-blocking receive any allowed message type
+     * 
+     * @tparam Visitor Callable accepting TimsMessage<T> for any allowed T
+     * @return Success, or MailboxError::Timeout if no message is pending
+     */
+    template<typename Visitor>
+    auto try_receive_any(Visitor&& visitor) -> MailboxResult<void> {
+        return mailbox_.try_receive_any(std::forward<Visitor>(visitor));
+    }
+    
     /**
      * @brief Receive any allowed message type with timeout
      * 
@@ -412,13 +424,13 @@ struct SendOnlyTypes {
 /**
  * @brief TypedMailbox with only send types (no receive)
  * 
- * Specialization for send-only mailboxes. No buffer needed for receiving.
- * Useful for modules without commands that only need to send outputs via CMD mailbox.
+ * Specialization for send-only mailboxes. Nothing is received, but the
+ * buffer size still bounds what can be sent. Useful for modules without commands that only need to send outputs via CMD mailbox.
  * 
  * @code
  * // CMD mailbox with no commands (only publishes outputs)
  * using CmdMailbox = TypedMailbox<Registry, SendOnlyTypes<OutputA, OutputB>>;
- * // Buffer sized minimally (no receive types)
+ * // Buffer sized for the largest of OutputA, OutputB
  * // Can send: OutputA, OutputB
  * // Cannot receive anything
  * @endcode
@@ -440,8 +452,10 @@ private:
     static constexpr bool is_registered_type = Registry::template is_registered<PayloadT>;
 
 public:
-    // Minimal buffer (no receive types)
-    static constexpr size_t max_message_size = 64;  // Minimal size for headers only
+    // Sized for the send types: send_raw() rejects messages larger than the
+    // sending mailbox's own max_message_size (test_module_data_path)
+    static constexpr size_t max_message_size =
+        Registry::template max_size_for_types<SendOnlyTypesInner...>();
     
     explicit TypedMailbox(const MailboxConfig& config)
         : mailbox_(MailboxConfig{
@@ -475,7 +489,7 @@ public:
     }
     
     template<typename PayloadT>
-    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp) -> MailboxResult<void> {
+    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp, uint32_t seq_number = 0) -> MailboxResult<void> {
         static_assert(is_send_only_type<PayloadT>, "Message type not in SendOnlyTypes list.");
         static_assert(is_registered_type<PayloadT>, "Type not registered.");
         
@@ -484,7 +498,7 @@ public:
                 .msg_type = Registry::template get_message_id<PayloadT>(),
                 .msg_size = 0,
                 .timestamp = timestamp,
-                .seq_number = 0,
+                .seq_number = seq_number,
                 .flags = 0
             },
             .payload = message
@@ -586,7 +600,7 @@ public:
     }
     
     template<typename PayloadT>
-    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp) -> MailboxResult<void> {
+    auto send(PayloadT& message, uint32_t dest_mailbox, uint64_t timestamp, uint32_t seq_number = 0) -> MailboxResult<void> {
         static_assert(is_sendable_type<PayloadT>, "Message type not sendable.");
         static_assert(is_registered_type<PayloadT>, "Type not registered.");
         
@@ -595,7 +609,7 @@ public:
                 .msg_type = Registry::template get_message_id<PayloadT>(),
                 .msg_size = 0,
                 .timestamp = timestamp,
-                .seq_number = 0,
+                .seq_number = seq_number,
                 .flags = 0
             },
             .payload = message
@@ -625,6 +639,11 @@ public:
         return mailbox_.receive_any(std::forward<Visitor>(visitor));
     }
     
+    template<typename Visitor>
+    auto try_receive_any(Visitor&& visitor) -> MailboxResult<void> {
+        return mailbox_.try_receive_any(std::forward<Visitor>(visitor));
+    }
+    
     // Lifecycle
     auto start() -> MailboxResult<void> { return mailbox_.start(); }
     void stop() { mailbox_.stop(); }
@@ -17,10 +17,17 @@ struct TimsHeader {
     uint32_t msg_type;
     uint32_t msg_size;      // Will be set by serialization
     uint64_t timestamp;     // Will be set by send()
-    uint32_t seq_number;    // Will be set by send()
+    uint32_t seq_number;    // Per-output publisher sequence 1, 2, ... (0 = unsequenced)
     uint32_t flags;
+    uint32_t correlation_id{0};  // Request/reply pairing (0 = one-way message)
+    uint32_t reply_to{0};        // Mailbox address for the reply (0 = no reply wanted)
+    uint64_t trace_id{0};        // Causal chain this message belongs to (0 = untraced)
+    uint64_t span_id{0};         // Span that produced this message (see platform/tracing.hpp)
 };
 
+// Header is memcpy'd from serialized buffers: packed layout == memory layout
+static_assert(sizeof(TimsHeader) == 48, "TimsHeader must not contain padding");
+
 // Message type ID - use compile-time type hash for automatic unique IDs
 using MessageType = uint32_t;
 
@@ -2,6 +2,7 @@
 
 #include "message_registry.hpp"
 #include <cstdint>
+#include <type_traits>
 
 namespace commrat {
 
@@ -51,6 +52,25 @@ using Data = MessageDefinition<T, Prefix, UserSubPrefix::Data, LocalID>;
 // Command Messages (UserDefined prefix, Commands subprefix, AUTO_ID by default)
 // ============================================================================
 
+namespace detail {
+
+// Second Command<> parameter is either a MessagePrefix or a Coalesce policy
+template<typename T, auto PrefixOrPolicy, uint16_t LocalID>
+struct MakeCommand {
+    using type = MessageDefinition<T, PrefixOrPolicy, UserSubPrefix::Commands, LocalID>;
+};
+
+template<typename T, Coalesce Policy, uint16_t LocalID>
+struct MakeCommand<T, Policy, LocalID> {
+    using type = std::conditional_t<
+        Policy == Coalesce::None,
+        MessageDefinition<T, MessagePrefix::UserDefined, UserSubPrefix::Commands, LocalID>,
+        Coalesced<MessageDefinition<T, MessagePrefix::UserDefined, UserSubPrefix::Commands, LocalID>, Policy>
+    >;
+};
+
+} // namespace detail
+
 /**
  * @brief Command message definition
  * 
@@ -58,14 +78,17 @@ using Data = MessageDefinition<T, Prefix, UserSubPrefix::Data, LocalID>;
  *   using ResetCmd = Message::Command<ResetCommand>;
  *   using CalibrateCmd = Message::Command<CalibrateCommand>;
  * 
+ *   // Latest-wins: stale pending setpoints are dropped, only the newest is delivered
+ *   using SetpointMsg = Message::Command<SetpointCmd, Coalesce::Latest>;
+ * 
  * @tparam T Payload type
- * @tparam Prefix Message prefix (default: UserDefined)
+ * @tparam PrefixOrPolicy Message prefix (default: UserDefined) or Coalesce policy
  * @tparam LocalID Local message ID (default: AUTO_ID)
  */
 template<typename T,
-         MessagePrefix Prefix = MessagePrefix::UserDefined,
+         auto PrefixOrPolicy = MessagePrefix::UserDefined,
          uint16_t LocalID = AUTO_ID>
-using Command = MessageDefinition<T, Prefix, UserSubPrefix::Commands, LocalID>;
+using Command = typename detail::MakeCommand<T, PrefixOrPolicy, LocalID>::type;
 
 // ============================================================================
 // Event Messages (UserDefined prefix, Events subprefix, AUTO_ID by default)
@@ -87,6 +110,26 @@ template<typename T,
          uint16_t LocalID = AUTO_ID>
 using Event = MessageDefinition<T, Prefix, UserSubPrefix::Events, LocalID>;
 
+// ============================================================================
+// Reply Messages (paired with a command, same prefix/subprefix)
+// ============================================================================
+
+/**
+ * @brief Reply definition for a command (request/reply)
+ * 
+ * Usage:
+ *   using GetGainReq = Message::Command<GetGainCmd>;
+ *   using GetGainRep = Message::Reply<GetGainReq, GainStatus>;
+ * 
+ * The module returns GainStatus from on_command(const GetGainCmd&), and
+ * RequestClient::send_request(GetGainCmd{...}, ...) yields a future<GainStatus>.
+ * 
+ * @tparam RequestDef Message definition of the command
+ * @tparam T Reply payload type
+ */
+template<typename RequestDef, typename T>
+using Reply = commrat::Reply<RequestDef, T>;
+
 } // namespace Message
 
 } // namespace commrat
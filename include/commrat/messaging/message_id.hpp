@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <cstdint>
 #include <type_traits>
 
@@ -95,15 +96,18 @@ struct MessageDefinition {
     static constexpr uint16_t local_id = ID_;
     
     // Extract subprefix value based on prefix type
+    // (integral subprefix comes from AutoAssignIDs re-instantiating a definition)
     static constexpr uint8_t subprefix = []() constexpr {
         if constexpr (Prefix_ == MessagePrefix::System) {
-            if constexpr (std::is_same_v<decltype(SubPrefix_), SystemSubPrefix>) {
+            if constexpr (std::is_same_v<decltype(SubPrefix_), SystemSubPrefix> ||
+                          std::is_integral_v<decltype(SubPrefix_)>) {
                 return static_cast<uint8_t>(SubPrefix_);
             } else {
                 return static_cast<uint8_t>(DefaultMessageDef::system_subprefix);
             }
         } else {
-            if constexpr (std::is_same_v<decltype(SubPrefix_), UserSubPrefix>) {
+            if constexpr (std::is_same_v<decltype(SubPrefix_), UserSubPrefix> ||
+                          std::is_integral_v<decltype(SubPrefix_)>) {
                 return static_cast<uint8_t>(SubPrefix_);
             } else {
                 return static_cast<uint8_t>(DefaultMessageDef::user_subprefix);
@@ -132,22 +136,94 @@ struct Request : MessageDef {
 /**
  * @brief Define a reply message paired with a request
  * 
- * Automatically gets negative ID of the request
+ * The reply carries its own payload type and remembers which request payload
+ * it answers. CommandDispatcher uses this pairing to send the return value of
+ * on_command() back to the requester, and RequestClient uses it to type the
+ * future returned by send_request(). A reply payload that is also registered
+ * as another message (e.g. a Data stream) resolves to the first definition
+ * when looked up by payload type.
+ * 
+ * ID assignment:
+ * - Request with explicit ID: reply ID = -request_id (RACK-style, int16_t space)
+ * - Request with auto ID: reply is auto-assigned like any other message
+ * 
+ * @tparam RequestMessageDef MessageDefinition of the request
+ * @tparam ReplyPayloadT Payload type of the reply
+ * 
+ * Example:
+ * @code
+ * using GetGainReq = Message::Command<GetGainCmd>;
+ * using App = CommRaT<
+ *     GetGainReq,
+ *     Message::Reply<GetGainReq, GainStatus>
+ * >;
+ * @endcode
  */
-template<typename RequestMessageDef>
+template<typename RequestMessageDef, typename ReplyPayloadT>
 struct Reply {
-    using Payload = typename RequestMessageDef::Payload;  // Can be different, override if needed
+    using Payload = ReplyPayloadT;
+    using RequestPayload = typename RequestMessageDef::Payload;
     static constexpr MessagePrefix prefix = RequestMessageDef::prefix;
     static constexpr uint8_t subprefix = RequestMessageDef::subprefix;
     
+    // Auto-assigned requests get auto-assigned replies (request ID not known yet)
+    static constexpr bool needs_auto_id = RequestMessageDef::needs_auto_id;
+    
     // Reply ID is negative of request ID (in int16_t space)
     static constexpr uint16_t local_id = []() constexpr {
-        int16_t signed_id = static_cast<int16_t>(RequestMessageDef::local_id);
-        return static_cast<uint16_t>(-signed_id);
+        if constexpr (RequestMessageDef::needs_auto_id) {
+            return DefaultMessageDef::id;
+        } else {
+            int16_t signed_id = static_cast<int16_t>(RequestMessageDef::local_id);
+            return static_cast<uint16_t>(-signed_id);
+        }
     }();
     
     static constexpr bool is_reply = true;
-    static constexpr bool needs_auto_id = false;  // Always explicit from request
+};
+
+// ============================================================================
+// Command Coalescing (latest-wins delivery)
+// ============================================================================
+
+/**
+ * @brief Delivery policy for pending commands of one type
+ * 
+ * - None:   FIFO, every command is delivered (default)
+ * - Latest: only the newest pending command is delivered, older ones are
+ *           dropped (setpoint-style commands, e.g. teleoperation)
+ */
+enum class Coalesce : uint8_t {
+    None = 0,
+    Latest = 1
+};
+
+/**
+ * @brief Attach a coalescing policy to a message definition
+ * 
+ * Usually created through Message::Command<T, Coalesce::Latest>.
+ * 
+ * @tparam MessageDef MessageDefinition of the command
+ * @tparam Policy Delivery policy
+ */
+template<typename MessageDef, Coalesce Policy>
+struct Coalesced : MessageDef {
+    static constexpr Coalesce coalesce = Policy;
+};
+
+/**
+ * @brief Anything the registry accepts as a message definition
+ * 
+ * Satisfied by MessageDefinition, Request<Def>, Reply<Def, T> and
+ * Coalesced<Def, Policy>.
+ */
+template<typename T>
+concept MessageDefinitionType = requires {
+    typename T::Payload;
+    { T::prefix } -> std::convertible_to<MessagePrefix>;
+    { T::subprefix } -> std::convertible_to<uint8_t>;
+    { T::local_id } -> std::convertible_to<uint16_t>;
+    { T::needs_auto_id } -> std::convertible_to<bool>;
 };
 
 // ============================================================================
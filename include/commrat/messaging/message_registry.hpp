@@ -2,10 +2,13 @@
 
 #include "../messages.hpp"
 #include "message_id.hpp"
+#include <algorithm>
+#include <array>
 #include <type_traits>
 #include <tuple>
 #include <optional>
 #include <span>
+#include <utility>
 
 namespace commrat {
 
@@ -20,108 +23,217 @@ class Module;
 /**
  * @brief Helper to assign auto-incremented IDs to messages marked with needs_auto_id
  * 
- * Forward processing: assigns ID to First, then recursively processes Rest with First in context.
+ * An auto ID is one above the highest ID assigned to an earlier message of the
+ * same prefix/subprefix. All IDs are computed in one constexpr pass over arrays
+ * of the definitions, so the cost does not grow with template recursion depth.
  */
 template<typename... MessageDefs>
-struct AutoAssignIDs;
-
-template<>
-struct AutoAssignIDs<> {
-    using Result = std::tuple<>;
-};
-
-// Forward declarations
-template<typename ProcessedTuple, typename... Remaining>
-struct AutoAssignIDsProcess;
-
-// Base case: no more messages to process
-template<typename... ProcessedDefs>
-struct AutoAssignIDsProcess<std::tuple<ProcessedDefs...>> {
-    using Result = std::tuple<>;
-};
-
-// Recursive case: process First, then Rest
-template<typename... ProcessedDefs, typename First, typename... Rest>
-struct AutoAssignIDsProcess<std::tuple<ProcessedDefs...>, First, Rest...> {
-private:
-    // Track highest ID for this prefix/subprefix
-    template<typename MessageDef>
-    struct HighestID {
-        static constexpr uint16_t value = []() constexpr {
-            if constexpr (sizeof...(ProcessedDefs) == 0) {
-                return 0;
-            } else {
-                uint16_t max_id = 0;
-                ((max_id = (ProcessedDefs::prefix == MessageDef::prefix && 
-                           ProcessedDefs::subprefix == MessageDef::subprefix &&
-                           ProcessedDefs::local_id > max_id) ? 
-                           ProcessedDefs::local_id : max_id), ...);
-                return max_id;
+struct AutoAssignIDs {
+    static constexpr std::size_t count = sizeof...(MessageDefs);
+    
+    // Local ID of every definition after auto-assignment (definition order)
+    static constexpr std::array<uint16_t, count> local_ids = []() constexpr {
+        std::array<uint16_t, count> assigned{MessageDefs::local_id...};
+        constexpr std::array<bool, count> needs_auto{MessageDefs::needs_auto_id...};
+        constexpr std::array<uint16_t, count> categories{
+            static_cast<uint16_t>((static_cast<uint16_t>(MessageDefs::prefix) << 8) | MessageDefs::subprefix)...
+        };
+        
+        // Highest ID so far per prefix/subprefix (a registry uses only a few)
+        std::array<uint16_t, count> seen_categories{};
+        std::array<uint16_t, count> highest{};
+        std::size_t num_seen = 0;
+        
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t slot = 0;
+            while (slot < num_seen && seen_categories[slot] != categories[i]) {
+                ++slot;
             }
-        }();
-    };
+            if (slot == num_seen) {
+                seen_categories[num_seen++] = categories[i];
+            }
+            
+            if (needs_auto[i]) {
+                assigned[i] = static_cast<uint16_t>(highest[slot] + 1);
+            }
+            
+            // IDs >= 0x8000 are negative in int16_t space (RACK-style replies) and
+            // must not push auto-assignment towards the 0xFFFF marker
+            if (assigned[i] < 0x8000 && assigned[i] > highest[slot]) {
+                highest[slot] = assigned[i];
+            }
+        }
+        return assigned;
+    }();
+    
+    // Full message ID of every definition (definition order)
+    static constexpr std::array<uint32_t, count> ids = []() constexpr {
+        constexpr std::array<uint8_t, count> prefixes{static_cast<uint8_t>(MessageDefs::prefix)...};
+        constexpr std::array<uint8_t, count> subprefixes{MessageDefs::subprefix...};
+        std::array<uint32_t, count> result{};
+        for (std::size_t i = 0; i < count; ++i) {
+            result[i] = make_message_id(prefixes[i], subprefixes[i], local_ids[i]);
+        }
+        return result;
+    }();
     
-    // Assign ID to current message
-    using CurrentProcessed = std::conditional_t<
-        First::needs_auto_id,
-        MessageDefinition<
-            typename First::Payload,
-            First::prefix,
-            First::subprefix,
-            HighestID<First>::value + 1
-        >,
-        First
+private:
+    template<typename Def, std::size_t I>
+    using Assigned = std::conditional_t<
+        Def::needs_auto_id,
+        MessageDefinition<typename Def::Payload, Def::prefix, Def::subprefix, local_ids[I]>,
+        Def
     >;
     
-    using RestResult = typename AutoAssignIDsProcess<std::tuple<ProcessedDefs..., CurrentProcessed>, Rest...>::Result;
+    template<std::size_t... Is>
+    static auto assign(std::index_sequence<Is...>) -> std::tuple<Assigned<MessageDefs, Is>...>;
     
 public:
-    using Result = decltype(std::tuple_cat(
-        std::declval<std::tuple<CurrentProcessed>>(),
-        std::declval<RestResult>()
-    ));
-};
-
-template<typename... MessageDefs>
-struct AutoAssignIDs {
-    using Result = typename AutoAssignIDsProcess<std::tuple<>, MessageDefs...>::Result;
+    // Definitions with their assigned IDs
+    using Result = decltype(assign(std::make_index_sequence<count>{}));
 };
 
 // ============================================================================
-// Compile-Time Message ID Collision Detection
+// Message ID Index (sorted ID -> definition index table)
 // ============================================================================
 
-template<typename... MessageDefs>
-struct CheckCollisions {
-    static constexpr bool check() {
-        if constexpr (sizeof...(MessageDefs) <= 1) {
-            return true;
-        } else {
-            return check_all_pairs<MessageDefs...>();
-        }
+/**
+ * @brief Entry of the sorted message ID table
+ */
+struct MessageIdEntry {
+    uint32_t id;
+    uint32_t index;  ///< Position of the definition in the registry
+};
+
+/**
+ * @brief Sort message IDs once, keeping their definition index
+ */
+template<std::size_t N>
+constexpr std::array<MessageIdEntry, N> sort_message_ids(const std::array<uint32_t, N>& ids) {
+    std::array<MessageIdEntry, N> table{};
+    for (std::size_t i = 0; i < N; ++i) {
+        table[i] = MessageIdEntry{ids[i], static_cast<uint32_t>(i)};
     }
-    
-private:
-    template<typename First, typename Second, typename... Rest>
-    static constexpr bool check_all_pairs() {
-        constexpr uint32_t id1 = make_message_id(
-            static_cast<uint8_t>(First::prefix),
-            First::subprefix,
-            First::local_id
-        );
-        constexpr uint32_t id2 = make_message_id(
-            static_cast<uint8_t>(Second::prefix),
-            Second::subprefix,
-            Second::local_id
-        );
-        
-        static_assert(id1 != id2, "Message ID collision detected!");
-        
-        if constexpr (sizeof...(Rest) > 0) {
-            return check_all_pairs<First, Rest...>() && check_all_pairs<Second, Rest...>();
+    std::sort(table.begin(), table.end(),
+              [](const MessageIdEntry& a, const MessageIdEntry& b) { return a.id < b.id; });
+    return table;
+}
+
+/**
+ * @brief Check a sorted ID table for duplicates (adjacent entries only)
+ */
+template<std::size_t N>
+constexpr bool has_message_id_collision(const std::array<MessageIdEntry, N>& sorted) {
+    for (std::size_t i = 1; i < N; ++i) {
+        if (sorted[i - 1].id == sorted[i].id) {
+            return true;
         }
-        return true;
     }
+    return false;
+}
+
+/**
+ * @brief Binary search a sorted ID table
+ * 
+ * @return Definition index of the ID, N if the ID is not registered
+ */
+template<std::size_t N>
+constexpr std::size_t find_message_index(const std::array<MessageIdEntry, N>& sorted, uint32_t id) {
+    auto it = std::lower_bound(sorted.begin(), sorted.end(), id,
+                               [](const MessageIdEntry& entry, uint32_t value) { return entry.id < value; });
+    return (it != sorted.end() && it->id == id) ? it->index : N;
+}
+
+// ============================================================================
+// Payload Index (payload type -> definition index)
+// ============================================================================
+
+/**
+ * @brief Tag base binding a payload type to its definition index
+ * 
+ * PayloadIndexMap derives from one tag per payload. payload_index_of() finds
+ * the index by derived-to-base deduction, a single overload resolution instead
+ * of a comparison against every registered type.
+ */
+template<std::size_t I, typename PayloadT>
+struct IndexedPayload {};
+
+template<typename Indices, typename... Payloads>
+struct PayloadIndexMap;
+
+template<std::size_t... Is, typename... Payloads>
+struct PayloadIndexMap<std::index_sequence<Is...>, Payloads...> : IndexedPayload<Is, Payloads>... {};
+
+template<typename PayloadT, std::size_t I>
+constexpr std::size_t payload_index_of(const IndexedPayload<I, PayloadT>*) {
+    return I;
+}
+
+/**
+ * @brief Index map for registries that register a payload more than once
+ *
+ * Only the first definition of each payload gets its tag, so lookups
+ * resolve to the lowest index (first match). Costs a pairwise comparison,
+ * so registries with unique payloads use PayloadIndexMap.
+ */
+template<typename PayloadT, std::size_t I, typename... Payloads>
+constexpr bool is_first_payload() {
+    std::size_t j = 0;
+    bool first = true;
+    ((first = first && (j++ >= I || !std::is_same_v<PayloadT, Payloads>)), ...);
+    return first;
+}
+
+template<std::size_t I, typename PayloadT, bool First>
+struct FirstIndexedPayload : IndexedPayload<I, PayloadT> {};
+
+template<std::size_t I, typename PayloadT>
+struct FirstIndexedPayload<I, PayloadT, false> {};
+
+template<typename Indices, typename... Payloads>
+struct FirstMatchPayloadIndexMap;
+
+template<std::size_t... Is, typename... Payloads>
+struct FirstMatchPayloadIndexMap<std::index_sequence<Is...>, Payloads...>
+    : FirstIndexedPayload<Is, Payloads, is_first_payload<Payloads, Is, Payloads...>()>... {};
+
+template<typename Map, typename PayloadT>
+concept HasPayloadIndex = requires {
+    payload_index_of<PayloadT>(static_cast<const Map*>(nullptr));
+};
+
+// ============================================================================
+// Request/Reply Pairing Lookup
+// ============================================================================
+
+/**
+ * @brief Request payload answered by a definition (void unless Reply<>)
+ */
+template<typename Def, typename = void>
+struct RequestPayloadOf {
+    using type = void;
+};
+
+template<typename Def>
+struct RequestPayloadOf<Def, std::void_t<typename Def::RequestPayload>> {
+    using type = typename Def::RequestPayload;
+};
+
+// ============================================================================
+// Command Coalescing Policy Lookup
+// ============================================================================
+
+/**
+ * @brief Coalescing policy of a definition (Coalesce::None unless Coalesced<>)
+ */
+template<typename Def, typename = void>
+struct CoalescePolicyOf {
+    static constexpr Coalesce value = Coalesce::None;
+};
+
+template<typename Def>
+struct CoalescePolicyOf<Def, std::void_t<decltype(Def::coalesce)>> {
+    static constexpr Coalesce value = Def::coalesce;
 };
 
 // ============================================================================
@@ -146,26 +258,74 @@ private:
  */
 template<typename... MessageDefs>
 class MessageRegistry {
+public:
+    // Number of registered message types
+    static constexpr size_t num_types = sizeof...(MessageDefs);
+    
+    // Payload types tuple - exposed for introspection
+    using PayloadTypes = std::tuple<typename MessageDefs::Payload...>;
+
 private:
     // Auto-assign IDs where needed
-    using ProcessedDefs = typename AutoAssignIDs<MessageDefs...>::Result;
+    using IDs = AutoAssignIDs<MessageDefs...>;
     
-    // Extract payload types from MessageDefinitions
-    template<typename Tuple>
-    struct ExtractPayloads;
+    // ID <-> index tables, built once per registry
+    static constexpr auto sorted_ids = sort_message_ids(IDs::ids);
+    
+    static_assert(!has_message_id_collision(sorted_ids), "Message ID collision detected!");
+    
+    using UniquePayloadIndex = PayloadIndexMap<std::make_index_sequence<num_types>, typename MessageDefs::Payload...>;
+    
+    // A payload registered twice is ambiguous in UniquePayloadIndex; it then
+    // resolves to its first definition, like a linear first-match search
+    static constexpr bool payloads_unique =
+        (HasPayloadIndex<UniquePayloadIndex, typename MessageDefs::Payload> && ...);
+    
+    using PayloadIndex = std::conditional_t<
+        payloads_unique,
+        UniquePayloadIndex,
+        FirstMatchPayloadIndexMap<std::make_index_sequence<num_types>, typename MessageDefs::Payload...>
+    >;
+    
+    template<typename T>
+    static constexpr bool has_payload_index = HasPayloadIndex<PayloadIndex, T>;
+    
+    // Definition index of a payload type, num_types if not registered
+    template<typename T>
+    static constexpr size_t payload_index() {
+        if constexpr (has_payload_index<T>) {
+            return payload_index_of<T>(static_cast<const PayloadIndex*>(nullptr));
+        } else {
+            return num_types;
+        }
+    }
     
-    template<typename... Defs>
-    struct ExtractPayloads<std::tuple<Defs...>> {
-        using PayloadTypes = std::tuple<typename Defs::Payload...>;
+    // Payload type at a definition index, void for num_types
+    template<size_t Index>
+    using PayloadAtOrVoid = typename std::conditional_t<
+        (Index < num_types),
+        std::tuple_element<Index, PayloadTypes>,
+        std::type_identity<void>
+    >::type;
+    
+    // Index of the request payload answered by each definition (num_types if none)
+    static constexpr std::array<size_t, num_types> request_indices{
+        payload_index<typename RequestPayloadOf<MessageDefs>::type>()...
     };
     
-    // Check for ID collisions at compile-time
-    static constexpr bool collisions_checked = CheckCollisions<MessageDefs...>::check();
+    static constexpr std::array<Coalesce, num_types> coalesce_policies{CoalescePolicyOf<MessageDefs>::value...};
+    
+    // Definition index of the Reply<> answering a request payload index
+    static constexpr size_t reply_index(size_t request_index) {
+        for (size_t i = 0; i < num_types; ++i) {
+            if (request_index < num_types && request_indices[i] == request_index) {
+                return i;
+            }
+        }
+        return num_types;
+    }
 
 public:
-    // Payload types tuple - exposed for introspection
-    using PayloadTypes = typename ExtractPayloads<ProcessedDefs>::PayloadTypes;
-    
     // Helper to check if a payload type is in the registry
     template<typename T, typename Tuple>
     struct IsInTuple;
@@ -176,10 +336,7 @@ public:
     };
     
     template<typename T>
-    static constexpr bool is_registered_v = IsInTuple<T, PayloadTypes>::value;
-
-    // Number of registered message types
-    static constexpr size_t num_types = sizeof...(MessageDefs);
+    static constexpr bool is_registered_v = has_payload_index<T>;
     
     // Maximum message size across all registered types (for buffer allocation)
     // NOTE: We calculate size of TimsMessage<Payload> not just Payload, because that's what gets serialized
@@ -220,91 +377,22 @@ public:
     }
 
 private:
-    // Helper to get MessageDefinition for a payload type
-    template<typename PayloadT, typename Tuple>
-    struct FindMessageDef;
-    
-    template<typename PayloadT, typename... Defs>
-    struct FindMessageDef<PayloadT, std::tuple<Defs...>> {
-    private:
-        template<typename Def>
-        static constexpr bool matches = std::is_same_v<typename Def::Payload, PayloadT>;
-        
-        template<typename First, typename... Rest>
-        static constexpr auto find_impl() {
-            if constexpr (matches<First>) {
-                return First{};
-            } else if constexpr (sizeof...(Rest) > 0) {
-                return find_impl<Rest...>();
-            } else {
-                return void{};
-            }
-        }
-        
-    public:
-        using type = decltype(find_impl<Defs...>());
-    };
-    
     // Helper to get message ID for a payload type
     template<typename PayloadT>
     static constexpr uint32_t get_message_id_for() {
-        using MessageDef = typename FindMessageDef<PayloadT, ProcessedDefs>::type;
-        return make_message_id(
-            static_cast<uint8_t>(MessageDef::prefix),
-            MessageDef::subprefix,
-            MessageDef::local_id
-        );
+        return IDs::ids[payload_index<PayloadT>()];
     }
     
-    // Helper to get index of payload type in tuple
-    template<typename T, typename Tuple, size_t Index = 0>
-    struct TypeIndex;
-    
-    template<typename T, typename... Types, size_t Index>
-    struct TypeIndex<T, std::tuple<Types...>, Index> {
-        static constexpr size_t value = []() constexpr {
-            size_t idx = num_types;
-            size_t current = 0;
-            ((std::is_same_v<T, Types> ? (idx = current, 0) : (++current, 0)), ...);
-            return idx;
-        }();
-    };
-    
+    // Helper to get index of payload type in tuple (num_types if not registered)
     template<typename T>
     static constexpr size_t type_index() {
-        return TypeIndex<T, PayloadTypes>::value;
+        return payload_index<T>();
     }
     
-    // Helper to get payload type by message ID at runtime
-    template<uint32_t ID, size_t Index = 0, typename Tuple = ProcessedDefs>
-    struct TypeByID;
-    
-    template<uint32_t ID, size_t Index, typename... Defs>
-    struct TypeByID<ID, Index, std::tuple<Defs...>> {
-        using type = void;
-        static constexpr bool found = false;
-    };
-    
-    template<uint32_t ID, size_t Index, typename... Defs>
-        requires (Index < sizeof...(Defs))
-    struct TypeByID<ID, Index, std::tuple<Defs...>> {
-    private:
-        using CurrentDef = std::tuple_element_t<Index, std::tuple<Defs...>>;
-        static constexpr uint32_t current_id = make_message_id(
-            static_cast<uint8_t>(CurrentDef::prefix),
-            CurrentDef::subprefix,
-            CurrentDef::local_id
-        );
-        
-    public:
-        using type = std::conditional_t<
-            current_id == ID,
-            typename CurrentDef::Payload,
-            typename TypeByID<ID, Index + 1>::type
-        >;
-        static constexpr bool found = (current_id == ID) || 
-                                      TypeByID<ID, Index + 1>::found;
-    };
+    // Helper to get definition index by message ID (num_types if not registered)
+    static constexpr size_t index_for_id(uint32_t id) {
+        return find_message_index(sorted_ids, id);
+    }
 
 public:
     // ========================================================================
@@ -330,13 +418,39 @@ public:
      * @brief Get the payload type by message ID (compile-time)
      */
     template<uint32_t ID>
-    using PayloadTypeFor = typename TypeByID<ID, 0>::type;
+    using PayloadTypeFor = PayloadAtOrVoid<index_for_id(ID)>;
     
     /**
      * @brief Check if a message ID is registered
      */
     template<uint32_t ID>
-    static constexpr bool has_message_id = TypeByID<ID, 0>::found;
+    static constexpr bool has_message_id = index_for_id(ID) < num_types;
+    
+    /**
+     * @brief Reply payload paired with a request payload via Reply<>
+     * 
+     * void if RequestT is a one-way command.
+     */
+    template<typename RequestT>
+    using reply_type_for = PayloadAtOrVoid<reply_index(payload_index<RequestT>())>;
+    
+    /**
+     * @brief Check if a request payload has a registered Reply<>
+     */
+    template<typename RequestT>
+    static constexpr bool has_reply = !std::is_void_v<reply_type_for<RequestT>>;
+    
+    /**
+     * @brief Delivery policy of a command payload (see Coalesced<>)
+     */
+    template<typename PayloadT>
+    static constexpr Coalesce coalesce_policy_for = []() constexpr {
+        if constexpr (is_registered_v<PayloadT>) {
+            return coalesce_policies[payload_index<PayloadT>()];
+        } else {
+            return Coalesce::None;
+        }
+    }();
     
     // ========================================================================
     // Serialization Interface (Compile-Time Type-Safe)
@@ -437,8 +551,8 @@ public:
      * @brief Visit a message by its message ID using a visitor
      * 
      * This provides runtime dispatch when the message type is not known at
-     * compile time. Uses template expansion to generate efficient switch-like
-     * behavior without virtual functions.
+     * compile time. The ID is looked up by binary search in the sorted ID
+     * table and dispatched through a function table, without virtual functions.
      * 
      * The visitor should accept any message type in the registry:
      *   auto visitor = [](auto&& msg) {
@@ -453,7 +567,12 @@ public:
      */
     template<typename Visitor>
     static bool visit(uint32_t msg_id, std::span<const std::byte> data, Visitor&& visitor) {
-        return visit_impl<0>(msg_id, data, std::forward<Visitor>(visitor));
+        const size_t index = index_for_id(msg_id);
+        if (index >= num_types) {
+            // Message ID not found in registry
+            return false;
+        }
+        return visit_table<Visitor>[index](data, std::forward<Visitor>(visitor));
     }
     
     /**
@@ -492,19 +611,8 @@ public:
     /**
      * @brief Get list of all message IDs in the registry
      */
-    template<typename... Defs>
-    static constexpr auto get_all_ids_impl(std::tuple<Defs...>*) {
-        return std::array<uint32_t, sizeof...(Defs)>{
-            make_message_id(
-                static_cast<uint8_t>(Defs::prefix),
-                Defs::subprefix,
-                Defs::local_id
-            )...
-        };
-    }
-    
     static constexpr auto message_ids() {
-        return get_all_ids_impl(static_cast<ProcessedDefs*>(nullptr));
+        return IDs::ids;
     }
     
     // ========================================================================
@@ -526,46 +634,30 @@ public:
     }
     
 private:
-    // Recursive visitor implementation
-    template<size_t Index, typename Visitor, typename... Defs>
-    static bool visit_impl_helper(uint32_t msg_id, std::span<const std::byte> data, 
-                                   Visitor&& visitor, std::tuple<Defs...>*) {
-        if constexpr (Index >= sizeof...(Defs)) {
-            // Message ID not found in registry
-            return false;
-        } else {
-            using CurrentDef = std::tuple_element_t<Index, std::tuple<Defs...>>;
-            using CurrentPayload = typename CurrentDef::Payload;
-            
-            constexpr uint32_t current_id = make_message_id(
-                static_cast<uint8_t>(CurrentDef::prefix),
-                CurrentDef::subprefix,
-                CurrentDef::local_id
-            );
-            
-            if (msg_id == current_id) {
-                // Found matching ID - deserialize TimsMessage<Payload> wrapper using Registry
-                auto result = deserialize<TimsMessage<CurrentPayload>>(data);
-                if (result) {
-                    // Visit with the full TimsMessage wrapper
-                    std::forward<Visitor>(visitor)(*result);
-                    return true;
-                }
-                return false;
-            }
-            
-            // Try next type
-            return visit_impl_helper<Index + 1>(msg_id, data, 
-                                                std::forward<Visitor>(visitor), 
-                                                static_cast<std::tuple<Defs...>*>(nullptr));
+    // Deserialize and visit the message type at definition index Index
+    template<size_t Index, typename Visitor>
+    static bool visit_at(std::span<const std::byte> data, Visitor&& visitor) {
+        // Deserialize TimsMessage<Payload> wrapper using Registry
+        auto result = deserialize<TimsMessage<type_at<Index>>>(data);
+        if (result) {
+            // Visit with the full TimsMessage wrapper
+            std::forward<Visitor>(visitor)(*result);
+            return true;
         }
+        return false;
     }
     
-    template<size_t Index, typename Visitor>
-    static bool visit_impl(uint32_t msg_id, std::span<const std::byte> data, Visitor&& visitor) {
-        return visit_impl_helper<Index>(msg_id, data, std::forward<Visitor>(visitor),
-                                        static_cast<ProcessedDefs*>(nullptr));
+    template<typename Visitor>
+    using VisitFn = bool (*)(std::span<const std::byte>, Visitor&&);
+    
+    template<typename Visitor, size_t... Is>
+    static constexpr std::array<VisitFn<Visitor>, num_types> make_visit_table(std::index_sequence<Is...>) {
+        return {&visit_at<Is, Visitor>...};
     }
+    
+    // One entry per definition index
+    template<typename Visitor>
+    static constexpr auto visit_table = make_visit_table<Visitor>(std::make_index_sequence<num_types>{});
 };
 
 // ============================================================================
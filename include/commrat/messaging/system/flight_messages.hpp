@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../message_id.hpp"
+#include <sertial/containers/fixed_string.hpp>
+#include <cstdint>
+
+namespace commrat {
+
+// ============================================================================
+// Flight Recorder Dump
+// ============================================================================
+
+/**
+ * @brief Ask a process to dump its flight recorder
+ *
+ * Sent to any module's WORK mailbox with TimsHeader::reply_to set. The dump
+ * covers the whole process (see FlightRecorder), not only that module.
+ */
+struct FlightDumpRequestPayload {
+    uint32_t reserved{0};            ///< Unused, keeps the payload non-empty
+};
+
+/**
+ * @brief Result of a flight recorder dump
+ */
+struct FlightDumpReplyPayload {
+    bool success{false};             ///< false: no FlightRecorder, dump in progress or write failed
+    uint64_t records{0};             ///< Records written
+    sertial::fixed_string<128> path; ///< Dump file on the module's host
+};
+
+// ============================================================================
+// Message Definitions with Compile-Time IDs
+// ============================================================================
+
+using FlightDumpRequest = MessageDefinition<
+    FlightDumpRequestPayload,
+    MessagePrefix::System,
+    SystemSubPrefix::Control,
+    0x0011
+>;
+
+// Reply ID is -0x0011 (RACK-style request/reply pairing)
+using FlightDumpReply = Reply<FlightDumpRequest, FlightDumpReplyPayload>;
+
+// Type aliases for accessing payloads
+using FlightDumpRequestType = typename FlightDumpRequest::Payload;
+using FlightDumpReplyType = typename FlightDumpReply::Payload;
+
+} // namespace commrat
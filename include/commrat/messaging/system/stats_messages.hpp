@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../message_id.hpp"
+#include <sertial/containers/fixed_string.hpp>
+#include <sertial/containers/fixed_vector.hpp>
+#include <cstdint>
+
+namespace commrat {
+
+// ============================================================================
+// Module Runtime Statistics
+// ============================================================================
+
+/// Capacity limits of StatsReplyPayload (fixed-size, no allocation)
+inline constexpr std::size_t max_stats_inputs = 8;
+inline constexpr std::size_t max_stats_subscribers = 16;
+inline constexpr std::size_t max_stats_threads = 16;
+
+/**
+ * @brief Percentile summary of a latency histogram (all values in ns)
+ *
+ * Percentiles are bucket upper bounds (log-linear buckets, <= 12.5% error),
+ * clamped to the observed maximum. All zero if count == 0.
+ */
+struct LatencyStats {
+    uint64_t count{0};
+    uint64_t min_ns{0};
+    uint64_t mean_ns{0};
+    uint64_t p50_ns{0};
+    uint64_t p90_ns{0};
+    uint64_t p99_ns{0};
+    uint64_t p999_ns{0};
+    uint64_t max_ns{0};
+};
+
+/**
+ * @brief Per-input receive statistics
+ */
+struct InputStats {
+    uint64_t received{0};            ///< Messages received on this input
+    uint64_t receive_errors{0};      ///< Failed receives (timeout, deserialization, ...)
+    uint64_t lost{0};                ///< Publisher sequence numbers never received
+    uint64_t duplicated{0};          ///< Sequence numbers received more than once
+    uint64_t reordered{0};           ///< Messages received after a later one
+    uint32_t history_fill{0};        ///< Messages in the history buffer (multi-input only)
+    uint32_t history_capacity{0};    ///< History buffer capacity (0 = no history buffer)
+};
+
+/**
+ * @brief Per-subscriber publishing statistics
+ */
+struct SubscriberStats {
+    uint32_t dest_mailbox{0};        ///< Subscriber DATA mailbox address
+    uint64_t sent{0};                ///< Successful sends
+    uint64_t send_failures{0};       ///< All failed sends (including drops)
+    uint64_t drops{0};               ///< Failed sends because the subscriber's queue was full
+};
+
+/**
+ * @brief CPU time consumed by one module thread
+ */
+struct ThreadStats {
+    sertial::fixed_string<16> name;  ///< "data", "command", "work[i]", "input[i]"
+    uint64_t cpu_time_ns{0};         ///< Thread CPU time (CLOCK_THREAD_CPUTIME_ID domain)
+};
+
+/**
+ * @brief Request runtime statistics from a module
+ *
+ * Sent to a module's WORK mailbox with TimsHeader::reply_to set, e.g. via
+ * RequestClient<SystemRegistry>.
+ */
+struct StatsRequestPayload {
+    uint32_t reserved{0};            ///< Unused, keeps the payload non-empty
+};
+
+/**
+ * @brief Snapshot of a module's runtime statistics
+ */
+struct StatsReplyPayload {
+    sertial::fixed_string<64> module_name;
+    uint64_t uptime_ns{0};           ///< Time since start()
+    uint64_t iterations{0};          ///< Data loop iterations
+    uint64_t sync_failures{0};       ///< Multi-input: secondary inputs could not be synchronized
+    uint64_t dropped_commands{0};    ///< Commands dropped by latest-wins coalescing
+
+    LatencyStats process_time;       ///< Duration of process() calls
+    LatencyStats loop_interval;      ///< Time between consecutive loop iterations
+    LatencyStats period_jitter;      ///< |interval - config.period| (PeriodicInput only)
+
+    sertial::fixed_vector<InputStats, max_stats_inputs> inputs;
+    sertial::fixed_vector<SubscriberStats, max_stats_subscribers> subscribers;
+    sertial::fixed_vector<ThreadStats, max_stats_threads> threads;
+};
+
+// ============================================================================
+// Message Definitions with Compile-Time IDs
+// ============================================================================
+
+using StatsRequest = MessageDefinition<
+    StatsRequestPayload,
+    MessagePrefix::System,
+    SystemSubPrefix::Control,
+    0x0010
+>;
+
+// Reply ID is -0x0010 (RACK-style request/reply pairing)
+using StatsReply = Reply<StatsRequest, StatsReplyPayload>;
+
+// Type aliases for accessing payloads
+using StatsRequestType = typename StatsRequest::Payload;
+using StatsReplyType = typename StatsReply::Payload;
+
+} // namespace commrat
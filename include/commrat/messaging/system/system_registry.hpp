@@ -3,6 +3,8 @@
 #include "../message_id.hpp"
 #include "../message_registry.hpp"
 #include "subscription_messages.hpp"
+#include "stats_messages.hpp"
+#include "flight_messages.hpp"
 
 // Forward declaration for Module (breaks circular dependency)
 namespace commrat {
@@ -24,12 +26,20 @@ namespace commrat {
  * 
  * These messages are used by the framework for subscription protocol
  * and other internal communication. Users don't need to manually include these.
+ * 
+ * StatsRequest/StatsReply and FlightDumpRequest/FlightDumpReply are only
+ * handled on WORK mailboxes, so they are not added to user registries (keeps
+ * CMD/DATA mailboxes at their own max size).
  */
 using SystemRegistry = MessageRegistry<
     SubscribeRequest,
     SubscribeReply,
     UnsubscribeRequest,
-    UnsubscribeReply
+    UnsubscribeReply,
+    StatsRequest,
+    StatsReply,
+    FlightDumpRequest,
+    FlightDumpReply
 >;
 
 // ============================================================================
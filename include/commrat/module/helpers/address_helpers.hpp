@@ -3,6 +3,8 @@
 #include "commrat/module/module_config.hpp"
 #include "commrat/mailbox/mailbox.hpp"
 #include "commrat/messaging/system/system_registry.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <chrono>
 #include <cstdint>
 #include <algorithm>
 
@@ -127,6 +129,17 @@ static constexpr uint32_t get_mailbox_address(uint8_t system_id, uint8_t instanc
     return base | mailbox_index;
 }
 
+/**
+ * @brief WORK mailbox of the producer publishing message_id (subscribe/unsubscribe target)
+ * Format: [message_id low 16 bits][system_id:8][instance_id:8] + MailboxType::WORK,
+ * the base address MailboxSet assigns to each output
+ */
+constexpr uint32_t producer_work_mailbox(uint32_t message_id, uint8_t system_id, uint8_t instance_id) {
+    const uint32_t base = ((message_id & 0xFFFF) << 16) |
+                          (static_cast<uint32_t>(system_id) << 8) | instance_id;
+    return base + static_cast<uint8_t>(MailboxType::WORK);
+}
+
 // ============================================================================
 // Compile-Time Mailbox Sizing
 // ============================================================================
@@ -173,4 +186,29 @@ static inline MailboxConfig createWorkMailboxConfig(const ModuleConfig& config)
     };
 }
 
+// ============================================================================
+// Subscription Helpers
+// ============================================================================
+
+/// Attempts of send_subscribe_request(), 100 ms apart
+constexpr int SUBSCRIBE_ATTEMPTS = 5;
+
+/**
+ * @brief Send a SubscribeRequest, retrying while the producer's mailbox isn't ready yet
+ * @return false if all SUBSCRIBE_ATTEMPTS sends failed
+ */
+template<typename WorkMailboxT>
+bool send_subscribe_request(WorkMailboxT& work_mailbox, const SubscribeRequestPayload& request,
+                            uint32_t producer_work_mbx) {
+    for (int i = 0; i < SUBSCRIBE_ATTEMPTS; ++i) {
+        if (work_mailbox.send(request, producer_work_mbx)) {
+            return true;
+        }
+        if (i < SUBSCRIBE_ATTEMPTS - 1) {
+            Time::sleep(std::chrono::milliseconds(100));
+        }
+    }
+    return false;
+}
+
 } // namespace commrat
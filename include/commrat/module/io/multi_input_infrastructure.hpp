@@ -12,7 +12,10 @@
 #include "commrat/mailbox/historical_mailbox.hpp"
 #include "commrat/module/module_config.hpp"
 #include "commrat/module/helpers/address_helpers.hpp"
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/tracing.hpp"
 #include <iostream>
+#include <string>
 #include <tuple>
 #include <optional>
 #include <thread>
@@ -180,7 +183,10 @@ private:
         
         // Start thread for each input except primary
         ((Is != PrimaryIdx ? 
-          (secondary_input_threads_.emplace_back(&ModuleType::template secondary_input_receive_loop<Is>, &module), true) : 
+          (secondary_input_threads_.push_back(start_thread([&module]() {
+              module.apply_data_thread_config();
+              module.template secondary_input_receive_loop<Is>();
+          })), true) : 
           true), ...);
     }
     
@@ -198,11 +204,20 @@ protected:
         auto& mailbox = std::get<InputIdx>(*input_mailboxes_);
         
         std::cout << "[" << module.config_.name << "] secondary_input_receive_loop[" << InputIdx << "] started\n";
+        auto cpu_scope = module.metrics_.input_thread_scope(InputIdx);
+        Tracer::name_thread(module.config_.name + "/input" + std::to_string(InputIdx));
         
         int receive_count = 0;
         while (module.running_) {
             // Blocking receive - stores in historical buffer automatically
+            TraceSpan receive_span(SpanKind::Receive, module.trace_name_id_);
             auto result = mailbox.template receive<InputType>();
+            module.metrics_.record_receive(InputIdx, result.has_value());
+            if (result.has_value()) {
+                module.metrics_.record_sequence(InputIdx, result.value().header.seq_number);
+                receive_span.set_link(Tracer::continue_trace(result.value().header));
+            }
+            receive_span.end();
             if (!result.has_value()) {
                 std::cout << "[" << module.config_.name << "] secondary_input_receive_loop[" << InputIdx 
                           << "] receive failed after " << receive_count << " messages\n";
@@ -4,6 +4,7 @@
 #include "commrat/module/helpers/address_helpers.hpp"
 #include "commrat/platform/threading.hpp"
 #include <vector>
+#include <memory>
 #include <mutex>
 #include <algorithm>
 #include <iostream>
@@ -60,9 +61,13 @@ protected:
      * Subscriptions are routed based on the subscriber's expected message type ID.
      * 
      * Now stores SubscriberInfo (base_addr + input_index) for multi-input routing.
+     * 
+     * Copy-on-write: (un)subscribing replaces an output's list, publishing
+     * takes a reference to the current one and sends without holding the lock.
      */
-    std::vector<std::vector<SubscriberInfo>> output_subscribers_;
-    mutable Mutex output_subscribers_mutex_;  // Protects output_subscribers_
+    using SubscriberList = std::vector<SubscriberInfo>;
+    std::vector<std::shared_ptr<const SubscriberList>> output_subscribers_;
+    mutable Mutex output_subscribers_mutex_;  // Protects output_subscribers_ (the pointers)
     
     /**
      * @brief Initialize per-output subscriber lists
@@ -71,7 +76,10 @@ protected:
      */
     void initialize_output_subscribers() {
         constexpr std::size_t num_outputs = std::tuple_size_v<OutputTypesTuple>;
-        output_subscribers_.resize(num_outputs);
+        output_subscribers_.clear();
+        for (std::size_t i = 0; i < num_outputs; ++i) {
+            output_subscribers_.push_back(std::make_shared<const SubscriberList>());
+        }
     }
     
     /**
@@ -94,18 +102,24 @@ protected:
             return;
         }
         
-        Lock lock(output_subscribers_mutex_);
-        auto& subs = output_subscribers_[output_idx];
-        
         SubscriberInfo sub_info{subscriber_base_addr, input_index};
-        
-        // Check if already subscribed
-        if (std::find(subs.begin(), subs.end(), sub_info) == subs.end()) {
-            subs.push_back(sub_info);
-            std::cout << "[" << derived().config_.name << "] Added subscriber " << subscriber_base_addr 
-                      << " (input_idx=" << static_cast<int>(input_index) << ") to output[" << output_idx 
-                      << "] (total: " << subs.size() << ")\n";
+        std::size_t total = 0;
+        {
+            Lock lock(output_subscribers_mutex_);
+            auto& subs = output_subscribers_[output_idx];
+            
+            // Check if already subscribed
+            if (std::find(subs->begin(), subs->end(), sub_info) != subs->end()) {
+                return;
+            }
+            auto updated = std::make_shared<SubscriberList>(*subs);
+            updated->push_back(sub_info);
+            total = updated->size();
+            subs = std::move(updated);
         }
+        std::cout << "[" << derived().config_.name << "] Added subscriber " << subscriber_base_addr 
+                  << " (input_idx=" << static_cast<int>(input_index) << ") to output[" << output_idx 
+                  << "] (total: " << total << ")\n";
     }
 
 public:
@@ -116,16 +130,36 @@ public:
      * Used by Publisher to send messages only to relevant subscribers.
      * 
      * @param output_idx Output index (0-based)
-     * @return Copy of subscriber list for that output
+     * @return Copy of subscriber list for that output (allocates; publishing
+     *         uses for_each_output_subscriber() instead)
      */
     std::vector<SubscriberInfo> get_output_subscribers(std::size_t output_idx) const {
-        Lock lock(output_subscribers_mutex_);
-        if (output_idx < output_subscribers_.size()) {
-            return output_subscribers_[output_idx];
+        if (auto subs = output_subscriber_snapshot(output_idx)) {
+            return *subs;
         }
         return {};
     }
     
+    /**
+     * @brief Call fn(const SubscriberInfo&) for each subscriber of an output
+     * 
+     * Iterates the output's current list (copy-on-write snapshot) without
+     * holding the subscriber lock, so sends and error logging in fn never
+     * delay (un)subscribing or another publisher, and the publish path does
+     * not allocate. A subscriber removed meanwhile may still get this message.
+     * 
+     * @param output_idx Output index (0-based)
+     * @param fn Callable invoked once per subscriber
+     */
+    template<typename Fn>
+    void for_each_output_subscriber(std::size_t output_idx, Fn&& fn) const {
+        if (auto subs = output_subscriber_snapshot(output_idx)) {
+            for (const auto& sub : *subs) {
+                fn(sub);
+            }
+        }
+    }
+    
     /**
      * @brief Remove subscriber from all output lists
      * 
@@ -135,17 +169,35 @@ public:
      * @param subscriber_base_addr Subscriber's base mailbox address
      */
     void remove_subscriber(uint32_t subscriber_base_addr) {
+        auto matches = [subscriber_base_addr](const SubscriberInfo& sub) {
+            return sub.base_addr == subscriber_base_addr;
+        };
         Lock lock(output_subscribers_mutex_);
         for (auto& output_subs : output_subscribers_) {
-            auto it = std::remove_if(output_subs.begin(), output_subs.end(),
-                [subscriber_base_addr](const SubscriberInfo& sub) {
-                    return sub.base_addr == subscriber_base_addr;
-                });
-            output_subs.erase(it, output_subs.end());
+            if (std::none_of(output_subs->begin(), output_subs->end(), matches)) {
+                continue;
+            }
+            auto updated = std::make_shared<SubscriberList>(*output_subs);
+            updated->erase(std::remove_if(updated->begin(), updated->end(), matches), updated->end());
+            output_subs = std::move(updated);
         }
     }
 
 private:
+    /**
+     * @brief Current subscriber list of an output (nullptr if out of range)
+     * 
+     * Only the pointer copy (a reference count increment) happens under the lock.
+     */
+    std::shared_ptr<const SubscriberList> output_subscriber_snapshot(std::size_t output_idx) const {
+        Lock lock(output_subscribers_mutex_);
+        if (output_idx < output_subscribers_.size()) {
+            return output_subscribers_[output_idx];
+        }
+        return nullptr;
+    }
+    
+
     /**
      * @brief Find output index by type ID (lower 16 bits of message ID)
      * 
@@ -231,9 +283,9 @@ protected:
      */
     template<std::size_t Index>
     void spawn_output_work_thread() {
-        output_work_threads_.emplace_back([this]() {
+        output_work_threads_.push_back(start_thread([this]() {
             derived().template output_work_loop<Index>();
-        });
+        }));
     }
     
     /**
@@ -286,10 +338,11 @@ protected:
                   << work_mailbox_addr << "\n" << std::flush;
         
         auto& work_mbx = derived().template get_work_mailbox<Index>();
+        auto cpu_scope = derived().metrics_.work_thread_scope(Index);
         
         while (derived().running_) {
             std::cout << "[" << derived().config_.name << "] output_work_loop[" << Index << "]: waiting for message...\n" << std::flush;
-            auto visitor = [this](auto&& tims_msg) {
+            auto visitor = [this, &work_mbx](auto&& tims_msg) {
                 auto& msg = tims_msg.payload;
                 using MsgType = std::decay_t<decltype(msg)>;
                 
@@ -305,6 +358,10 @@ protected:
                     std::cout << "[" << derived().config_.name << "] output_work_loop[" << Index 
                               << "] Handling UnsubscribeRequest\n";
                     derived().handle_unsubscribe_request(msg);
+                } else if constexpr (std::is_same_v<MsgType, StatsRequestType>) {
+                    derived().handle_stats_request(tims_msg.header, work_mbx);
+                } else if constexpr (std::is_same_v<MsgType, FlightDumpRequestType>) {
+                    derived().handle_flight_dump_request(tims_msg.header, work_mbx);
                 }
             };
             
@@ -1,94 +1,229 @@
 /**
  * @file command_dispatcher.hpp
  * @brief Command dispatch mixin for Module
- * 
+ *
  * Extracted from registry_module.hpp Phase 3.
  * Handles user command dispatch to on_command() handlers.
+ *
+ * Request/reply: when the registry pairs a command with Reply<CmdDef, ReplyT>,
+ * the handler returns ReplyT and the dispatcher sends it back to the
+ * requester's mailbox (TimsHeader::reply_to) with the request's correlation id.
+ *
+ * Coalescing: commands registered as Command<T, Coalesce::Latest> are
+ * latest-wins - after each receive the CMD mailbox is drained and only the
+ * newest pending command of that type reaches on_command().
  */
 
 #pragma once
 
+#include "commrat/messages.hpp"
+#include "commrat/module/traits/processor_bases.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <atomic>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <tuple>
 
 namespace commrat {
 
 /**
  * @brief Command dispatcher mixin
- * 
+ *
  * Provides command_loop() and handle_user_command() for modules that accept
  * user commands via the CMD mailbox.
- * 
+ *
+ * Each command type gets its own virtual on_command() via CommandHandlerBase,
+ * so derived classes override exactly the handlers they need:
+ *
+ *   void on_command(const ResetCmd& cmd) override { ... }               // one-way
+ *   GainStatus on_command(const GetGainCmd& cmd) override { ... }       // request/reply
+ *
  * @tparam ModuleType The derived Module class (CRTP)
+ * @tparam UserRegistry Message registry (provides Reply<> pairing and Coalesce policy)
  * @tparam CommandTypes Variadic pack of command payload types
  */
-template<typename ModuleType, typename... CommandTypes>
-class CommandDispatcher {
+template<typename ModuleType, typename UserRegistry, typename... CommandTypes>
+class CommandDispatcher
+    : public CommandHandlerBase<CommandTypes, typename UserRegistry::template reply_type_for<CommandTypes>>... {
+    template<typename CmdT>
+    static constexpr bool is_latest_wins =
+        (std::is_same_v<CmdT, CommandTypes> || ...) &&
+        UserRegistry::template coalesce_policy_for<CmdT> == Coalesce::Latest;
+
+    static constexpr bool has_coalesced_commands = (is_latest_wins<CommandTypes> || ...);
+
+public:
+    /**
+     * @brief Number of CmdT commands dropped by latest-wins coalescing
+     */
+    template<typename CmdT>
+        requires is_latest_wins<CmdT>
+    uint64_t dropped_commands() const {
+        return std::get<LatestSlot<CmdT>>(latest_slots_).dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Total number of commands dropped by latest-wins coalescing
+     */
+    uint64_t dropped_commands() const {
+        return (dropped_in<CommandTypes>() + ... + uint64_t{0});
+    }
+
 protected:
     /**
      * @brief Command loop - receives and dispatches user commands
-     * 
+     *
      * Runs in a dedicated thread, blocking on CMD mailbox receives.
      * Routes commands to on_command() handlers based on payload type.
+     *
+     * With latest-wins commands, every blocking receive is followed by a
+     * non-blocking drain of the CMD mailbox (bounded by cmd_message_slots).
+     * FIFO commands are handled in arrival order during the drain, the
+     * surviving latest-wins commands right after it.
      */
     void command_loop() {
         auto& module = static_cast<ModuleType&>(*this);
         std::cout << "[" << module.config_.name << "] command_loop started\n";
-        
+        auto cpu_scope = module.metrics_.command_thread_scope();
+
         while (module.running_) {
             // Use receive_any with visitor pattern on cmd_mailbox
             // BLOCKING receive - waits indefinitely for user commands
-            auto visitor = [&module](auto&& tims_msg) {
-                // tims_msg is TimsMessage<PayloadT>, extract payload
-                auto& msg = tims_msg.payload;
-                using MsgType = std::decay_t<decltype(msg)>;
-                
-                std::cout << "[" << module.config_.name << "] Received command in command_loop\n";
-                
-                // Handle user command types only
-                module.handle_user_command(msg);
+            auto visitor = [this](auto&& tims_msg) {
+                // tims_msg is TimsMessage<PayloadT>; header carries reply routing
+                route_command(tims_msg);
             };
-            
+
             // BLOCKING receive on command mailbox (no timeout)
             module.cmd_mailbox().receive_any(visitor);
+
+            if constexpr (has_coalesced_commands) {
+                const uint32_t max_drain = module.config_.cmd_message_slots.value();
+                for (uint32_t i = 0; i < max_drain && module.running_; ++i) {
+                    auto result = module.cmd_mailbox().try_receive_any(visitor);
+                    if (!result && result.get_error() != MailboxError::InvalidMessage) {
+                        break;  // Mailbox empty (Timeout) or stopped
+                    }
+                }
+                (flush_latest<CommandTypes>(), ...);
+            }
         }
-        
+
         std::cout << "[" << module.config_.name << "] command_loop ended\n";
     }
-    
+
     /**
      * @brief Dispatch user command to on_command handler
-     * 
+     *
+     * One-way commands call the void handler. Requests call the reply-returning
+     * handler and send the result to header.reply_to (skipped if the sender
+     * did not ask for a reply).
+     *
      * @tparam CmdT Command payload type
-     * @param cmd Command payload
+     * @param tims_msg Received command with header
      */
     template<typename CmdT>
-    void handle_user_command(const CmdT& cmd) {
-        auto& module = static_cast<ModuleType&>(*this);
-        
+    void handle_user_command(const TimsMessage<CmdT>& tims_msg) {
         // Check if this is one of our declared CommandTypes
         if constexpr ((std::is_same_v<CmdT, CommandTypes> || ...)) {
-            module.on_command(cmd);
+            using ReplyT = typename UserRegistry::template reply_type_for<CmdT>;
+            auto& handler = static_cast<CommandHandlerBase<CmdT, ReplyT>&>(*this);
+
+            if constexpr (std::is_void_v<ReplyT>) {
+                handler.on_command(tims_msg.payload);
+            } else {
+                ReplyT reply = handler.on_command(tims_msg.payload);
+                send_reply(tims_msg.header, reply);
+            }
         }
         // Otherwise ignore (not in our command list)
     }
-    
+
+private:
+    // Pending latest-wins command (FIFO commands need no storage)
+    template<typename CmdT, bool = is_latest_wins<CmdT>>
+    struct LatestSlot {};
+
+    template<typename CmdT>
+    struct LatestSlot<CmdT, true> {
+        std::optional<TimsMessage<CmdT>> pending;
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    std::tuple<LatestSlot<CommandTypes>...> latest_slots_;
+
+    template<typename CmdT>
+    uint64_t dropped_in() const {
+        if constexpr (is_latest_wins<CmdT>) {
+            return dropped_commands<CmdT>();
+        } else {
+            return 0;
+        }
+    }
+
     /**
-     * @brief Handle a specific command type (override in derived class)
-     * 
-     * Default implementation does nothing. Derived classes should provide
-     * overloads for each command type they support:
-     * 
-     *   void on_command(const ResetCmd& cmd) override { ... }
-     *   void on_command(const CalibrateCmd& cmd) override { ... }
-     * 
-     * @tparam CmdT Command payload type
-     * @param cmd Command payload
+     * @brief Handle a FIFO command now, or park a latest-wins command
+     *
+     * A parked command that is overwritten before being handled is dropped.
      */
     template<typename CmdT>
-    void on_command(const CmdT& cmd) {
-        // Default: no-op - override in derived classes for specific CommandTypes
-        (void)cmd; // Suppress unused parameter warning
+    void route_command(const TimsMessage<CmdT>& tims_msg) {
+        if constexpr (is_latest_wins<CmdT>) {
+            auto& slot = std::get<LatestSlot<CmdT>>(latest_slots_);
+            if (slot.pending) {
+                slot.dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            slot.pending = tims_msg;
+        } else {
+            handle_user_command(tims_msg);
+        }
+    }
+
+    template<typename CmdT>
+    void flush_latest() {
+        if constexpr (is_latest_wins<CmdT>) {
+            auto& slot = std::get<LatestSlot<CmdT>>(latest_slots_);
+            if (slot.pending) {
+                handle_user_command(*slot.pending);
+                slot.pending.reset();
+            }
+        }
+    }
+
+    /**
+     * @brief Send reply for a request back to the requester
+     *
+     * Uses the CMD mailbox's underlying registry mailbox (reply types are not
+     * part of the CMD mailbox's send-only list).
+     */
+    template<typename ReplyT>
+    void send_reply(const TimsHeader& request_header, ReplyT& reply) {
+        auto& module = static_cast<ModuleType&>(*this);
+
+        if (request_header.reply_to == 0) {
+            return;  // Sender used fire-and-forget send(), nobody is waiting
+        }
+
+        TimsMessage<ReplyT> reply_msg{
+            .header = {
+                .msg_type = UserRegistry::template get_message_id<ReplyT>(),
+                .msg_size = 0,
+                .timestamp = Time::now(),
+                .seq_number = 0,
+                .flags = 0,
+                .correlation_id = request_header.correlation_id,
+                .reply_to = 0
+            },
+            .payload = reply
+        };
+
+        auto result = module.cmd_mailbox().get_underlying_mailbox().send(reply_msg, request_header.reply_to);
+        if (!result) {
+            std::cerr << "[" << module.config_.name << "] Reply send failed to 0x" << std::hex
+                      << request_header.reply_to << std::dec << " (correlation_id="
+                      << request_header.correlation_id << ")\n";
+        }
     }
 };
 
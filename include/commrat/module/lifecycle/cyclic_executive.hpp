@@ -0,0 +1,472 @@
+/**
+ * @file cyclic_executive.hpp
+ * @brief Static time-triggered schedule running several modules on one RT thread
+ *
+ * A CyclicExecutive replaces the free-running data threads of a set of
+ * modules by one thread (SCHED_FIFO and pinned by default) that runs their
+ * iterations in a fixed order. Time is cut into minor frames; each scheduled
+ * module runs in the minor frames where (frame time - offset) is a multiple
+ * of its period. The pattern repeats every major frame (least common
+ * multiple of all periods) and is precomputed as a frame table at start().
+ *
+ * Within a minor frame, modules run in the order of their slots. With slots
+ * in data-flow order, a whole control chain (sensor -> filter -> controller)
+ * runs back to back in one frame: each module publishes as usual, and the
+ * next one finds the message in its mailbox when its step() runs. The phase
+ * between modules and the end-to-end latency are then fixed by the schedule
+ * instead of by thread wake-up order.
+ *
+ * Scheduled modules are started with start_scheduled() (no data thread) and
+ * run through LoopExecutor::step(); see there for the per-input-mode
+ * behavior. Source modules (PeriodicInput/LoopInput) stamp their output
+ * with the scheduled release time.
+ *
+ * A minor frame that finishes after the next frame's release is an overrun.
+ * It is counted and reported to the overrun handler; with
+ * OverrunPolicy::SkipFrames, releases that already passed are skipped so the
+ * schedule stays aligned to the frame grid.
+ */
+
+#pragma once
+
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include "commrat/platform/tracing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace commrat {
+
+/**
+ * @brief What to do after a minor frame overran into the next one
+ */
+enum class OverrunPolicy : uint8_t {
+    SkipFrames,   ///< Skip releases that already passed, resume on the frame grid
+    RunLate       ///< Run every frame, late ones back to back until caught up
+};
+
+/**
+ * @brief One scheduled module
+ */
+struct ScheduleSlot {
+    std::string module;                  ///< Name passed to CyclicExecutive::add()
+    Microseconds period{1000};           ///< Multiple of the minor frame
+    Microseconds offset{0};              ///< Release within the period, multiple of the minor frame
+};
+
+/**
+ * @brief Static schedule and executive thread configuration
+ *
+ * Can be written in code or loaded from JSON (rfl), like ModuleConfig:
+ * @code
+ * {
+ *   "name": "control",
+ *   "minor_frame": 1000,
+ *   "slots": [
+ *     {"module": "imu", "period": 1000, "offset": 0},
+ *     {"module": "estimator", "period": 1000, "offset": 0},
+ *     {"module": "gps", "period": 10000, "offset": 5000}
+ *   ],
+ *   "cpu_affinity": 3
+ * }
+ * @endcode
+ */
+struct CyclicScheduleConfig {
+    std::string name{"cyclic"};
+    Microseconds minor_frame{1000};
+    std::vector<ScheduleSlot> slots;                        ///< Run order within a minor frame
+    ThreadPriority priority{ThreadPriority::REALTIME};
+    SchedulingPolicy policy{SchedulingPolicy::FIFO};
+    int cpu_affinity{-1};                                   ///< -1 = no affinity
+    OverrunPolicy overrun_policy{OverrunPolicy::SkipFrames};
+};
+
+/**
+ * @brief Counters of one slot
+ */
+struct ScheduleSlotStats {
+    std::string module;
+    uint64_t releases{0};        ///< step() calls
+    uint64_t processed{0};       ///< step() calls that ran process()
+    uint64_t max_step_ns{0};     ///< Longest step() including publish
+};
+
+/**
+ * @brief Executive counters (snapshot)
+ */
+struct CyclicExecutiveStats {
+    uint64_t frames{0};                  ///< Minor frames run
+    uint64_t overruns{0};                ///< Frames that ended after the next release
+    uint64_t skipped_frames{0};          ///< Releases skipped (OverrunPolicy::SkipFrames)
+    uint64_t max_frame_ns{0};            ///< Longest minor frame (first step to last step end)
+    uint64_t max_release_delay_ns{0};    ///< Latest wake-up after a frame's release time
+    std::vector<ScheduleSlotStats> slots;
+};
+
+/**
+ * @brief Reported to the overrun handler on the executive thread
+ */
+struct FrameOverrun {
+    uint64_t release_ns;         ///< Release time of the overrunning frame
+    uint64_t end_ns;             ///< When its last step finished
+    std::size_t frame_index;     ///< Minor frame within the major frame
+    uint64_t skipped;            ///< Releases skipped because of it
+};
+
+/**
+ * @brief Time-triggered executor for a static schedule of modules
+ *
+ * Example:
+ * @code
+ * CyclicExecutive executive(CyclicScheduleConfig{
+ *     .name = "control",
+ *     .minor_frame = Microseconds(1000),
+ *     .slots = {
+ *         {.module = "imu", .period = Microseconds(1000)},
+ *         {.module = "controller", .period = Microseconds(1000)},
+ *         {.module = "logger", .period = Microseconds(10000), .offset = Microseconds(5000)}
+ *     },
+ *     .cpu_affinity = 3
+ * });
+ * executive.add("imu", imu);
+ * executive.add("controller", controller);
+ * executive.add("logger", logger);
+ * executive.start();   // start_scheduled() on every module, then the RT thread
+ * // ...
+ * executive.stop();    // Stops the thread, then the modules in reverse order
+ * @endcode
+ *
+ * The modules must outlive the executive's run (stop() or destruction).
+ */
+class CyclicExecutive {
+public:
+    using OverrunHandler = std::function<void(const FrameOverrun&)>;
+
+    explicit CyclicExecutive(CyclicScheduleConfig config)
+        : config_(std::move(config))
+        , minor_ns_(Time::to_nanoseconds(config_.minor_frame))
+        , tasks_(config_.slots.size()) {
+        validate_schedule();
+    }
+
+    ~CyclicExecutive() {
+        stop();
+    }
+
+    CyclicExecutive(const CyclicExecutive&) = delete;
+    CyclicExecutive& operator=(const CyclicExecutive&) = delete;
+
+    /**
+     * @brief Bind a module to the slot named `name`
+     *
+     * @throws std::invalid_argument if there is no such slot or it is bound
+     */
+    template<typename ModuleT>
+    void add(const std::string& name, ModuleT& module) {
+        Task& task = tasks_[slot_index(name)];
+        if (task.step) {
+            throw std::invalid_argument("[CyclicExecutive] Slot '" + name + "' is already bound");
+        }
+        task.start = [&module]() { module.start_scheduled(); };
+        task.stop = [&module]() { module.stop(); };
+        task.step = [&module](uint64_t release_ns, uint64_t period_ns) {
+            return module.step(release_ns, period_ns);
+        };
+    }
+
+    /**
+     * @brief Called on the executive thread after every overrun
+     *
+     * Set before start(). Runs inside the schedule, so it must be short
+     * (e.g. set a flag for a safe-state transition).
+     */
+    void on_overrun(OverrunHandler handler) {
+        overrun_handler_ = std::move(handler);
+    }
+
+    /**
+     * @brief Start the modules (slot order) and the executive thread
+     *
+     * The first release is the next multiple of the major frame on the
+     * Time::now() clock, so executives with the same schedule in different
+     * processes run in phase.
+     *
+     * @throws std::logic_error if a slot has no module
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+        for (std::size_t i = 0; i < tasks_.size(); ++i) {
+            if (!tasks_[i].step) {
+                throw std::logic_error("[CyclicExecutive] No module added for slot '" +
+                                       config_.slots[i].module + "'");
+            }
+        }
+
+        build_frame_table();
+        reset_stats();
+
+        for (auto& task : tasks_) {
+            task.start();
+        }
+
+        running_ = true;
+        // A simulated-time participant: time does not advance mid-frame
+        thread_ = start_thread([this]() {
+            configure_current_thread(ThreadConfig{.name = config_.name,
+                                                  .priority = config_.priority,
+                                                  .policy = config_.policy,
+                                                  .cpu_affinity = config_.cpu_affinity});
+            run();
+        });
+    }
+
+    /**
+     * @brief Stop the executive thread, then the modules (reverse slot order)
+     *
+     * Returns after the current minor frame and at most one minor frame of
+     * real-time sleep. Simulated-time sleeps end at once.
+     */
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        SimulatedClock::interrupt();  // Simulated-time sleeps end without the controller
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        for (auto it = tasks_.rbegin(); it != tasks_.rend(); ++it) {
+            it->stop();
+        }
+    }
+
+    bool is_running() const { return running_; }
+
+    /// Major frame (least common multiple of all slot periods)
+    uint64_t major_frame_ns() const { return major_ns_; }
+
+    /// Minor frames per major frame
+    std::size_t frames_per_major() const { return major_ns_ / minor_ns_; }
+
+    /**
+     * @brief Snapshot of the counters, callable from any thread
+     */
+    CyclicExecutiveStats stats() const {
+        CyclicExecutiveStats stats{
+            .frames = frames_.load(std::memory_order_relaxed),
+            .overruns = overruns_.load(std::memory_order_relaxed),
+            .skipped_frames = skipped_frames_.load(std::memory_order_relaxed),
+            .max_frame_ns = max_frame_ns_.load(std::memory_order_relaxed),
+            .max_release_delay_ns = max_release_delay_ns_.load(std::memory_order_relaxed),
+            .slots = {}
+        };
+        stats.slots.reserve(tasks_.size());
+        for (std::size_t i = 0; i < tasks_.size(); ++i) {
+            stats.slots.push_back(ScheduleSlotStats{
+                .module = config_.slots[i].module,
+                .releases = tasks_[i].releases.load(std::memory_order_relaxed),
+                .processed = tasks_[i].processed.load(std::memory_order_relaxed),
+                .max_step_ns = tasks_[i].max_step_ns.load(std::memory_order_relaxed)
+            });
+        }
+        return stats;
+    }
+
+private:
+    struct Task {
+        std::function<void()> start;
+        std::function<void()> stop;
+        std::function<bool(uint64_t, uint64_t)> step;
+        uint64_t period_ns{0};
+        // Written by the executive thread only
+        std::atomic<uint64_t> releases{0};
+        std::atomic<uint64_t> processed{0};
+        std::atomic<uint64_t> max_step_ns{0};
+    };
+
+    /// Upper bound of the frame table (major frame / minor frame)
+    static constexpr uint64_t max_frames_per_major = 1 << 16;
+
+    std::size_t slot_index(const std::string& name) const {
+        for (std::size_t i = 0; i < config_.slots.size(); ++i) {
+            if (config_.slots[i].module == name) {
+                return i;
+            }
+        }
+        throw std::invalid_argument("[CyclicExecutive] No slot '" + name + "' in schedule " + config_.name);
+    }
+
+    void validate_schedule() {
+        auto fail = [this](const std::string& what) {
+            throw std::invalid_argument("[CyclicExecutive] " + config_.name + ": " + what);
+        };
+        if (minor_ns_ == 0) {
+            fail("minor_frame must be > 0");
+        }
+
+        major_ns_ = minor_ns_;
+        for (std::size_t i = 0; i < config_.slots.size(); ++i) {
+            const ScheduleSlot& slot = config_.slots[i];
+            const uint64_t period_ns = Time::to_nanoseconds(slot.period);
+            const uint64_t offset_ns = Time::to_nanoseconds(slot.offset);
+            if (period_ns == 0 || period_ns % minor_ns_ != 0) {
+                fail("period of '" + slot.module + "' is not a multiple of the minor frame");
+            }
+            if (offset_ns % minor_ns_ != 0 || offset_ns >= period_ns) {
+                fail("offset of '" + slot.module + "' must be a multiple of the minor frame below its period");
+            }
+            for (std::size_t j = 0; j < i; ++j) {
+                if (config_.slots[j].module == slot.module) {
+                    fail("slot '" + slot.module + "' appears twice");
+                }
+            }
+            major_ns_ = std::lcm(major_ns_, period_ns);
+            if (major_ns_ / minor_ns_ > max_frames_per_major) {
+                fail("major frame exceeds " + std::to_string(max_frames_per_major) + " minor frames");
+            }
+            tasks_[i].period_ns = period_ns;
+        }
+    }
+
+    // frame_slots_[frame_begin_[f] .. frame_begin_[f + 1]) = slots released in minor frame f
+    void build_frame_table() {
+        const std::size_t frames = frames_per_major();
+        frame_begin_.assign(frames + 1, 0);
+        frame_slots_.clear();
+        for (std::size_t f = 0; f < frames; ++f) {
+            frame_begin_[f] = static_cast<uint32_t>(frame_slots_.size());
+            const uint64_t t = f * minor_ns_;
+            for (std::size_t i = 0; i < config_.slots.size(); ++i) {
+                const uint64_t offset_ns = Time::to_nanoseconds(config_.slots[i].offset);
+                if (t >= offset_ns && (t - offset_ns) % tasks_[i].period_ns == 0) {
+                    frame_slots_.push_back(static_cast<uint16_t>(i));
+                }
+            }
+        }
+        frame_begin_[frames] = static_cast<uint32_t>(frame_slots_.size());
+    }
+
+    void reset_stats() {
+        frames_ = 0;
+        overruns_ = 0;
+        skipped_frames_ = 0;
+        max_frame_ns_ = 0;
+        max_release_delay_ns_ = 0;
+        for (auto& task : tasks_) {
+            task.releases = 0;
+            task.processed = 0;
+            task.max_step_ns = 0;
+        }
+    }
+
+    static void store_max(std::atomic<uint64_t>& max, uint64_t value) {
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static void increment(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void run() {
+        Tracer::name_thread(config_.name);
+        const std::size_t frames = frames_per_major();
+
+        uint64_t release = (Time::now() / major_ns_ + 1) * major_ns_;
+        std::size_t frame = 0;
+
+        std::cout << "[" << config_.name << "] Cyclic executive started: " << tasks_.size()
+                  << " modules, minor frame " << minor_ns_ / 1000 << "us, "
+                  << frames << " frames per major frame\n";
+
+        // The first release is up to a major frame away: wait in minor frames
+        // so that stop() is not held up
+        for (uint64_t now = Time::now(); running_ && now + minor_ns_ < release; now = Time::now()) {
+            Time::sleep_until(now + minor_ns_, running_);
+        }
+
+        while (running_) {
+            Time::sleep_until(release, running_);  // Absolute on monotonic clocks: no drift from late wakeups
+            if (!running_) {
+                break;
+            }
+
+            const uint64_t frame_start = Time::now();
+            store_max(max_release_delay_ns_, frame_start - std::min(frame_start, release));
+
+            uint64_t step_start = frame_start;
+            for (uint32_t k = frame_begin_[frame]; k < frame_begin_[frame + 1]; ++k) {
+                Task& task = tasks_[frame_slots_[k]];
+                const bool processed = task.step(release, task.period_ns);
+                const uint64_t step_end = Time::now();
+
+                increment(task.releases);
+                if (processed) {
+                    increment(task.processed);
+                }
+                store_max(task.max_step_ns, step_end - std::min(step_end, step_start));
+                step_start = step_end;
+            }
+
+            const uint64_t frame_end = step_start;
+            store_max(max_frame_ns_, frame_end - frame_start);
+            increment(frames_);
+
+            const std::size_t current = frame;
+            const uint64_t current_release = release;
+            release += minor_ns_;
+            frame = (frame + 1) % frames;
+
+            if (frame_end > release) {
+                uint64_t skipped = 0;
+                if (config_.overrun_policy == OverrunPolicy::SkipFrames) {
+                    skipped = (frame_end - release) / minor_ns_ + 1;
+                    release += skipped * minor_ns_;
+                    frame = (frame + skipped) % frames;
+                    increment(skipped_frames_, skipped);
+                }
+                increment(overruns_);
+                if (overrun_handler_) {
+                    overrun_handler_(FrameOverrun{
+                        .release_ns = current_release,
+                        .end_ns = frame_end,
+                        .frame_index = current,
+                        .skipped = skipped
+                    });
+                }
+            }
+        }
+
+        std::cout << "[" << config_.name << "] Cyclic executive stopped after "
+                  << frames_.load() << " frames (" << overruns_.load() << " overruns)\n";
+    }
+
+    CyclicScheduleConfig config_;
+    uint64_t minor_ns_;
+    uint64_t major_ns_{0};
+    std::vector<Task> tasks_;              // One per slot, same order
+    std::vector<uint32_t> frame_begin_;
+    std::vector<uint16_t> frame_slots_;
+    OverrunHandler overrun_handler_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // Written by the executive thread only
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> skipped_frames_{0};
+    std::atomic<uint64_t> max_frame_ns_{0};
+    std::atomic<uint64_t> max_release_delay_ns_{0};
+};
+
+} // namespace commrat
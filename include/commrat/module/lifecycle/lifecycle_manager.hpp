@@ -1,5 +1,7 @@
 #pragma once
 
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -32,8 +34,47 @@ public:
      * 6. Spawn command thread (user command handler)
      * 7. Subscribe to configured input sources
      * 8. Spawn data thread (periodic/loop/continuous/multi-input)
+     * 
+     * Threads are created with start_thread(): stack prefault (off unless
+     * enabled by module_main's realtime memory setup) and simulated time.
+     * The data thread then applies config_.data_thread.
      */
     void start() {
+        start_module(true);
+    }
+    
+    /**
+     * @brief Start the module without its data thread
+     * 
+     * Same sequence as start() except step 8: the module's iterations are run
+     * by a CyclicExecutive through step(). Work, command and secondary input
+     * threads run as usual. stop() is the same for both.
+     */
+    void start_scheduled() {
+        start_module(false);
+    }
+    
+    /**
+     * @brief Apply config_.data_thread (SCHED_FIFO priority, CPU) to the
+     *        calling thread
+     * 
+     * First call of the data thread and the multi-input receive threads, so
+     * the data path runs at the planned priority. A refused change is
+     * reported and the thread keeps running with default scheduling.
+     */
+    void apply_data_thread_config() {
+        auto& module = static_cast<ModuleType&>(*this);
+        const auto& thread = module.config_.data_thread.value();
+        const int priority = thread.rt_priority.value();
+        const int cpu = thread.cpu_affinity.value();
+        if ((priority > 0 || cpu >= 0) && !set_current_thread_scheduling(priority, cpu)) {
+            std::cerr << "[" << module.config_.name << "] Failed to set data thread scheduling (priority "
+                      << priority << ", cpu " << cpu << ")\n";
+        }
+    }
+    
+private:
+    void start_module(bool spawn_data_thread) {
         auto& module = static_cast<ModuleType&>(*this);
         
         if (module.running_) {
@@ -58,6 +99,7 @@ public:
             module.start_input_mailboxes();
         }
         
+        module.metrics_.mark_started(Time::now());
         module.running_ = true;
         module.on_start();
         
@@ -68,7 +110,7 @@ public:
         
         // Start command thread for user commands (only if module has commands)
         if constexpr (module.num_command_types > 0) {
-            module.command_thread_ = std::thread(&ModuleType::command_loop, &module);
+            module.command_thread_ = start_thread([&module]() { module.command_loop(); });
         }
         
         // Give threads time to start
@@ -85,17 +127,36 @@ public:
             }
         }
         
+        if (!spawn_data_thread) {
+            std::cout << "[" << module.config_.name << "] Scheduled externally, no data thread\n";
+            if constexpr (module.has_multi_input) {
+                // Primary input is polled by step(), secondaries fill history as usual
+                constexpr size_t primary_idx = ModuleType::get_primary_input_index();
+                module.template start_secondary_input_threads<primary_idx>();
+            }
+            return;
+        }
+        
         // Start data thread based on input mode
         if constexpr (module.has_periodic_input) {
             std::cout << "[" << module.config_.name << "] Starting periodic_loop thread...\n";
-            module.data_thread_ = std::thread(&ModuleType::periodic_loop, &module);
+            module.data_thread_ = start_thread([&module]() {
+                module.apply_data_thread_config();
+                module.periodic_loop();
+            });
         } else if constexpr (module.has_loop_input) {
             std::cout << "[" << module.config_.name << "] Starting free_loop thread...\n";
-            module.data_thread_ = std::thread(&ModuleType::free_loop, &module);
+            module.data_thread_ = start_thread([&module]() {
+                module.apply_data_thread_config();
+                module.free_loop();
+            });
         } else if constexpr (module.has_multi_input) {
             // Phase 6.6: Multi-input processing
             std::cout << "[" << module.config_.name << "] Starting multi_input_loop thread...\n";
-            module.data_thread_ = std::thread(&ModuleType::multi_input_loop, &module);
+            module.data_thread_ = start_thread([&module]() {
+                module.apply_data_thread_config();
+                module.multi_input_loop();
+            });
             
             // Phase 6.9: Start secondary input receive threads
             // Primary input (index 0) is handled by multi_input_loop's blocking receive
@@ -105,10 +166,14 @@ public:
         } else if constexpr (module.has_continuous_input) {
             // Single continuous input (backward compatible)
             std::cout << "[" << module.config_.name << "] Starting continuous_loop thread...\n";
-            module.data_thread_ = std::thread(&ModuleType::continuous_loop, &module);
+            module.data_thread_ = start_thread([&module]() {
+                module.apply_data_thread_config();
+                module.continuous_loop();
+            });
         }
     }
     
+public:
     /**
      * @brief Stop the module
      * 
@@ -146,6 +211,7 @@ public:
         }
         
         module.running_ = false;
+        SimulatedClock::interrupt();  // Simulated-time sleeps end without the controller
         
         // Wait for threads to finish
         if (module.data_thread_ && module.data_thread_->joinable()) {
@@ -9,14 +9,34 @@
  * - Inputs<T, U, V>: multi_input_loop (synchronized multi-input)
  * 
  * Phase 6.10: All loops use TimsMessage.header.timestamp as single source of truth
+ * 
+ * Every loop records its iteration interval, process() duration and input
+ * receive results in the module's ModuleMetrics (served via StatsRequest).
+ * 
+ * process_offline() runs the input handling of continuous_loop() and
+ * multi_input_loop() for one message taken from a recording, without
+ * mailboxes or threads (offline reprocessing, see recording/reprocessor.hpp).
+ * 
+ * step() runs one non-blocking iteration of any input mode on the caller's
+ * thread, for modules scheduled by a CyclicExecutive (cyclic_executive.hpp).
+ * 
+ * When tracing is enabled (Tracer::enable()), every loop also records
+ * receive/sync/process/publish spans. Source loops start a new trace per
+ * iteration, input loops continue the trace of their (primary) input, so
+ * published messages carry the lineage of the data they were derived from.
  */
 
 #pragma once
 
 #include <commrat/platform/timestamp.hpp>
+#include <commrat/platform/tracing.hpp>
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <optional>
+#include <tuple>
+#include <utility>
 
 namespace commrat {
 
@@ -47,46 +67,54 @@ public:
      * Generates output at fixed intervals (config_.period).
      * Phase 6.10: Captures timestamp at generation moment.
      * 
+     * With config_.tick_alignment enabled, releases are the ticks
+     * k * period + phase_us of the Time::now() clock instead, and the tick
+     * is the output timestamp. Aligned producers of the same period then
+     * publish identical timestamps (or a fixed phase apart) in every
+     * process. An iteration that runs past the next tick skips to the
+     * first tick after it. Ticks are absolute sleeps on monotonic clocks
+     * (Time::sleep_until), so a late wakeup does not shift the next one.
+     * 
      * Used for: PeriodicInput modules
      */
     void periodic_loop() {
         auto& mod = module();
         std::cout << "[" << mod.config_.name << "] periodic_loop started, period=" 
                   << mod.config_.period.count() << "ms\n";
+        auto cpu_scope = mod.metrics_.data_thread_scope();
+        Tracer::name_thread(mod.config_.name + "/data");
+        const uint64_t period_ns = Time::to_nanoseconds(mod.config_.period);
+        
+        const TickAlignmentConfig& alignment = mod.config_.tick_alignment.value();
+        const bool aligned = alignment.enabled.value() && period_ns > 0;
+        const uint64_t phase_ns = Time::microseconds_to_ns(alignment.phase_us.value());
+        uint64_t release = aligned ? Time::next_tick(Time::now(), period_ns, phase_ns) : 0;
         
         uint32_t iteration = 0;
         while (mod.running_) {
+            if (aligned) {
+                Time::sleep_until(release, mod.running_);
+                if (!mod.running_) {
+                    break;
+                }
+            }
             if (iteration < 3) {
                 std::cout << "[" << mod.config_.name << "] periodic_loop iteration " << iteration << "\n";
             }
             
             // Phase 6.10: Capture timestamp at data generation moment
-            uint64_t generation_timestamp = Time::now();
+            // Aligned: stamped with the release, metrics see the actual wake-up
+            const uint64_t wake_timestamp = Time::now();
+            uint64_t generation_timestamp = aligned ? release : wake_timestamp;
+            mod.metrics_.record_loop_start(wake_timestamp, period_ns);
+            
+            produce(generation_timestamp, wake_timestamp);
             
-            if constexpr (ModuleType::has_multi_output) {
-                // Multi-output: create tuple and call process with references
-                typename ModuleType::OutputTypesTuple outputs{};
-                // Unpack tuple and call multi-output process(Ts&...) via virtual dispatch
-                // Must use MultiOutputProcessorBase explicitly to avoid ambiguity with SingleOutputProcessorBase
-                using MultiOutBase = MultiOutputProcessorBase<
-                    typename ModuleType::OutputTypesTuple,
-                    typename ModuleType::InputData
-                >;
-                std::apply([&mod](auto&... args) { 
-                    static_cast<MultiOutBase&>(mod).process(args...);
-                }, outputs);
-                // Phase 6.10: Publish with automatic header.timestamp
-                mod.publish_multi_outputs_with_timestamp(outputs, generation_timestamp);
+            if (aligned) {
+                release = Time::next_tick(std::max(Time::now(), release + period_ns), period_ns, phase_ns);
             } else {
-                // Single output: call process() with output reference
-                typename ModuleType::OutputData output{};
-                mod.process(output);  // Virtual call to derived class
-                // Phase 6.10: Wrap in TimsMessage with header.timestamp = generation time
-                auto tims_msg = mod.create_tims_message(std::move(output), generation_timestamp);
-                mod.publish_tims_message(tims_msg);
+                Time::sleep(mod.config_.period, mod.running_);
             }
-            
-            std::this_thread::sleep_for(mod.config_.period);
             iteration++;
         }
         
@@ -103,31 +131,15 @@ public:
      */
     void free_loop() {
         auto& mod = module();
+        auto cpu_scope = mod.metrics_.data_thread_scope();
+        Tracer::name_thread(mod.config_.name + "/data");
         
         while (mod.running_) {
             // Phase 6.10: Capture timestamp at data generation moment
             uint64_t generation_timestamp = Time::now();
+            mod.metrics_.record_loop_start(generation_timestamp);
             
-            if constexpr (ModuleType::has_multi_output) {
-                // Multi-output: create tuple and call process with references
-                typename ModuleType::OutputTypesTuple outputs{};
-                // Must use MultiOutputProcessorBase explicitly to avoid ambiguity
-                using MultiOutBase = MultiOutputProcessorBase<
-                    typename ModuleType::OutputTypesTuple,
-                    typename ModuleType::InputData
-                >;
-                std::apply([&mod](auto&... args) { 
-                    static_cast<MultiOutBase&>(mod).process(args...);
-                }, outputs);
-                mod.publish_multi_outputs_with_timestamp(outputs, generation_timestamp);
-            } else {
-                // Single output: call process() with virtual dispatch
-                // TODO: think about where to buffer output memory
-                typename ModuleType::OutputData output{};
-                mod.process(output);
-                auto tims_msg = mod.create_tims_message(std::move(output), generation_timestamp);
-                mod.publish_tims_message(tims_msg);
-            }
+            produce(generation_timestamp, generation_timestamp);
         }
     }
     
@@ -142,21 +154,23 @@ public:
     void continuous_loop() {
         auto& mod = module();
         std::cout << "[" << mod.config_.name << "] continuous_loop started, waiting for data...\n";
+        auto cpu_scope = mod.metrics_.data_thread_scope();
+        Tracer::name_thread(mod.config_.name + "/data");
+        const uint16_t trace_name = mod.trace_name_id_;
         
         while (mod.running_) {
             // BLOCKING receive on data mailbox - no timeout, waits for data
+            TraceSpan receive_span(SpanKind::Receive, trace_name);
             auto result = mod.data_mailbox_->template receive<typename ModuleType::InputData>();
+            mod.metrics_.record_receive(0, static_cast<bool>(result));
             
             if (result) {
-                // Phase 6.10: Populate metadata BEFORE process call
-                // Single continuous input always uses index 0
-                mod.update_input_metadata(0, result.value(), true);  // Always new data for continuous
+                mod.metrics_.record_sequence(0, result->header.seq_number);
+                // Continue the producer's causal chain
+                receive_span.set_link(Tracer::continue_trace(result->header));
+                receive_span.end();
                 
-                typename ModuleType::OutputData output{};
-                mod.process_dispatch(result->payload, output);
-                // Phase 6.10: Use input timestamp from header (data validity time)
-                auto tims_msg = mod.create_tims_message(std::move(output), result->header.timestamp);
-                mod.publish_tims_message(tims_msg);
+                consume(result.value());
             }
         }
         
@@ -182,6 +196,9 @@ public:
         // Identify primary input index
         constexpr size_t primary_idx = ModuleType::get_primary_input_index();
         std::cout << "[" << mod.config_.name << "] Primary input index: " << primary_idx << "\n";
+        auto cpu_scope = mod.metrics_.data_thread_scope();
+        Tracer::name_thread(mod.config_.name + "/data");
+        const uint16_t trace_name = mod.trace_name_id_;
         
         uint32_t loop_iteration = 0;
         while (mod.running_) {
@@ -191,7 +208,9 @@ public:
                           << loop_iteration << ")\n";
             }
             
+            TraceSpan receive_span(SpanKind::Receive, trace_name);
             auto primary_result = mod.template receive_primary_input<primary_idx>();
+            mod.metrics_.record_receive(primary_idx, primary_result.has_value());
             
             if (!primary_result.has_value()) {
                 if (loop_iteration < 3) {
@@ -205,43 +224,264 @@ public:
                 std::cout << "[" << mod.config_.name << "] Primary input received!\n";
             }
             
-            // Phase 6.10: Populate primary metadata
-            mod.update_input_metadata(0, primary_result.value(), true);
+            mod.metrics_.record_sequence(primary_idx, primary_result->header.seq_number);
             
-            // Step 2: Sync all secondary inputs
-            auto all_inputs = mod.template gather_all_inputs<primary_idx>(primary_result.value());
+            // Simulated time: let secondaries of this instant arrive first
+            SimulatedClock::settle(&mod.running_);
             
-            if (!all_inputs) {
-                if (loop_iteration < 3) {
-                    std::cout << "[" << mod.config_.name << "] Failed to sync inputs\n";
-                }
-                loop_iteration++;
-                continue;
-            }
+            // Outputs continue the primary input's causal chain (like its timestamp)
+            receive_span.set_link(Tracer::continue_trace(primary_result->header));
+            receive_span.end();
             
-            if (loop_iteration < 3) {
-                std::cout << "[" << mod.config_.name << "] All inputs synced, calling process()\n";
+            // Sync secondaries at the primary timestamp, process and publish
+            if (!consume_primary<primary_idx>(primary_result.value()) && loop_iteration < 3) {
+                std::cout << "[" << mod.config_.name << "] Failed to sync inputs\n";
             }
             
-            // Phase 6.10: Extract primary timestamp (synchronization point)
-            uint64_t primary_timestamp = primary_result->header.timestamp;
+            loop_iteration++;
+        }
+        
+        std::cout << "[" << mod.config_.name << "] multi_input_loop ended\n";
+    }
+    
+    /**
+     * @brief Scheduled step - one iteration run by a CyclicExecutive
+     * 
+     * Runs on the executive's thread instead of a data thread (module
+     * started with start_scheduled()) and never blocks:
+     * - PeriodicInput/LoopInput: one process() call, output timestamp is
+     *   the scheduled release time, so it does not depend on thread wake-up
+     * - Input<T>: processes the newest pending message; older pending
+     *   messages are counted as received and skipped
+     * - Inputs<...>: moves all pending primary messages into the primary's
+     *   history and processes the newest one; secondaries are synced from
+     *   history as in multi_input_loop() (their receive threads still run)
+     * 
+     * Outputs are published as usual. A consumer scheduled later in the
+     * same frame finds them in its mailbox.
+     * 
+     * @param release_ns Scheduled release time of this step
+     * @param period_ns Scheduled period of the module (jitter metrics,
+     *        measured from the actual step start)
+     * @return true if process() ran
+     */
+    bool step(uint64_t release_ns, [[maybe_unused]] uint64_t period_ns) {
+        auto& mod = module();
+        
+        if constexpr (ModuleType::has_periodic_input || ModuleType::has_loop_input) {
+            // Jitter of the actual step start, not of the ideal release
+            const uint64_t step_start = Time::now();
+            mod.metrics_.record_loop_start(step_start, period_ns);
+            produce(release_ns, step_start);
+            return true;
+        } else if constexpr (ModuleType::has_multi_input) {
+            constexpr size_t primary_idx = ModuleType::get_primary_input_index();
+            using PrimaryType = std::tuple_element_t<primary_idx, typename ModuleType::InputTypesTuple>;
+            auto& primary_mailbox = std::get<primary_idx>(*mod.input_mailboxes_);
             
-            // Step 3: Call process with all inputs
-            if constexpr (ModuleType::has_multi_output) {
-                typename ModuleType::OutputTypesTuple outputs{};
-                mod.call_multi_input_multi_output_process(*all_inputs, outputs);
-                mod.publish_multi_outputs_with_timestamp(outputs, primary_timestamp);
+            // Drain: every primary message goes to history, the newest is processed
+            std::optional<TimsMessage<PrimaryType>> newest;
+            while (auto result = primary_mailbox.template try_receive<PrimaryType>()) {
+                mod.metrics_.record_receive(primary_idx, true);
+                mod.metrics_.record_sequence(primary_idx, result->header.seq_number);
+                newest = std::move(result.value());
+            }
+            if (!newest) {
+                return false;
+            }
+            Tracer::continue_trace(newest->header);
+            return consume_primary<primary_idx>(*newest);
+        } else {
+            static_assert(ModuleType::has_continuous_input, "step() needs a module with an input mode");
+            std::optional<TimsMessage<typename ModuleType::InputData>> newest;
+            while (auto result = mod.data_mailbox_->template try_receive<typename ModuleType::InputData>()) {
+                mod.metrics_.record_receive(0, true);
+                mod.metrics_.record_sequence(0, result->header.seq_number);
+                newest = std::move(result.value());
+            }
+            if (!newest) {
+                return false;
+            }
+            Tracer::continue_trace(newest->header);
+            consume(*newest);
+            return true;
+        }
+    }
+    
+    /**
+     * @brief Offline step - feed one message of input InputIdx, no mailboxes
+     * 
+     * Same metadata, history and sync handling as continuous_loop() /
+     * multi_input_loop(), but the message comes from the caller and every
+     * output is passed to `emit(output_index, TimsMessage<O>&)` instead of
+     * being published. The module does not need to be started; time-related
+     * behavior follows Time::now() of the calling thread (VirtualTimeScope).
+     * 
+     * Multi-input: secondary messages only go to their history buffer, a
+     * primary message triggers sync and process().
+     * 
+     * @tparam InputIdx Index in Inputs<...> (0 for Input<T>)
+     * @return true if process() ran
+     */
+    template<std::size_t InputIdx, typename T, typename Emit>
+    bool process_offline(const TimsMessage<T>& msg, Emit&& emit) {
+        auto& mod = module();
+        
+        if constexpr (ModuleType::has_multi_input) {
+            constexpr size_t primary_idx = ModuleType::get_primary_input_index();
+            std::get<InputIdx>(*mod.input_mailboxes_).store(msg);
+            if constexpr (InputIdx != primary_idx) {
+                return false;
             } else {
-                typename ModuleType::OutputData output{};
-                mod.call_multi_input_process(*all_inputs, output);
-                auto tims_msg = mod.create_tims_message(std::move(output), primary_timestamp);
-                mod.publish_tims_message(tims_msg);
+                mod.update_input_metadata(0, msg, true);
+                auto all_inputs = mod.template gather_all_inputs<primary_idx>(msg);
+                if (!all_inputs) {
+                    mod.metrics_.record_sync_failure();
+                    return false;
+                }
+                if constexpr (ModuleType::has_multi_output) {
+                    typename ModuleType::OutputTypesTuple outputs{};
+                    mod.call_multi_input_multi_output_process(*all_inputs, outputs);
+                    emit_offline_outputs(outputs, msg.header.timestamp, emit,
+                                         std::make_index_sequence<std::tuple_size_v<typename ModuleType::OutputTypesTuple>>{});
+                } else {
+                    typename ModuleType::OutputData output{};
+                    mod.call_multi_input_process(*all_inputs, output);
+                    auto tims_msg = mod.create_tims_message(std::move(output), msg.header.timestamp);
+                    emit(std::size_t{0}, tims_msg);
+                }
+                return true;
             }
-            
-            loop_iteration++;
+        } else {
+            static_assert(ModuleType::has_continuous_input && InputIdx == 0,
+                          "process_offline() needs an Input<T> or Inputs<...> module");
+            mod.update_input_metadata(0, msg, true);
+            typename ModuleType::OutputData output{};
+            mod.process_dispatch(msg.payload, output);
+            auto tims_msg = mod.create_tims_message(std::move(output), msg.header.timestamp);
+            emit(std::size_t{0}, tims_msg);
+            return true;
         }
+    }
+    
+private:
+    // Source iteration: process() and publish with the given timestamp
+    void produce(uint64_t timestamp, uint64_t process_start) {
+        auto& mod = module();
+        const uint16_t trace_name = mod.trace_name_id_;
         
-        std::cout << "[" << mod.config_.name << "] multi_input_loop ended\n";
+        // Source module: every iteration starts a new causal chain
+        Tracer::start_trace();
+        TraceSpan loop_span(SpanKind::Loop, trace_name);
+        TraceSpan process_span(SpanKind::Process, trace_name);
+        
+        if constexpr (ModuleType::has_multi_output) {
+            // Multi-output: create tuple and call process with references
+            typename ModuleType::OutputTypesTuple outputs{};
+            // Unpack tuple and call multi-output process(Ts&...) via virtual dispatch
+            // Must use MultiOutputProcessorBase explicitly to avoid ambiguity with SingleOutputProcessorBase
+            using MultiOutBase = MultiOutputProcessorBase<
+                typename ModuleType::OutputTypesTuple,
+                typename ModuleType::InputData
+            >;
+            std::apply([&mod](auto&... args) { 
+                static_cast<MultiOutBase&>(mod).process(args...);
+            }, outputs);
+            mod.metrics_.record_process_time(process_start, Time::now());
+            process_span.end();
+            // Phase 6.10: Publish with automatic header.timestamp
+            TraceSpan publish_span(SpanKind::Publish, trace_name);
+            mod.publish_multi_outputs_with_timestamp(outputs, timestamp);
+        } else {
+            // Single output: call process() with output reference
+            typename ModuleType::OutputData output{};
+            mod.process(output);  // Virtual call to derived class
+            mod.metrics_.record_process_time(process_start, Time::now());
+            process_span.end();
+            // Phase 6.10: Wrap in TimsMessage with header.timestamp = generation time
+            TraceSpan publish_span(SpanKind::Publish, trace_name);
+            auto tims_msg = mod.create_tims_message(std::move(output), timestamp);
+            mod.publish_tims_message(tims_msg);
+        }
+    }
+    
+    // Single input: process() one received message and publish
+    template<typename InputMsg>
+    void consume(const InputMsg& msg) {
+        auto& mod = module();
+        const uint16_t trace_name = mod.trace_name_id_;
+        
+        uint64_t process_start = Time::now();
+        mod.metrics_.record_loop_start(process_start);
+        
+        // Phase 6.10: Populate metadata BEFORE process call
+        // Single continuous input always uses index 0
+        mod.update_input_metadata(0, msg, true);  // Always new data for continuous
+        
+        TraceSpan process_span(SpanKind::Process, trace_name, msg.header.span_id);
+        typename ModuleType::OutputData output{};
+        mod.process_dispatch(msg.payload, output);
+        mod.metrics_.record_process_time(process_start, Time::now());
+        process_span.end();
+        // Phase 6.10: Use input timestamp from header (data validity time)
+        TraceSpan publish_span(SpanKind::Publish, trace_name);
+        auto tims_msg = mod.create_tims_message(std::move(output), msg.header.timestamp);
+        mod.publish_tims_message(tims_msg);
+    }
+    
+    // Multi-input: sync secondaries to a primary message, process() and publish
+    // Returns false if the secondaries could not be synced
+    template<std::size_t PrimaryIdx, typename PrimaryMsg>
+    bool consume_primary(const PrimaryMsg& primary_msg) {
+        auto& mod = module();
+        const uint16_t trace_name = mod.trace_name_id_;
+        
+        // Phase 6.10: Populate primary metadata
+        mod.update_input_metadata(0, primary_msg, true);
+        
+        // Sync all secondary inputs
+        TraceSpan sync_span(SpanKind::Sync, trace_name);
+        auto all_inputs = mod.template gather_all_inputs<PrimaryIdx>(primary_msg);
+        sync_span.end();
+        
+        if (!all_inputs) {
+            mod.metrics_.record_sync_failure();
+            return false;
+        }
+        
+        // Phase 6.10: Extract primary timestamp (synchronization point)
+        uint64_t primary_timestamp = primary_msg.header.timestamp;
+        uint64_t process_start = Time::now();
+        mod.metrics_.record_loop_start(process_start);
+        
+        // Call process with all inputs
+        TraceSpan process_span(SpanKind::Process, trace_name, primary_msg.header.span_id);
+        if constexpr (ModuleType::has_multi_output) {
+            typename ModuleType::OutputTypesTuple outputs{};
+            mod.call_multi_input_multi_output_process(*all_inputs, outputs);
+            mod.metrics_.record_process_time(process_start, Time::now());
+            process_span.end();
+            TraceSpan publish_span(SpanKind::Publish, trace_name);
+            mod.publish_multi_outputs_with_timestamp(outputs, primary_timestamp);
+        } else {
+            typename ModuleType::OutputData output{};
+            mod.call_multi_input_process(*all_inputs, output);
+            mod.metrics_.record_process_time(process_start, Time::now());
+            process_span.end();
+            TraceSpan publish_span(SpanKind::Publish, trace_name);
+            auto tims_msg = mod.create_tims_message(std::move(output), primary_timestamp);
+            mod.publish_tims_message(tims_msg);
+        }
+        return true;
+    }
+    
+    template<typename Outputs, typename Emit, std::size_t... Is>
+    void emit_offline_outputs(Outputs& outputs, uint64_t timestamp, Emit& emit, std::index_sequence<Is...>) {
+        auto& mod = module();
+        ((void)[&] {
+            auto tims_msg = mod.create_tims_message(std::move(std::get<Is>(outputs)), timestamp);
+            emit(Is, tims_msg);
+        }(), ...);
     }
 };
 
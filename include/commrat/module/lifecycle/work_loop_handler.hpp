@@ -1,6 +1,8 @@
 #pragma once
 
 #include "commrat/messaging/system/subscription_messages.hpp"
+#include "commrat/messaging/system/stats_messages.hpp"
+#include "commrat/messaging/system/flight_messages.hpp"
 #include "commrat/module/helpers/address_helpers.hpp"
 #include <iostream>
 #include <type_traits>
@@ -14,6 +16,8 @@ namespace commrat {
  * - SubscribeRequest: Producer receives subscription from consumer
  * - SubscribeReply: Consumer receives acknowledgment from producer
  * - UnsubscribeRequest: Producer receives unsubscription from consumer
+ * - StatsRequest: Tool requests the module's runtime statistics
+ * - FlightDumpRequest: Tool requests a flight recorder dump of the process
  * 
  * This is the main dispatch loop for the subscription protocol.
  * Runs in a dedicated thread spawned by LifecycleManager.
@@ -33,12 +37,15 @@ protected:
      * - SubscribeRequest: Add subscriber to output list
      * - SubscribeReply: Confirm subscription established
      * - UnsubscribeRequest: Remove subscriber from output list
+     * - StatsRequest: Reply with runtime statistics
+     * - FlightDumpRequest: Dump the process's flight recorder and reply
      */
     void work_loop() {
         auto& module = static_cast<ModuleType&>(*this);
         
         // Just print a simple message - the address details aren't critical for the log
         std::cout << "[" << module.config_.name << "] work_loop started on WORK mailbox\n" << std::flush;
+        auto cpu_scope = module.metrics_.work_thread_scope(0);
         
         while (module.running_) {
             // Use receive_any with visitor pattern on work_mailbox
@@ -60,6 +67,10 @@ protected:
                 } else if constexpr (std::is_same_v<MsgType, UnsubscribeRequestType>) {
                     std::cout << "[" << module.config_.name << "] Handling UnsubscribeRequest\n";
                     module.handle_unsubscribe_request(msg);
+                } else if constexpr (std::is_same_v<MsgType, StatsRequestType>) {
+                    module.handle_stats_request(tims_msg.header, module.work_mailbox());
+                } else if constexpr (std::is_same_v<MsgType, FlightDumpRequestType>) {
+                    module.handle_flight_dump_request(tims_msg.header, module.work_mailbox());
                 }
             };
             
@@ -39,6 +39,9 @@ struct InputMetadata {
     uint32_t message_id;         ///< Message type ID
     bool is_new_data;            ///< True if freshly received, false if stale/reused
     bool is_valid;               ///< True if getData succeeded, false if failed
+    uint64_t lost;               ///< Publisher sequence numbers never received on this input
+    uint64_t duplicated;         ///< Sequence numbers received more than once
+    uint64_t reordered;          ///< Messages received after a later one
     
     // Helper to get input type (for debugging/logging)
     static constexpr const char* type_name() { return typeid(T).name(); }
@@ -4,6 +4,11 @@
  * 
  * Phase 6.10: Provides get_input_metadata, get_input_timestamp, has_new_data,
  * and is_input_valid accessors for both index-based and type-based access.
+ * 
+ * The lost/duplicated/reordered counters come from the input's
+ * SequenceTracker (ModuleMetrics), updated by the thread receiving the
+ * input - for secondary inputs that is every message, not only the ones
+ * getData() picks.
  */
 
 #pragma once
@@ -48,6 +53,9 @@ public:
         uint32_t message_id;         ///< Message type ID
         bool is_new_data;            ///< True if freshly received, false if stale/reused
         bool is_valid;               ///< True if getData succeeded, false if failed
+        uint64_t lost;               ///< Publisher sequence numbers never received on this input
+        uint64_t duplicated;         ///< Sequence numbers received more than once
+        uint64_t reordered;          ///< Messages received after a later one
         
         // Helper to get input type (for debugging/logging)
         static constexpr const char* type_name() { return typeid(T).name(); }
@@ -86,13 +94,24 @@ public:
         >;
         
         const auto& storage = module().input_metadata_[Index];
-        return InputMetadata<InputType>{
+        InputMetadata<InputType> metadata{
             .timestamp = storage.timestamp,
             .sequence_number = storage.sequence_number,
             .message_id = storage.message_id,
             .is_new_data = storage.is_new_data,
-            .is_valid = storage.is_valid
+            .is_valid = storage.is_valid,
+            .lost = 0,
+            .duplicated = 0,
+            .reordered = 0
         };
+        // Inputs beyond max_stats_inputs are not tracked
+        if constexpr (Index < ModuleType::MetricsType::num_inputs) {
+            const auto& sequence = module().metrics().input(Index).sequence;
+            metadata.lost = sequence.lost();
+            metadata.duplicated = sequence.duplicated();
+            metadata.reordered = sequence.reordered();
+        }
+        return metadata;
     }
     
     /**
@@ -0,0 +1,581 @@
+/**
+ * @file module_metrics.hpp
+ * @brief Per-module runtime metrics (counters, latency histograms, input
+ *        sequence tracking, thread CPU time)
+ *
+ * Every metric has exactly one writer thread (data loop, secondary input
+ * receive thread, ...) and sits on its own cache line, so recording is a few
+ * relaxed loads/stores with no locked instructions and no false sharing.
+ * Readers (StatsRequest handler on the WORK thread) may run concurrently and
+ * see a slightly torn but never corrupted snapshot.
+ *
+ * Served through StatsRequest/StatsReply on each module's WORK mailbox.
+ */
+
+#pragma once
+
+#include "commrat/mailbox/mailbox.hpp"
+#include "commrat/messaging/system/stats_messages.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <pthread.h>
+
+namespace commrat {
+
+/// Cache line size used to pad per-thread metrics
+inline constexpr std::size_t cache_line_size = 64;
+
+// ============================================================================
+// Building Blocks
+// ============================================================================
+
+/**
+ * @brief Single-writer counter on its own cache line
+ *
+ * increment() must only be called from one thread; value() from any thread.
+ */
+struct alignas(cache_line_size) PaddedCounter {
+    std::atomic<uint64_t> count{0};
+
+    void increment(uint64_t n = 1) noexcept {
+        count.store(count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const noexcept { return count.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Single-writer log-linear latency histogram
+ *
+ * Values below 8 get exact buckets, above that every power of two is split
+ * into 8 linear sub-buckets (relative error <= 12.5%). Covers the full
+ * uint64_t range in 496 buckets, record() is O(1) and allocation-free.
+ */
+class alignas(cache_line_size) LatencyHistogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 3;
+    static constexpr uint64_t sub_buckets = uint64_t{1} << sub_bucket_bits;
+    static constexpr std::size_t num_buckets = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    /**
+     * @brief Record one value (single writer)
+     */
+    void record(uint64_t value) noexcept {
+        bump(buckets_[bucket_index(value)], 1);
+        bump(count_, 1);
+        bump(sum_, value);
+        if (value < min_.load(std::memory_order_relaxed)) {
+            min_.store(value, std::memory_order_relaxed);
+        }
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add all values recorded by another histogram
+     *
+     * Same single-writer rule as record(); the writer of @p other must
+     * have stopped (e.g. per-thread histograms merged after join()).
+     */
+    void merge(const LatencyHistogram& other) noexcept {
+        if (other.count() == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            bump(buckets_[i], other.buckets_[i].load(std::memory_order_relaxed));
+        }
+        bump(count_, other.count());
+        bump(sum_, other.sum_.load(std::memory_order_relaxed));
+        if (other.min_.load(std::memory_order_relaxed) < min_.load(std::memory_order_relaxed)) {
+            min_.store(other.min_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        if (other.max_.load(std::memory_order_relaxed) > max_.load(std::memory_order_relaxed)) {
+            max_.store(other.max_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Value at quantile q (0.0 - 1.0), 0 if empty
+     */
+    uint64_t percentile(double q) const noexcept {
+        uint64_t total = 0;
+        for (const auto& bucket : buckets_) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+        rank = (rank == 0) ? 1 : (rank > total ? total : rank);
+
+        uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            cumulative += buckets_[i].load(std::memory_order_relaxed);
+            if (cumulative >= rank) {
+                uint64_t upper = bucket_upper_bound(i);
+                uint64_t max = max_.load(std::memory_order_relaxed);
+                return upper < max ? upper : max;
+            }
+        }
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Percentile summary for StatsReply
+     */
+    LatencyStats summary() const noexcept {
+        LatencyStats stats;
+        stats.count = count();
+        if (stats.count == 0) {
+            return stats;
+        }
+        stats.min_ns = min_.load(std::memory_order_relaxed);
+        stats.max_ns = max_.load(std::memory_order_relaxed);
+        stats.mean_ns = sum_.load(std::memory_order_relaxed) / stats.count;
+        stats.p50_ns = percentile(0.50);
+        stats.p90_ns = percentile(0.90);
+        stats.p99_ns = percentile(0.99);
+        stats.p999_ns = percentile(0.999);
+        return stats;
+    }
+
+    static constexpr std::size_t bucket_index(uint64_t value) noexcept {
+        if (value < sub_buckets) {
+            return static_cast<std::size_t>(value);
+        }
+        unsigned msb = 63 - static_cast<unsigned>(std::countl_zero(value));
+        unsigned shift = msb - sub_bucket_bits;
+        return static_cast<std::size_t>((msb - sub_bucket_bits + 1) * sub_buckets +
+                                        ((value >> shift) & (sub_buckets - 1)));
+    }
+
+    static constexpr uint64_t bucket_upper_bound(std::size_t index) noexcept {
+        if (index < sub_buckets) {
+            return index;
+        }
+        unsigned shift = static_cast<unsigned>(index / sub_buckets) - 1;
+        uint64_t lower = (sub_buckets + index % sub_buckets) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+    std::array<std::atomic<uint64_t>, num_buckets> buckets_{};
+};
+
+/**
+ * @brief Single-writer loss, duplicate and reorder detection
+ *
+ * Fed with TimsHeader::seq_number of every message received on one input.
+ * Publishers number each output 1, 2, 3, ... (0 is skipped on wrap-around
+ * and means "unsequenced", which is ignored). The last `window` numbers
+ * below the highest one seen are remembered, so a number arriving late is
+ * classified exactly: seen before -> duplicate, otherwise reordered (and no
+ * longer counted as lost). Numbers below the first one received since the
+ * last (re)sync were never counted as lost: they are reordered without
+ * changing lost(). A 1 or a number further back than the window is a
+ * publisher restart; counting resumes from it.
+ */
+class alignas(cache_line_size) SequenceTracker {
+public:
+    static constexpr uint32_t window = 64;
+
+    enum class Result : uint8_t {
+        InOrder,
+        Gap,            ///< Numbers were skipped (counted in lost())
+        Duplicate,
+        Reordered,      ///< Arrived after a higher number
+        Restart,
+        Unsequenced
+    };
+
+    /**
+     * @brief Classify one received sequence number (single writer)
+     */
+    Result record(uint32_t seq) noexcept {
+        if (seq == 0) {
+            return Result::Unsequenced;
+        }
+        if (highest_ == 0) {
+            resync(seq);
+            return Result::InOrder;
+        }
+        // Distance in serial number arithmetic, without the skipped 0
+        int64_t distance = static_cast<int32_t>(seq - highest_);
+        if (distance > 0 && seq < highest_) {
+            --distance;
+        } else if (distance < 0 && seq > highest_) {
+            ++distance;
+        }
+
+        if (distance > 0) {
+            bump(lost_, static_cast<uint64_t>(distance - 1));
+            seen_ = distance >= window ? 1 : (seen_ << distance) | 1;
+            span_ = static_cast<uint32_t>(std::min<int64_t>(window, span_ + distance));
+            highest_ = seq;
+            return distance > 1 ? Result::Gap : Result::InOrder;
+        }
+        if (distance == 0) {
+            bump(duplicated_, 1);
+            return Result::Duplicate;
+        }
+        if (seq == 1 || -distance >= window) {
+            bump(restarts_, 1);
+            resync(seq);
+            return Result::Restart;
+        }
+        const uint64_t bit = uint64_t{1} << -distance;
+        if (seen_ & bit) {
+            bump(duplicated_, 1);
+            return Result::Duplicate;
+        }
+        seen_ |= bit;
+        if (-distance < span_) {
+            // Counted as lost when the gap was seen
+            lost_.store(lost_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+        bump(reordered_, 1);
+        return Result::Reordered;
+    }
+
+    /// Numbers skipped and not (yet) received late
+    uint64_t lost() const noexcept { return lost_.load(std::memory_order_relaxed); }
+    uint64_t duplicated() const noexcept { return duplicated_.load(std::memory_order_relaxed); }
+    uint64_t reordered() const noexcept { return reordered_.load(std::memory_order_relaxed); }
+    uint64_t restarts() const noexcept { return restarts_.load(std::memory_order_relaxed); }
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void resync(uint32_t seq) noexcept {
+        highest_ = seq;
+        seen_ = 1;
+        span_ = 1;
+    }
+
+    // Writer only
+    uint32_t highest_{0};   // 0 = nothing received yet
+    uint64_t seen_{0};      // Bit i: highest_ - i was received
+    uint32_t span_{0};      // Window positions at or above the resync number
+
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> duplicated_{0};
+    std::atomic<uint64_t> reordered_{0};
+    std::atomic<uint64_t> restarts_{0};
+};
+
+/**
+ * @brief CPU time of one thread, readable from other threads
+ *
+ * The owning thread calls attach() when it starts and detach() before it
+ * exits. While attached, other threads read its CPU clock through
+ * pthread_getcpuclockid() (same clock as the thread's own
+ * CLOCK_THREAD_CPUTIME_ID); after detach() the final value is kept.
+ */
+class alignas(cache_line_size) ThreadCpuClock {
+public:
+    void attach() noexcept {
+        clockid_t id;
+        if (pthread_getcpuclockid(pthread_self(), &id) == 0) {
+            clock_id_ = id;
+            attached_.store(true, std::memory_order_release);
+        }
+    }
+
+    void detach() noexcept {
+        final_ns_.store(read(CLOCK_THREAD_CPUTIME_ID), std::memory_order_relaxed);
+        attached_.store(false, std::memory_order_release);
+        used_.store(true, std::memory_order_relaxed);
+    }
+
+    /// Thread CPU time in ns (0 if the thread never ran)
+    uint64_t cpu_time_ns() const noexcept {
+        if (attached_.load(std::memory_order_acquire)) {
+            uint64_t ns = read(clock_id_);
+            if (ns != 0) {
+                return ns;
+            }
+            // Thread detached (and exited) between the two loads
+        }
+        return final_ns_.load(std::memory_order_relaxed);
+    }
+
+    /// True once the owning thread attached at least once
+    bool used() const noexcept {
+        return attached_.load(std::memory_order_acquire) || used_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t read(clockid_t id) noexcept {
+        struct timespec ts;
+        if (clock_gettime(id, &ts) != 0) {
+            return 0;
+        }
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    clockid_t clock_id_{};
+    std::atomic<bool> attached_{false};
+    std::atomic<bool> used_{false};
+    std::atomic<uint64_t> final_ns_{0};
+};
+
+// ============================================================================
+// Module Metrics
+// ============================================================================
+
+/**
+ * @brief All runtime metrics of one module
+ *
+ * Writers:
+ * - Data thread: iterations, loop/process histograms, sync failures,
+ *   primary input counters, subscriber table
+ * - Secondary input threads (multi-input): their own input counters
+ * - Every module thread: its own ThreadCpuClock (via ThreadScope)
+ *
+ * @tparam InputCount Number of inputs (0 for PeriodicInput/LoopInput)
+ * @tparam OutputCount Number of outputs (one WORK thread each)
+ */
+template<std::size_t InputCount, std::size_t OutputCount>
+class ModuleMetrics {
+public:
+    static constexpr std::size_t num_inputs = (InputCount < max_stats_inputs) ? InputCount : max_stats_inputs;
+    static constexpr std::size_t num_threads = 2 + OutputCount + InputCount;
+
+    struct alignas(cache_line_size) InputCounters {
+        PaddedCounter received;
+        PaddedCounter receive_errors;
+        SequenceTracker sequence;
+    };
+
+    struct alignas(cache_line_size) SubscriberCounters {
+        std::atomic<uint32_t> dest_mailbox{0};   // 0 = free slot
+        PaddedCounter sent;
+        PaddedCounter send_failures;
+        PaddedCounter drops;
+    };
+
+    /**
+     * @brief RAII attach/detach of a module thread's CPU clock
+     */
+    class ThreadScope {
+    public:
+        explicit ThreadScope(ThreadCpuClock& clock) : clock_(clock) { clock_.attach(); }
+        ~ThreadScope() { clock_.detach(); }
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+    private:
+        ThreadCpuClock& clock_;
+    };
+
+    // ------------------------------------------------------------------------
+    // Thread CPU time
+    // ------------------------------------------------------------------------
+
+    ThreadScope data_thread_scope() { return ThreadScope(thread_clocks_[0]); }
+    ThreadScope command_thread_scope() { return ThreadScope(thread_clocks_[1]); }
+    ThreadScope work_thread_scope(std::size_t output_idx) { return ThreadScope(thread_clocks_[2 + output_idx]); }
+    ThreadScope input_thread_scope(std::size_t input_idx) { return ThreadScope(thread_clocks_[2 + OutputCount + input_idx]); }
+
+    // ------------------------------------------------------------------------
+    // Recording (hot path, single writer per metric)
+    // ------------------------------------------------------------------------
+
+    void mark_started(uint64_t now_ns) noexcept {
+        start_ns_.store(now_ns, std::memory_order_relaxed);
+        last_loop_start_ns_ = 0;
+    }
+
+    /**
+     * @brief Start of a data loop iteration (data thread)
+     * @param expected_period_ns Configured period, 0 if the loop is not periodic
+     */
+    void record_loop_start(uint64_t now_ns, uint64_t expected_period_ns = 0) noexcept {
+        if (last_loop_start_ns_ != 0 && now_ns >= last_loop_start_ns_) {
+            uint64_t interval = now_ns - last_loop_start_ns_;
+            loop_interval_.record(interval);
+            if (expected_period_ns != 0) {
+                period_jitter_.record(interval > expected_period_ns
+                    ? interval - expected_period_ns
+                    : expected_period_ns - interval);
+            }
+        }
+        last_loop_start_ns_ = now_ns;
+        iterations_.increment();
+    }
+
+    void record_process_time(uint64_t start_ns, uint64_t end_ns) noexcept {
+        process_time_.record(end_ns >= start_ns ? end_ns - start_ns : 0);
+    }
+
+    void record_receive(std::size_t input_idx, bool success) noexcept {
+        if (input_idx < num_inputs) {
+            auto& counters = inputs_[input_idx];
+            (success ? counters.received : counters.receive_errors).increment();
+        }
+    }
+
+    /**
+     * @brief Sequence number of a received message (same thread as record_receive)
+     */
+    SequenceTracker::Result record_sequence(std::size_t input_idx, uint32_t seq_number) noexcept {
+        if (input_idx < num_inputs) {
+            return inputs_[input_idx].sequence.record(seq_number);
+        }
+        return SequenceTracker::Result::Unsequenced;
+    }
+
+    void record_sync_failure() noexcept { sync_failures_.increment(); }
+
+    /**
+     * @brief Result of one send to a subscriber (data thread)
+     *
+     * Subscribers are tracked in a fixed table of max_stats_subscribers
+     * entries, first come first served; further subscribers are only counted
+     * in untracked_sends().
+     */
+    void record_send(uint32_t dest_mailbox, const MailboxResult<void>& result) noexcept {
+        SubscriberCounters* counters = find_or_add_subscriber(dest_mailbox);
+        if (counters == nullptr) {
+            untracked_sends_.increment();
+            return;
+        }
+        if (result) {
+            counters->sent.increment();
+        } else {
+            counters->send_failures.increment();
+            if (result.get_error() == MailboxError::QueueFull) {
+                counters->drops.increment();
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Reading (any thread)
+    // ------------------------------------------------------------------------
+
+    uint64_t iterations() const noexcept { return iterations_.value(); }
+    uint64_t sync_failures() const noexcept { return sync_failures_.value(); }
+    uint64_t untracked_sends() const noexcept { return untracked_sends_.value(); }
+    const LatencyHistogram& process_time() const noexcept { return process_time_; }
+    const LatencyHistogram& loop_interval() const noexcept { return loop_interval_; }
+    const LatencyHistogram& period_jitter() const noexcept { return period_jitter_; }
+    const InputCounters& input(std::size_t input_idx) const noexcept { return inputs_[input_idx]; }
+
+    /**
+     * @brief Fill everything except module-specific fields (name, inputs'
+     *        history fill, dropped commands) into a StatsReply payload
+     */
+    void fill_stats(StatsReplyPayload& stats, uint64_t now_ns) const {
+        uint64_t start = start_ns_.load(std::memory_order_relaxed);
+        stats.uptime_ns = (start != 0 && now_ns >= start) ? now_ns - start : 0;
+        stats.iterations = iterations();
+        stats.sync_failures = sync_failures();
+        stats.process_time = process_time_.summary();
+        stats.loop_interval = loop_interval_.summary();
+        stats.period_jitter = period_jitter_.summary();
+
+        stats.inputs.clear();
+        for (std::size_t i = 0; i < num_inputs; ++i) {
+            InputStats input;
+            input.received = inputs_[i].received.value();
+            input.receive_errors = inputs_[i].receive_errors.value();
+            input.lost = inputs_[i].sequence.lost();
+            input.duplicated = inputs_[i].sequence.duplicated();
+            input.reordered = inputs_[i].sequence.reordered();
+            stats.inputs.push_back(input);
+        }
+
+        stats.subscribers.clear();
+        for (const auto& sub : subscribers_) {
+            uint32_t dest = sub.dest_mailbox.load(std::memory_order_acquire);
+            if (dest == 0) {
+                break;  // Table is filled front to back
+            }
+            SubscriberStats entry;
+            entry.dest_mailbox = dest;
+            entry.sent = sub.sent.value();
+            entry.send_failures = sub.send_failures.value();
+            entry.drops = sub.drops.value();
+            stats.subscribers.push_back(entry);
+        }
+
+        stats.threads.clear();
+        for (std::size_t i = 0; i < num_threads && stats.threads.size() < max_stats_threads; ++i) {
+            if (!thread_clocks_[i].used()) {
+                continue;
+            }
+            ThreadStats thread;
+            thread.name = thread_name(i);
+            thread.cpu_time_ns = thread_clocks_[i].cpu_time_ns();
+            stats.threads.push_back(thread);
+        }
+    }
+
+private:
+    SubscriberCounters* find_or_add_subscriber(uint32_t dest_mailbox) noexcept {
+        for (auto& sub : subscribers_) {
+            uint32_t dest = sub.dest_mailbox.load(std::memory_order_relaxed);
+            if (dest == dest_mailbox) {
+                return &sub;
+            }
+            if (dest == 0) {
+                sub.dest_mailbox.store(dest_mailbox, std::memory_order_release);
+                return &sub;
+            }
+        }
+        return nullptr;
+    }
+
+    static sertial::fixed_string<16> thread_name(std::size_t slot) {
+        char name[16];
+        if (slot == 0) {
+            std::snprintf(name, sizeof(name), "data");
+        } else if (slot == 1) {
+            std::snprintf(name, sizeof(name), "command");
+        } else if (slot < 2 + OutputCount) {
+            std::snprintf(name, sizeof(name), "work[%zu]", slot - 2);
+        } else {
+            std::snprintf(name, sizeof(name), "input[%zu]", slot - 2 - OutputCount);
+        }
+        return sertial::fixed_string<16>(name);
+    }
+
+    // Data thread
+    PaddedCounter iterations_;
+    PaddedCounter sync_failures_;
+    PaddedCounter untracked_sends_;
+    LatencyHistogram process_time_;
+    LatencyHistogram loop_interval_;
+    LatencyHistogram period_jitter_;
+    uint64_t last_loop_start_ns_{0};
+    std::array<SubscriberCounters, max_stats_subscribers> subscribers_{};
+
+    // One writer per input (primary: data thread, secondaries: own threads)
+    std::array<InputCounters, (num_inputs > 0 ? num_inputs : 1)> inputs_{};
+
+    // data, command, work[OutputCount], input[InputCount]
+    std::array<ThreadCpuClock, num_threads> thread_clocks_{};
+
+    std::atomic<uint64_t> start_ns_{0};
+};
+
+} // namespace commrat
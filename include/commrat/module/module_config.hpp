@@ -100,6 +100,35 @@ struct MultiInputConfig {
 
 using InputConfig = rfl::TaggedUnion<"input_type", NoInputConfig, SingleInputConfig, MultiInputConfig>;
 
+// ============================================================================
+// Realtime Memory Configuration
+// ============================================================================
+
+/// Memory setup done by module_main() before the module is created
+/// (see platform/rt_memory.hpp). Everything is off by default.
+struct RtMemoryConfig {
+    rfl::DefaultVal<bool> lock_memory = false;        // mlockall(MCL_CURRENT | MCL_FUTURE), failure is fatal
+    rfl::DefaultVal<bool> tune_malloc = false;        // No trimming, no mmap'd blocks, one arena
+    rfl::DefaultVal<size_t> heap_prefault = 0;        // Bytes faulted into the heap (implies tune_malloc)
+    rfl::DefaultVal<size_t> stack_prefault = 0;       // Stack bytes every module thread faults in at start
+};
+
+/// Tick alignment of PeriodicInput modules (see LoopExecutor::periodic_loop).
+/// Aligned modules release at k * period + phase_us of the Time::now() clock
+/// instead of relative to start(), so producers with related periods tick
+/// with a fixed, designed phase. Off by default.
+struct TickAlignmentConfig {
+    rfl::DefaultVal<bool> enabled = false;
+    rfl::DefaultVal<uint32_t> phase_us = 0;           // Offset into the period, taken modulo the period
+};
+
+/// Scheduling of the threads that run process() (data thread, multi-input
+/// receive threads). Usually written by RtPlan::apply() (rt_planner.hpp).
+struct DataThreadConfig {
+    rfl::DefaultVal<int> rt_priority = 0;             // SCHED_FIFO priority 1..99, 0 = default scheduling
+    rfl::DefaultVal<int> cpu_affinity = -1;           // Pin to this CPU, -1 = no pinning
+};
+
 // ============================================================================
 // Module Configuration
 // ============================================================================
@@ -123,6 +152,19 @@ struct ModuleConfig {
     rfl::DefaultVal<uint32_t> cmd_message_slots = DEFAULT_CMD_SLOTS;
     rfl::DefaultVal<uint32_t> data_message_slots = DEFAULT_DATA_SLOTS;
     
+    // Causal tracing (module_main): Chrome/Perfetto JSON written at shutdown
+    // Empty = tracing disabled
+    rfl::DefaultVal<std::string> trace_file = std::string{};
+    
+    // Realtime memory setup (module_main): locking and prefaulting
+    rfl::DefaultVal<RtMemoryConfig> rt_memory = RtMemoryConfig{};
+    
+    // Periodic release on a shared clock grid (PeriodicInput only)
+    rfl::DefaultVal<TickAlignmentConfig> tick_alignment = TickAlignmentConfig{};
+    
+    // Realtime priority and CPU of the data thread
+    rfl::DefaultVal<DataThreadConfig> data_thread = DataThreadConfig{};
+    
     // ========================================================================
     // Output Configuration Accessors
     // ========================================================================
@@ -8,8 +8,10 @@
  * - Subscription protocol (SubscribeRequest/Reply/Unsubscribe handling)
  * - Publisher (message publishing to subscribers)
  * - MailboxSet (CMD/WORK/PUBLISH mailbox grouping)
+ * - ModuleMetrics (runtime statistics served via StatsRequest)
  */
 
 #include "commrat/module/services/subscription.hpp"
 #include "commrat/module/services/publishing.hpp"
 #include "commrat/module/mailbox/mailbox_set.hpp"
+#include "commrat/module/metrics/module_metrics.hpp"
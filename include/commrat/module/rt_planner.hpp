@@ -0,0 +1,301 @@
+/**
+ * @file rt_planner.hpp
+ * @brief Rate-monotonic priority and CPU assignment for a host's modules
+ *
+ * RateMonotonicPlanner takes the realtime modules of one host with their
+ * periods and process() costs and:
+ * - assigns SCHED_FIFO priorities in rate-monotonic order (shorter period =
+ *   higher priority, so a 1 kHz module always preempts a 10 Hz one)
+ * - spreads modules over the given isolated CPUs, largest utilization first
+ *   onto the least loaded CPU that stays schedulable
+ * - checks every CPU with response-time analysis: R = C + sum over higher
+ *   priority modules of ceil(R / T_j) * C_j, schedulable if R <= T
+ * - writes priority and CPU into a ModuleConfig::data_thread (RtPlan::apply())
+ *
+ * Costs are worst-case process() durations, e.g. StatsReply process_time
+ * max_ns, scaled by cost_margin. Modules with realtime = false keep default
+ * scheduling and are not analysed.
+ *
+ * Usage:
+ *   RateMonotonicPlanner planner({.cores = {2, 3}});
+ *   planner.add(imu_config, Microseconds(150));      // PeriodicInput: config.period
+ *   planner.add(fusion_config, fusion_stats);        // Measured cost and rate
+ *   RtPlan plan = planner.plan();
+ *   if (!plan.schedulable) { ... }
+ *   plan.apply(imu_config);
+ *   plan.apply(fusion_config);
+ *
+ * The planner copies what it needs from the configs, they may move or be
+ * destroyed after add().
+ *
+ * The same planning for JSON config files: tools/commrat_rt_plan.
+ */
+
+#pragma once
+
+#include "commrat/module/module_config.hpp"
+#include "commrat/messaging/system/stats_messages.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace commrat {
+
+/**
+ * @brief Planner settings
+ */
+struct RtPlannerConfig {
+    std::vector<int> cores;          ///< Isolated CPUs for realtime modules (empty = one unpinned CPU)
+    int highest_priority{90};        ///< SCHED_FIFO priority of the shortest period
+    int lowest_priority{10};         ///< Lowest priority handed out
+    double cost_margin{1.2};         ///< Costs are multiplied by this
+};
+
+/**
+ * @brief Result for one module
+ */
+struct RtTaskPlan {
+    std::string module;
+    bool realtime{false};
+    uint64_t period_ns{0};
+    uint64_t cost_ns{0};             ///< Including cost_margin
+    int priority{0};                 ///< SCHED_FIFO priority, 0 = default scheduling
+    int cpu{-1};                     ///< -1 = not pinned
+    uint64_t response_ns{0};         ///< Worst-case response time (realtime modules)
+    bool schedulable{true};          ///< response_ns <= period_ns
+};
+
+/**
+ * @brief Load of one CPU
+ */
+struct RtCorePlan {
+    int cpu{-1};
+    double utilization{0.0};         ///< Sum of cost / period
+    std::size_t modules{0};
+};
+
+/**
+ * @brief Planner result, tasks in add() order
+ */
+struct RtPlan {
+    std::vector<RtTaskPlan> tasks;
+    std::vector<RtCorePlan> cores;
+    bool schedulable{true};
+
+    /**
+     * @brief Write priority and CPU of the task named config.name into
+     *        config.data_thread (realtime = false modules get defaults)
+     * @return false if no task of that name was planned (config unchanged)
+     */
+    bool apply(ModuleConfig& config) const {
+        for (const auto& task : tasks) {
+            if (task.module == config.name) {
+                config.data_thread = DataThreadConfig{
+                    .rt_priority = task.priority,
+                    .cpu_affinity = task.cpu
+                };
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+class RateMonotonicPlanner {
+public:
+    explicit RateMonotonicPlanner(RtPlannerConfig config = {})
+        : config_(std::move(config)) {
+        if (config_.highest_priority > 99 || config_.lowest_priority < 1 ||
+            config_.lowest_priority > config_.highest_priority) {
+            throw std::invalid_argument("RateMonotonicPlanner: priorities must satisfy 1 <= lowest <= highest <= 99");
+        }
+        if (config_.cost_margin < 1.0) {
+            throw std::invalid_argument("RateMonotonicPlanner: cost_margin must be >= 1");
+        }
+    }
+
+    /**
+     * @brief Add a module with a known worst-case process() cost
+     *
+     * @param period Activation period (default config.period). Input-driven
+     *               modules run at their source's rate, pass it here.
+     */
+    template<typename Rep, typename Period>
+    void add(const ModuleConfig& config, std::chrono::duration<Rep, Period> cost,
+             std::optional<Milliseconds> period = std::nullopt) {
+        add_task(config, Time::to_nanoseconds(cost),
+                 Time::to_nanoseconds(period.value_or(config.period)));
+    }
+
+    /**
+     * @brief Add a module with cost and rate measured by its StatsReply
+     *
+     * Cost is process_time.max_ns. The period is config.period for source
+     * modules and the median loop interval for input-driven modules (if
+     * any iterations were measured).
+     */
+    void add(const ModuleConfig& config, const StatsReplyPayload& stats) {
+        uint64_t period_ns = Time::to_nanoseconds(config.period);
+        if (!config.has_no_input() && stats.loop_interval.count > 0) {
+            period_ns = stats.loop_interval.p50_ns;
+        }
+        add_task(config, stats.process_time.max_ns, period_ns);
+    }
+
+    /**
+     * @brief Compute priorities, CPUs and response times
+     */
+    [[nodiscard]] RtPlan plan() const {
+        RtPlan result;
+        result.tasks.reserve(entries_.size());
+        for (const auto& entry : entries_) {
+            RtTaskPlan task;
+            task.module = entry.name;
+            task.realtime = entry.realtime;
+            task.period_ns = entry.period_ns;
+            task.cost_ns = static_cast<uint64_t>(std::ceil(static_cast<double>(entry.cost_ns) * config_.cost_margin));
+            result.tasks.push_back(std::move(task));
+        }
+
+        // Rate-monotonic order of the realtime tasks (name breaks ties, stable across runs)
+        std::vector<std::size_t> by_rate;
+        for (std::size_t i = 0; i < result.tasks.size(); ++i) {
+            if (result.tasks[i].realtime) {
+                by_rate.push_back(i);
+            }
+        }
+        std::sort(by_rate.begin(), by_rate.end(), [&](std::size_t a, std::size_t b) {
+            const auto& ta = result.tasks[a];
+            const auto& tb = result.tasks[b];
+            return ta.period_ns != tb.period_ns ? ta.period_ns < tb.period_ns : ta.module < tb.module;
+        });
+
+        // One priority level per distinct period while levels last
+        int priority = config_.highest_priority;
+        for (std::size_t k = 0; k < by_rate.size(); ++k) {
+            if (k > 0 && result.tasks[by_rate[k]].period_ns != result.tasks[by_rate[k - 1]].period_ns) {
+                priority = std::max(priority - 1, config_.lowest_priority);
+            }
+            result.tasks[by_rate[k]].priority = priority;
+        }
+
+        // Worst-fit decreasing: largest utilization onto the least loaded CPU
+        // where every task still meets its deadline
+        const std::vector<int> cpus = config_.cores.empty() ? std::vector<int>{-1} : config_.cores;
+        std::vector<std::vector<std::size_t>> on_cpu(cpus.size());
+        std::vector<std::size_t> by_load = by_rate;
+        std::stable_sort(by_load.begin(), by_load.end(), [&](std::size_t a, std::size_t b) {
+            return utilization(result.tasks[a]) > utilization(result.tasks[b]);
+        });
+        for (std::size_t index : by_load) {
+            std::vector<std::size_t> order(cpus.size());
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return load(result.tasks, on_cpu[a]) < load(result.tasks, on_cpu[b]);
+            });
+            std::size_t chosen = order.front();  // Unschedulable anywhere: least loaded
+            for (std::size_t c : order) {
+                auto candidate = on_cpu[c];
+                candidate.push_back(index);
+                if (analyse(result.tasks, candidate)) {
+                    chosen = c;
+                    break;
+                }
+            }
+            on_cpu[chosen].push_back(index);
+            result.tasks[index].cpu = cpus[chosen];
+        }
+
+        for (std::size_t c = 0; c < cpus.size(); ++c) {
+            result.schedulable = analyse(result.tasks, on_cpu[c], true) && result.schedulable;
+            result.cores.push_back(RtCorePlan{
+                .cpu = cpus[c],
+                .utilization = load(result.tasks, on_cpu[c]),
+                .modules = on_cpu[c].size()
+            });
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        bool realtime;
+        uint64_t cost_ns;
+        uint64_t period_ns;
+    };
+
+    void add_task(const ModuleConfig& config, uint64_t cost_ns, uint64_t period_ns) {
+        if (period_ns == 0) {
+            throw std::invalid_argument("RateMonotonicPlanner: module '" + config.name + "' has no period");
+        }
+        for (const auto& entry : entries_) {
+            if (entry.name == config.name) {
+                throw std::invalid_argument("RateMonotonicPlanner: module '" + config.name + "' added twice");
+            }
+        }
+        entries_.push_back(Entry{config.name, config.realtime, cost_ns, period_ns});
+    }
+
+    static double utilization(const RtTaskPlan& task) {
+        return static_cast<double>(task.cost_ns) / static_cast<double>(task.period_ns);
+    }
+
+    static double load(const std::vector<RtTaskPlan>& tasks, const std::vector<std::size_t>& indices) {
+        double sum = 0.0;
+        for (std::size_t i : indices) {
+            sum += utilization(tasks[i]);
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Response-time analysis of the tasks on one CPU
+     *
+     * A task is interfered with by every task of higher or equal priority
+     * (equal priorities are FIFO-ordered). With store = true, response_ns
+     * and schedulable are written into the tasks.
+     */
+    static bool analyse(std::vector<RtTaskPlan>& tasks, const std::vector<std::size_t>& indices,
+                        bool store = false) {
+        bool all = true;
+        for (std::size_t i : indices) {
+            auto& task = tasks[i];
+            uint64_t response = task.cost_ns;
+            while (response <= task.period_ns) {
+                uint64_t next = task.cost_ns;
+                for (std::size_t j : indices) {
+                    if (j != i && tasks[j].priority >= task.priority) {
+                        next += (response + tasks[j].period_ns - 1) / tasks[j].period_ns * tasks[j].cost_ns;
+                    }
+                }
+                if (next == response) {
+                    break;
+                }
+                response = next;
+            }
+            const bool ok = response <= task.period_ns;
+            if (store) {
+                task.response_ns = response;
+                task.schedulable = ok;
+            }
+            all = all && ok;
+        }
+        return all;
+    }
+
+    RtPlannerConfig config_;
+    std::vector<Entry> entries_;
+};
+
+} // namespace commrat
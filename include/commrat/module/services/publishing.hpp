@@ -7,6 +7,16 @@
  * publishing with explicit timestamp control (Phase 6.10).
  * 
  * Phase 7: Uses new addressing scheme with SubscriberInfo (base_addr + mailbox_index)
+ * 
+ * Every send result is recorded per subscriber in the module's ModuleMetrics.
+ * Subscriber lists are copy-on-write snapshots (for_each_output_subscriber):
+ * publishing does not allocate and sends without holding the subscriber lock.
+ * 
+ * Each output numbers its messages in TimsHeader::seq_number (1, 2, ...,
+ * skipping 0 on wrap-around). All subscribers of one publish see the same
+ * number, so receivers detect lost, duplicated and reordered messages per
+ * input (SequenceTracker). TiMS's own sequence number counts sends per
+ * mailbox - one per subscriber - and cannot serve this purpose.
  */
 
 #pragma once
@@ -16,6 +26,8 @@
 #include <commrat/messages.hpp>  // TimsMessage definition
 #include <commrat/module/helpers/address_helpers.hpp>  // encode_address, extract_*
 #include <commrat/module/io/multi_output_manager.hpp>  // SubscriberInfo
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <tuple>
 #include <mutex>
@@ -28,7 +40,7 @@ namespace commrat {
  * 
  * Handles publishing to subscribers with type-specific filtering.
  * After unification, ALL modules use MailboxSets and access subscribers
- * via module_ptr_->get_output_subscribers(index).
+ * via module_ptr_->for_each_output_subscriber(index, fn).
  * 
  * Phase 7: Uses CMD mailbox (index 0) for publishing, calculates dest as
  * subscriber.base_addr | subscriber.mailbox_index.
@@ -38,12 +50,14 @@ namespace commrat {
  * - OutputData: Single output type (or void for multi-output)
  * - PublishMailboxT: Publish mailbox type (defaults to TypedMailbox<UserRegistry>)
  * - ModuleType: Module type for mailbox/subscriber access (REQUIRED after unification)
+ * - OutputCount: Number of outputs (one sequence counter each)
  */
 template<
     typename UserRegistry,
     typename OutputData,
     typename PublishMailboxT = TypedMailbox<UserRegistry>,
-    typename ModuleType = void  // Module type for multi-output mailbox access
+    typename ModuleType = void,  // Module type for multi-output mailbox access
+    std::size_t OutputCount = 1
 >
 class Publisher {
 protected:
@@ -52,6 +66,16 @@ protected:
     // REMOVED: publish_mailbox_ - ALL modules now use MailboxSets (post-unification)
     ModuleType* module_ptr_{nullptr};  // Typed pointer to Module for mailbox/subscriber access
     std::string module_name_;
+    std::array<uint32_t, (OutputCount > 0 ? OutputCount : 1)> output_sequence_{};  // Data thread only
+    
+    /**
+     * @brief Sequence number of the next message of an output (never 0)
+     */
+    uint32_t next_sequence(std::size_t output_index) {
+        uint32_t& seq = output_sequence_[output_index];
+        seq = (seq == UINT32_MAX) ? 1 : seq + 1;
+        return seq;
+    }
     
 public:
     // REMOVED: set_subscriber_manager() - no longer used after unification
@@ -70,7 +94,7 @@ public:
                 .msg_type = 0,     // serialize() will set this
                 .msg_size = 0,     // serialize() will set this
                 .timestamp = timestamp_ns,  // ONE SOURCE OF TRUTH
-                .seq_number = 0,   // TiMS will set this
+                .seq_number = 0,   // Numbered when published
                 .flags = 0
             },
             .payload = std::forward<T>(payload)
@@ -90,20 +114,20 @@ public:
         if constexpr (!std::is_void_v<ModuleType>) {
             // Use CMD mailbox for publishing (Phase 7)
             auto& cmd_mbx = module_ptr_->template get_cmd_mailbox_public<0>();
-            // Get output-specific subscriber list (index 0 for single-output)
-            auto subscribers = module_ptr_->get_output_subscribers(0);
-            
-            for (const auto& sub : subscribers) {
+            const uint32_t seq = next_sequence(0);
+            // Output-specific subscriber list (index 0 for single-output)
+            module_ptr_->for_each_output_subscriber(0, [&](const SubscriberInfo& sub) {
                 // Calculate destination: base_addr | mailbox_index
                 uint32_t dest_mailbox = sub.base_addr | sub.input_index;
-                auto result = cmd_mbx.send(data, dest_mailbox);
+                auto result = cmd_mbx.send(data, dest_mailbox, 0, seq);
+                module_ptr_->metrics().record_send(dest_mailbox, result);
                 if (!result) {
                     std::cerr << "[" << module_name_ << "] Send failed to subscriber base=0x" << std::hex << sub.base_addr 
                               << " mbx_idx=" << std::dec << static_cast<int>(sub.input_index)
                               << " dest=0x" << std::hex << dest_mailbox << std::dec
                               << " error=" << static_cast<int>(result.get_error()) << "\n";
                 }
-            }
+            });
         }
     }
     
@@ -117,20 +141,21 @@ public:
         if constexpr (!std::is_void_v<ModuleType>) {
             // Use CMD mailbox for publishing (Phase 7)
             auto& cmd_mbx = module_ptr_->template get_cmd_mailbox_public<0>();
-            // Get output-specific subscriber list (index 0 for single-output)
-            auto subscribers = module_ptr_->get_output_subscribers(0);
-            
-            for (const auto& sub : subscribers) {
+            tims_msg.header.seq_number = next_sequence(0);
+            // Output-specific subscriber list (index 0 for single-output)
+            module_ptr_->for_each_output_subscriber(0, [&](const SubscriberInfo& sub) {
                 uint32_t dest_mailbox = sub.base_addr | sub.input_index;
                 // Phase 6.10: Send with explicit timestamp from header
-                auto result = cmd_mbx.send(tims_msg.payload, dest_mailbox, tims_msg.header.timestamp);
+                auto result = cmd_mbx.send(tims_msg.payload, dest_mailbox, tims_msg.header.timestamp,
+                                           tims_msg.header.seq_number);
+                module_ptr_->metrics().record_send(dest_mailbox, result);
                 if (!result) {
                     std::cerr << "[" << module_name_ << "] Send failed to subscriber base=0x" << std::hex << sub.base_addr 
                               << " mbx_idx=" << std::dec << static_cast<int>(sub.input_index)
                               << " dest=0x" << std::hex << dest_mailbox << std::dec
                               << " error=" << static_cast<int>(result.get_error()) << "\n";
                 }
-            }
+            });
         }
     }
     
@@ -153,6 +178,7 @@ public:
             if constexpr (!std::is_void_v<ModuleType>) {
                 auto& publish_mbx = module_ptr_->template get_publish_mailbox_public<Index>();
                 auto result = publish_mbx.send(output, dest_mailbox);
+                module_ptr_->metrics().record_send(dest_mailbox, result);
                 if (!result) {
                     std::cout << "[" << module_name_ << "] Send failed for output[" << Index << "]\n";
                 }
@@ -177,21 +203,20 @@ public:
     template<std::size_t Index, typename OutputType>
     void publish_output_at_index(OutputType& output) {
         if constexpr (!std::is_void_v<ModuleType>) {
-            // Get subscribers for this specific output
-            auto subscribers = module_ptr_->get_output_subscribers(Index);
-            
-            // Send to each subscriber using CMD mailbox
+            // Send to each subscriber of this specific output using its CMD mailbox
             auto& cmd_mbx = module_ptr_->template get_cmd_mailbox_public<Index>();
-            for (const auto& sub : subscribers) {
+            const uint32_t seq = next_sequence(Index);
+            module_ptr_->for_each_output_subscriber(Index, [&](const SubscriberInfo& sub) {
                 uint32_t dest_mailbox = sub.base_addr | sub.input_index;
-                auto result = cmd_mbx.send(output, dest_mailbox);
+                auto result = cmd_mbx.send(output, dest_mailbox, 0, seq);
+                module_ptr_->metrics().record_send(dest_mailbox, result);
                 if (!result) {
                     std::cout << "[" << module_name_ << "] Send failed for output[" << Index 
                               << "] to subscriber base=0x" << std::hex << sub.base_addr 
                               << " mbx_idx=" << std::dec << static_cast<int>(sub.input_index)
                               << " dest=0x" << std::hex << dest_mailbox << std::dec << "\n";
                 }
-            }
+            });
         }
     }
     
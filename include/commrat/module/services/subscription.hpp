@@ -11,6 +11,8 @@
 #include <commrat/module/module_config.hpp>
 #include <commrat/module/helpers/address_helpers.hpp>
 #include <commrat/messaging/system/system_registry.hpp>
+#include <commrat/platform/threading.hpp>
+#include <commrat/platform/timestamp.hpp>
 #include <iostream>
 #include <vector>
 #include <mutex>
@@ -65,7 +67,7 @@ protected:
     using UnsubscribeReplyType = UnsubscribeReplyPayload;
     
     std::vector<SubscriptionState> input_subscriptions_;
-    mutable std::mutex subscription_mutex_;
+    mutable Mutex subscription_mutex_;
     
     // Reference to module's config and mailboxes (set by derived class)
     const ModuleConfig* config_{nullptr};
@@ -97,7 +99,7 @@ public:
                 return;
             }
             
-            std::lock_guard<std::mutex> lock(subscription_mutex_);
+            Lock lock(subscription_mutex_);
             input_subscriptions_.resize(sources.size());
             
             for (size_t i = 0; i < sources.size(); ++i) {
@@ -137,15 +139,12 @@ public:
         };
         
         // Calculate source WORK mailbox
-        uint32_t source_base;
         uint32_t source_work_mbx;
         
         if constexpr (has_continuous_input && !has_multi_input) {
             // Single continuous input
             constexpr uint32_t source_data_type_id = Registry::template get_message_id<InputData>();
-            constexpr uint16_t source_data_type_id_low = static_cast<uint16_t>(source_data_type_id & 0xFFFF);
-            source_base = (static_cast<uint32_t>(source_data_type_id_low) << 16) | (source_system_id << 8) | source_instance_id;
-            source_work_mbx = source_base + static_cast<uint8_t>(MailboxType::WORK);
+            source_work_mbx = producer_work_mailbox(source_data_type_id, source_system_id, source_instance_id);
         }
         
         // Send unsubscribe request from work mailbox (SystemRegistry messages)
@@ -174,10 +173,7 @@ public:
         // Multi-input: use the input type at source.input_index
         uint32_t source_data_type_id = get_input_type_id_at_index(source.input_index);
         
-        uint16_t source_data_type_id_low = static_cast<uint16_t>(source_data_type_id & 0xFFFF);
-        uint32_t source_base = (static_cast<uint32_t>(source_data_type_id_low) << 16) | 
-                               (source.system_id << 8) | source.instance_id;
-        uint32_t source_work_mbx = source_base + static_cast<uint8_t>(MailboxType::WORK);
+        uint32_t source_work_mbx = producer_work_mailbox(source_data_type_id, source.system_id, source.instance_id);
         
         // Send unsubscribe request from work mailbox (SystemRegistry messages)
         work_mailbox_->send(request, source_work_mbx);
@@ -224,7 +220,7 @@ public:
      * @brief Handle incoming SubscribeReply (consumer side)
      */
     void handle_subscribe_reply(const SubscribeReplyType& reply) {
-        std::lock_guard<std::mutex> lock(subscription_mutex_);
+        Lock lock(subscription_mutex_);
         
         // Phase 6.6: Mark subscription as complete
         // For now, mark the first non-replied subscription
@@ -293,39 +289,25 @@ protected:
             .requested_period_ms = config_->period.count()
         };
         
-        uint16_t source_data_type_id_low = static_cast<uint16_t>(source_data_type_id & 0xFFFF);
-        uint32_t source_base = (static_cast<uint32_t>(source_data_type_id_low) << 16) | 
-                                (source_system_id << 8) | source_instance_id;
-        uint32_t source_work_mbx = source_base + static_cast<uint8_t>(MailboxType::WORK);
+        uint32_t source_work_mbx = producer_work_mailbox(source_data_type_id, source_system_id, source_instance_id);
         
         std::cout << "[" << module_name_ << "] Sending SubscribeRequest[" << source_index 
                   << "] to source WORK mailbox " << source_work_mbx << "\n";
         
-        // Retry a few times in case the producer's mailbox isn't ready yet
-        int max_retries = 5;
-        for (int i = 0; i < max_retries; ++i) {
-            // Send subscribe request from work mailbox (SystemRegistry messages)
-            auto result = work_mailbox_->send(request, source_work_mbx);
-            if (result) {
-                std::cout << "[" << module_name_ << "] SubscribeRequest[" << source_index 
-                          << "] sent successfully\n";
-                // Mark subscription as sent (reply not yet received)
-                if (source_index < input_subscriptions_.size()) {
-                    input_subscriptions_[source_index].subscribed = true;
-                    input_subscriptions_[source_index].reply_received = false;
-                }
-                return;
-            }
-            
-            if (i < max_retries - 1) {
-                std::cout << "[" << module_name_ << "] Failed to send SubscribeRequest (attempt " 
-                          << (i + 1) << "/" << max_retries << "), retrying...\n";
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Send subscribe request from work mailbox (SystemRegistry messages)
+        if (send_subscribe_request(*work_mailbox_, request, source_work_mbx)) {
+            std::cout << "[" << module_name_ << "] SubscribeRequest[" << source_index 
+                      << "] sent successfully\n";
+            // Mark subscription as sent (reply not yet received)
+            if (source_index < input_subscriptions_.size()) {
+                input_subscriptions_[source_index].subscribed = true;
+                input_subscriptions_[source_index].reply_received = false;
             }
+            return;
         }
         
         std::cout << "[" << module_name_ << "] Failed to send SubscribeRequest[" << source_index
-                  << "] after " << max_retries << " attempts!\n";
+                  << "] after " << SUBSCRIBE_ATTEMPTS << " attempts!\n";
     }
     
     /**
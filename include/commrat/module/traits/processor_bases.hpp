@@ -164,4 +164,38 @@ public:
     }
 };
 
+// ============================================================================
+// Command Handler Base (one virtual on_command() per command type)
+// ============================================================================
+
+// One-way command: void on_command(const CmdT&)
+// Request with Reply<> registered: ReplyT on_command(const CmdT&), the return
+// value is sent back to the requester by CommandDispatcher. There is no
+// meaningful default reply, so the module must override it (pure virtual).
+template<typename CmdT, typename ReplyT = void>
+class CommandHandlerBase {
+public:
+    virtual ~CommandHandlerBase() = default;
+    
+    // Public virtual function for polymorphic calls from CommandDispatcher
+    virtual ReplyT on_command(const CmdT& cmd) = 0;
+};
+
+template<typename CmdT>
+class CommandHandlerBase<CmdT, void> {
+public:
+    virtual ~CommandHandlerBase() = default;
+    
+    virtual void on_command(const CmdT& cmd) {
+        // Default: no-op - override in derived classes for specific CommandTypes
+        (void)cmd;  // Suppress unused warning
+    }
+};
+
+// PrimaryInput<T> travels in the CommandTypes pack but is not a command
+template<typename T>
+class CommandHandlerBase<PrimaryInput<T>, void> {
+    // Empty - selects the primary input, no handler
+};
+
 } // namespace commrat
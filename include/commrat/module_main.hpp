@@ -2,7 +2,9 @@
 
 #include <commrat/commrat.hpp>
 #include <commrat/module/module_config.hpp>
+#include <commrat/platform/rt_memory.hpp>
 #include <commrat/platform/threading.hpp>
+#include <commrat/platform/tracing.hpp>
 #include <rfl.hpp>
 #include <rfl/json.hpp>
 #include <csignal>
@@ -26,14 +28,55 @@ inline void signal_handler(int signal) {
     std::cout << "\nReceived signal " << signal << ", shutting down...\n";
 }
 
+/**
+ * @brief Realtime memory setup from ModuleConfig::rt_memory
+ * 
+ * Runs before the module is created, so its buffers (history buffers,
+ * mailboxes, receive buffers) and thread stacks are allocated from locked,
+ * prefaulted memory:
+ * 1. Tune malloc (also when heap_prefault is set)
+ * 2. mlockall(MCL_CURRENT | MCL_FUTURE)
+ * 3. Fault heap_prefault bytes into the heap
+ * 4. Enable stack prefaulting for every thread started afterwards
+ * 
+ * @return false if locking or heap prefaulting failed (reason on stderr)
+ */
+inline bool setup_rt_memory(const RtMemoryConfig& config) {
+    const size_t heap_bytes = config.heap_prefault.value();
+    if (config.tune_malloc.value() || heap_bytes > 0) {
+        if (!tune_malloc()) {
+            std::cerr << "WARNING: mallopt failed, freed memory may be returned to the system\n";
+        }
+    }
+    
+    if (config.lock_memory.value()) {
+        std::string error;
+        if (!lock_memory(error)) {
+            std::cerr << "ERROR: " << error << "\n";
+            return false;
+        }
+    }
+    
+    if (!prefault_heap(heap_bytes)) {
+        std::cerr << "ERROR: Cannot prefault " << heap_bytes << " bytes of heap\n";
+        return false;
+    }
+    
+    set_thread_stack_prefault(config.stack_prefault.value());
+    prefault_thread_stack();
+    return true;
+}
+
 /**
  * @brief Main entry point for standalone module binaries
  * 
  * Provides complete lifecycle management:
  * - Signal handler installation (SIGINT, SIGTERM)
+ * - Realtime memory setup if config.rt_memory asks for it
  * - Module instantiation with configuration
  * - Module start and execution
  * - Graceful shutdown on signal
+ * - Causal trace export if config.trace_file is set
  * - Exception handling with proper exit codes
  * 
  * Real-time safe after module start. Uses blocking sleep (0% CPU idle).
@@ -64,6 +107,17 @@ int module_main(const ModuleConfig& config) {
         std::signal(SIGINT, signal_handler);
         std::signal(SIGTERM, signal_handler);
         
+        // Enable tracing before the module threads start
+        const std::string& trace_file = config.trace_file.value();
+        if (!trace_file.empty()) {
+            Tracer::enable();
+        }
+        
+        // Lock and prefault memory before any module buffer or thread exists
+        if (!setup_rt_memory(config.rt_memory.value())) {
+            return 1;
+        }
+        
         // Create module instance
         std::cout << "Starting " << config.name << " (system_id=" 
                   << static_cast<int>(config.system_id()) << ", instance_id=" 
@@ -84,6 +138,14 @@ int module_main(const ModuleConfig& config) {
         std::cout << "Stopping " << config.name << "...\n";
         module.stop();
         
+        if (!trace_file.empty()) {
+            if (Tracer::write_chrome_trace(trace_file)) {
+                std::cout << "Trace written to " << trace_file << "\n";
+            } else {
+                std::cerr << "Failed to write trace to " << trace_file << "\n";
+            }
+        }
+        
         std::cout << config.name << " stopped successfully\n";
         return g_shutdown_requested.load() ? 130 : 0;  // 130 = SIGINT convention
         
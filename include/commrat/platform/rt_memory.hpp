@@ -0,0 +1,189 @@
+/**
+ * @file rt_memory.hpp
+ * @brief Memory locking and prefaulting for realtime processes
+ *
+ * A page touched for the first time costs a page fault (zeroing, possibly
+ * reclaim) - several milliseconds under memory pressure. Realtime processes
+ * therefore fault everything in before they start working:
+ * - lock_memory(): mlockall(MCL_CURRENT | MCL_FUTURE), nothing is paged out
+ *   and every future mapping (thread stacks, heap growth) is populated when
+ *   it is mapped
+ * - tune_malloc(): freed memory stays in one arena instead of being trimmed
+ *   or unmapped, so prefaulted heap pages are reused by later allocations
+ * - prefault_heap(): fault a block into the malloc arena and free it again
+ * - prefault_thread_stack(): fault the calling thread's stack; module
+ *   threads and commrat::Thread call it at start once a size is set with
+ *   set_thread_stack_prefault()
+ *
+ * Usually configured through ModuleConfig::rt_memory and done by
+ * module_main() before the module is created.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace commrat {
+
+namespace detail {
+
+inline std::size_t page_size() {
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/// Process-wide stack prefault size (0 = off)
+inline std::atomic<std::size_t> g_thread_stack_prefault{0};
+
+/// Left untouched at the end of the stack: the thread's own frames and TLS
+constexpr std::size_t stack_prefault_margin = 64 * 1024;
+
+} // namespace detail
+
+/**
+ * @brief Lock all current and future pages of the process into RAM
+ *
+ * Needs CAP_IPC_LOCK or an RLIMIT_MEMLOCK covering the whole process
+ * (thread stacks included: lower their size or the limit accordingly).
+ *
+ * @param error Set to the reason on failure
+ * @return true if locked
+ */
+inline bool lock_memory(std::string& error) {
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        error = std::string("mlockall failed: ") + std::strerror(errno) +
+                " (needs CAP_IPC_LOCK or a larger RLIMIT_MEMLOCK)";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Keep freed heap memory in the process
+ *
+ * - M_TRIM_THRESHOLD -1: never give the top of the heap back to the kernel
+ * - M_MMAP_MAX 0: large blocks come from the heap instead of their own
+ *   mapping, which free() would unmap
+ * - M_ARENA_MAX 1: all threads allocate from the (prefaulted) main arena
+ *   instead of lazily created per-thread arenas
+ *
+ * Call before prefault_heap() and before threads are started.
+ */
+inline bool tune_malloc() {
+    return ::mallopt(M_TRIM_THRESHOLD, -1) == 1 &&
+           ::mallopt(M_MMAP_MAX, 0) == 1 &&
+           ::mallopt(M_ARENA_MAX, 1) == 1;
+}
+
+/**
+ * @brief Fault bytes of memory into the malloc arena
+ *
+ * The block is freed again and stays in the arena after tune_malloc(), so
+ * allocations up to this size no longer fault.
+ *
+ * @return false if the block could not be allocated
+ */
+inline bool prefault_heap(std::size_t bytes) {
+    if (bytes == 0) {
+        return true;
+    }
+    auto* block = static_cast<volatile unsigned char*>(std::malloc(bytes));
+    if (!block) {
+        return false;
+    }
+    for (std::size_t offset = 0; offset < bytes; offset += detail::page_size()) {
+        block[offset] = 0;
+    }
+    std::free(const_cast<unsigned char*>(block));
+    return true;
+}
+
+/**
+ * @brief Fault bytes of the calling thread's stack below the current frame
+ */
+[[gnu::noinline]] inline void prefault_stack(std::size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    auto* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (std::size_t offset = 0; offset < bytes; offset += detail::page_size()) {
+        stack[offset] = 0;
+    }
+    stack[bytes - 1] = 0;
+}
+
+/**
+ * @brief Size of the calling thread's stack (0 if unknown)
+ */
+inline std::size_t current_stack_size() {
+    pthread_attr_t attr;
+    if (::pthread_getattr_np(::pthread_self(), &attr) != 0) {
+        return 0;
+    }
+    void* address = nullptr;
+    std::size_t size = 0;
+    ::pthread_attr_getstack(&attr, &address, &size);
+    ::pthread_attr_destroy(&attr);
+    return size;
+}
+
+/**
+ * @brief Stack bytes prefault_thread_stack() faults in (0 = off, default)
+ */
+inline void set_thread_stack_prefault(std::size_t bytes) {
+    detail::g_thread_stack_prefault.store(bytes, std::memory_order_relaxed);
+}
+
+inline std::size_t thread_stack_prefault() {
+    return detail::g_thread_stack_prefault.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Fault in the calling thread's stack, if stack prefaulting is on
+ *
+ * Called first thing in every module thread and commrat::Thread. Faults
+ * stack_size bytes (ThreadConfig::stack_size) if given, the process-wide
+ * size otherwise; never more than the actual stack minus a safety margin.
+ */
+inline void prefault_thread_stack(std::size_t stack_size = 0) {
+    const std::size_t configured = thread_stack_prefault();
+    if (configured == 0) {
+        return;
+    }
+    std::size_t bytes = stack_size != 0 ? stack_size : configured;
+    const std::size_t actual = current_stack_size();
+    if (actual != 0) {
+        const std::size_t margin = std::min(actual / 2, detail::stack_prefault_margin);
+        bytes = std::min(bytes, actual - margin);
+    }
+    prefault_stack(bytes);
+}
+
+/**
+ * @brief Page faults (minor + major) of the calling thread so far
+ *
+ * Compare before and after a loop iteration to check that a thread runs
+ * without faulting.
+ */
+inline uint64_t thread_page_faults() {
+    struct rusage usage {};
+    if (::getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(usage.ru_minflt) + static_cast<uint64_t>(usage.ru_majflt);
+}
+
+} // namespace commrat
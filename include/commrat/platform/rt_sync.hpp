@@ -0,0 +1,496 @@
+/**
+ * @file rt_sync.hpp
+ * @brief Realtime synchronization: priority inheritance and futex wakeups
+ *
+ * std::mutex does not boost the priority of its owner. A non-RT thread that
+ * holds a lock an RT thread waits for can then be preempted by any thread
+ * in between (priority inversion), for as long as the scheduler likes.
+ * - PiMutex: PI futex (FUTEX_LOCK_PI), the owner runs at the priority of
+ *   its highest waiter until it unlocks. Uncontended lock and unlock are a
+ *   single compare-exchange in user space. Errors (relocking from the
+ *   owner, unlocking from another thread) throw std::system_error.
+ * - PiSharedMutex: writer-preferring reader-writer lock. Readers hold it
+ *   concurrently. A writer holds a PiMutex for its whole exclusive section,
+ *   so blocked readers and writers boost it; it then waits for the readers
+ *   inside to leave. Those readers have no single owner to inherit to, so
+ *   read sections must stay short (ring buffer index and copy).
+ * - FutexConditionVariable: waits on a futex word. Works with any lock
+ *   and has no internal lock of its own, unlike pthread_cond_t whose
+ *   internal lock does not inherit priority. With a PiMutex, notify_all
+ *   requeues the waiters onto the mutex (requeue-PI) instead of waking
+ *   them all at once.
+ *
+ * Mutex/SharedMutex/ConditionVariable select these unless COMMRAT_SYNC_STD
+ * is defined (CMake: -DCOMMRAT_SYNC=std), see the end of this file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <shared_mutex>
+#include <system_error>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace commrat {
+
+namespace detail {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free,
+              "futex word must be a plain 32-bit atomic");
+
+inline long futex(std::atomic<uint32_t>* word, int op, uint32_t value,
+                  const struct timespec* timeout = nullptr,
+                  std::atomic<uint32_t>* word2 = nullptr, uint32_t value3 = 0) noexcept {
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout,
+                     reinterpret_cast<uint32_t*>(word2), value3);
+}
+
+/// FUTEX_CMP_REQUEUE*: the timeout argument carries the requeue count
+inline long futex_requeue(std::atomic<uint32_t>* word, int op, uint32_t wake, uint32_t requeue,
+                          std::atomic<uint32_t>* word2, uint32_t expected) noexcept {
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, wake,
+                     static_cast<uintptr_t>(requeue), reinterpret_cast<uint32_t*>(word2), expected);
+}
+
+} // namespace detail
+
+/**
+ * @brief Mutex with priority inheritance (PI futex)
+ *
+ * The word holds the owner's kernel thread ID (0: unlocked), plus
+ * FUTEX_WAITERS while threads block in the kernel, which then boosts the
+ * owner. Not recursive.
+ */
+class PiMutex {
+public:
+    constexpr PiMutex() noexcept = default;
+    ~PiMutex() = default;
+
+    // Non-copyable, non-movable
+    PiMutex(const PiMutex&) = delete;
+    PiMutex& operator=(const PiMutex&) = delete;
+
+    void lock() {
+        uint32_t expected = 0;
+        if (word_.compare_exchange_strong(expected, current_tid(),
+                                          std::memory_order_acquire, std::memory_order_relaxed)) [[likely]] {
+            return;
+        }
+        // The kernel takes the lock or queues us and boosts the owner
+        while (detail::futex(&word_, FUTEX_LOCK_PI_PRIVATE, 0) != 0) {
+            if (errno != EINTR && errno != EAGAIN) {
+                throw std::system_error(errno, std::generic_category(), "PiMutex: FUTEX_LOCK_PI");
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t expected = 0;
+        return word_.compare_exchange_strong(expected, current_tid(),
+                                             std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() {
+        uint32_t expected = current_tid();
+        if (word_.compare_exchange_strong(expected, 0,
+                                          std::memory_order_release, std::memory_order_relaxed)) [[likely]] {
+            return;
+        }
+        // Waiters queued (the kernel hands the lock over) or not the owner
+        if (detail::futex(&word_, FUTEX_UNLOCK_PI_PRIVATE, 0) != 0) {
+            throw std::system_error(errno, std::generic_category(), "PiMutex: FUTEX_UNLOCK_PI");
+        }
+    }
+
+private:
+    friend class FutexConditionVariable;  // Requeue-PI waits on word_
+
+    static uint32_t current_tid() noexcept {
+        if (tid_ == 0) [[unlikely]] {
+            tid_ = static_cast<uint32_t>(::syscall(SYS_gettid));
+        }
+        return tid_;
+    }
+
+    static void forget_tid() noexcept { tid_ = 0; }
+
+    static inline thread_local uint32_t tid_{0};
+    // A forked child keeps the parent's cached ID but gets its own
+    static inline const int forget_tid_in_child_ = ::pthread_atfork(nullptr, nullptr, &forget_tid);
+
+    std::atomic<uint32_t> word_{0};
+};
+
+/**
+ * @brief Writer-preferring SharedMutex with priority inheritance
+ *
+ * Readers and writers first take writer_ (a PiMutex). Readers only count
+ * themselves in and release it again, so they run concurrently. A writer
+ * keeps it until unlock() and waits for the counted readers to drain: new
+ * readers queue behind it (no writer starvation) and boost it. See the file
+ * comment for what readers cannot inherit.
+ */
+class PiSharedMutex {
+public:
+    constexpr PiSharedMutex() noexcept = default;
+    ~PiSharedMutex() = default;
+
+    // Non-copyable, non-movable
+    PiSharedMutex(const PiSharedMutex&) = delete;
+    PiSharedMutex& operator=(const PiSharedMutex&) = delete;
+
+    void lock() {
+        writer_.lock();
+        writer_waiting_.store(true);
+        // seq_cst pairs with unlock_shared(): either the last reader sees
+        // writer_waiting_ and wakes us, or we see readers_ == 0 here
+        for (uint32_t readers = readers_.load(); readers != 0; readers = readers_.load()) {
+            detail::futex(&readers_, FUTEX_WAIT_PRIVATE, readers);
+        }
+        writer_waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    bool try_lock() {
+        if (!writer_.try_lock()) {
+            return false;
+        }
+        if (readers_.load() != 0) {
+            writer_.unlock();
+            return false;
+        }
+        return true;
+    }
+
+    void unlock() { writer_.unlock(); }
+
+    void lock_shared() {
+        writer_.lock();
+        readers_.fetch_add(1, std::memory_order_relaxed);
+        writer_.unlock();
+    }
+
+    bool try_lock_shared() {
+        if (!writer_.try_lock()) {
+            return false;
+        }
+        readers_.fetch_add(1, std::memory_order_relaxed);
+        writer_.unlock();
+        return true;
+    }
+
+    void unlock_shared() noexcept {
+        if (readers_.fetch_sub(1) == 1 && writer_waiting_.load()) {
+            detail::futex(&readers_, FUTEX_WAKE_PRIVATE, 1);
+        }
+    }
+
+private:
+    PiMutex writer_;
+    std::atomic<uint32_t> readers_{0};
+    std::atomic<bool> writer_waiting_{false};
+};
+
+/**
+ * @brief Condition variable on a futex word, for any lock type
+ *
+ * Every notify bumps a sequence number. A waiter reads it before releasing
+ * the lock and sleeps only while it is unchanged, so a notify between
+ * unlock and sleep is not lost. notify_*() skip the syscall when nobody
+ * waits. Spurious wakeups are possible, as with std::condition_variable.
+ *
+ * Waits on std::unique_lock<PiMutex> (UniqueLock) use requeue-PI: a notify
+ * hands the mutex to one waiter if it is free and moves the other waiters
+ * onto the mutex's PI wait queue, where they boost its owner and take it in
+ * turn instead of all waking to contend for it. Waits on other locks are
+ * plain futex waits, notify_all wakes all of them. As with
+ * std::condition_variable, concurrent waiters must use the same mutex:
+ * PiMutex and other lock types must not wait on one condition variable.
+ */
+class FutexConditionVariable {
+public:
+    constexpr FutexConditionVariable() noexcept = default;
+    ~FutexConditionVariable() = default;
+
+    // Non-copyable, non-movable
+    FutexConditionVariable(const FutexConditionVariable&) = delete;
+    FutexConditionVariable& operator=(const FutexConditionVariable&) = delete;
+
+    void notify_one() noexcept { notify(false); }
+    void notify_all() noexcept { notify(true); }
+
+    template<typename Lock>
+    void wait(Lock& lock) {
+        wait_until(lock, nullptr);
+    }
+
+    template<typename Lock, typename Predicate>
+    void wait(Lock& lock, Predicate pred) {
+        while (!pred()) {
+            wait(lock);
+        }
+    }
+
+    template<typename Lock, typename Rep, typename Period>
+    std::cv_status wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& rel_time) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(rel_time).count();
+        if (ns <= 0) {
+            return std::cv_status::timeout;
+        }
+        const struct timespec deadline = deadline_after(static_cast<int64_t>(ns));
+        return wait_until(lock, &deadline);
+    }
+
+    template<typename Lock, typename Rep, typename Period, typename Predicate>
+    bool wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& rel_time, Predicate pred) {
+        const auto deadline = std::chrono::steady_clock::now() + rel_time;
+        while (!pred()) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return pred();
+            }
+            wait_for(lock, deadline - now);
+        }
+        return true;
+    }
+
+private:
+    /// Absolute CLOCK_MONOTONIC time, as both futex waits below take it
+    static struct timespec deadline_after(int64_t ns) noexcept {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        const int64_t nsec = now.tv_nsec + ns % 1'000'000'000;
+        return {
+            .tv_sec = static_cast<time_t>(now.tv_sec + ns / 1'000'000'000 + nsec / 1'000'000'000),
+            .tv_nsec = static_cast<long>(nsec % 1'000'000'000)
+        };
+    }
+
+    std::cv_status wait_until(std::unique_lock<PiMutex>& lock, const struct timespec* deadline) {
+        PiMutex& mutex = *lock.mutex();
+        const uint32_t seq = seq_.load();
+        requeue_to_.store(&mutex, std::memory_order_relaxed);
+        waiters_.fetch_add(1);
+        mutex.unlock();  // lock still owns it: we hold the mutex again on return
+        const long result = detail::futex(&seq_, FUTEX_WAIT_REQUEUE_PI_PRIVATE, seq, deadline, &mutex.word_);
+        const bool timed_out = result != 0 && errno == ETIMEDOUT;
+        waiters_.fetch_sub(1);
+        if (result != 0) {
+            // Not handed the mutex: notified before sleeping, timeout, signal
+            mutex.lock();
+        }
+        return timed_out ? std::cv_status::timeout : std::cv_status::no_timeout;
+    }
+
+    template<typename Lock>
+    std::cv_status wait_until(Lock& lock, const struct timespec* deadline) {
+        const uint32_t seq = seq_.load();
+        waiters_.fetch_add(1);
+        lock.unlock();
+        const long result = detail::futex(&seq_, FUTEX_WAIT_BITSET_PRIVATE, seq, deadline,
+                                          nullptr, FUTEX_BITSET_MATCH_ANY);
+        const bool timed_out = result != 0 && errno == ETIMEDOUT;
+        waiters_.fetch_sub(1);
+        lock.lock();
+        return timed_out ? std::cv_status::timeout : std::cv_status::no_timeout;
+    }
+
+    void notify(bool all) noexcept {
+        // seq_cst pairs with wait_until(): either the waiter is counted here
+        // or its futex wait sees the new sequence number and returns at once
+        uint32_t seq = seq_.fetch_add(1) + 1;
+        if (waiters_.load() == 0) {
+            return;
+        }
+        PiMutex* mutex = requeue_to_.load(std::memory_order_relaxed);
+        if (mutex == nullptr) {
+            detail::futex(&seq_, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1);
+            return;
+        }
+        // EAGAIN: another notify bumped seq_ in between, requeue for both
+        while (detail::futex_requeue(&seq_, FUTEX_CMP_REQUEUE_PI_PRIVATE, 1, all ? INT_MAX : 0,
+                                     &mutex->word_, seq) < 0 && errno == EAGAIN) {
+            seq = seq_.load();
+        }
+    }
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> waiters_{0};
+    std::atomic<PiMutex*> requeue_to_{nullptr};  ///< Mutex of requeue-PI waiters
+};
+
+/**
+ * @brief std::mutex wrapper (Mutex with COMMRAT_SYNC_STD)
+ * 
+ * No priority inheritance: see PiMutex above.
+ */
+class StdMutex {
+public:
+    StdMutex() = default;
+    ~StdMutex() = default;
+    
+    // Non-copyable, non-movable
+    StdMutex(const StdMutex&) = delete;
+    StdMutex& operator=(const StdMutex&) = delete;
+    
+    void lock() { mutex_.lock(); }
+    bool try_lock() { return mutex_.try_lock(); }
+    void unlock() { mutex_.unlock(); }
+    
+    std::mutex& native() { return mutex_; }
+    
+private:
+    std::mutex mutex_;
+};
+
+/**
+ * @brief std::shared_mutex wrapper (SharedMutex with COMMRAT_SYNC_STD)
+ * 
+ * Multiple readers OR single writer.
+ * Useful for ring buffers where reads are frequent, writes are rare.
+ */
+class StdSharedMutex {
+public:
+    StdSharedMutex() = default;
+    ~StdSharedMutex() = default;
+    
+    // Non-copyable, non-movable
+    StdSharedMutex(const StdSharedMutex&) = delete;
+    StdSharedMutex& operator=(const StdSharedMutex&) = delete;
+    
+    void lock() { mutex_.lock(); }               // Exclusive (write) lock
+    void lock_shared() { mutex_.lock_shared(); } // Shared (read) lock
+    bool try_lock() { return mutex_.try_lock(); }
+    bool try_lock_shared() { return mutex_.try_lock_shared(); }
+    void unlock() { mutex_.unlock(); }
+    void unlock_shared() { mutex_.unlock_shared(); }
+    
+    std::shared_mutex& native() { return mutex_; }
+    
+private:
+    std::shared_mutex mutex_;
+};
+
+/**
+ * @brief std::condition_variable wrapper (ConditionVariable with
+ *        COMMRAT_SYNC_STD)
+ * 
+ * Waits with UniqueLock, or std::unique_lock<std::mutex> on native().
+ */
+class StdConditionVariable {
+public:
+    StdConditionVariable() = default;
+    ~StdConditionVariable() = default;
+    
+    // Non-copyable, non-movable
+    StdConditionVariable(const StdConditionVariable&) = delete;
+    StdConditionVariable& operator=(const StdConditionVariable&) = delete;
+    
+    void notify_one() noexcept { cv_.notify_one(); }
+    void notify_all() noexcept { cv_.notify_all(); }
+    
+    // Accept std::unique_lock<std::mutex> directly for condition variable compatibility
+    void wait(std::unique_lock<std::mutex>& lock) { cv_.wait(lock); }
+    
+    template<typename Predicate>
+    void wait(std::unique_lock<std::mutex>& lock, Predicate pred) {
+        cv_.wait(lock, pred);
+    }
+    
+    template<typename Rep, typename Period>
+    std::cv_status wait_for(std::unique_lock<std::mutex>& lock, 
+                           const std::chrono::duration<Rep, Period>& rel_time) {
+        return cv_.wait_for(lock, rel_time);
+    }
+    
+    // Same on a lock of the wrapper: wait on the adopted std::mutex
+    void wait(std::unique_lock<StdMutex>& lock) {
+        std::unique_lock<std::mutex> native(lock.mutex()->native(), std::adopt_lock);
+        cv_.wait(native);
+        native.release();
+    }
+    
+    template<typename Predicate>
+    void wait(std::unique_lock<StdMutex>& lock, Predicate pred) {
+        std::unique_lock<std::mutex> native(lock.mutex()->native(), std::adopt_lock);
+        cv_.wait(native, pred);
+        native.release();
+    }
+    
+    template<typename Rep, typename Period>
+    std::cv_status wait_for(std::unique_lock<StdMutex>& lock, 
+                           const std::chrono::duration<Rep, Period>& rel_time) {
+        std::unique_lock<std::mutex> native(lock.mutex()->native(), std::adopt_lock);
+        const std::cv_status status = cv_.wait_for(native, rel_time);
+        native.release();
+        return status;
+    }
+    
+    template<typename Rep, typename Period, typename Predicate>
+    bool wait_for(std::unique_lock<StdMutex>& lock, 
+                  const std::chrono::duration<Rep, Period>& rel_time, Predicate pred) {
+        std::unique_lock<std::mutex> native(lock.mutex()->native(), std::adopt_lock);
+        const bool satisfied = cv_.wait_for(native, rel_time, pred);
+        native.release();
+        return satisfied;
+    }
+    
+private:
+    std::condition_variable cv_;
+};
+
+/**
+ * @brief Synchronization backend
+ * 
+ * Default: priority inheritance (PiMutex, PiSharedMutex,
+ * FutexConditionVariable from rt_sync.hpp), so an RT thread waiting for a
+ * lock held by a non-RT thread boosts that thread instead of waiting behind
+ * everything in between. COMMRAT_SYNC_STD (CMake: -DCOMMRAT_SYNC=std)
+ * selects the std:: wrappers above. Defined here rather than in
+ * threading.hpp so that simulated_clock.hpp, which threading.hpp includes,
+ * can lock with them too.
+ */
+#if defined(COMMRAT_SYNC_STD)
+using Mutex = StdMutex;
+using SharedMutex = StdSharedMutex;
+using ConditionVariable = StdConditionVariable;
+#else
+using Mutex = PiMutex;
+using SharedMutex = PiSharedMutex;
+using ConditionVariable = FutexConditionVariable;
+#endif
+
+/**
+ * @brief Scoped lock guard (RAII)
+ * 
+ * Usage:
+ *   Mutex mtx;
+ *   {
+ *     Lock lock(mtx);  // Acquires lock
+ *     // ... critical section ...
+ *   } // Releases lock automatically
+ */
+using Lock = std::lock_guard<Mutex>;
+using UniqueLock = std::unique_lock<Mutex>;
+
+/**
+ * @brief Scoped shared lock (RAII) - for readers
+ */
+using SharedLock = std::shared_lock<SharedMutex>;
+
+/**
+ * @brief Scoped unique lock (RAII) - for writers
+ */
+using UniqueLockShared = std::unique_lock<SharedMutex>;
+
+} // namespace commrat
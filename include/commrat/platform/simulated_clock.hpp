@@ -0,0 +1,368 @@
+/**
+ * @file simulated_clock.hpp
+ * @brief Virtual process-wide time for deterministic faster-than-real-time runs
+ *
+ * With Time::set_clock_source(Time::ClockSource::SIMULATED), Time::now()
+ * returns SimulatedClock::now() and Time::sleep()/sleep_until() wait for
+ * simulated time instead of real time. Nothing advances it on its own: a
+ * controller (usually the test's main thread) calls run_until(), which
+ * repeatedly waits until the pipeline is quiescent and then jumps to the
+ * earliest pending wake-up.
+ *
+ * Quiescent means:
+ * - every participant thread (module threads started via start_thread())
+ *   sleeps or waits in a blocking receive, and
+ * - no message is queued in a loopback mailbox (sent but not yet received)
+ *
+ * so time only moves once all work caused by the current instant is done.
+ * A period of 10ms then costs the few microseconds the pipeline needs to
+ * compute it, and every timestamp is exact and reproducible.
+ *
+ * Requirements and limits:
+ * - Loopback transport (one process); TiMS messages are not tracked
+ * - LoopInput modules never idle; receive timeouts stay in real time
+ * - If the pipeline does not settle within run_until()'s settle time (e.g. a
+ *   message nobody receives), time is advanced anyway and counted as forced
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include "rt_sync.hpp"
+
+namespace commrat {
+
+/**
+ * @brief Controller-driven virtual clock
+ *
+ * All state is process-wide. The hooks (enlist(), begin_wait(), message_*())
+ * are single relaxed loads while the clock is not enabled.
+ */
+class SimulatedClock {
+public:
+    static constexpr uint64_t never = std::numeric_limits<uint64_t>::max();
+
+    /// Result of run_until()
+    struct RunStats {
+        uint64_t steps{0};      ///< Time advances
+        uint64_t forced{0};     ///< Advances without quiescence (settle time exceeded)
+    };
+
+    static bool enabled() noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Switch simulated time on or off (Time::set_clock_source())
+     *
+     * Switching off releases all sleepers.
+     */
+    static void enable(bool on) {
+        Lock lock(mutex_);
+        enabled_.store(on, std::memory_order_relaxed);
+        if (!on) {
+            release_due(never);
+            wake_cv_.notify_all();
+        }
+    }
+
+    static uint64_t now() noexcept {
+        return now_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Set the current time, e.g. to a recording's start (nothing may sleep)
+     */
+    static void reset(uint64_t start_ns) {
+        Lock lock(mutex_);
+        now_.store(start_ns, std::memory_order_release);
+    }
+
+    // ========================================================================
+    // Waiting
+    // ========================================================================
+
+    /**
+     * @brief Block until simulated time reaches wake_ns
+     *
+     * Also returns when the clock is disabled, or after interrupt() once
+     * running is false (module stop() must not depend on the controller).
+     */
+    static void sleep_until(uint64_t wake_ns, const std::atomic<bool>* running = nullptr) {
+        UniqueLock lock(mutex_);
+        if (wake_ns <= now_.load(std::memory_order_relaxed)) {
+            return;
+        }
+        wait_for_release(lock, wake_ns, running);
+    }
+
+    /**
+     * @brief Wait until the pipeline is quiescent at the current instant
+     *
+     * For consumers of several inputs: everything published at this instant
+     * has been received once it returns, independent of thread scheduling.
+     * Returns immediately when the clock is not enabled; running as for
+     * sleep_until().
+     */
+    static void settle(const std::atomic<bool>* running = nullptr) {
+        if (!enabled()) {
+            return;
+        }
+        UniqueLock lock(mutex_);
+        wait_for_release(lock, now_.load(std::memory_order_relaxed), running);
+    }
+
+    /**
+     * @brief Re-check the running flags of interrupted sleepers
+     */
+    static void interrupt() {
+        if (!enabled()) {
+            return;
+        }
+        Lock lock(mutex_);
+        wake_cv_.notify_all();
+    }
+
+    // ========================================================================
+    // Participants and transport hooks
+    // ========================================================================
+
+    /**
+     * @brief Count a thread about to be started as busy (called by the spawner)
+     *
+     * Counting before the thread exists keeps the controller from advancing
+     * while it starts up.
+     *
+     * @return true if the new thread must construct a Participant(true)
+     */
+    static bool enlist() {
+        if (!enabled()) {
+            return false;
+        }
+        Lock lock(mutex_);
+        ++busy_;
+        return true;
+    }
+
+    /**
+     * @brief Marks the calling thread as participant for its lifetime
+     */
+    class Participant {
+    public:
+        explicit Participant(bool enlisted) : enlisted_(enlisted) {
+            participant_ = enlisted;
+        }
+        ~Participant() {
+            if (enlisted_) {
+                participant_ = false;
+                Lock lock(mutex_);
+                --busy_;
+                notify_if_quiescent();
+            }
+        }
+        Participant(const Participant&) = delete;
+        Participant& operator=(const Participant&) = delete;
+
+    private:
+        bool enlisted_;
+    };
+
+    /// A participant blocks in a receive
+    static void begin_wait() {
+        if (participant_ && enabled()) {
+            Lock lock(mutex_);
+            --busy_;
+            notify_if_quiescent();
+        }
+    }
+
+    /// ... and returns from it (before message_dequeued())
+    static void end_wait() {
+        if (participant_ && enabled()) {
+            Lock lock(mutex_);
+            ++busy_;
+        }
+    }
+
+    /// A message was queued for delivery; true if it is counted
+    static bool message_queued() {
+        if (!enabled()) {
+            return false;
+        }
+        Lock lock(mutex_);
+        ++in_flight_;
+        return true;
+    }
+
+    /// Counted messages were received or discarded
+    static void messages_dequeued(uint64_t count = 1) {
+        Lock lock(mutex_);
+        in_flight_ -= static_cast<int64_t>(count);
+        notify_if_quiescent();
+    }
+
+    // ========================================================================
+    // Controller
+    // ========================================================================
+
+    /**
+     * @brief Wait until the pipeline is quiescent
+     *
+     * @return false if it did not settle within real_timeout
+     */
+    static bool wait_quiescent(std::chrono::milliseconds real_timeout) {
+        UniqueLock lock(mutex_);
+        return idle_cv_.wait_for(lock, real_timeout, [] { return quiescent(); });
+    }
+
+    /**
+     * @brief Earliest pending wake-up (never = nobody sleeps)
+     */
+    static uint64_t next_wakeup() {
+        Lock lock(mutex_);
+        return earliest();
+    }
+
+    /**
+     * @brief Move time forward (never backwards) and wake everything due
+     */
+    static void advance_to(uint64_t ns) {
+        Lock lock(mutex_);
+        if (ns > now_.load(std::memory_order_relaxed)) {
+            now_.store(ns, std::memory_order_release);
+        }
+        release_due(now_.load(std::memory_order_relaxed));
+        wake_cv_.notify_all();
+    }
+
+    /**
+     * @brief Drive time until end_ns
+     *
+     * Each step waits for quiescence (at most settle of real time), releases
+     * settle() waiters, then advances to the next wake-up. Ends with
+     * now() == end_ns.
+     */
+    static RunStats run_until(uint64_t end_ns,
+                              std::chrono::milliseconds settle_time = std::chrono::milliseconds(200)) {
+        RunStats stats;
+        while (true) {
+            const bool quiet = wait_quiescent(settle_time);
+            Lock lock(mutex_);
+            const uint64_t current = now_.load(std::memory_order_relaxed);
+            const uint64_t next = earliest();
+            if (!quiet) {
+                ++stats.forced;
+            }
+            if (next <= current) {
+                release_due(current);   // settle() waiters
+            } else if (next <= end_ns) {
+                now_.store(next, std::memory_order_release);
+                release_due(next);
+                ++stats.steps;
+            } else {
+                now_.store(std::max(current, end_ns), std::memory_order_release);
+                break;
+            }
+            wake_cv_.notify_all();
+        }
+        return stats;
+    }
+
+    /// Participants currently running (diagnostics)
+    static int64_t busy() {
+        Lock lock(mutex_);
+        return busy_;
+    }
+
+    /// Messages queued and not yet received (diagnostics)
+    static int64_t in_flight() {
+        Lock lock(mutex_);
+        return in_flight_;
+    }
+
+private:
+    /// Lives on the sleeping thread's stack, linked into sleepers_ (no allocation)
+    struct Sleeper {
+        uint64_t wake_ns;
+        bool participant;
+        bool released{false};
+        Sleeper* next{nullptr};
+    };
+
+    /// Caller holds mutex_
+    static void wait_for_release(UniqueLock& lock, uint64_t wake_ns,
+                                 const std::atomic<bool>* running) {
+        Sleeper sleeper{wake_ns, participant_};
+        sleeper.next = sleepers_.next;
+        sleepers_.next = &sleeper;
+        if (sleeper.participant) {
+            --busy_;
+            notify_if_quiescent();
+        }
+        wake_cv_.wait(lock, [&] {
+            return sleeper.released || (running && !running->load(std::memory_order_relaxed));
+        });
+        if (!sleeper.released) {
+            // Interrupted: running again on its own
+            Sleeper** link = &sleepers_.next;
+            while (*link != &sleeper) {
+                link = &(*link)->next;
+            }
+            *link = sleeper.next;
+            if (sleeper.participant) {
+                ++busy_;
+            }
+        }
+    }
+
+    /// Released sleepers count as busy right away, before they get scheduled
+    static void release_due(uint64_t ns) {
+        Sleeper** link = &sleepers_.next;
+        while (Sleeper* s = *link) {
+            if (s->wake_ns > ns) {
+                link = &s->next;
+                continue;
+            }
+            *link = s->next;        // Unlink before the owner may return
+            if (s->participant) {
+                ++busy_;
+            }
+            s->released = true;
+        }
+    }
+
+    static uint64_t earliest() {
+        uint64_t next = never;
+        for (const Sleeper* s = sleepers_.next; s != nullptr; s = s->next) {
+            next = std::min(next, s->wake_ns);
+        }
+        return next;
+    }
+
+    static bool quiescent() {
+        return busy_ <= 0 && in_flight_ <= 0;
+    }
+
+    static void notify_if_quiescent() {
+        if (quiescent()) {
+            idle_cv_.notify_all();
+        }
+    }
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::atomic<uint64_t> now_{0};
+    static inline Mutex mutex_;
+    static inline ConditionVariable wake_cv_;    ///< Sleepers
+    static inline ConditionVariable idle_cv_;    ///< Controller
+    static inline Sleeper sleepers_{0, false, false, nullptr};  ///< List head (sentinel)
+    static inline int64_t busy_{0};
+    static inline int64_t in_flight_{0};
+    static inline thread_local bool participant_{false};
+};
+
+} // namespace commrat
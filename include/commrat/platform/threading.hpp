@@ -4,7 +4,7 @@
  * 
  * Provides clean abstractions for:
  * - Thread creation and management
- * - Mutexes and locks (with future realtime support)
+ * - Mutexes and locks (priority inheritance by default, see rt_sync.hpp)
  * - Thread priorities and affinity
  * 
  * Future: Can be switched to realtime thread APIs (pthread RT, SCHED_FIFO, etc.)
@@ -22,6 +22,10 @@
 #include <string>
 #include <cstdint>
 
+#include "rt_memory.hpp"
+#include "rt_sync.hpp"
+#include "simulated_clock.hpp"
+
 // For future realtime support
 #include <pthread.h>
 #include <sched.h>
@@ -60,6 +64,55 @@ struct ThreadConfig {
     size_t stack_size = 0;  ///< 0 = default, > 0 = custom stack size
 };
 
+/**
+ * @brief Apply a thread configuration (name, priority, policy, affinity)
+ *        to the calling thread
+ * 
+ * Used by Thread, and by threads started with start_thread() that need a
+ * ThreadConfig.
+ */
+inline void configure_current_thread(const ThreadConfig& config) {
+    pthread_t thread_handle = pthread_self();
+    
+    // Set thread name (Linux-specific)
+#ifdef __linux__
+    if (!config.name.empty()) {
+        pthread_setname_np(thread_handle, config.name.c_str());
+    }
+#endif
+    
+    // Set scheduling policy and priority
+    if (config.policy != SchedulingPolicy::NORMAL || 
+        config.priority != ThreadPriority::NORMAL) {
+        
+        int policy = SCHED_OTHER;
+        switch (config.policy) {
+            case SchedulingPolicy::FIFO:
+                policy = SCHED_FIFO;
+                break;
+            case SchedulingPolicy::ROUND_ROBIN:
+                policy = SCHED_RR;
+                break;
+            default:
+                policy = SCHED_OTHER;
+        }
+        
+        struct sched_param param;
+        param.sched_priority = static_cast<int>(config.priority);
+        
+        // Note: Requires CAP_SYS_NICE capability or root for SCHED_FIFO/RR
+        pthread_setschedparam(thread_handle, policy, &param);
+    }
+    
+    // Set CPU affinity
+    if (config.cpu_affinity >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(config.cpu_affinity, &cpuset);
+        pthread_setaffinity_np(thread_handle, sizeof(cpu_set_t), &cpuset);
+    }
+}
+
 /**
  * @brief Thread wrapper with realtime support
  * 
@@ -181,169 +234,61 @@ private:
      */
     template<typename Func>
     void thread_function(Func&& func) {
-        // Set thread name (Linux-specific)
-#ifdef __linux__
-        if (!config_.name.empty()) {
-            pthread_setname_np(pthread_self(), config_.name.c_str());
-        }
-#endif
+        // Name, priority, scheduling policy and affinity
+        configure_current_thread(config_);
         
-        // Set priority and scheduling policy
-        apply_thread_config();
+        // Fault in the stack before any work (no-op unless enabled)
+        prefault_thread_stack(config_.stack_size);
         
         // Run user function
         func();
     }
     
-    /**
-     * @brief Apply thread configuration (priority, affinity, policy)
-     */
-    void apply_thread_config() {
-        pthread_t thread_handle = pthread_self();
-        
-        // Set scheduling policy and priority
-        if (config_.policy != SchedulingPolicy::NORMAL || 
-            config_.priority != ThreadPriority::NORMAL) {
-            
-            int policy = SCHED_OTHER;
-            switch (config_.policy) {
-                case SchedulingPolicy::FIFO:
-                    policy = SCHED_FIFO;
-                    break;
-                case SchedulingPolicy::ROUND_ROBIN:
-                    policy = SCHED_RR;
-                    break;
-                default:
-                    policy = SCHED_OTHER;
-            }
-            
-            struct sched_param param;
-            param.sched_priority = static_cast<int>(config_.priority);
-            
-            // Note: Requires CAP_SYS_NICE capability or root for SCHED_FIFO/RR
-            pthread_setschedparam(thread_handle, policy, &param);
-        }
-        
-        // Set CPU affinity
-        if (config_.cpu_affinity >= 0) {
-            cpu_set_t cpuset;
-            CPU_ZERO(&cpuset);
-            CPU_SET(config_.cpu_affinity, &cpuset);
-            pthread_setaffinity_np(thread_handle, sizeof(cpu_set_t), &cpuset);
-        }
-    }
-    
     ThreadConfig config_;
     std::thread thread_;
 };
 
 /**
- * @brief Mutex wrapper (future: realtime mutex support)
+ * @brief Realtime scheduling of the calling thread
  * 
- * Currently wraps std::mutex, future can switch to priority-inheriting mutex.
- */
-class Mutex {
-public:
-    Mutex() = default;
-    ~Mutex() = default;
-    
-    // Non-copyable, non-movable
-    Mutex(const Mutex&) = delete;
-    Mutex& operator=(const Mutex&) = delete;
-    
-    void lock() { mutex_.lock(); }
-    bool try_lock() { return mutex_.try_lock(); }
-    void unlock() { mutex_.unlock(); }
-    
-    std::mutex& native() { return mutex_; }
-    
-private:
-    std::mutex mutex_;
-};
-
-/**
- * @brief Shared mutex wrapper (reader-writer lock)
+ * fifo_priority 1..99 switches to SCHED_FIFO at that priority, 0 keeps the
+ * current policy. cpu_affinity >= 0 pins the thread to that CPU.
  * 
- * Multiple readers OR single writer.
- * Useful for ring buffers where reads are frequent, writes are rare.
+ * @return false if the kernel refused a change (SCHED_FIFO needs
+ *         CAP_SYS_NICE or an RLIMIT_RTPRIO, the CPU may not exist)
  */
-class SharedMutex {
-public:
-    SharedMutex() = default;
-    ~SharedMutex() = default;
-    
-    // Non-copyable, non-movable
-    SharedMutex(const SharedMutex&) = delete;
-    SharedMutex& operator=(const SharedMutex&) = delete;
-    
-    void lock() { mutex_.lock(); }               // Exclusive (write) lock
-    void lock_shared() { mutex_.lock_shared(); } // Shared (read) lock
-    bool try_lock() { return mutex_.try_lock(); }
-    bool try_lock_shared() { return mutex_.try_lock_shared(); }
-    void unlock() { mutex_.unlock(); }
-    void unlock_shared() { mutex_.unlock_shared(); }
-    
-    std::shared_mutex& native() { return mutex_; }
-    
-private:
-    std::shared_mutex mutex_;
-};
+inline bool set_current_thread_scheduling(int fifo_priority, int cpu_affinity) {
+    bool ok = true;
+    if (fifo_priority > 0) {
+        struct sched_param param;
+        param.sched_priority = fifo_priority;
+        ok = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+    if (cpu_affinity >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu_affinity, &cpuset);
+        ok = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0 && ok;
+    }
+    return ok;
+}
 
 /**
- * @brief Scoped lock guard (RAII)
+ * @brief Start a module thread
  * 
- * Usage:
- *   Mutex mtx;
- *   {
- *     Lock lock(mtx);  // Acquires lock
- *     // ... critical section ...
- *   } // Releases lock automatically
- */
-using Lock = std::lock_guard<Mutex>;
-using UniqueLock = std::unique_lock<Mutex>;
-
-/**
- * @brief Scoped shared lock (RAII) - for readers
+ * The thread faults in its stack first (prefault_thread_stack()) and takes
+ * part in simulated time: the time controller does not advance while it
+ * runs, only while it sleeps or waits for a message.
  */
-using SharedLock = std::shared_lock<SharedMutex>;
-
-/**
- * @brief Scoped unique lock (RAII) - for writers
- */
-using UniqueLockShared = std::unique_lock<SharedMutex>;
-
-/**
- * @brief Condition variable wrapper
- */
-class ConditionVariable {
-public:
-    ConditionVariable() = default;
-    ~ConditionVariable() = default;
-    
-    // Non-copyable, non-movable
-    ConditionVariable(const ConditionVariable&) = delete;
-    ConditionVariable& operator=(const ConditionVariable&) = delete;
-    
-    void notify_one() noexcept { cv_.notify_one(); }
-    void notify_all() noexcept { cv_.notify_all(); }
-    
-    // Accept std::unique_lock<std::mutex> directly for condition variable compatibility
-    void wait(std::unique_lock<std::mutex>& lock) { cv_.wait(lock); }
-    
-    template<typename Predicate>
-    void wait(std::unique_lock<std::mutex>& lock, Predicate pred) {
-        cv_.wait(lock, pred);
-    }
-    
-    template<typename Rep, typename Period>
-    std::cv_status wait_for(std::unique_lock<std::mutex>& lock, 
-                           const std::chrono::duration<Rep, Period>& rel_time) {
-        return cv_.wait_for(lock, rel_time);
-    }
-    
-private:
-    std::condition_variable cv_;
-};
+template<typename Func>
+std::thread start_thread(Func&& func) {
+    const bool enlisted = SimulatedClock::enlist();
+    return std::thread([enlisted, f = std::forward<Func>(func)]() mutable {
+        SimulatedClock::Participant participant(enlisted);
+        prefault_thread_stack();
+        f();
+    });
+}
 
 /**
  * @brief Scoped synchronized block - convenience wrapper
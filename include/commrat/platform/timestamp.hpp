@@ -13,6 +13,10 @@
 
 #pragma once
 
+#include "simulated_clock.hpp"
+#include "tsc_clock.hpp"
+#include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <thread>  // For std::this_thread::sleep_for
 #include <cstdint>
@@ -59,7 +63,9 @@ public:
         STEADY_CLOCK,      ///< std::chrono::steady_clock (monotonic)
         HIGH_RES_CLOCK,    ///< std::chrono::high_resolution_clock
         REALTIME_CLOCK,    ///< CLOCK_REALTIME (future: PTP, NTP sync)
-        MONOTONIC_CLOCK    ///< CLOCK_MONOTONIC (future: realtime monotonic)
+        MONOTONIC_CLOCK,   ///< CLOCK_MONOTONIC (future: realtime monotonic)
+        TSC,               ///< Invariant TSC calibrated to CLOCK_MONOTONIC (falls back to it)
+        SIMULATED          ///< SimulatedClock: virtual time advanced by a controller
     };
     
     /**
@@ -68,11 +74,35 @@ public:
      * @return Current time as uint64_t nanoseconds
      * 
      * Real-time safe: Yes (if using MONOTONIC_CLOCK)
+     * 
+     * Returns the calling thread's virtual time instead while one is set
+     * (VirtualTimeScope), whatever the clock source. See VirtualTimeScope
+     * for how it relates to ClockSource::SIMULATED.
      */
     static Timestamp now() noexcept {
+        if (thread_virtual_time_ != 0) [[unlikely]] {
+            return thread_virtual_time_;
+        }
         return get_timestamp(current_clock_source_);
     }
     
+    /**
+     * @brief Override now() for the calling thread only (0 = real clock)
+     * 
+     * Used by offline reprocessing, where each worker thread runs its own
+     * part of a recording at the recorded times.
+     */
+    static void set_thread_virtual_time(Timestamp ns) noexcept {
+        thread_virtual_time_ = ns;
+    }
+    
+    /**
+     * @brief Virtual time of the calling thread (0 = none)
+     */
+    static Timestamp thread_virtual_time() noexcept {
+        return thread_virtual_time_;
+    }
+    
     /**
      * @brief Get current timestamp from specific clock source
      * 
@@ -93,6 +123,12 @@ public:
                 
             case ClockSource::MONOTONIC_CLOCK:
                 return posix_clock_now(CLOCK_MONOTONIC);
+
+            case ClockSource::TSC:
+                return TscClock::now();
+                
+            case ClockSource::SIMULATED:
+                return SimulatedClock::now();
                 
             default:
                 return steady_clock_now();
@@ -102,12 +138,29 @@ public:
     /**
      * @brief Set default clock source for all future now() calls
      * 
+     * ClockSource::TSC is calibrated here (~20ms) so the first now() on a
+     * hot path does not pay for it. ClockSource::SIMULATED also makes
+     * sleep()/sleep_until() wait for simulated time.
+     * 
      * @param source Clock source to use
      * 
      * Not thread-safe: Should be called once at initialization
      */
     static void set_clock_source(ClockSource source) noexcept {
+        if (source == ClockSource::TSC && TscClock::state() == TscClock::State::UNCALIBRATED) {
+            TscClock::calibrate();
+        }
         current_clock_source_ = source;
+        if ((source == ClockSource::SIMULATED) != SimulatedClock::enabled()) {
+            SimulatedClock::enable(source == ClockSource::SIMULATED);
+        }
+    }
+
+    /**
+     * @brief Get default clock source used by now()
+     */
+    static ClockSource clock_source() noexcept {
+        return current_clock_source_;
     }
     
     /**
@@ -181,16 +234,42 @@ public:
         return diff(timestamp, target) <= tolerance_ns;
     }
     
+    /**
+     * @brief First tick at or after t on the grid k * period_ns + phase_ns
+     * 
+     * The grid is anchored at the clock's epoch, so every thread and process
+     * reading the same clock computes the same ticks (tick alignment).
+     * 
+     * @param t Earliest acceptable tick
+     * @param period_ns Grid period (> 0)
+     * @param phase_ns Offset into the period (taken modulo period_ns)
+     */
+    static constexpr Timestamp next_tick(Timestamp t, Timestamp period_ns, Timestamp phase_ns) noexcept {
+        phase_ns %= period_ns;
+        if (t <= phase_ns) {
+            return phase_ns;
+        }
+        return phase_ns + (t - phase_ns + period_ns - 1) / period_ns * period_ns;
+    }
+    
     /**
      * @brief Sleep for specified nanoseconds
      * 
-     * Uses high-resolution sleep if available.
+     * Uses high-resolution sleep if available. Waits for simulated time with
+     * ClockSource::SIMULATED.
      * 
      * @param ns Nanoseconds to sleep
      * 
      * Real-time safe: Depends on OS scheduler
+     * 
+     * noexcept: the simulated wait does not allocate; a failing lock there is
+     * unrecoverable and terminates, like a failing sleep_for would.
      */
     static void sleep_ns(Timestamp ns) noexcept {
+        if (SimulatedClock::enabled()) {
+            SimulatedClock::sleep_until(SimulatedClock::now() + ns);
+            return;
+        }
         std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
     }
     
@@ -199,11 +278,73 @@ public:
      */
     template<typename Rep, typename Period>
     static void sleep(std::chrono::duration<Rep, Period> duration) noexcept {
+        sleep_ns(to_nanoseconds(duration));
+    }
+    
+    /**
+     * @brief Sleep for duration; a simulated-time sleep also ends once
+     *        running is false and SimulatedClock::interrupt() is called
+     * 
+     * Used by module loops so stop() does not wait for the time controller.
+     */
+    template<typename Rep, typename Period>
+    static void sleep(std::chrono::duration<Rep, Period> duration, const std::atomic<bool>& running) noexcept {
+        if (SimulatedClock::enabled()) {
+            SimulatedClock::sleep_until(SimulatedClock::now() + to_nanoseconds(duration), &running);
+            return;
+        }
         std::this_thread::sleep_for(duration);
     }
+    
+    /**
+     * @brief Sleep until now() reaches deadline (returns at once if it has)
+     * 
+     * Clock sources in the CLOCK_MONOTONIC domain (STEADY, HIGH_RES,
+     * MONOTONIC, TSC) sleep with an absolute clock_nanosleep(), so preemption
+     * between reading the clock and sleeping does not delay the wakeup.
+     * SYSTEM/REALTIME can step and sleep for the remaining duration instead,
+     * as does a thread with virtual time (VirtualTimeScope).
+     */
+    static void sleep_until(Timestamp deadline) noexcept {
+        if (SimulatedClock::enabled()) {
+            SimulatedClock::sleep_until(deadline);
+            return;
+        }
+        if (is_monotonic(current_clock_source_) && thread_virtual_time_ == 0) {
+            const struct timespec ts{
+                .tv_sec = static_cast<time_t>(deadline / 1'000'000'000),
+                .tv_nsec = static_cast<long>(deadline % 1'000'000'000)
+            };
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+            }
+            // TSC may still trail CLOCK_MONOTONIC by its slew, topped up below
+        }
+        const Timestamp current = now();
+        if (deadline > current) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - current));
+        }
+    }
+    
+    /**
+     * @brief Sleep until deadline; a simulated-time sleep also ends once
+     *        running is false and SimulatedClock::interrupt() is called
+     */
+    static void sleep_until(Timestamp deadline, const std::atomic<bool>& running) noexcept {
+        if (SimulatedClock::enabled()) {
+            SimulatedClock::sleep_until(deadline, &running);
+            return;
+        }
+        sleep_until(deadline);
+    }
 
 private:
     // Implementation helpers
+    static constexpr bool is_monotonic(ClockSource source) noexcept {
+        // libstdc++/libc++ steady_clock reads CLOCK_MONOTONIC on Linux, TSC is calibrated to it
+        return source == ClockSource::STEADY_CLOCK || source == ClockSource::HIGH_RES_CLOCK ||
+               source == ClockSource::MONOTONIC_CLOCK || source == ClockSource::TSC;
+    }
+    
     static Timestamp system_clock_now() noexcept {
         auto now = std::chrono::system_clock::now();
         auto duration = now.time_since_epoch();
@@ -228,6 +369,41 @@ private:
     
     // Default clock source (can be changed via set_clock_source)
     static inline ClockSource current_clock_source_ = ClockSource::STEADY_CLOCK;
+    
+    // Per-thread override of now() (set_thread_virtual_time)
+    static inline thread_local Timestamp thread_virtual_time_ = 0;
+};
+
+/**
+ * @brief RAII virtual time for the calling thread
+ * 
+ * Not the same as ClockSource::SIMULATED, and it wins over it in now():
+ * - VirtualTimeScope is per thread and set directly by the code that owns
+ *   the thread (offline reprocessing: one worker per chunk, each at its own
+ *   record's time). Nothing sleeps on it and nothing else advances it.
+ * - SimulatedClock is one process-wide time that a controller advances
+ *   while live module threads sleep on it.
+ * A process-wide clock cannot give parallel workers different times, and a
+ * per-thread value cannot wake sleepers, so neither replaces the other. The
+ * cost in now() is one thread-local load, which stays in cache.
+ * 
+ * Usage:
+ *   VirtualTimeScope clock;
+ *   clock.set(record.receive_ns);  // Time::now() on this thread returns it
+ */
+class VirtualTimeScope {
+public:
+    VirtualTimeScope() : previous_(Time::thread_virtual_time()) {}
+    explicit VirtualTimeScope(Timestamp ns) : VirtualTimeScope() { set(ns); }
+    ~VirtualTimeScope() { Time::set_thread_virtual_time(previous_); }
+    
+    VirtualTimeScope(const VirtualTimeScope&) = delete;
+    VirtualTimeScope& operator=(const VirtualTimeScope&) = delete;
+    
+    void set(Timestamp ns) noexcept { Time::set_thread_virtual_time(ns); }
+    
+private:
+    Timestamp previous_;
 };
 
 /**
@@ -21,6 +21,7 @@ struct TimsConfig {
     std::string mailbox_name;
     uint32_t mailbox_id;
     size_t max_msg_size;
+    size_t message_slots;
     uint32_t priority;
     bool realtime;
     
@@ -28,6 +29,7 @@ struct TimsConfig {
         : mailbox_name("default")
         , mailbox_id(0)
         , max_msg_size(4096)
+        , message_slots(10)
         , priority(0)
         , realtime(false) {}
 };
@@ -40,9 +42,46 @@ enum class TimsResult {
     ERROR_RECEIVE = -3,
     ERROR_TIMEOUT = -4,
     ERROR_INVALID_MESSAGE = -5,
-    ERROR_NOT_INITIALIZED = -6
+    ERROR_NOT_INITIALIZED = -6,
+    ERROR_QUEUE_FULL = -7          ///< Destination mailbox has no free slot
 };
 
+/**
+ * @brief Transport used by all TimsWrappers of the process
+ *
+ * - Router: TiMS mailboxes via the TiMS router (default)
+ * - Loopback: in-process stand-in with TiMS semantics (bounded slots, max
+ *   message size, blocking/timed/non-blocking receive). Only reaches
+ *   mailboxes of the same process - for benchmarks and tests on machines
+ *   without a TiMS router.
+ *
+ * Must be selected before the first mailbox is started.
+ */
+enum class TimsTransport {
+    Router,
+    Loopback
+};
+
+/// Direction of a message passed to a TrafficTap
+enum class TrafficDirection : uint8_t {
+    Sent = 1,
+    Received = 2
+};
+
+/**
+ * @brief Process-wide observer of every message sent or received
+ *
+ * Called on the sending/receiving thread after the transport succeeded,
+ * with the destination (Sent) or receiving (Received) mailbox and the
+ * wire bytes. Must not block. Used by the flight recorder.
+ */
+using TrafficTap = void (*)(TrafficDirection direction, uint32_t mailbox_id,
+                            std::span<const std::byte> wire) noexcept;
+
+namespace detail {
+struct LoopbackMailbox;
+}
+
 // Modern C++ wrapper around TiMS with compile-time safety
 class TimsWrapper {
 public:
@@ -121,6 +160,17 @@ public:
         return receive_raw(buffer.data(), buffer.size(), timeout);
     }
     
+    TimsResult send_raw_bytes(std::span<const std::byte> data, uint32_t dest_mailbox_id) {
+        return send_raw(data.data(), data.size(), dest_mailbox_id);
+    }
+    
+    // Process-wide transport selection (see TimsTransport)
+    static void set_transport(TimsTransport transport);
+    static TimsTransport transport();
+    
+    // Process-wide traffic observer (see TrafficTap), nullptr to remove
+    static void set_traffic_tap(TrafficTap tap);
+    
 private:
     TimsResult send_raw(const void* data, size_t size, uint32_t dest_mailbox_id);
     ssize_t receive_raw(void* buffer, size_t buffer_size, Milliseconds timeout);
@@ -131,6 +181,7 @@ private:
     std::atomic<uint64_t> messages_sent_;
     std::atomic<uint64_t> messages_received_;
     uint32_t sequence_number_;
+    std::shared_ptr<detail::LoopbackMailbox> loopback_;  // Loopback transport only
 };
 
 } // namespace commrat
@@ -0,0 +1,401 @@
+/**
+ * @file tracing.hpp
+ * @brief Cross-module causal tracing with Chrome/Perfetto trace export
+ *
+ * Every published message carries (trace_id, span_id) in its TimsHeader:
+ * - trace_id: one causal chain, started by a source module (PeriodicInput /
+ *   LoopInput iteration) and inherited by every module downstream
+ *   (Input<T>: from the input, Inputs<...>: from the primary input)
+ * - span_id: the process() span that produced the message; the consumer's
+ *   receive/process spans point back to it
+ *
+ * Spans (loop, receive, sync, process, publish) are recorded into per-thread
+ * ring buffers (single writer, no locks, oldest records overwritten) and
+ * exported as Chrome JSON (chrome://tracing, ui.perfetto.dev). Producer
+ * publish -> consumer receive hops are drawn as flow arrows; traces of
+ * several processes are merged with the commrat_trace_merge tool.
+ *
+ * Tracing is off by default; when off, every span is a single relaxed load.
+ */
+
+#pragma once
+
+#include "rt_sync.hpp"
+#include "timestamp.hpp"
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace commrat {
+
+/**
+ * @brief Kind of a recorded span
+ */
+enum class SpanKind : uint8_t {
+    Loop,       ///< One data loop iteration (excluding idle sleep)
+    Receive,    ///< Blocking receive of an input message
+    Sync,       ///< Multi-input synchronization (gather_all_inputs)
+    Process,    ///< User process() call
+    Publish     ///< Publishing outputs to subscribers
+};
+
+constexpr const char* to_string(SpanKind kind) {
+    switch (kind) {
+        case SpanKind::Loop:    return "loop";
+        case SpanKind::Receive: return "receive";
+        case SpanKind::Sync:    return "sync";
+        case SpanKind::Process: return "process";
+        case SpanKind::Publish: return "publish";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Causal context of the current thread
+ *
+ * Stamped into the header of every message sent by this thread
+ * (Mailbox::send), unless the header already carries a trace id.
+ */
+struct TraceContext {
+    uint64_t trace_id{0};
+    uint64_t span_id{0};
+};
+
+/**
+ * @brief One finished span
+ */
+struct SpanRecord {
+    uint64_t trace_id{0};
+    uint64_t span_id{0};
+    uint64_t link_id{0};    ///< Receive/Process: producing span, Publish: stamped span
+    uint64_t start_ns{0};
+    uint64_t end_ns{0};
+    uint16_t name_id{0};    ///< Tracer::register_name()
+    SpanKind kind{SpanKind::Loop};
+};
+
+/**
+ * @brief Per-thread span ring buffer (single writer)
+ */
+class TraceBuffer {
+public:
+    static constexpr std::size_t capacity = 4096;  // Power of two
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    TraceBuffer(uint32_t tid, std::string thread_name)
+        : tid_(tid), thread_name_(std::move(thread_name)) {}
+
+    void push(const SpanRecord& record) noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        records_[head & (capacity - 1)] = record;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy out the buffered records (oldest first)
+     *
+     * Records the writer may have overwritten during the copy are dropped.
+     */
+    std::vector<SpanRecord> snapshot() const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        uint64_t first = head > capacity ? head - capacity : 0;
+        std::vector<SpanRecord> out;
+        out.reserve(static_cast<std::size_t>(head - first));
+        for (uint64_t i = first; i < head; ++i) {
+            out.push_back(records_[i & (capacity - 1)]);
+        }
+        uint64_t head_after = head_.load(std::memory_order_acquire);
+        uint64_t overwritten = head_after > capacity ? head_after - capacity : 0;
+        if (overwritten > first) {
+            out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(
+                std::min<uint64_t>(overwritten - first, out.size())));
+        }
+        return out;
+    }
+
+    void clear() noexcept { head_.store(0, std::memory_order_release); }
+
+    uint32_t tid() const noexcept { return tid_; }
+    const std::string& thread_name() const noexcept { return thread_name_; }
+
+    /// Total records written, including overwritten ones
+    uint64_t total_records() const noexcept { return head_.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t tid_;
+    std::string thread_name_;
+    std::atomic<uint64_t> head_{0};
+    std::array<SpanRecord, capacity> records_{};
+};
+
+/**
+ * @brief Process-wide tracer (all static)
+ *
+ * Real-time safe: record()/new_id()/current() yes (after the thread's first
+ * span, which allocates its TraceBuffer); register_name(), name_thread()
+ * and write_chrome_trace() no.
+ */
+class Tracer {
+public:
+    static void enable(bool on = true) noexcept { enabled_.store(on, std::memory_order_relaxed); }
+    static bool enabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Register a span name (module name), returns its id
+     */
+    static uint16_t register_name(std::string_view name) {
+        Lock lock(registry_mutex());
+        auto& names = registered_names();
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        names.emplace_back(name);
+        return static_cast<uint16_t>(names.size() - 1);
+    }
+
+    /**
+     * @brief Name the calling thread in exported traces (before its first span)
+     */
+    static void name_thread(std::string name) {
+        thread_name() = std::move(name);
+    }
+
+    /// Causal context of the calling thread
+    static TraceContext& current() noexcept {
+        thread_local TraceContext context;
+        return context;
+    }
+
+    /**
+     * @brief Start a new trace on this thread (source modules, per iteration)
+     */
+    static void start_trace() noexcept {
+        if (enabled()) {
+            current() = TraceContext{new_id(), 0};
+        }
+    }
+
+    /**
+     * @brief Continue the trace of a received message on this thread
+     * @return Span that produced the message (0 if untraced)
+     */
+    template<typename HeaderT>
+    static uint64_t continue_trace(const HeaderT& header) noexcept {
+        if (!enabled()) {
+            return 0;
+        }
+        current() = TraceContext{header.trace_id != 0 ? header.trace_id : new_id(), 0};
+        return header.span_id;
+    }
+
+    /**
+     * @brief Globally unique non-zero id (trace and span ids)
+     *
+     * Per-thread counter mixed with a per-process random seed, so ids from
+     * different processes do not collide in merged traces.
+     */
+    static uint64_t new_id() noexcept {
+        thread_local uint64_t counter = 0;
+        thread_local uint64_t thread_salt = next_thread_salt_.fetch_add(1, std::memory_order_relaxed) << 40;
+        uint64_t id = mix(process_seed() ^ thread_salt ^ ++counter);
+        return id != 0 ? id : 1;
+    }
+
+    /**
+     * @brief Append a finished span to the calling thread's buffer
+     */
+    static void record(const SpanRecord& span) {
+        thread_buffer().push(span);
+    }
+
+    /**
+     * @brief Export all buffered spans as Chrome JSON trace
+     *
+     * Safe while modules run (records being overwritten are skipped).
+     * @return false if the file could not be written
+     */
+    static bool write_chrome_trace(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (file == nullptr) {
+            return false;
+        }
+
+        std::vector<std::shared_ptr<TraceBuffer>> buffers;
+        std::vector<std::string> names;
+        {
+            Lock lock(registry_mutex());
+            buffers = thread_buffers();
+            names = registered_names();
+        }
+
+        const long pid = static_cast<long>(::getpid());
+        bool first = true;
+        auto separator = [&]() {
+            std::fputs(first ? "\n" : ",\n", file);
+            first = false;
+        };
+
+        std::fputs("{\"traceEvents\":[", file);
+        for (const auto& buffer : buffers) {
+            separator();
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,"
+                               "\"args\":{\"name\":\"%s\"}}",
+                         pid, buffer->tid(), buffer->thread_name().c_str());
+
+            for (const auto& span : buffer->snapshot()) {
+                const char* name = span.name_id < names.size() ? names[span.name_id].c_str() : "?";
+                separator();
+                std::fprintf(file, "{\"name\":\"%s.%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                                   "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%u,"
+                                   "\"args\":{\"trace_id\":\"%016" PRIx64 "\",\"span_id\":\"%016" PRIx64
+                                   "\",\"link_id\":\"%016" PRIx64 "\"}}",
+                             name, to_string(span.kind), to_string(span.kind),
+                             static_cast<double>(span.start_ns) / 1000.0,
+                             static_cast<double>(span.end_ns - span.start_ns) / 1000.0,
+                             pid, buffer->tid(), span.trace_id, span.span_id, span.link_id);
+
+                // Hop between modules: publish (flow start) -> receive (flow end)
+                if (span.link_id != 0 && (span.kind == SpanKind::Publish || span.kind == SpanKind::Receive)) {
+                    bool start = span.kind == SpanKind::Publish;
+                    separator();
+                    std::fprintf(file, "{\"name\":\"message\",\"cat\":\"flow\",\"ph\":\"%s\",%s"
+                                       "\"id\":\"0x%016" PRIx64 "\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%u}",
+                                 start ? "s" : "f", start ? "" : "\"bp\":\"e\",",
+                                 span.link_id,
+                                 static_cast<double>(start ? span.start_ns : span.end_ns) / 1000.0,
+                                 pid, buffer->tid());
+                }
+            }
+        }
+        std::fputs("\n]}\n", file);
+        return std::fclose(file) == 0;
+    }
+
+    /**
+     * @brief Drop all buffered spans (threads keep their buffers)
+     */
+    static void clear() {
+        Lock lock(registry_mutex());
+        for (auto& buffer : thread_buffers()) {
+            buffer->clear();
+        }
+    }
+
+private:
+    static uint64_t mix(uint64_t x) noexcept {
+        // splitmix64 finalizer
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    static uint64_t process_seed() noexcept {
+        static const uint64_t seed =
+            mix(Time::get_timestamp(Time::ClockSource::SYSTEM_CLOCK) ^ (static_cast<uint64_t>(::getpid()) << 32));
+        return seed;
+    }
+
+    static std::string& thread_name() {
+        thread_local std::string name;
+        return name;
+    }
+
+    static TraceBuffer& thread_buffer() {
+        thread_local std::shared_ptr<TraceBuffer> buffer = [] {
+            auto tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+            std::string name = thread_name().empty() ? "thread-" + std::to_string(tid) : thread_name();
+            auto created = std::make_shared<TraceBuffer>(tid, std::move(name));
+            Lock lock(registry_mutex());
+            thread_buffers().push_back(created);  // Outlives the thread for export
+            return created;
+        }();
+        return *buffer;
+    }
+
+    static Mutex& registry_mutex() {
+        static Mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<std::shared_ptr<TraceBuffer>>& thread_buffers() {
+        static std::vector<std::shared_ptr<TraceBuffer>> buffers;
+        return buffers;
+    }
+
+    static std::vector<std::string>& registered_names() {
+        static std::vector<std::string> names;
+        return names;
+    }
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::atomic<uint64_t> next_thread_salt_{1};
+};
+
+/**
+ * @brief RAII span: records [construction, end()] when tracing is enabled
+ *
+ * A Process span becomes the thread's current span, so the messages it
+ * publishes point back to it.
+ *
+ * @code
+ * TraceSpan process_span(SpanKind::Process, name_id, input.header.span_id);
+ * process(input, output);
+ * process_span.end();
+ * @endcode
+ */
+class TraceSpan {
+public:
+    TraceSpan(SpanKind kind, uint16_t name_id, uint64_t link_id = 0) noexcept
+        : active_(Tracer::enabled()) {
+        if (active_) {
+            span_ = SpanRecord{
+                .trace_id = 0,
+                .span_id = Tracer::new_id(),
+                .link_id = link_id,
+                .start_ns = Time::now(),
+                .end_ns = 0,
+                .name_id = name_id,
+                .kind = kind
+            };
+            if (kind == SpanKind::Process) {
+                Tracer::current().span_id = span_.span_id;
+            } else if (kind == SpanKind::Publish) {
+                span_.link_id = Tracer::current().span_id;
+            }
+        }
+    }
+
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /// Set the producing span once it is known (Receive spans)
+    void set_link(uint64_t link_id) noexcept { span_.link_id = link_id; }
+
+    void end() {
+        if (active_) {
+            active_ = false;
+            span_.trace_id = Tracer::current().trace_id;
+            span_.end_ns = Time::now();
+            Tracer::record(span_);
+        }
+    }
+
+private:
+    bool active_;
+    SpanRecord span_{};
+};
+
+} // namespace commrat
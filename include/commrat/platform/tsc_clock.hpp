@@ -0,0 +1,319 @@
+/**
+ * @file tsc_clock.hpp
+ * @brief Low-overhead timestamps from the CPU time stamp counter (TSC)
+ *
+ * Reads the invariant TSC (rdtsc, no syscall, no vDSO) and converts ticks to
+ * nanoseconds in the CLOCK_MONOTONIC domain, so TSC timestamps can be mixed
+ * with Time::ClockSource::STEADY_CLOCK / MONOTONIC_CLOCK timestamps.
+ *
+ * - Calibration: TSC frequency measured against CLOCK_MONOTONIC (~20ms, once)
+ * - Resync: every resync_interval_ns the conversion is re-anchored to
+ *   CLOCK_MONOTONIC; drift is slewed out over the next interval (no steps,
+ *   no backwards jumps)
+ * - Fallback: without invariant TSC (or non-x86), with an implausible
+ *   frequency, or when a resync finds the TSC off by more than
+ *   max_resync_error_ns, now() permanently falls back to CLOCK_MONOTONIC
+ *
+ * Usually selected via Time::set_clock_source(Time::ClockSource::TSC).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define COMMRAT_HAS_TSC 1
+#else
+#define COMMRAT_HAS_TSC 0
+#endif
+
+namespace commrat {
+
+/**
+ * @brief TSC clock with calibration, periodic resync and automatic fallback
+ *
+ * All state is static (one TSC per machine). now() is lock-free: readers use
+ * a sequence lock, only the thread that wins the resync flag writes.
+ *
+ * Real-time safe: now() yes (after calibration), calibrate() no (sleeps)
+ */
+class TscClock {
+public:
+    /// Re-anchor to CLOCK_MONOTONIC this often
+    static constexpr uint64_t resync_interval_ns = 1'000'000'000;      // 1 s
+
+    /// Larger deviation at resync marks the TSC unreliable
+    static constexpr uint64_t max_resync_error_ns = 500'000;           // 500 us
+
+    /// Calibration measurement window
+    static constexpr uint64_t calibration_window_ns = 20'000'000;      // 20 ms
+
+    /// Accepted TSC frequency range (sanity check)
+    static constexpr uint64_t min_frequency_hz = 100'000'000;          // 100 MHz
+    static constexpr uint64_t max_frequency_hz = 10'000'000'000;       // 10 GHz
+
+    enum class State : uint8_t {
+        UNCALIBRATED,   ///< calibrate() not run yet
+        RELIABLE,       ///< now() reads the TSC
+        UNRELIABLE      ///< now() falls back to CLOCK_MONOTONIC
+    };
+
+    /**
+     * @brief Check for an invariant TSC (constant rate, runs in all C-states)
+     */
+    static bool hardware_supported() noexcept {
+#if COMMRAT_HAS_TSC
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+            return false;
+        }
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;  // Invariant TSC
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Measure the TSC frequency against CLOCK_MONOTONIC
+     *
+     * Blocks for calibration_window_ns. Called automatically by
+     * Time::set_clock_source(ClockSource::TSC) and by the first now().
+     * Concurrent callers do not wait - they see the previous state.
+     *
+     * @return true if the TSC is usable
+     */
+    static bool calibrate() noexcept {
+        if (writer_busy_.exchange(true, std::memory_order_acquire)) {
+            return is_reliable();
+        }
+
+        State result = State::UNRELIABLE;
+        if (hardware_supported()) {
+            Sample start = sample();
+            std::this_thread::sleep_for(std::chrono::nanoseconds(calibration_window_ns));
+            Sample end = sample();
+
+            uint64_t elapsed_ns = end.ns - start.ns;
+            uint64_t elapsed_ticks = end.ticks - start.ticks;
+            uint64_t freq = (elapsed_ns > 0 && end.ticks > start.ticks)
+                ? static_cast<uint64_t>(static_cast<uint128>(elapsed_ticks) * 1'000'000'000 / elapsed_ns)
+                : 0;
+
+            if (freq >= min_frequency_hz && freq <= max_frequency_hz) {
+                frequency_hz_.store(freq, std::memory_order_relaxed);
+                store_params(Params{
+                    .base_ticks = end.ticks,
+                    .base_ns = end.ns,
+                    .mult = (uint64_t{1'000'000'000} << shift) / freq,
+                    .resync_ticks = static_cast<uint64_t>(
+                        static_cast<uint128>(resync_interval_ns) * freq / 1'000'000'000)
+                });
+                result = State::RELIABLE;
+            }
+        }
+
+        state_.store(result, std::memory_order_release);
+        writer_busy_.store(false, std::memory_order_release);
+        return result == State::RELIABLE;
+    }
+
+    /**
+     * @brief Current time in nanoseconds (CLOCK_MONOTONIC domain)
+     */
+    static uint64_t now() noexcept {
+        State state = state_.load(std::memory_order_acquire);
+        if (state != State::RELIABLE) [[unlikely]] {
+            if (state == State::UNRELIABLE || !calibrate()) {
+                return monotonic_ns();
+            }
+        }
+
+        uint64_t ticks = read_ticks();
+        Params p = load_params();
+
+        // Another thread re-anchored after we read the TSC
+        if (ticks <= p.base_ticks) {
+            return p.base_ns;
+        }
+
+        uint64_t delta = ticks - p.base_ticks;
+        if (delta >= p.resync_ticks) [[unlikely]] {
+            resync();
+        }
+        return p.base_ns + scale(delta, p.mult);
+    }
+
+    /**
+     * @brief Raw TSC ticks
+     */
+    static uint64_t read_ticks() noexcept {
+#if COMMRAT_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Permanently switch now() to CLOCK_MONOTONIC
+     */
+    static void disable() noexcept {
+        state_.store(State::UNRELIABLE, std::memory_order_release);
+    }
+
+    static State state() noexcept { return state_.load(std::memory_order_acquire); }
+    static bool is_reliable() noexcept { return state() == State::RELIABLE; }
+
+    /// Calibrated TSC frequency (0 if never calibrated)
+    static uint64_t frequency_hz() noexcept { return frequency_hz_.load(std::memory_order_relaxed); }
+
+    /// Number of successful re-anchors since calibration
+    static uint64_t resync_count() noexcept { return resync_count_.load(std::memory_order_relaxed); }
+
+    /// Deviation from CLOCK_MONOTONIC found at the last resync (ns)
+    static uint64_t last_resync_error_ns() noexcept { return last_resync_error_ns_.load(std::memory_order_relaxed); }
+
+private:
+#if COMMRAT_HAS_TSC
+    __extension__ typedef unsigned __int128 uint128;
+#else
+    using uint128 = uint64_t;  // TSC path is never taken without x86-64
+#endif
+
+    // ns = base_ns + (ticks - base_ticks) * mult >> shift
+    static constexpr unsigned shift = 32;
+
+    struct Params {
+        uint64_t base_ticks;
+        uint64_t base_ns;
+        uint64_t mult;
+        uint64_t resync_ticks;
+    };
+
+    struct Sample {
+        uint64_t ticks;
+        uint64_t ns;
+    };
+
+    static uint64_t scale(uint64_t delta_ticks, uint64_t mult) noexcept {
+        return static_cast<uint64_t>((static_cast<uint128>(delta_ticks) * mult) >> shift);
+    }
+
+    static uint64_t monotonic_ns() noexcept {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    /**
+     * @brief Paired (TSC, CLOCK_MONOTONIC) reading
+     *
+     * The clock_gettime call is bracketed by two TSC reads; the tightest of a
+     * few attempts is used, its midpoint is the matching tick count.
+     */
+    static Sample sample() noexcept {
+        Sample best{0, 0};
+        uint64_t best_width = UINT64_MAX;
+        for (int i = 0; i < 5; ++i) {
+            uint64_t t0 = read_ticks();
+            uint64_t ns = monotonic_ns();
+            uint64_t t1 = read_ticks();
+            if (t1 >= t0 && t1 - t0 < best_width) {
+                best_width = t1 - t0;
+                best = Sample{t0 + (t1 - t0) / 2, ns};
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Re-anchor to CLOCK_MONOTONIC, slewing out the drift
+     *
+     * The new anchor is the current TSC prediction (continuous), and the new
+     * rate reaches CLOCK_MONOTONIC exactly one resync interval later.
+     */
+    static void resync() noexcept {
+        if (writer_busy_.exchange(true, std::memory_order_acquire)) {
+            return;  // Another thread is already re-anchoring
+        }
+
+        Params p = load_params();
+        Sample now = sample();
+        if (now.ticks > p.base_ticks) {
+            uint64_t predicted = p.base_ns + scale(now.ticks - p.base_ticks, p.mult);
+            uint64_t error = (predicted > now.ns) ? predicted - now.ns : now.ns - predicted;
+            last_resync_error_ns_.store(error, std::memory_order_relaxed);
+
+            if (error > max_resync_error_ns) {
+                state_.store(State::UNRELIABLE, std::memory_order_release);
+            } else {
+                uint64_t target_ns = now.ns + resync_interval_ns - predicted;
+                store_params(Params{
+                    .base_ticks = now.ticks,
+                    .base_ns = predicted,
+                    .mult = static_cast<uint64_t>(
+                        (static_cast<uint128>(target_ns) << shift) / p.resync_ticks),
+                    .resync_ticks = p.resync_ticks
+                });
+                resync_count_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        writer_busy_.store(false, std::memory_order_release);
+    }
+
+    // Sequence lock: odd sequence = write in progress
+    static Params load_params() noexcept {
+        for (;;) {
+            uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1) {
+                continue;
+            }
+            Params p{
+                base_ticks_.load(std::memory_order_relaxed),
+                base_ns_.load(std::memory_order_relaxed),
+                mult_.load(std::memory_order_relaxed),
+                resync_ticks_.load(std::memory_order_relaxed)
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                return p;
+            }
+        }
+    }
+
+    static void store_params(const Params& p) noexcept {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        base_ticks_.store(p.base_ticks, std::memory_order_relaxed);
+        base_ns_.store(p.base_ns, std::memory_order_relaxed);
+        mult_.store(p.mult, std::memory_order_relaxed);
+        resync_ticks_.store(p.resync_ticks, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    static inline std::atomic<State> state_{State::UNCALIBRATED};
+    static inline std::atomic<bool> writer_busy_{false};
+
+    static inline std::atomic<uint32_t> seq_{0};
+    static inline std::atomic<uint64_t> base_ticks_{0};
+    static inline std::atomic<uint64_t> base_ns_{0};
+    static inline std::atomic<uint64_t> mult_{0};
+    static inline std::atomic<uint64_t> resync_ticks_{1};
+
+    static inline std::atomic<uint64_t> frequency_hz_{0};
+    static inline std::atomic<uint64_t> resync_count_{0};
+    static inline std::atomic<uint64_t> last_resync_error_ns_{0};
+};
+
+} // namespace commrat
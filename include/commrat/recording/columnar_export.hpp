@@ -0,0 +1,693 @@
+/**
+ * @file columnar_export.hpp
+ * @brief Columnar export of recordings for offline analysis
+ *
+ * ColumnarExporter<App> converts the streams of a recording (Recorder<App>
+ * or FlightRecorder log) into a column store: one directory per stream
+ * with one raw little-endian array file per leaf field and a
+ * `columns.json` manifest. Every column can be memory-mapped directly,
+ * e.g. `np.memmap(dir / col["file"], dtype=col["dtype"])`.
+ *
+ * Layout of a stream directory:
+ * - `timestamp`, `seq_number` (TimsHeader) and `receive_ns` (recording)
+ *   columns shared by all payload columns of the stream, one row each
+ * - scalar fields (nested structs flattened to `pose.x`): one value per row
+ * - std::array fields: `shape` values per row, stored row-major
+ * - fixed_vector / fixed_string fields: a `<name>.offsets` column of
+ *   rows + 1 uint64 element offsets and the concatenated values; vectors
+ *   of structs get one values column per leaf, sharing the offsets
+ *
+ * The field table (ColumnarLayout) is computed once per type by
+ * reflecting over a default TimsMessage<T>: byte offsets, element sizes
+ * and strides of every leaf. Records are decoded into a batch of
+ * TimsMessage<T> and every column is gathered from the batch with a
+ * fixed-size strided copy per element, so the per-row work is a handful
+ * of loads and stores and no per-field dispatch. Fields that do not fit
+ * the model (lists inside lists, other containers) are listed as
+ * `skipped` in the manifest.
+ */
+
+#pragma once
+
+#include "commrat/recording/log_reader.hpp"
+#include "commrat/messages.hpp"
+#include <rfl.hpp>
+#include <sertial/containers/fixed_string.hpp>
+#include <sertial/containers/fixed_vector.hpp>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace commrat {
+
+// ============================================================================
+// Field Table
+// ============================================================================
+
+/**
+ * @brief One output column: a leaf field at a fixed byte offset
+ *
+ * Row (or list element) r holds `count` values of `size` bytes at
+ * `base + offset + i * stride`, where base is the TimsMessage<T> of the row,
+ * or the list element if `list` >= 0.
+ */
+struct ColumnSpec {
+    std::string name;           ///< Dotted path relative to the payload
+    const char* dtype;          ///< NumPy type string ("<f8", "<u4", "|u1", ...)
+    uint32_t size;              ///< Bytes per value
+    uint32_t offset;            ///< Byte offset in the row (or list element)
+    uint32_t count{1};          ///< Values per row (std::array extent)
+    uint32_t stride{0};         ///< Bytes between the values of one row
+    int32_t list{-1};           ///< Index into ColumnarLayout::lists, -1 = one entry per row
+};
+
+/**
+ * @brief A variable-length field: fixed_vector or fixed_string
+ */
+struct ListSpec {
+    std::string name;           ///< Dotted path; offsets column is `<name>.offsets`
+    bool string{false};         ///< fixed_string (values are UTF-8 bytes)
+    uint32_t offset;            ///< Byte offset of the container in the row
+    uint32_t element_size;      ///< Bytes between consecutive elements
+    uint32_t capacity;          ///< Maximum number of elements
+    std::size_t (*length)(const std::byte* container);
+    const std::byte* (*elements)(const std::byte* container);  ///< Only called if length > 0
+    void (*resize)(std::byte* container, std::size_t length);   ///< Default elements ('x' for strings)
+};
+
+/**
+ * @brief Flattened field table of TimsMessage<T>
+ */
+struct ColumnarLayout {
+    std::vector<ColumnSpec> columns;     ///< Header columns first, then payload leaves
+    std::vector<ListSpec> lists;
+    std::vector<std::string> skipped;    ///< Fields without a column
+    std::size_t row_size{0};             ///< sizeof(TimsMessage<T>)
+};
+
+namespace columnar_detail {
+
+template<typename T> struct is_std_array : std::false_type {};
+template<typename E, std::size_t N> struct is_std_array<std::array<E, N>> : std::true_type {
+    using element_type = E;
+    static constexpr std::size_t extent = N;
+};
+
+template<typename T> struct is_fixed_vector : std::false_type {};
+template<typename E, std::size_t N> struct is_fixed_vector<sertial::fixed_vector<E, N>> : std::true_type {
+    using element_type = E;
+    static constexpr std::size_t capacity = N;
+};
+
+template<typename T> struct is_fixed_string : std::false_type {};
+template<std::size_t N> struct is_fixed_string<sertial::fixed_string<N>> : std::true_type {
+    static constexpr std::size_t capacity = N;
+};
+
+template<typename T>
+constexpr const char* dtype() {
+    if constexpr (std::is_enum_v<T>) {
+        return dtype<std::underlying_type_t<T>>();
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return "|b1";
+    } else if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported floating point width");
+        return sizeof(T) == 4 ? "<f4" : "<f8";
+    } else {
+        constexpr bool is_signed = std::is_signed_v<T>;
+        switch (sizeof(T)) {
+            case 1: return is_signed ? "|i1" : "|u1";
+            case 2: return is_signed ? "<i2" : "<u2";
+            case 4: return is_signed ? "<i4" : "<u4";
+            default: return is_signed ? "<i8" : "<u8";
+        }
+    }
+}
+
+template<typename T>
+constexpr bool is_scalar_field = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+/// Position of the field being visited: inside a std::array and/or a list
+struct Placement {
+    uint32_t count{1};
+    uint32_t stride{0};
+    int32_t list{-1};
+};
+
+inline std::string join(const std::string& prefix, std::string_view name) {
+    return prefix.empty() ? std::string(name) : prefix + "." + std::string(name);
+}
+
+template<typename F>
+void flatten(ColumnarLayout& layout, const std::string& name, F& value,
+             const std::byte* base, Placement at) {
+    const auto offset = static_cast<uint32_t>(reinterpret_cast<const std::byte*>(&value) - base);
+
+    if constexpr (is_scalar_field<F>) {
+        layout.columns.push_back(ColumnSpec{
+            .name = name, .dtype = dtype<F>(), .size = sizeof(F), .offset = offset,
+            .count = at.count, .stride = at.count > 1 ? at.stride : 0, .list = at.list
+        });
+    } else if constexpr (is_std_array<F>::value) {
+        using E = typename is_std_array<F>::element_type;
+        if (at.count > 1 || is_std_array<F>::extent == 0) {
+            layout.skipped.push_back(name);
+            return;
+        }
+        flatten(layout, name, value[0], base,
+                Placement{static_cast<uint32_t>(is_std_array<F>::extent), sizeof(E), at.list});
+    } else if constexpr (is_fixed_string<F>::value) {
+        if (at.list >= 0 || at.count > 1) {
+            layout.skipped.push_back(name);
+            return;
+        }
+        const auto list = static_cast<int32_t>(layout.lists.size());
+        layout.lists.push_back(ListSpec{
+            .name = name, .string = true, .offset = offset, .element_size = 1,
+            .capacity = static_cast<uint32_t>(is_fixed_string<F>::capacity),
+            .length = [](const std::byte* p) -> std::size_t {
+                return reinterpret_cast<const F*>(p)->view().size();
+            },
+            .elements = [](const std::byte* p) {
+                return reinterpret_cast<const std::byte*>(reinterpret_cast<const F*>(p)->view().data());
+            },
+            .resize = [](std::byte* p, std::size_t length) {
+                *reinterpret_cast<F*>(p) = F(std::string(length, 'x').c_str());
+            }
+        });
+        layout.columns.push_back(ColumnSpec{
+            .name = name, .dtype = "|u1", .size = 1, .offset = 0, .list = list
+        });
+    } else if constexpr (is_fixed_vector<F>::value) {
+        using E = typename is_fixed_vector<F>::element_type;
+        if (at.list >= 0 || at.count > 1) {
+            layout.skipped.push_back(name);
+            return;
+        }
+        const auto list = static_cast<int32_t>(layout.lists.size());
+        layout.lists.push_back(ListSpec{
+            .name = name, .offset = offset, .element_size = sizeof(E),
+            .capacity = static_cast<uint32_t>(is_fixed_vector<F>::capacity),
+            .length = [](const std::byte* p) -> std::size_t {
+                return reinterpret_cast<const F*>(p)->size();
+            },
+            .elements = [](const std::byte* p) {
+                return reinterpret_cast<const std::byte*>(&(*reinterpret_cast<const F*>(p))[0]);
+            },
+            .resize = [](std::byte* p, std::size_t length) {
+                auto& vector = *reinterpret_cast<F*>(p);
+                vector.clear();
+                for (std::size_t i = 0; i < length; ++i) {
+                    vector.push_back(E{});
+                }
+            }
+        });
+        E element{};
+        flatten(layout, name, element, reinterpret_cast<const std::byte*>(&element), Placement{1, 0, list});
+    } else if constexpr (std::is_class_v<F> && std::is_aggregate_v<F>) {
+        rfl::to_view(value).apply([&](const auto& field) {
+            flatten(layout, join(name, field.name()), *field.value(), base, at);
+        });
+    } else {
+        layout.skipped.push_back(name);
+    }
+}
+
+/// Copy `rows` x `count` values of Size bytes from a strided source into a packed array
+template<std::size_t Size>
+void gather(const std::byte* src, std::size_t row_stride, std::size_t rows,
+            std::size_t count, std::size_t stride, std::byte* out) {
+    if (count == 1) {
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::memcpy(out + r * Size, src + r * row_stride, Size);
+        }
+        return;
+    }
+    for (std::size_t r = 0; r < rows; ++r) {
+        const std::byte* row = src + r * row_stride;
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(out, row + i * stride, Size);
+            out += Size;
+        }
+    }
+}
+
+inline void gather(std::size_t size, const std::byte* src, std::size_t row_stride, std::size_t rows,
+                   std::size_t count, std::size_t stride, std::byte* out) {
+    switch (size) {
+        case 1: gather<1>(src, row_stride, rows, count, stride, out); break;
+        case 2: gather<2>(src, row_stride, rows, count, stride, out); break;
+        case 4: gather<4>(src, row_stride, rows, count, stride, out); break;
+        case 8: gather<8>(src, row_stride, rows, count, stride, out); break;
+        default:
+            for (std::size_t r = 0; r < rows; ++r) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    std::memcpy(out, src + r * row_stride + i * stride, size);
+                    out += size;
+                }
+            }
+    }
+}
+
+/// Append-only column file with its own write buffer
+class ColumnFile {
+public:
+    explicit ColumnFile(const std::filesystem::path& path) : path_(path) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "[ColumnarExporter] open " + path.string());
+        }
+        buffer_.resize(buffer_bytes);
+    }
+
+    ~ColumnFile() {
+        if (fd_ >= 0) {
+            flush();
+            ::close(fd_);
+        }
+    }
+
+    ColumnFile(const ColumnFile&) = delete;
+    ColumnFile& operator=(const ColumnFile&) = delete;
+
+    /// Writable space for `bytes` more bytes, valid until the next call
+    std::byte* extend(std::size_t bytes) {
+        if (used_ + bytes > buffer_.size()) {
+            flush();
+            if (bytes > buffer_.size()) {
+                buffer_.resize(bytes);
+            }
+        }
+        std::byte* out = buffer_.data() + used_;
+        used_ += bytes;
+        written_ += bytes;
+        return out;
+    }
+
+    void append(const void* data, std::size_t bytes) {
+        std::memcpy(extend(bytes), data, bytes);
+    }
+
+    void flush() {
+        std::size_t done = 0;
+        while (done < used_) {
+            const ssize_t n = ::write(fd_, buffer_.data() + done, used_ - done);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "[ColumnarExporter] write " + path_.string());
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        used_ = 0;
+    }
+
+    uint64_t bytes() const { return written_; }
+    std::string file_name() const { return path_.filename().string(); }
+
+private:
+    static constexpr std::size_t buffer_bytes = 256 * 1024;
+
+    std::filesystem::path path_;
+    int fd_{-1};
+    std::vector<std::byte> buffer_;
+    std::size_t used_{0};
+    uint64_t written_{0};
+};
+
+} // namespace columnar_detail
+
+/**
+ * @brief Field table of TimsMessage<PayloadT>, computed once
+ *
+ * Columns: `timestamp` and `seq_number` from the header, then the payload
+ * leaves in declaration order.
+ */
+template<typename PayloadT>
+const ColumnarLayout& columnar_layout() {
+    static const ColumnarLayout layout = [] {
+        ColumnarLayout l;
+        TimsMessage<PayloadT> sample{};
+        const auto* base = reinterpret_cast<const std::byte*>(&sample);
+        l.row_size = sizeof(sample);
+        columnar_detail::flatten(l, "timestamp", sample.header.timestamp, base, {});
+        columnar_detail::flatten(l, "seq_number", sample.header.seq_number, base, {});
+        columnar_detail::flatten(l, "", sample.payload, base, {});
+        return l;
+    }();
+    return layout;
+}
+
+// ============================================================================
+// Exporter
+// ============================================================================
+
+/**
+ * @brief Columnar export configuration
+ */
+struct ColumnarExportConfig {
+    std::string directory{"."};                  ///< LogWriterConfig::directory of the recording
+    std::string prefix{"commrat"};               ///< LogWriterConfig::prefix of the recording
+    std::string output_directory{"columnar"};    ///< Created if missing; one subdirectory per stream
+    uint64_t start_ns{0};                        ///< First receive time exported (0 = beginning)
+    uint64_t end_ns{0};                          ///< Receive time limit, exclusive (0 = end)
+    std::function<bool(const LogStreamInfo&)> stream_filter{};  ///< Streams to export (empty = all)
+    std::size_t batch_rows{1024};                ///< Records decoded before the columns are gathered
+};
+
+/**
+ * @brief Export counters
+ */
+struct ColumnarExportStats {
+    uint64_t streams{0};          ///< Stream directories written
+    uint64_t rows{0};             ///< Records exported
+    uint64_t skipped_records{0};  ///< Unknown message type or failed to deserialize
+    uint64_t bytes{0};            ///< Column bytes written
+    uint64_t elapsed_ns{0};       ///< Wall time of run()
+};
+
+/**
+ * @brief Converts a recording into per-stream column files
+ *
+ * @tparam App CommRaT application (message registry of the recording)
+ *
+ * @code
+ * ColumnarExporter<MyApp> exporter(ColumnarExportConfig{
+ *     .directory = "/data/run42", .prefix = "run", .output_directory = "/data/run42/columns"});
+ * auto stats = exporter.run();
+ * @endcode
+ *
+ * ```python
+ * m = json.load(open("columns/imu_1_0/columns.json"))
+ * cols = {c["name"]: np.memmap("columns/imu_1_0/" + c["file"], dtype=c["dtype"], mode="r")
+ *         for c in m["columns"]}
+ * ```
+ */
+template<typename App>
+class ColumnarExporter {
+public:
+    explicit ColumnarExporter(ColumnarExportConfig config)
+        : config_(std::move(config))
+        , segments_(list_log_segments(config_.directory, config_.prefix)) {
+        if (config_.batch_rows == 0) {
+            throw std::invalid_argument("[ColumnarExporter] batch_rows must be positive");
+        }
+        if (segments_.empty()) {
+            throw std::runtime_error("[ColumnarExporter] No segments '" + config_.prefix + "' in " + config_.directory);
+        }
+    }
+
+    ColumnarExporter(const ColumnarExporter&) = delete;
+    ColumnarExporter& operator=(const ColumnarExporter&) = delete;
+
+    /**
+     * @brief Export all selected streams; existing column files are replaced
+     */
+    ColumnarExportStats run() {
+        const auto wall_start = std::chrono::steady_clock::now();
+        ColumnarExportStats stats;
+        std::filesystem::create_directories(config_.output_directory);
+
+        std::vector<std::unique_ptr<StreamColumns>> streams;  // By stream_id
+        std::vector<bool> excluded;
+        std::map<std::string, int> directory_names;
+
+        for (const auto& path : segments_) {
+            LogSegmentReader reader(path);
+            for (const auto& info : reader.streams()) {
+                if (info.stream_id >= excluded.size()) {
+                    excluded.resize(info.stream_id + 1, false);
+                    streams.resize(info.stream_id + 1);
+                }
+                excluded[info.stream_id] = config_.stream_filter && !config_.stream_filter(info);
+            }
+            if (config_.start_ns != 0) {
+                reader.seek_time(config_.start_ns);
+            }
+
+            while (auto record = reader.next()) {
+                if (config_.end_ns != 0 && record->receive_ns >= config_.end_ns) {
+                    break;
+                }
+                if (record->receive_ns < config_.start_ns ||
+                    record->stream_id >= excluded.size() || excluded[record->stream_id]) {
+                    continue;
+                }
+                auto& stream = streams[record->stream_id];
+                if (!stream) {
+                    const LogStreamInfo* info = reader.stream(record->stream_id);
+                    stream = info ? make_stream(*info, directory_names) : nullptr;
+                    if (!stream) {
+                        ++stats.skipped_records;
+                        continue;
+                    }
+                }
+                if (stream->add(*record)) {
+                    ++stats.rows;
+                } else {
+                    ++stats.skipped_records;
+                }
+            }
+        }
+
+        for (auto& stream : streams) {
+            if (stream) {
+                stats.bytes += stream->finish();
+                ++stats.streams;
+            }
+        }
+        stats.elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_start).count());
+        return stats;
+    }
+
+private:
+    /// Column files of one stream; the typed part decodes batches of its message type
+    class StreamColumns {
+    public:
+        virtual ~StreamColumns() = default;
+        virtual bool add(const LogRecord& record) = 0;
+        virtual uint64_t finish() = 0;
+    };
+
+    template<typename PayloadT>
+    class TypedStreamColumns final : public StreamColumns {
+        using Row = TimsMessage<PayloadT>;
+        using ColumnFile = columnar_detail::ColumnFile;
+
+    public:
+        TypedStreamColumns(std::filesystem::path directory, const LogStreamInfo& info, std::size_t batch_rows)
+            : directory_(std::move(directory))
+            , info_(info)
+            , layout_(columnar_layout<PayloadT>())
+            , batch_rows_(batch_rows) {
+            std::filesystem::create_directories(directory_);
+            batch_.reserve(batch_rows_);
+            receive_ns_.reserve(batch_rows_);
+            receive_file_ = std::make_unique<ColumnFile>(directory_ / "receive_ns.bin");
+            for (const auto& column : layout_.columns) {
+                files_.push_back(std::make_unique<ColumnFile>(directory_ / (column.name + ".bin")));
+            }
+            for (const auto& list : layout_.lists) {
+                offset_files_.push_back(std::make_unique<ColumnFile>(directory_ / (list.name + ".offsets.bin")));
+                offset_files_.back()->append(&zero_offset, sizeof(zero_offset));
+            }
+            list_lengths_.assign(layout_.lists.size(), 0);
+        }
+
+        bool add(const LogRecord& record) override {
+            auto msg = App::template deserialize<Row>(record.wire);
+            if (!msg) {
+                return false;
+            }
+            batch_.push_back(std::move(*msg));
+            receive_ns_.push_back(record.receive_ns);
+            if (batch_.size() == batch_rows_) {
+                flush_batch();
+            }
+            return true;
+        }
+
+        uint64_t finish() override {
+            flush_batch();
+            write_manifest();
+            uint64_t bytes = receive_file_->bytes();
+            for (auto* group : {&files_, &offset_files_}) {
+                for (auto& file : *group) {
+                    file->flush();
+                    bytes += file->bytes();
+                }
+            }
+            receive_file_->flush();
+            return bytes;
+        }
+
+    private:
+        static constexpr uint64_t zero_offset = 0;
+
+        void flush_batch() {
+            const std::size_t rows = batch_.size();
+            if (rows == 0) {
+                return;
+            }
+            const auto* first = reinterpret_cast<const std::byte*>(batch_.data());
+            receive_file_->append(receive_ns_.data(), rows * sizeof(uint64_t));
+
+            for (std::size_t c = 0; c < layout_.columns.size(); ++c) {
+                const ColumnSpec& column = layout_.columns[c];
+                if (column.list >= 0) {
+                    continue;
+                }
+                std::byte* out = files_[c]->extend(rows * column.count * column.size);
+                columnar_detail::gather(column.size, first + column.offset, sizeof(Row), rows,
+                                        column.count, column.stride, out);
+            }
+
+            for (std::size_t l = 0; l < layout_.lists.size(); ++l) {
+                const ListSpec& list = layout_.lists[l];
+                uint64_t* offsets = reinterpret_cast<uint64_t*>(
+                    offset_files_[l]->extend(rows * sizeof(uint64_t)));
+                for (std::size_t r = 0; r < rows; ++r) {
+                    const std::byte* container = first + r * sizeof(Row) + list.offset;
+                    const std::size_t length = list.length(container);
+                    if (length > 0) {
+                        const std::byte* elements = list.elements(container);
+                        for (std::size_t c = 0; c < layout_.columns.size(); ++c) {
+                            const ColumnSpec& column = layout_.columns[c];
+                            if (column.list != static_cast<int32_t>(l)) {
+                                continue;
+                            }
+                            std::byte* out = files_[c]->extend(length * column.count * column.size);
+                            columnar_detail::gather(column.size, elements + column.offset, list.element_size,
+                                                    length, column.count, column.stride, out);
+                        }
+                    }
+                    list_lengths_[l] += length;
+                    std::memcpy(offsets + r, &list_lengths_[l], sizeof(uint64_t));
+                }
+            }
+
+            total_rows_ += rows;
+            batch_.clear();
+            receive_ns_.clear();
+        }
+
+        void write_manifest() const {
+            const auto path = directory_ / "columns.json";
+            std::FILE* file = std::fopen(path.c_str(), "w");
+            if (!file) {
+                throw std::system_error(errno, std::generic_category(), "[ColumnarExporter] open " + path.string());
+            }
+            std::fprintf(file, "{\n  \"format\": \"commrat-columnar\",\n  \"version\": 1,\n");
+            std::fprintf(file, "  \"type\": \"%s\",\n", rfl::type_name_t<PayloadT>().str().c_str());
+            std::fprintf(file, "  \"message_id\": %" PRIu32 ",\n  \"system_id\": %u,\n  \"instance_id\": %u,\n",
+                         info_.message_id, info_.system_id, info_.instance_id);
+            std::fprintf(file, "  \"stream\": \"%s\",\n", label(info_).c_str());
+            std::fprintf(file, "  \"rows\": %" PRIu64 ",\n  \"columns\": [\n", total_rows_);
+            std::fprintf(file, "    {\"name\": \"receive_ns\", \"file\": \"receive_ns.bin\", \"dtype\": \"<u8\", "
+                               "\"shape\": [], \"length\": %" PRIu64 "}", total_rows_);
+            for (std::size_t c = 0; c < layout_.columns.size(); ++c) {
+                const ColumnSpec& column = layout_.columns[c];
+                const uint64_t length = column.list >= 0 ? list_lengths_[column.list] : total_rows_;
+                std::fprintf(file, ",\n    {\"name\": \"%s\", \"file\": \"%s\", \"dtype\": \"%s\", ",
+                             column.name.c_str(), files_[c]->file_name().c_str(), column.dtype);
+                if (column.count > 1) {
+                    std::fprintf(file, "\"shape\": [%u], ", column.count);
+                } else {
+                    std::fprintf(file, "\"shape\": [], ");
+                }
+                if (column.list >= 0) {
+                    const ListSpec& list = layout_.lists[column.list];
+                    std::fprintf(file, "\"offsets\": \"%s.offsets\", \"kind\": \"%s\", ",
+                                 list.name.c_str(), list.string ? "string" : "list");
+                }
+                std::fprintf(file, "\"length\": %" PRIu64 "}", length);
+            }
+            for (std::size_t l = 0; l < layout_.lists.size(); ++l) {
+                std::fprintf(file, ",\n    {\"name\": \"%s.offsets\", \"file\": \"%s\", \"dtype\": \"<u8\", "
+                                   "\"shape\": [], \"length\": %" PRIu64 "}",
+                             layout_.lists[l].name.c_str(), offset_files_[l]->file_name().c_str(), total_rows_ + 1);
+            }
+            std::fprintf(file, "\n  ],\n  \"skipped\": [");
+            for (std::size_t s = 0; s < layout_.skipped.size(); ++s) {
+                std::fprintf(file, "%s\"%s\"", s ? ", " : "", layout_.skipped[s].c_str());
+            }
+            std::fprintf(file, "]\n}\n");
+            std::fclose(file);
+        }
+
+        std::filesystem::path directory_;
+        LogStreamInfo info_;
+        const ColumnarLayout& layout_;
+        std::size_t batch_rows_;
+        std::vector<Row> batch_;
+        std::vector<uint64_t> receive_ns_;
+        std::unique_ptr<ColumnFile> receive_file_;
+        std::vector<std::unique_ptr<ColumnFile>> files_;          // Parallel to layout_.columns
+        std::vector<std::unique_ptr<ColumnFile>> offset_files_;   // Parallel to layout_.lists
+        std::vector<uint64_t> list_lengths_;                      // Elements written per list
+        uint64_t total_rows_{0};
+    };
+
+    /// Stream label restricted to file name characters ("0x<id>" if unnamed)
+    static std::string label(const LogStreamInfo& info) {
+        std::string name(info.name, ::strnlen(info.name, sizeof(info.name)));
+        if (name.empty()) {
+            char id[16];
+            std::snprintf(id, sizeof(id), "0x%08" PRIx32, info.message_id);
+            name = id;
+        }
+        for (char& c : name) {
+            const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                              c == '_' || c == '-' || c == '.';
+            if (!keep) {
+                c = '_';
+            }
+        }
+        return name;
+    }
+
+    /// Columns for a stream of a registered type in `<label>_<system>_<instance>`, nullptr otherwise
+    std::unique_ptr<StreamColumns> make_stream(const LogStreamInfo& info, std::map<std::string, int>& names) {
+        std::string name = label(info) + "_" + std::to_string(info.system_id) + "_" + std::to_string(info.instance_id);
+        std::unique_ptr<StreamColumns> stream;
+        make_stream_impl(info, name, names, stream, static_cast<typename App::payload_types*>(nullptr));
+        return stream;
+    }
+
+    template<typename... Payloads>
+    void make_stream_impl(const LogStreamInfo& info, std::string name, std::map<std::string, int>& names,
+                          std::unique_ptr<StreamColumns>& stream, std::tuple<Payloads...>*) {
+        auto create = [&]<typename PayloadT>() {
+            if (const int n = names[name]++; n > 0) {
+                name += "_" + std::to_string(n);
+            }
+            stream = std::make_unique<TypedStreamColumns<PayloadT>>(
+                std::filesystem::path(config_.output_directory) / name, info, config_.batch_rows);
+        };
+        (void)((info.message_id == App::template get_message_id<Payloads>() &&
+                (create.template operator()<Payloads>(), true)) || ...);
+    }
+
+    ColumnarExportConfig config_;
+    std::vector<std::string> segments_;
+};
+
+} // namespace commrat
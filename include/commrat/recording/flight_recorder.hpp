@@ -0,0 +1,573 @@
+/**
+ * @file flight_recorder.hpp
+ * @brief Always-on in-memory ring of recent traffic, dumped on demand
+ *
+ * FlightRecorder keeps the wire bytes of every message the process sends
+ * or receives (TimsWrapper traffic tap) in a preallocated, lock-free ring
+ * buffer. The most recent `window` of traffic is written as a recording
+ * segment (log_format.hpp) when:
+ * - dump() is called, e.g. from a FlightDumpRequest command
+ * - the process receives SIGUSR1 (dumped on the recorder's dump thread)
+ * - the process receives a fatal signal (SIGSEGV, SIGBUS, SIGFPE, SIGILL,
+ *   SIGABRT): dumped inside the signal handler, then the previous handler
+ *   runs
+ *
+ * Capturing a message costs a few atomic increments, a clock read and a
+ * memcpy; no locks, no allocation. The dump path only uses buffers
+ * allocated up front and open/write/fsync/close, so it is async-signal-safe.
+ *
+ * Dumps are single-segment recordings `<prefix>_<pid>_<n>_000000.crlog`.
+ * Streams are (direction, message type, mailbox): records carry
+ * LOG_FLAG_SENT or LOG_FLAG_RECEIVED, and the stream name is
+ * "tx 0x<destination>" or "rx 0x<receiving mailbox>".
+ */
+
+#pragma once
+
+#include "commrat/recording/log_format.hpp"
+#include "commrat/messages.hpp"
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include "commrat/platform/tims_wrapper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace commrat {
+
+/**
+ * @brief FlightRecorder configuration
+ */
+struct FlightRecorderConfig {
+    std::string directory{"."};                     ///< Dump directory (must exist)
+    std::string prefix{"flight"};                   ///< Dump name prefix
+    std::size_t buffer_bytes{64 * 1024 * 1024};     ///< Wire byte ring (rounded up to a power of two)
+    std::size_t max_records{256 * 1024};            ///< Record ring entries (rounded up to a power of two)
+    std::chrono::milliseconds window{10000};        ///< Traffic age included in dumps (0 = whole ring)
+    bool dump_on_sigusr1{true};
+    bool dump_on_fatal_signal{true};
+    std::string schema{"[]"};                       ///< Stored in dumps, e.g. App::Introspection::export_all()
+};
+
+/**
+ * @brief Outcome of a dump (plain data: produced inside signal handlers)
+ */
+struct FlightDumpResult {
+    bool success{false};
+    uint64_t records{0};
+    char path[256]{};
+};
+
+/**
+ * @brief Capture counters (snapshot)
+ */
+struct FlightRecorderStats {
+    uint64_t captured{0};     ///< Messages put into the ring
+    uint64_t oversized{0};    ///< Messages larger than a quarter of the ring (not captured)
+    uint64_t dumps{0};        ///< Dumps started (also numbers the dump files)
+};
+
+/**
+ * @brief Process-wide flight recorder (at most one instance at a time)
+ *
+ * Example:
+ * @code
+ * int main() {
+ *     FlightRecorder flight(FlightRecorderConfig{
+ *         .directory = "/var/log/robot", .window = Milliseconds(30000),
+ *         .schema = MyApp::Introspection::export_all()
+ *     });
+ *     // ... run modules; `kill -USR1 <pid>` writes the last 30 s
+ * }
+ * @endcode
+ *
+ * Construction installs the traffic tap and signal handlers and throws
+ * std::logic_error if another FlightRecorder exists; destruction restores
+ * the previous signal handlers.
+ */
+class FlightRecorder {
+public:
+    static constexpr int fatal_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+    static constexpr std::size_t max_streams = 1024;
+
+    explicit FlightRecorder(const FlightRecorderConfig& config)
+        : config_(config)
+        , data_capacity_(std::bit_ceil(std::max<std::size_t>(config.buffer_bytes, 64 * 1024)))
+        , entry_capacity_(std::bit_ceil(std::max<std::size_t>(config.max_records, 64)))
+        , max_record_(data_capacity_ / 4)
+        , data_(new std::byte[data_capacity_])
+        , entries_(new Entry[entry_capacity_])
+        , record_scratch_(new std::byte[max_record_])
+        , write_buffer_(new std::byte[write_buffer_size]) {
+        // Touch everything now: capturing and dumping never page-fault in fresh memory
+        std::memset(data_.get(), 0, data_capacity_);
+        std::memset(record_scratch_.get(), 0, max_record_);
+        std::memset(write_buffer_.get(), 0, write_buffer_size);
+        for (auto& key : stream_keys_) {
+            key = StreamKey{};
+        }
+
+        const std::string base = (config_.directory.empty() ? std::string(".") : config_.directory) + "/" +
+                                 config_.prefix + "_" + std::to_string(::getpid()) + "_";
+        if (base.size() + 32 > sizeof(FlightDumpResult::path)) {
+            throw std::invalid_argument("[FlightRecorder] Dump path too long");
+        }
+        std::memcpy(path_base_, base.c_str(), base.size() + 1);
+        path_base_len_ = base.size();
+
+        FlightRecorder* expected = nullptr;
+        if (!active_.compare_exchange_strong(expected, this)) {
+            throw std::logic_error("[FlightRecorder] Another FlightRecorder is active");
+        }
+
+        if (config_.dump_on_sigusr1) {
+            if (::pipe2(wake_pipe_, O_CLOEXEC) != 0) {
+                active_.store(nullptr);
+                throw std::runtime_error("[FlightRecorder] pipe2 failed");
+            }
+            dump_thread_.emplace(ThreadConfig{.name = "flight/dump", .priority = ThreadPriority::LOW},
+                                 [this]() { dump_loop(); });
+            install_handler(SIGUSR1, &FlightRecorder::on_dump_signal, sigusr1_previous_, 0);
+        }
+        if (config_.dump_on_fatal_signal) {
+            install_alt_stack();
+            for (std::size_t i = 0; i < std::size(fatal_signals); ++i) {
+                install_handler(fatal_signals[i], &FlightRecorder::on_fatal_signal, fatal_previous_[i],
+                                SA_ONSTACK | SA_RESETHAND);
+            }
+        }
+        TimsWrapper::set_traffic_tap(&FlightRecorder::on_traffic);
+    }
+
+    ~FlightRecorder() {
+        TimsWrapper::set_traffic_tap(nullptr);
+        if (config_.dump_on_fatal_signal) {
+            for (std::size_t i = 0; i < std::size(fatal_signals); ++i) {
+                ::sigaction(fatal_signals[i], &fatal_previous_[i], nullptr);
+            }
+        }
+        if (config_.dump_on_sigusr1) {
+            ::sigaction(SIGUSR1, &sigusr1_previous_, nullptr);
+            const char stop = 'q';
+            [[maybe_unused]] auto n = ::write(wake_pipe_[1], &stop, 1);
+            dump_thread_.reset();
+            ::close(wake_pipe_[0]);
+            ::close(wake_pipe_[1]);
+        }
+        active_.store(nullptr);
+        // Wait for a tap call that loaded the pointer before it was cleared
+        while (in_capture_.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /// The installed recorder, nullptr if none
+    static FlightRecorder* active() { return active_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Write the recent traffic to a new dump file
+     *
+     * Thread-safe; returns an unsuccessful result if another dump is in
+     * progress or the file cannot be written.
+     */
+    FlightDumpResult dump() {
+        FlightDumpResult result;
+        if (dumping_.test_and_set(std::memory_order_acquire)) {
+            return result;
+        }
+        write_dump(result);
+        dumping_.clear(std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * @brief Append one message to the ring (the traffic tap; lock-free)
+     */
+    void capture(TrafficDirection direction, uint32_t mailbox_id, std::span<const std::byte> wire) noexcept {
+        if (wire.size() > max_record_) {
+            oversized_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint64_t n = entry_head_.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t pos = data_head_.fetch_add(wire.size(), std::memory_order_seq_cst);
+
+        Entry& entry = entries_[n & (entry_capacity_ - 1)];
+        entry.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.data_pos = pos;
+        entry.time_ns = Time::now();
+        entry.size = static_cast<uint32_t>(wire.size());
+        entry.mailbox_id = mailbox_id;
+        entry.direction = static_cast<uint8_t>(direction);
+        copy_to_ring(pos, wire);
+        entry.seq.store(2 * n + 2, std::memory_order_release);
+    }
+
+    FlightRecorderStats stats() const {
+        return FlightRecorderStats{
+            .captured = entry_head_.load(std::memory_order_relaxed),
+            .oversized = oversized_.load(std::memory_order_relaxed),
+            .dumps = dumps_.load(std::memory_order_relaxed)
+        };
+    }
+
+    const FlightRecorderConfig& config() const { return config_; }
+
+private:
+    static constexpr std::size_t write_buffer_size = 1024 * 1024;
+    static constexpr std::size_t stream_slots = 2 * max_streams;  // Open addressing, <= 50% load
+
+    struct Entry {
+        std::atomic<uint64_t> seq{0};   // 2n+2: entry n complete, odd: being written
+        uint64_t data_pos{0};           // Absolute position in the byte ring
+        uint64_t time_ns{0};
+        uint32_t size{0};
+        uint32_t mailbox_id{0};
+        uint8_t direction{0};
+    };
+
+    struct StreamKey {
+        uint32_t message_id{0};
+        uint32_t mailbox_id{0};
+        uint8_t direction{0};           // 0 = free slot
+        uint16_t stream_id{0};
+    };
+
+    // ========================================================================
+    // Capture
+    // ========================================================================
+
+    static void on_traffic(TrafficDirection direction, uint32_t mailbox_id,
+                           std::span<const std::byte> wire) noexcept {
+        in_capture_.fetch_add(1, std::memory_order_acquire);
+        if (FlightRecorder* recorder = active_.load(std::memory_order_acquire)) {
+            recorder->capture(direction, mailbox_id, wire);
+        }
+        in_capture_.fetch_sub(1, std::memory_order_release);
+    }
+
+    void copy_to_ring(uint64_t pos, std::span<const std::byte> wire) noexcept {
+        const std::size_t offset = pos & (data_capacity_ - 1);
+        const std::size_t first = std::min(wire.size(), data_capacity_ - offset);
+        std::memcpy(data_.get() + offset, wire.data(), first);
+        std::memcpy(data_.get(), wire.data() + first, wire.size() - first);
+    }
+
+    void copy_from_ring(uint64_t pos, std::size_t size, std::byte* out) const noexcept {
+        const std::size_t offset = pos & (data_capacity_ - 1);
+        const std::size_t first = std::min(size, data_capacity_ - offset);
+        std::memcpy(out, data_.get() + offset, first);
+        std::memcpy(out + first, data_.get(), size - first);
+    }
+
+    /**
+     * @brief Consistent copy of entry n (seqlock read) and up to copy_bytes
+     *        of its wire bytes into record_scratch_
+     * @return false if the entry is incomplete, was overwritten, or its bytes were
+     */
+    bool read_entry(uint64_t n, Entry& out, std::size_t copy_bytes) const noexcept {
+        const Entry& entry = entries_[n & (entry_capacity_ - 1)];
+        const uint64_t seq = entry.seq.load(std::memory_order_acquire);
+        if (seq != 2 * n + 2) {
+            return false;
+        }
+        out.data_pos = entry.data_pos;
+        out.time_ns = entry.time_ns;
+        out.size = entry.size;
+        out.mailbox_id = entry.mailbox_id;
+        out.direction = entry.direction;
+        if (out.size < sizeof(TimsHeader) || out.size > max_record_) {
+            return false;
+        }
+        copy_from_ring(out.data_pos, std::min<std::size_t>(out.size, copy_bytes), record_scratch_.get());
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.seq.load(std::memory_order_relaxed) != seq) {
+            return false;
+        }
+        // Bytes still valid if no writer has reserved past them by a full ring
+        return data_head_.load(std::memory_order_seq_cst) - out.data_pos <= data_capacity_;
+    }
+
+    // ========================================================================
+    // Dump (async-signal-safe: no allocation, no locks)
+    // ========================================================================
+
+    void write_dump(FlightDumpResult& result) noexcept {
+        const uint64_t dump_index = dumps_.fetch_add(1, std::memory_order_relaxed);
+        format_path(result.path, dump_index);
+
+        const uint64_t hi = entry_head_.load(std::memory_order_acquire);
+        const uint64_t lo = hi > entry_capacity_ ? hi - entry_capacity_ : 0;
+        const uint64_t window_ns = static_cast<uint64_t>(config_.window.count()) * 1'000'000;
+        const uint64_t now = Time::now();
+        const uint64_t cutoff = window_ns != 0 && now > window_ns ? now - window_ns : 0;
+
+        // Pass 1: stream table of the records to dump
+        for (auto& key : stream_keys_) {
+            key.direction = 0;
+        }
+        stream_count_ = 0;
+        Entry entry;
+        for (uint64_t n = lo; n < hi; ++n) {
+            if (read_entry(n, entry, sizeof(TimsHeader)) && entry.time_ns >= cutoff) {
+                stream_for(entry, true);
+            }
+        }
+
+        const int fd = ::open(result.path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return;
+        }
+        buffered_ = 0;
+        flushed_ = 0;
+        write_fd_ = fd;
+        write_failed_ = false;
+
+        const std::size_t data_offset = log_data_offset(stream_count_, config_.schema.size());
+        LogSegmentHeader header{
+            .magic = LOG_MAGIC,
+            .version = LOG_VERSION,
+            .stream_count = static_cast<uint16_t>(stream_count_),
+            .segment_index = 0,
+            .schema_size = static_cast<uint32_t>(config_.schema.size()),
+            .created_ns = now,
+            .data_offset = data_offset
+        };
+        append(&header, sizeof(header));
+        append(stream_table_, stream_count_ * sizeof(LogStreamInfo));
+        append(config_.schema.data(), config_.schema.size());
+        pad_to(data_offset);
+        std::size_t written = data_offset;
+
+        // Pass 2: records in capture order
+        for (uint64_t n = lo; n < hi; ++n) {
+            if (!read_entry(n, entry, max_record_) || entry.time_ns < cutoff) {
+                continue;
+            }
+            const StreamKey* key = stream_for(entry, false);
+            if (!key) {
+                continue;
+            }
+            LogRecordHeader record{
+                .size = entry.size,
+                .stream_id = key->stream_id,
+                .flags = entry.direction == static_cast<uint8_t>(TrafficDirection::Sent)
+                    ? LOG_FLAG_SENT : LOG_FLAG_RECEIVED,
+                .receive_ns = entry.time_ns
+            };
+            append(&record, sizeof(record));
+            append(record_scratch_.get(), entry.size);
+            written += log_record_span(entry.size);
+            pad_to(written);
+            ++result.records;
+        }
+        const LogRecordHeader end{};
+        append(&end, sizeof(end));
+        flush();
+        ::fsync(fd);
+        ::close(fd);
+        result.success = !write_failed_;
+    }
+
+    /// Stream of an entry (message type from the record in record_scratch_)
+    const StreamKey* stream_for(const Entry& entry, bool insert) noexcept {
+        TimsHeader header;
+        std::memcpy(&header, record_scratch_.get(), sizeof(header));
+        const uint32_t hash = (header.msg_type * 2654435761u) ^ (entry.mailbox_id * 40503u) ^ entry.direction;
+        for (std::size_t probe = 0; probe < stream_slots; ++probe) {
+            StreamKey& key = stream_keys_[(hash + probe) & (stream_slots - 1)];
+            if (key.direction == 0) {
+                if (!insert || stream_count_ >= max_streams) {
+                    return nullptr;
+                }
+                key = StreamKey{.message_id = header.msg_type, .mailbox_id = entry.mailbox_id,
+                                .direction = entry.direction, .stream_id = static_cast<uint16_t>(stream_count_)};
+                LogStreamInfo& info = stream_table_[stream_count_++];
+                info = LogStreamInfo{.message_id = header.msg_type, .stream_id = key.stream_id,
+                                     .system_id = 0, .instance_id = 0, .name = {}};
+                format_stream_name(info.name, entry.direction, entry.mailbox_id);
+                return &key;
+            }
+            if (key.message_id == header.msg_type && key.mailbox_id == entry.mailbox_id &&
+                key.direction == entry.direction) {
+                return &key;
+            }
+        }
+        return nullptr;
+    }
+
+    void append(const void* data, std::size_t size) noexcept {
+        auto* bytes = static_cast<const std::byte*>(data);
+        while (size > 0) {
+            const std::size_t chunk = std::min(size, write_buffer_size - buffered_);
+            std::memcpy(write_buffer_.get() + buffered_, bytes, chunk);
+            buffered_ += chunk;
+            bytes += chunk;
+            size -= chunk;
+            if (buffered_ == write_buffer_size) {
+                flush();
+            }
+        }
+    }
+
+    /// Zero padding up to absolute file offset `offset`
+    void pad_to(std::size_t offset) noexcept {
+        static constexpr std::byte zeros[LOG_RECORD_ALIGN]{};
+        const std::size_t pos = written_total();
+        if (offset > pos) {
+            append(zeros, offset - pos);
+        }
+    }
+
+    std::size_t written_total() const noexcept { return flushed_ + buffered_; }
+
+    void flush() noexcept {
+        std::size_t done = 0;
+        while (done < buffered_) {
+            const ssize_t n = ::write(write_fd_, write_buffer_.get() + done, buffered_ - done);
+            if (n <= 0) {
+                write_failed_ = true;
+                break;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        flushed_ += buffered_;
+        buffered_ = 0;
+    }
+
+    void format_path(char* out, uint64_t index) const noexcept {
+        std::memcpy(out, path_base_, path_base_len_);
+        char* p = out + path_base_len_;
+        p = format_decimal(p, index);
+        const char* suffix = "_000000";
+        std::memcpy(p, suffix, 7);
+        p += 7;
+        std::memcpy(p, LOG_SEGMENT_EXTENSION, std::strlen(LOG_SEGMENT_EXTENSION) + 1);
+    }
+
+    static char* format_decimal(char* out, uint64_t value) noexcept {
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+
+    static void format_stream_name(char* out, uint8_t direction, uint32_t mailbox_id) noexcept {
+        static constexpr char hex[] = "0123456789abcdef";
+        const char* prefix = direction == static_cast<uint8_t>(TrafficDirection::Sent) ? "tx 0x" : "rx 0x";
+        std::memcpy(out, prefix, 5);
+        for (int i = 0; i < 8; ++i) {
+            out[5 + i] = hex[(mailbox_id >> (28 - 4 * i)) & 0xF];
+        }
+        out[13] = '\0';
+    }
+
+    // ========================================================================
+    // Signals
+    // ========================================================================
+
+    static void install_handler(int signal, void (*handler)(int), struct sigaction& previous, int flags) {
+        struct sigaction action{};
+        action.sa_handler = handler;
+        action.sa_flags = flags | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        ::sigaction(signal, &action, &previous);
+    }
+
+    /// Alternate signal stack for the installing thread (dump after stack overflow)
+    void install_alt_stack() {
+        alt_stack_.reset(new std::byte[alt_stack_size]);
+        stack_t stack{};
+        stack.ss_sp = alt_stack_.get();
+        stack.ss_size = alt_stack_size;
+        ::sigaltstack(&stack, nullptr);
+    }
+
+    static void on_dump_signal(int) {
+        if (FlightRecorder* recorder = active_.load(std::memory_order_acquire)) {
+            const char wake = 'd';
+            [[maybe_unused]] auto n = ::write(recorder->wake_pipe_[1], &wake, 1);
+        }
+    }
+
+    static void on_fatal_signal(int signal) {
+        if (FlightRecorder* recorder = active_.load(std::memory_order_acquire)) {
+            recorder->dump();
+            for (std::size_t i = 0; i < std::size(fatal_signals); ++i) {
+                if (fatal_signals[i] == signal) {
+                    ::sigaction(signal, &recorder->fatal_previous_[i], nullptr);
+                }
+            }
+        }
+        ::raise(signal);  // Previous handler or default action (SA_RESETHAND)
+    }
+
+    void dump_loop() {
+        char command = 0;
+        while (::read(wake_pipe_[0], &command, 1) == 1 && command != 'q') {
+            auto result = dump();
+            if (result.success) {
+                std::cerr << "[FlightRecorder] Dumped " << result.records << " records to " << result.path << "\n";
+            }
+        }
+    }
+
+    static constexpr std::size_t alt_stack_size = 64 * 1024;
+
+    FlightRecorderConfig config_;
+    std::size_t data_capacity_;
+    std::size_t entry_capacity_;
+    std::size_t max_record_;
+    std::unique_ptr<std::byte[]> data_;
+    std::unique_ptr<Entry[]> entries_;
+    std::atomic<uint64_t> entry_head_{0};
+    std::atomic<uint64_t> data_head_{0};
+    std::atomic<uint64_t> oversized_{0};
+    std::atomic<uint64_t> dumps_{0};
+
+    // Dump state (one dump at a time: dumping_)
+    std::atomic_flag dumping_ = ATOMIC_FLAG_INIT;
+    std::unique_ptr<std::byte[]> record_scratch_;
+    std::unique_ptr<std::byte[]> write_buffer_;
+    std::size_t buffered_{0};
+    std::size_t flushed_{0};
+    int write_fd_{-1};
+    bool write_failed_{false};
+    StreamKey stream_keys_[stream_slots];
+    LogStreamInfo stream_table_[max_streams];
+    std::size_t stream_count_{0};
+    char path_base_[sizeof(FlightDumpResult::path)]{};
+    std::size_t path_base_len_{0};
+
+    int wake_pipe_[2]{-1, -1};
+    std::optional<Thread> dump_thread_;
+    std::unique_ptr<std::byte[]> alt_stack_;
+    struct sigaction sigusr1_previous_{};
+    struct sigaction fatal_previous_[std::size(fatal_signals)]{};
+
+    static inline std::atomic<FlightRecorder*> active_{nullptr};
+    static inline std::atomic<int> in_capture_{0};
+};
+
+} // namespace commrat
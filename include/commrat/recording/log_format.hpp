@@ -0,0 +1,172 @@
+/**
+ * @file log_format.hpp
+ * @brief On-disk format of CommRaT recording logs
+ *
+ * A log is a sequence of segment files `<prefix>_<NNNNNN>.crlog`. Every
+ * segment is self-describing:
+ *
+ * @code
+ * [LogSegmentHeader]                       32 bytes
+ * [LogStreamInfo x stream_count]           32 bytes each
+ * [schema JSON, schema_size bytes]         IntrospectionHelper::export_all()
+ * [padding to data_offset]
+ * [LogRecordHeader][wire bytes][pad to 8]  repeated
+ * [LogRecordHeader.size == 0]              end of data (pre-allocated space is zero)
+ * [LogIndexEntry x count]                  finished segments only
+ * [LogIndexFooter]                         16 bytes, last in the file
+ * @endcode
+ *
+ * Wire bytes are the message exactly as received (TimsHeader + serialized
+ * payload), so records decode with the registry that produced them.
+ *
+ * The index is sparse: one entry per LOG_INDEX_STRIDE bytes of records,
+ * so seeking by receive time is a binary search plus a short scan. Segments
+ * without an index (still being written, or the writer crashed) are indexed
+ * by the reader on demand.
+ *
+ * All fields are host byte order (logs are read on the recording platform).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace commrat {
+
+// ============================================================================
+// Constants
+// ============================================================================
+
+inline constexpr uint32_t LOG_MAGIC = 0x474C5243;        // "CRLG"
+inline constexpr uint16_t LOG_VERSION = 1;
+inline constexpr std::size_t LOG_RECORD_ALIGN = 8;
+inline constexpr const char* LOG_SEGMENT_EXTENSION = ".crlog";
+inline constexpr uint32_t LOG_INDEX_MAGIC = 0x58495243;  // "CRIX"
+inline constexpr std::size_t LOG_INDEX_STRIDE = 64 * 1024;
+
+// LogRecordHeader::flags
+inline constexpr uint16_t LOG_FLAG_SENT = 0x0001;       ///< Flight recorder: message sent by the process
+inline constexpr uint16_t LOG_FLAG_RECEIVED = 0x0002;   ///< Flight recorder: message received by the process
+
+// ============================================================================
+// Segment and Record Layout
+// ============================================================================
+
+/**
+ * @brief Header at offset 0 of every segment file
+ */
+struct LogSegmentHeader {
+    uint32_t magic;           ///< LOG_MAGIC
+    uint16_t version;         ///< LOG_VERSION
+    uint16_t stream_count;    ///< LogStreamInfo entries following the header
+    uint32_t segment_index;   ///< 0, 1, 2, ... within one recording
+    uint32_t schema_size;     ///< Bytes of schema JSON after the stream table
+    uint64_t created_ns;      ///< Time::now() when the segment was created
+    uint64_t data_offset;     ///< Offset of the first record (LOG_RECORD_ALIGN aligned)
+};
+static_assert(sizeof(LogSegmentHeader) == 32, "LogSegmentHeader layout is part of the file format");
+
+/**
+ * @brief One recorded stream: a message type from one producer
+ */
+struct LogStreamInfo {
+    uint32_t message_id;      ///< Registry message ID of the stream's payload
+    uint16_t stream_id;       ///< Referenced by LogRecordHeader::stream_id
+    uint8_t system_id;        ///< Producer system ID
+    uint8_t instance_id;      ///< Producer instance ID
+    char name[24];            ///< User label, NUL-terminated (may be empty)
+};
+static_assert(sizeof(LogStreamInfo) == 32, "LogStreamInfo layout is part of the file format");
+
+/**
+ * @brief Header in front of every record's wire bytes
+ *
+ * Writers store `size` last (release), so a reader that sees a non-zero
+ * size also sees the complete record.
+ */
+struct LogRecordHeader {
+    uint32_t size;            ///< Wire bytes following this header (0 = end of data)
+    uint16_t stream_id;       ///< LogStreamInfo::stream_id
+    uint16_t flags;           ///< LOG_FLAG_* (0 for Recorder records)
+    uint64_t receive_ns;      ///< Time::now() when the recorder received the message
+};
+static_assert(sizeof(LogRecordHeader) == 16, "LogRecordHeader layout is part of the file format");
+static_assert(std::atomic_ref<uint32_t>::required_alignment <= alignof(LogRecordHeader));
+
+/**
+ * @brief Sparse seek index entry: a record and its receive time
+ */
+struct LogIndexEntry {
+    uint64_t receive_ns;      ///< LogRecordHeader::receive_ns of the record
+    uint64_t offset;          ///< Byte offset of the record in the segment
+};
+static_assert(sizeof(LogIndexEntry) == 16, "LogIndexEntry layout is part of the file format");
+
+/**
+ * @brief Last 16 bytes of a finished segment
+ */
+struct LogIndexFooter {
+    uint32_t magic;           ///< LOG_INDEX_MAGIC
+    uint32_t count;           ///< LogIndexEntry entries directly before the footer
+    uint64_t data_end;        ///< Offset of the end-of-data marker
+};
+static_assert(sizeof(LogIndexFooter) == 16, "LogIndexFooter layout is part of the file format");
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr std::size_t log_align(std::size_t n) {
+    return (n + LOG_RECORD_ALIGN - 1) & ~(LOG_RECORD_ALIGN - 1);
+}
+
+/// Bytes a record with `wire_size` bytes of message data occupies in a segment
+constexpr std::size_t log_record_span(std::size_t wire_size) {
+    return log_align(sizeof(LogRecordHeader) + wire_size);
+}
+
+/// Bytes before the first record for the given stream table and schema
+constexpr std::size_t log_data_offset(std::size_t stream_count, std::size_t schema_size) {
+    return log_align(sizeof(LogSegmentHeader) + stream_count * sizeof(LogStreamInfo) + schema_size);
+}
+
+/// Segment file name within the log directory: `<prefix>_<NNNNNN>.crlog`
+inline std::string log_segment_filename(const std::string& prefix, uint32_t segment_index) {
+    char index[16];
+    std::snprintf(index, sizeof(index), "_%06u", segment_index);
+    return prefix + index + LOG_SEGMENT_EXTENSION;
+}
+
+/**
+ * @brief Sparse index of the records in [data_offset, data_end) of a mapped segment
+ *
+ * One entry for the first record and then for the first record at or past
+ * every LOG_INDEX_STRIDE bytes.
+ */
+inline std::vector<LogIndexEntry> build_log_index(const std::byte* base, std::size_t data_offset,
+                                                  std::size_t data_end) {
+    std::vector<LogIndexEntry> index;
+    index.reserve((data_end - data_offset) / LOG_INDEX_STRIDE + 1);
+    std::size_t next_entry = data_offset;
+    for (std::size_t pos = data_offset; pos + sizeof(LogRecordHeader) <= data_end;) {
+        auto* rec = reinterpret_cast<const LogRecordHeader*>(base + pos);
+        const uint32_t wire_size = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(rec->size))
+                                       .load(std::memory_order_acquire);
+        if (wire_size == 0 || pos + log_record_span(wire_size) > data_end) {
+            break;
+        }
+        if (pos >= next_entry) {
+            index.push_back(LogIndexEntry{.receive_ns = rec->receive_ns, .offset = pos});
+            next_entry = pos + LOG_INDEX_STRIDE;
+        }
+        pos += log_record_span(wire_size);
+    }
+    return index;
+}
+
+} // namespace commrat
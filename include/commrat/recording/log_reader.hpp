@@ -0,0 +1,266 @@
+/**
+ * @file log_reader.hpp
+ * @brief Read access to recording log segments
+ *
+ * LogSegmentReader maps one segment read-only and iterates its records;
+ * list_log_segments() finds the segments of a recording in index order.
+ * Segments that are still being written can be read: iteration stops at
+ * the first record whose size is not yet published.
+ *
+ * seek_time() uses the segment's sparse index (written when the segment is
+ * finished) and falls back to indexing the segment on the fly.
+ */
+
+#pragma once
+
+#include "commrat/recording/log_format.hpp"
+#include "commrat/messages.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace commrat {
+
+/**
+ * @brief One record as stored in a segment (views into the mapping)
+ */
+struct LogRecord {
+    uint16_t stream_id;
+    uint16_t flags;
+    uint64_t receive_ns;
+    std::span<const std::byte> wire;  ///< TimsHeader + serialized payload
+
+    /// Message header at the start of the wire bytes
+    TimsHeader header() const {
+        TimsHeader h{};
+        if (wire.size() >= sizeof(TimsHeader)) {
+            std::memcpy(&h, wire.data(), sizeof(TimsHeader));
+        }
+        return h;
+    }
+};
+
+/**
+ * @brief Read-only view of one segment file
+ *
+ * Throws std::runtime_error if the file cannot be mapped or is not a
+ * segment of a supported version.
+ */
+class LogSegmentReader {
+public:
+    explicit LogSegmentReader(const std::string& path) : path_(path) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("[LogSegmentReader] Cannot open " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(LogSegmentHeader)) {
+            ::close(fd_);
+            throw std::runtime_error("[LogSegmentReader] Not a log segment: " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("[LogSegmentReader] Cannot map " + path);
+        }
+        base_ = static_cast<const std::byte*>(addr);
+        ::madvise(const_cast<std::byte*>(base_), size_, MADV_SEQUENTIAL);
+
+        std::memcpy(&header_, base_, sizeof(header_));
+        const std::size_t table_end = sizeof(LogSegmentHeader) +
+                                      header_.stream_count * sizeof(LogStreamInfo);
+        if (header_.magic != LOG_MAGIC || header_.version != LOG_VERSION ||
+            table_end + header_.schema_size > size_ || header_.data_offset > size_ ||
+            header_.data_offset < table_end + header_.schema_size) {
+            unmap();
+            throw std::runtime_error("[LogSegmentReader] Invalid or unsupported segment: " + path);
+        }
+
+        streams_.resize(header_.stream_count);
+        std::memcpy(streams_.data(), base_ + sizeof(LogSegmentHeader),
+                    streams_.size() * sizeof(LogStreamInfo));
+        schema_ = std::string_view(reinterpret_cast<const char*>(base_ + table_end), header_.schema_size);
+        pos_ = header_.data_offset;
+        load_index();
+    }
+
+    ~LogSegmentReader() {
+        unmap();
+    }
+
+    LogSegmentReader(const LogSegmentReader&) = delete;
+    LogSegmentReader& operator=(const LogSegmentReader&) = delete;
+
+    const std::string& path() const { return path_; }
+    const LogSegmentHeader& header() const { return header_; }
+    std::span<const LogStreamInfo> streams() const { return streams_; }
+
+    /// Schema JSON stored in the segment (IntrospectionHelper::export_all())
+    std::string_view schema() const { return schema_; }
+
+    /// Stream table entry for a record, nullptr if unknown
+    const LogStreamInfo* stream(uint16_t stream_id) const {
+        auto it = std::find_if(streams_.begin(), streams_.end(),
+            [stream_id](const LogStreamInfo& s) { return s.stream_id == stream_id; });
+        return it != streams_.end() ? &*it : nullptr;
+    }
+
+    /**
+     * @brief Next record, or std::nullopt at the end of data
+     */
+    std::optional<LogRecord> next() {
+        if (pos_ + sizeof(LogRecordHeader) > size_) {
+            return std::nullopt;
+        }
+        auto* rec = reinterpret_cast<const LogRecordHeader*>(base_ + pos_);
+        // Pairs with the writer's release store of size
+        const uint32_t wire_size = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(rec->size))
+                                       .load(std::memory_order_acquire);
+        if (wire_size == 0 || pos_ + log_record_span(wire_size) > size_) {
+            return std::nullopt;
+        }
+        LogRecord record{
+            .stream_id = rec->stream_id,
+            .flags = rec->flags,
+            .receive_ns = rec->receive_ns,
+            .wire = std::span<const std::byte>(base_ + pos_ + sizeof(LogRecordHeader), wire_size)
+        };
+        pos_ += log_record_span(wire_size);
+        return record;
+    }
+
+    /// Restart iteration at the first record
+    void rewind() { pos_ = header_.data_offset; }
+
+    /**
+     * @brief Position iteration at the first record received at or after receive_ns
+     *
+     * O(log n) in the number of index entries plus a scan of at most
+     * LOG_INDEX_STRIDE bytes. Records are in append order, so receive times
+     * of concurrently appended records may be slightly out of order.
+     *
+     * @return false if no such record exists (iteration is then at the end)
+     */
+    bool seek_time(uint64_t receive_ns) {
+        std::vector<LogIndexEntry> built;
+        if (!indexed_) {
+            built = build_log_index(base_, header_.data_offset, size_);
+        }
+        const std::vector<LogIndexEntry>& index = indexed_ ? index_ : built;
+
+        // Last entry before receive_ns: the wanted record is in its stride
+        auto it = std::partition_point(index.begin(), index.end(),
+            [receive_ns](const LogIndexEntry& e) { return e.receive_ns < receive_ns; });
+        pos_ = it == index.begin() ? header_.data_offset : std::prev(it)->offset;
+
+        std::size_t candidate = pos_;
+        while (auto record = next()) {
+            if (record->receive_ns >= receive_ns) {
+                pos_ = candidate;
+                return true;
+            }
+            candidate = pos_;
+        }
+        return false;
+    }
+
+    /// Receive time of the first record, std::nullopt if the segment is empty
+    std::optional<uint64_t> first_receive_ns() const {
+        if (header_.data_offset + sizeof(LogRecordHeader) > size_) {
+            return std::nullopt;
+        }
+        auto* rec = reinterpret_cast<const LogRecordHeader*>(base_ + header_.data_offset);
+        const uint32_t wire_size = std::atomic_ref<uint32_t>(const_cast<uint32_t&>(rec->size))
+                                       .load(std::memory_order_acquire);
+        if (wire_size == 0) {
+            return std::nullopt;
+        }
+        return rec->receive_ns;
+    }
+
+    /// Ask the kernel to read the whole segment ahead (replay of the next segment)
+    void prefetch() const {
+        ::madvise(const_cast<std::byte*>(base_), size_, MADV_WILLNEED);
+    }
+
+    /// Seek index stored in the segment (empty for unfinished segments)
+    std::span<const LogIndexEntry> index() const { return index_; }
+
+    /// Byte offset of the next record (for resuming with seek())
+    std::size_t position() const { return pos_; }
+    void seek(std::size_t offset) { pos_ = std::max<std::size_t>(offset, header_.data_offset); }
+
+private:
+    void load_index() {
+        if (size_ < header_.data_offset + sizeof(LogRecordHeader) + sizeof(LogIndexFooter)) {
+            return;
+        }
+        LogIndexFooter footer{};
+        std::memcpy(&footer, base_ + size_ - sizeof(footer), sizeof(footer));
+        const std::size_t index_bytes = static_cast<std::size_t>(footer.count) * sizeof(LogIndexEntry);
+        if (footer.magic != LOG_INDEX_MAGIC ||
+            footer.data_end + sizeof(LogRecordHeader) + index_bytes + sizeof(footer) != size_) {
+            return;
+        }
+        index_.resize(footer.count);
+        std::memcpy(index_.data(), base_ + size_ - sizeof(footer) - index_bytes, index_bytes);
+        indexed_ = true;
+    }
+
+    void unmap() {
+        if (base_) {
+            ::munmap(const_cast<std::byte*>(base_), size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    std::string path_;
+    int fd_{-1};
+    const std::byte* base_{nullptr};
+    std::size_t size_{0};
+    std::size_t pos_{0};
+    LogSegmentHeader header_{};
+    std::vector<LogStreamInfo> streams_;
+    std::string_view schema_;
+    std::vector<LogIndexEntry> index_;
+    bool indexed_{false};  // index_ loaded from the footer
+};
+
+/**
+ * @brief Segment files of a recording, sorted by segment index
+ *
+ * @param directory Log directory (LogWriterConfig::directory)
+ * @param prefix Segment prefix (LogWriterConfig::prefix)
+ */
+inline std::vector<std::string> list_log_segments(const std::string& directory,
+                                                  const std::string& prefix) {
+    std::vector<std::string> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == prefix.size() + 7 + std::string_view(LOG_SEGMENT_EXTENSION).size() &&
+            name.starts_with(prefix + "_") && name.ends_with(LOG_SEGMENT_EXTENSION)) {
+            segments.push_back(entry.path().string());
+        }
+    }
+    std::sort(segments.begin(), segments.end());  // Zero-padded index: lexical == numeric
+    return segments;
+}
+
+} // namespace commrat
@@ -0,0 +1,415 @@
+/**
+ * @file mmap_log_writer.hpp
+ * @brief Segmented, memory-mapped append-only log writer
+ *
+ * MmapLogWriter appends records (see log_format.hpp) to pre-allocated,
+ * memory-mapped segment files. append() is a memcpy into the mapping under
+ * a short lock; everything that touches the file system runs on a
+ * background flush thread:
+ * - creating the next segment ahead of time (posix_fallocate + mmap, optionally
+ *   pre-faulted) so rollover is a rename and a pointer swap
+ * - periodic msync() of the written range of the active segment
+ * - finalizing full segments (msync, seek index, ftruncate to used size,
+ *   fdatasync, close)
+ *
+ * If the flush thread falls behind, append() creates the next segment
+ * itself (counted in LogWriterStats::inline_rollovers).
+ */
+
+#pragma once
+
+#include "commrat/recording/log_format.hpp"
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace commrat {
+
+/**
+ * @brief MmapLogWriter configuration
+ */
+struct LogWriterConfig {
+    std::string directory{"."};                      ///< Created if missing
+    std::string prefix{"commrat"};                   ///< Segment file name prefix
+    std::size_t segment_size{256 * 1024 * 1024};     ///< Bytes per segment (pre-allocated)
+    std::chrono::milliseconds sync_interval{500};    ///< msync period of the active segment (0 = kernel writeback only)
+    bool prefault{true};                             ///< Pre-fault spare segments (MAP_POPULATE)
+    bool durable{true};                              ///< fdatasync finished segments
+};
+
+/**
+ * @brief Writer counters (snapshot)
+ */
+struct LogWriterStats {
+    uint64_t records{0};           ///< Records appended
+    uint64_t bytes{0};             ///< Segment bytes used by records (headers + padding)
+    uint64_t dropped{0};           ///< Records rejected (too large or segment creation failed)
+    uint32_t segments{0};          ///< Segments started
+    uint32_t inline_rollovers{0};  ///< Rollovers that had to create the segment in append()
+};
+
+/**
+ * @brief Append-only writer of segmented recording logs
+ *
+ * append() may be called from any number of threads. Construction creates
+ * the directory and the first segment and throws std::runtime_error if that
+ * fails; later I/O failures drop records instead of throwing.
+ */
+class MmapLogWriter {
+public:
+    /**
+     * @param config Output location and segment policy
+     * @param streams Stream table written into every segment
+     * @param schema Schema JSON written into every segment
+     */
+    MmapLogWriter(const LogWriterConfig& config,
+                  std::span<const LogStreamInfo> streams,
+                  std::string_view schema)
+        : config_(config)
+        , streams_(streams.begin(), streams.end())
+        , schema_(schema)
+        , data_offset_(log_data_offset(streams.size(), schema.size())) {
+        if (streams.size() > UINT16_MAX) {
+            throw std::runtime_error("[MmapLogWriter] Too many streams");
+        }
+        if (config_.segment_size < data_offset_ + 64 * 1024) {
+            throw std::runtime_error("[MmapLogWriter] segment_size too small for stream table and schema");
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(config_.directory, ec);
+        if (ec) {
+            throw std::runtime_error("[MmapLogWriter] Cannot create " + config_.directory + ": " + ec.message());
+        }
+
+        auto first = create_segment(segment_path(0), config_.prefault);
+        if (!first) {
+            throw std::runtime_error("[MmapLogWriter] Cannot create first segment in " + config_.directory);
+        }
+        active_ = *first;
+        stamp_segment(active_, 0);
+        write_pos_ = data_offset_;
+        segments_ = 1;
+        retired_.reserve(4);
+
+        flush_thread_.emplace(ThreadConfig{.name = config_.prefix + "/flush",
+                                           .priority = ThreadPriority::LOW},
+                              [this]() { flush_loop(); });
+    }
+
+    ~MmapLogWriter() {
+        close();
+    }
+
+    MmapLogWriter(const MmapLogWriter&) = delete;
+    MmapLogWriter& operator=(const MmapLogWriter&) = delete;
+
+    /**
+     * @brief Append one record
+     *
+     * @param stream_id Stream the record belongs to
+     * @param receive_ns Receive timestamp stored with the record
+     * @param wire Message bytes (TimsHeader + serialized payload)
+     * @return false if the record was dropped
+     */
+    bool append(uint16_t stream_id, uint64_t receive_ns, std::span<const std::byte> wire) {
+        const std::size_t span = log_record_span(wire.size());
+
+        Lock lock(mutex_);
+        if (closed_ || span + sizeof(LogRecordHeader) > config_.segment_size - data_offset_) {
+            ++dropped_;
+            return false;
+        }
+        // Keep room for the zero end marker behind the record
+        if (write_pos_ + span + sizeof(LogRecordHeader) > active_.capacity && !rollover()) {
+            ++dropped_;
+            return false;
+        }
+
+        std::byte* dst = active_.base + write_pos_;
+        std::memcpy(dst + sizeof(LogRecordHeader), wire.data(), wire.size());
+        auto* header = reinterpret_cast<LogRecordHeader*>(dst);
+        header->stream_id = stream_id;
+        header->flags = 0;
+        header->receive_ns = receive_ns;
+        std::atomic_ref<uint32_t>(header->size).store(static_cast<uint32_t>(wire.size()),
+                                                      std::memory_order_release);
+
+        write_pos_ += span;
+        ++records_;
+        bytes_ += span;
+        return true;
+    }
+
+    /**
+     * @brief Stop the flush thread and finalize all segments
+     *
+     * Idempotent. Records appended afterwards are dropped.
+     */
+    void close() {
+        {
+            Lock lock(mutex_);
+            if (closed_) {
+                return;
+            }
+            closed_ = true;
+        }
+        cv_.notify_all();
+        if (flush_thread_) {
+            flush_thread_->join();
+            flush_thread_.reset();
+        }
+
+        // Flush thread is gone: finish its queue, the active segment and drop the spare
+        for (auto& retired : retired_) {
+            finalize_segment(retired.first, retired.second);
+        }
+        retired_.clear();
+        finalize_segment(active_, write_pos_);
+        if (spare_) {
+            discard_segment(*spare_);
+            spare_.reset();
+        }
+    }
+
+    LogWriterStats stats() const {
+        Lock lock(mutex_);
+        return LogWriterStats{
+            .records = records_,
+            .bytes = bytes_,
+            .dropped = dropped_,
+            .segments = segments_,
+            .inline_rollovers = inline_rollovers_
+        };
+    }
+
+    const LogWriterConfig& config() const { return config_; }
+
+private:
+    struct Segment {
+        int fd{-1};
+        std::byte* base{nullptr};
+        std::size_t capacity{0};
+        uint32_t index{0};
+        std::string path;
+    };
+
+    std::string segment_path(uint32_t index) const {
+        return (std::filesystem::path(config_.directory) /
+                log_segment_filename(config_.prefix, index)).string();
+    }
+
+    /// Spares get their segment name when they become active
+    std::string spare_path() const {
+        return (std::filesystem::path(config_.directory) / ("." + config_.prefix + "_spare")).string();
+    }
+
+    // ========================================================================
+    // Segment Management
+    // ========================================================================
+
+    /// Called with mutex_ held
+    bool rollover() {
+        const uint32_t next_index = active_.index + 1;
+        const std::string next_path = segment_path(next_index);
+        Segment next;
+        if (spare_ && ::rename(spare_->path.c_str(), next_path.c_str()) == 0) {
+            next = *spare_;
+            next.path = next_path;
+            spare_.reset();
+        } else {
+            auto created = create_segment(next_path, false);
+            if (!created) {
+                return false;
+            }
+            next = *created;
+            ++inline_rollovers_;
+        }
+        stamp_segment(next, next_index);
+        retired_.emplace_back(active_, write_pos_);
+        active_ = next;
+        write_pos_ = data_offset_;
+        synced_pos_ = data_offset_;
+        ++segments_;
+        cv_.notify_one();
+        return true;
+    }
+
+    /// Create, pre-allocate and map a segment; header written except index/time
+    std::optional<Segment> create_segment(const std::string& path, bool prefault) const {
+        Segment seg;
+        seg.capacity = config_.segment_size;
+        seg.path = path;
+
+        seg.fd = ::open(seg.path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (seg.fd < 0) {
+            return std::nullopt;
+        }
+        // Allocate blocks up front: page faults in append() never extend the file
+        if (::posix_fallocate(seg.fd, 0, static_cast<off_t>(seg.capacity)) != 0 &&
+            ::ftruncate(seg.fd, static_cast<off_t>(seg.capacity)) != 0) {
+            ::close(seg.fd);
+            ::unlink(seg.path.c_str());
+            return std::nullopt;
+        }
+
+        void* addr = ::mmap(nullptr, seg.capacity, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | (prefault ? MAP_POPULATE : 0), seg.fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(seg.fd);
+            ::unlink(seg.path.c_str());
+            return std::nullopt;
+        }
+        seg.base = static_cast<std::byte*>(addr);
+        ::madvise(seg.base, seg.capacity, MADV_SEQUENTIAL);
+
+        LogSegmentHeader header{
+            .magic = LOG_MAGIC,
+            .version = LOG_VERSION,
+            .stream_count = static_cast<uint16_t>(streams_.size()),
+            .segment_index = 0,
+            .schema_size = static_cast<uint32_t>(schema_.size()),
+            .created_ns = 0,
+            .data_offset = data_offset_
+        };
+        std::byte* p = seg.base;
+        std::memcpy(p, &header, sizeof(header));
+        p += sizeof(header);
+        if (!streams_.empty()) {
+            std::memcpy(p, streams_.data(), streams_.size() * sizeof(LogStreamInfo));
+            p += streams_.size() * sizeof(LogStreamInfo);
+        }
+        std::memcpy(p, schema_.data(), schema_.size());
+        return seg;
+    }
+
+    static void stamp_segment(Segment& seg, uint32_t index) {
+        seg.index = index;
+        auto* header = reinterpret_cast<LogSegmentHeader*>(seg.base);
+        header->segment_index = index;
+        header->created_ns = Time::now();
+    }
+
+    /// Persist the used part of a segment, append its seek index and release it
+    void finalize_segment(Segment& seg, std::size_t used) const {
+        if (!seg.base) {
+            return;
+        }
+        ::msync(seg.base, used, MS_SYNC);
+        const auto index = build_log_index(seg.base, data_offset_, used);
+        ::munmap(seg.base, seg.capacity);
+
+        // Keep the zero end marker behind the last record, index after it
+        const std::size_t data_end = std::min(used + sizeof(LogRecordHeader), seg.capacity);
+        ::ftruncate(seg.fd, static_cast<off_t>(data_end));
+        const LogIndexFooter footer{.magic = LOG_INDEX_MAGIC,
+                                    .count = static_cast<uint32_t>(index.size()),
+                                    .data_end = used};
+        const std::size_t index_bytes = index.size() * sizeof(LogIndexEntry);
+        if (::pwrite(seg.fd, index.data(), index_bytes, static_cast<off_t>(data_end)) ==
+                static_cast<ssize_t>(index_bytes)) {
+            ::pwrite(seg.fd, &footer, sizeof(footer), static_cast<off_t>(data_end + index_bytes));
+        }
+        if (config_.durable) {
+            ::fdatasync(seg.fd);
+        }
+        ::close(seg.fd);
+        seg = Segment{};
+    }
+
+    /// Release a segment that never received records
+    static void discard_segment(Segment& seg) {
+        ::munmap(seg.base, seg.capacity);
+        ::close(seg.fd);
+        ::unlink(seg.path.c_str());
+        seg = Segment{};
+    }
+
+    // ========================================================================
+    // Flush Thread
+    // ========================================================================
+
+    void flush_loop() {
+        const auto wake_interval = config_.sync_interval.count() > 0
+            ? config_.sync_interval : std::chrono::milliseconds(100);
+        std::vector<std::pair<Segment, std::size_t>> retired;
+        retired.reserve(4);
+
+        UniqueLock lock(mutex_);
+        while (!closed_) {
+            // Prepare a spare / finish retired segments right away, else wait
+            if (spare_ && retired_.empty()) {
+                cv_.wait_for(lock, wake_interval);
+                if (closed_) {
+                    break;
+                }
+            }
+
+            retired.swap(retired_);
+            const bool need_spare = !spare_;
+            // Only this thread unmaps segments, so the snapshot stays valid unlocked
+            const Segment active = active_;
+            const std::size_t sync_from = synced_pos_;
+            const std::size_t sync_to = write_pos_;
+            synced_pos_ = write_pos_;
+            lock.unlock();
+
+            for (auto& [seg, used] : retired) {
+                finalize_segment(seg, used);
+            }
+            retired.clear();
+
+            std::optional<Segment> spare;
+            if (need_spare) {
+                spare = create_segment(spare_path(), config_.prefault);
+            }
+
+            if (config_.sync_interval.count() > 0 && sync_to > sync_from) {
+                const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                const std::size_t begin = sync_from & ~(page - 1);
+                ::msync(active.base + begin, sync_to - begin, MS_SYNC);
+            }
+
+            lock.lock();
+            if (spare) {
+                spare_ = *spare;  // Only this thread creates spares
+            }
+        }
+    }
+
+    LogWriterConfig config_;
+    std::vector<LogStreamInfo> streams_;
+    std::string schema_;
+    std::size_t data_offset_;
+
+    mutable Mutex mutex_;
+    ConditionVariable cv_;
+    // Guarded by mutex_
+    Segment active_;
+    std::size_t write_pos_{0};
+    std::size_t synced_pos_{0};
+    std::optional<Segment> spare_;
+    std::vector<std::pair<Segment, std::size_t>> retired_;  // Full segments and their used size
+    bool closed_{false};
+    uint64_t records_{0};
+    uint64_t bytes_{0};
+    uint64_t dropped_{0};
+    uint32_t segments_{0};
+    uint32_t inline_rollovers_{0};
+
+    std::optional<Thread> flush_thread_;
+};
+
+} // namespace commrat
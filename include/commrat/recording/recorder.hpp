@@ -0,0 +1,301 @@
+/**
+ * @file recorder.hpp
+ * @brief Generic stream recorder writing memory-mapped binary logs
+ *
+ * Recorder<App> subscribes to any set of (message type, producer) streams
+ * with the regular subscription protocol and appends every received
+ * message's wire bytes to an MmapLogWriter log. Each segment carries the
+ * stream table and App::Introspection::export_all() so logs are
+ * self-describing (see log_format.hpp).
+ *
+ * Messages are not deserialized: the receive path is one TiMS receive into
+ * a per-stream buffer and one memcpy into the mapped segment. File system
+ * work (segment creation, msync, fdatasync) runs on the writer's flush
+ * thread, so a slow disk shows up as page-cache growth rather than as
+ * back-pressure on publishers.
+ *
+ * Addressing: the recorder uses base address
+ * encode_address(RECORDER_TYPE_ID, system_id, instance_id, 0), its WORK
+ * mailbox at base + MailboxType::WORK (subscribe replies) and one DATA
+ * mailbox per stream at base | (MailboxType::DATA + stream_id).
+ */
+
+#pragma once
+
+#include "commrat/recording/mmap_log_writer.hpp"
+#include "commrat/mailbox/registry_mailbox.hpp"
+#include "commrat/messaging/system/system_registry.hpp"
+#include "commrat/module/module_config.hpp"
+#include "commrat/module/helpers/address_helpers.hpp"
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace commrat {
+
+/// Type byte of recorder base addresses (modules use their output type's low byte)
+inline constexpr uint8_t RECORDER_TYPE_ID = 0xFE;
+
+/// DATA mailbox indices run from MailboxType::DATA to 0xFF
+inline constexpr std::size_t RECORDER_MAX_STREAMS = 0x100 - static_cast<std::size_t>(MailboxType::DATA);
+
+/**
+ * @brief Recorder configuration
+ */
+struct RecorderConfig {
+    std::string name{"recorder"};
+    uint8_t system_id{0};
+    uint8_t instance_id{0};
+    LogWriterConfig log;                                   ///< Output directory and segment policy
+    std::size_t mailbox_slots{256};                        ///< Receive queue depth per stream
+    ThreadPriority priority{ThreadPriority::HIGH};         ///< Receive threads
+    SchedulingPolicy policy{SchedulingPolicy::NORMAL};     ///< Receive threads
+};
+
+/**
+ * @brief Records subscribed streams to a segmented binary log
+ *
+ * @tparam App CommRaT application (provides registry and Introspection)
+ *
+ * Example:
+ * @code
+ * Recorder<MyApp> recorder(RecorderConfig{
+ *     .name = "field_log", .system_id = 90, .instance_id = 1,
+ *     .log = {.directory = "/data/run_042", .prefix = "run_042"}
+ * });
+ * recorder.record<ImuData>(10, 1, "imu");
+ * recorder.record<GpsData>(11, 1, "gps");
+ * recorder.start();
+ * recorder.wait_for_subscriptions(Milliseconds(500));
+ * // ...
+ * recorder.stop();  // Unsubscribes and finalizes all segments
+ * @endcode
+ *
+ * Each stream has its own DATA mailbox and receive thread, so the stream a
+ * message belongs to is known without inspecting it. Starting again after
+ * stop() begins a new recording and overwrites segments with the same prefix.
+ */
+template<typename App>
+class Recorder {
+    using DataMailbox = RegistryMailbox<App>;
+    using WorkMailbox = RegistryMailbox<SystemRegistry>;
+    using RawMessage = typename DataMailbox::RawMessage;
+
+public:
+    explicit Recorder(const RecorderConfig& config)
+        : config_(config)
+        , base_address_(encode_address(RECORDER_TYPE_ID, config.system_id, config.instance_id, 0)) {}
+
+    ~Recorder() {
+        stop();
+    }
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /**
+     * @brief Add a stream to record (before start())
+     *
+     * @tparam T Payload type published by the producer
+     * @param source_system_id Producer system ID
+     * @param source_instance_id Producer instance ID
+     * @param label Optional name stored in the stream table (truncated to 23 chars)
+     * @return Stream ID used in the log records
+     */
+    template<typename T>
+        requires App::template is_registered<T>
+    uint16_t record(uint8_t source_system_id, uint8_t source_instance_id, std::string_view label = {}) {
+        if (running_) {
+            throw std::logic_error("[Recorder] record() must be called before start()");
+        }
+        if (streams_.size() >= RECORDER_MAX_STREAMS) {
+            throw std::runtime_error("[Recorder] Too many streams");
+        }
+
+        auto stream = std::make_unique<Stream>();
+        stream->info = LogStreamInfo{
+            .message_id = App::template get_message_id<T>(),
+            .stream_id = static_cast<uint16_t>(streams_.size()),
+            .system_id = source_system_id,
+            .instance_id = source_instance_id,
+            .name = {}
+        };
+        label.copy(stream->info.name, std::min(label.size(), sizeof(stream->info.name) - 1));
+        streams_.push_back(std::move(stream));
+        return streams_.back()->info.stream_id;
+    }
+
+    /**
+     * @brief Create the log, start receiving and subscribe to all streams
+     *
+     * Throws std::runtime_error if the log or a mailbox cannot be created.
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+
+        std::vector<LogStreamInfo> table;
+        table.reserve(streams_.size());
+        for (const auto& stream : streams_) {
+            table.push_back(stream->info);
+        }
+        writer_.emplace(config_.log, table, App::Introspection::export_all());
+
+        work_mailbox_.emplace(MailboxConfig{
+            .mailbox_id = base_address_ + static_cast<uint8_t>(MailboxType::WORK),
+            .message_slots = std::max<std::size_t>(10, streams_.size() * 2),
+            .max_message_size = SystemRegistry::max_message_size,
+            .mailbox_name = config_.name + "_work"
+        });
+        if (!work_mailbox_->start()) {
+            throw std::runtime_error("[Recorder] Failed to start WORK mailbox for " + config_.name);
+        }
+
+        for (auto& stream : streams_) {
+            const uint16_t id = stream->info.stream_id;
+            stream->mailbox = std::make_unique<DataMailbox>(MailboxConfig{
+                .mailbox_id = data_mailbox_address(id),
+                .message_slots = config_.mailbox_slots,
+                .max_message_size = App::max_message_size,
+                .mailbox_name = config_.name + "_data_" + std::to_string(id)
+            });
+            if (!stream->mailbox->start()) {
+                throw std::runtime_error("[Recorder] Failed to start DATA mailbox " +
+                                         std::to_string(id) + " for " + config_.name);
+            }
+        }
+
+        running_ = true;
+        for (auto& stream : streams_) {
+            Stream* s = stream.get();
+            s->thread.emplace(ThreadConfig{.name = config_.name + "/rx" + std::to_string(s->info.stream_id),
+                                           .priority = config_.priority,
+                                           .policy = config_.policy},
+                              [this, s]() { receive_loop(*s); });
+        }
+
+        for (auto& stream : streams_) {
+            subscribe(*stream);
+        }
+    }
+
+    /**
+     * @brief Wait until every producer acknowledged its subscription
+     * @return true if all SubscribeReplies arrived within timeout
+     */
+    bool wait_for_subscriptions(Milliseconds timeout) {
+        if (!running_) {
+            return false;
+        }
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (acknowledged_ < streams_.size()) {
+            auto remaining = std::chrono::duration_cast<Milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                return false;
+            }
+            auto reply = work_mailbox_->template receive_for<SubscribeReplyPayload>(remaining);
+            if (reply && reply->payload.success) {
+                ++acknowledged_;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Unsubscribe, drain receive queues and finalize the log
+     */
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+
+        for (auto& stream : streams_) {
+            UnsubscribeRequestPayload request{.subscriber_base_addr = base_address_};
+            work_mailbox_->send(request, producer_work_mailbox(stream->info.message_id, stream->info.system_id,
+                                                               stream->info.instance_id));
+        }
+        for (auto& stream : streams_) {
+            stream->thread.reset();  // Joins after draining
+            stream->mailbox.reset();
+        }
+        work_mailbox_.reset();
+        acknowledged_ = 0;
+
+        if (writer_) {
+            writer_->close();
+        }
+    }
+
+    bool is_running() const { return running_; }
+
+    /// Base address used as subscriber address towards producers
+    uint32_t base_address() const { return base_address_; }
+
+    /// Log counters (zero before the first start())
+    LogWriterStats stats() const {
+        return writer_ ? writer_->stats() : LogWriterStats{};
+    }
+
+private:
+    struct Stream {
+        LogStreamInfo info{};
+        std::unique_ptr<DataMailbox> mailbox;
+        RawMessage buffer;                 // Receive thread only
+        std::optional<Thread> thread;
+    };
+
+    uint32_t data_mailbox_address(uint16_t stream_id) const {
+        return base_address_ | (static_cast<uint32_t>(MailboxType::DATA) + stream_id);
+    }
+
+    void subscribe(Stream& stream) {
+        SubscribeRequestPayload request{
+            .subscriber_base_addr = base_address_,
+            .mailbox_index = static_cast<uint8_t>(static_cast<uint32_t>(MailboxType::DATA) + stream.info.stream_id),
+            .requested_period_ms = 0
+        };
+        const uint32_t dest = producer_work_mailbox(stream.info.message_id, stream.info.system_id,
+                                                    stream.info.instance_id);
+        if (send_subscribe_request(*work_mailbox_, request, dest)) {
+            return;
+        }
+        std::cerr << "[" << config_.name << "] Failed to subscribe stream " << stream.info.stream_id
+                  << " (WORK mailbox 0x" << std::hex << dest << std::dec << ")\n";
+    }
+
+    void receive_loop(Stream& stream) {
+        auto& mailbox = stream.mailbox->underlying();
+        const uint16_t id = stream.info.stream_id;
+
+        while (running_.load(std::memory_order_acquire)) {
+            if (mailbox.receive_any_raw(stream.buffer, Milliseconds(10))) {
+                writer_->append(id, Time::now(), stream.buffer.data());
+            }
+        }
+        // Keep what is already queued
+        while (mailbox.receive_any_raw(stream.buffer, Milliseconds(-1))) {
+            writer_->append(id, Time::now(), stream.buffer.data());
+        }
+    }
+
+    RecorderConfig config_;
+    uint32_t base_address_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::optional<MmapLogWriter> writer_;
+    std::optional<WorkMailbox> work_mailbox_;
+    std::atomic<bool> running_{false};
+    std::size_t acknowledged_{0};
+};
+
+} // namespace commrat
@@ -0,0 +1,588 @@
+/**
+ * @file replayer.hpp
+ * @brief Replay of recording logs as the original producers
+ *
+ * Replayer<App> reads a log written by Recorder<App> and republishes every
+ * record's wire bytes unchanged, so header timestamps, sequence numbers and
+ * trace context are the recorded ones. For each recorded stream it opens
+ * the WORK mailbox of the original producer (MailboxSet addressing of the
+ * stream's message type, system and instance ID) and answers the regular
+ * subscription protocol there, so consumers subscribe exactly as they would
+ * to the live producer.
+ *
+ * Pacing follows the recorded receive times (LogRecordHeader::receive_ns):
+ * - RealTime: original timing
+ * - Scaled: original timing divided by ReplayConfig::speed (0.1x - 10x)
+ * - AsFastAsPossible: no pacing
+ *
+ * In every mode a full consumer mailbox throttles the replay instead of
+ * dropping the message: the send is retried until it succeeds or
+ * ReplayConfig::max_block passes. At maximum speed the replay therefore
+ * runs at the rate of the slowest subscribed consumer and nothing is lost.
+ *
+ * Addressing: data is sent from the replayer's own mailbox at
+ * encode_address(REPLAY_TYPE_ID, system_id, instance_id, 0).
+ */
+
+#pragma once
+
+#include "commrat/recording/log_reader.hpp"
+#include "commrat/mailbox/registry_mailbox.hpp"
+#include "commrat/messaging/system/system_registry.hpp"
+#include "commrat/module/module_config.hpp"
+#include "commrat/module/helpers/address_helpers.hpp"
+#include "commrat/platform/threading.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace commrat {
+
+/// Type byte of replayer base addresses (modules use their output type's low byte)
+inline constexpr uint8_t REPLAY_TYPE_ID = 0xFD;
+
+/// Subscribers per replayed stream (ModuleConfig::max_subscribers default)
+inline constexpr std::size_t REPLAY_MAX_SUBSCRIBERS = 8;
+
+enum class ReplayPacing : uint8_t {
+    RealTime,          ///< Recorded timing
+    Scaled,            ///< Recorded timing / ReplayConfig::speed
+    AsFastAsPossible   ///< Limited only by consumer backpressure
+};
+
+/**
+ * @brief Replayer configuration
+ */
+struct ReplayConfig {
+    std::string name{"replay"};
+    uint8_t system_id{0};
+    uint8_t instance_id{0};
+    std::string directory{"."};                         ///< LogWriterConfig::directory of the recording
+    std::string prefix{"commrat"};                      ///< LogWriterConfig::prefix of the recording
+    ReplayPacing pacing{ReplayPacing::RealTime};
+    double speed{1.0};                                  ///< Scaled pacing factor, 0.1 to 10
+    uint64_t start_ns{0};                               ///< Start at the first record received at or after (0 = beginning)
+    std::chrono::milliseconds max_block{1000};          ///< Longest wait for a full consumer mailbox before dropping
+    ThreadPriority priority{ThreadPriority::HIGH};      ///< Replay thread
+    SchedulingPolicy policy{SchedulingPolicy::NORMAL};  ///< Replay thread
+};
+
+/**
+ * @brief Replay counters (snapshot)
+ */
+struct ReplayStats {
+    uint64_t records{0};      ///< Records read from the log
+    uint64_t sent{0};         ///< Messages delivered (one per subscriber)
+    uint64_t dropped{0};      ///< Sends abandoned after max_block or failed
+    uint64_t skipped{0};      ///< Records of streams App cannot publish
+    uint64_t blocked_ns{0};   ///< Time spent waiting for full consumer mailboxes
+    uint64_t max_lag_ns{0};   ///< Furthest behind the paced schedule (0 for AsFastAsPossible)
+    bool finished{false};     ///< All records replayed
+};
+
+/**
+ * @brief Replays a recording to subscribed consumers
+ *
+ * @tparam App CommRaT application the recording was made with
+ *
+ * Example:
+ * @code
+ * Replayer<MyApp> replay(ReplayConfig{
+ *     .name = "replay", .system_id = 91, .instance_id = 1,
+ *     .directory = "/data/run_042", .prefix = "run_042",
+ *     .pacing = ReplayPacing::AsFastAsPossible
+ * });
+ * replay.start();                                   // Producers appear
+ * perception.start();                               // Consumers subscribe as usual
+ * replay.wait_for_subscribers(2, Milliseconds(2000));
+ * replay.play();
+ * replay.wait_until_finished(Milliseconds(60000));
+ * replay.stop();
+ * @endcode
+ *
+ * The original producers must not run at the same time (their WORK
+ * mailbox addresses are taken by the replayer).
+ */
+template<typename App>
+class Replayer {
+    using ControlMailbox = RegistryMailbox<SystemRegistry>;
+    using PublishMailbox = RegistryMailbox<App>;
+
+public:
+    /**
+     * Opens the recording and reads its stream table. Throws
+     * std::runtime_error if there are no segments or the first one is
+     * invalid, std::invalid_argument for a speed outside 0.1 to 10.
+     */
+    explicit Replayer(const ReplayConfig& config)
+        : config_(config)
+        , base_address_(encode_address(REPLAY_TYPE_ID, config.system_id, config.instance_id, 0))
+        , segments_(list_log_segments(config.directory, config.prefix)) {
+        if (config_.pacing == ReplayPacing::Scaled && !(config_.speed >= 0.1 && config_.speed <= 10.0)) {
+            throw std::invalid_argument("[Replayer] speed must be within 0.1 and 10");
+        }
+        if (segments_.empty()) {
+            throw std::runtime_error("[Replayer] No segments '" + config_.prefix + "' in " + config_.directory);
+        }
+
+        LogSegmentReader first(segments_.front());
+        streams_.assign(first.streams().begin(), first.streams().end());
+        if (first.schema() != App::Introspection::export_all()) {
+            std::cerr << "[" << config_.name << "] Recording schema differs from the application's;"
+                      << " replaying streams by message ID\n";
+        }
+
+        constexpr auto app_ids = App::message_ids();
+        for (const auto& stream : streams_) {
+            if (std::find(app_ids.begin(), app_ids.end(), stream.message_id) == app_ids.end()) {
+                std::cerr << "[" << config_.name << "] Stream " << stream.stream_id << " ('" << stream.name
+                          << "'): message ID 0x" << std::hex << stream.message_id << std::dec
+                          << " not registered, skipped\n";
+                continue;
+            }
+            if (stream.stream_id >= stream_sources_.size()) {
+                stream_sources_.resize(stream.stream_id + 1, nullptr);
+            }
+            stream_sources_[stream.stream_id] = source_for(stream);
+        }
+
+        start_segment_ = find_segment(config_.start_ns);
+    }
+
+    ~Replayer() {
+        stop();
+    }
+
+    Replayer(const Replayer&) = delete;
+    Replayer& operator=(const Replayer&) = delete;
+
+    /// Stream table of the recording
+    std::span<const LogStreamInfo> streams() const { return streams_; }
+
+    /**
+     * @brief Open the producer mailboxes and accept subscriptions
+     *
+     * Throws std::runtime_error if a mailbox cannot be created (e.g. the
+     * original producer is running).
+     */
+    void start() {
+        if (running_) {
+            return;
+        }
+
+        publish_mailbox_.emplace(MailboxConfig{
+            .mailbox_id = base_address_,
+            .max_message_size = App::max_message_size,
+            .mailbox_name = config_.name + "_publish"
+        });
+        if (!publish_mailbox_->start()) {
+            throw std::runtime_error("[Replayer] Failed to start publish mailbox for " + config_.name);
+        }
+        for (auto& source : sources_) {
+            source->mailbox = std::make_unique<ControlMailbox>(MailboxConfig{
+                .mailbox_id = source->work_address,
+                .max_message_size = SystemRegistry::max_message_size,
+                .mailbox_name = config_.name + "_work_" + std::to_string(source->work_address)
+            });
+            if (!source->mailbox->start()) {
+                throw std::runtime_error("[Replayer] Failed to start producer mailbox 0x" +
+                                         to_hex(source->work_address) + " for " + config_.name);
+            }
+        }
+
+        running_ = true;
+        control_thread_.emplace(ThreadConfig{.name = config_.name + "/control"},
+                                [this]() { control_loop(); });
+    }
+
+    /**
+     * @brief Wait until at least `count` subscriptions (over all streams) exist
+     */
+    bool wait_for_subscribers(std::size_t count, Milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (subscriber_count() < count) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Start at the first record received at or after receive_ns (before play())
+     *
+     * Binary search over the segments' first records, then over the
+     * segment's sparse index.
+     */
+    void seek(uint64_t receive_ns) {
+        if (replay_thread_) {
+            throw std::logic_error("[Replayer] seek() must be called before play()");
+        }
+        config_.start_ns = receive_ns;
+        start_segment_ = find_segment(receive_ns);
+    }
+
+    /// Begin replaying (once per Replayer)
+    void play() {
+        if (!running_ || replay_thread_) {
+            return;
+        }
+        replay_thread_.emplace(ThreadConfig{.name = config_.name + "/replay",
+                                            .priority = config_.priority,
+                                            .policy = config_.policy},
+                               [this]() { replay_loop(); });
+    }
+
+    /// Wait until every record was replayed
+    bool wait_until_finished(Milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        UniqueLock lock(mutex_);
+        while (!finished_) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+            cv_.wait_for(lock, deadline - now);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Stop replaying and close the producer mailboxes
+     */
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        {
+            Lock lock(mutex_);  // Wakes a paced wait between its check and wait
+        }
+        cv_.notify_all();
+        replay_thread_.reset();   // Joins
+        control_thread_.reset();
+        for (auto& source : sources_) {
+            source->mailbox.reset();
+            Lock lock(source->mutex);
+            source->subscriber_count = 0;
+        }
+        publish_mailbox_.reset();
+    }
+
+    bool is_running() const { return running_; }
+    bool is_finished() const { return finished_; }
+
+    /// Subscriptions over all streams
+    std::size_t subscriber_count() const {
+        std::size_t total = 0;
+        for (const auto& source : sources_) {
+            Lock lock(source->mutex);
+            total += source->subscriber_count;
+        }
+        return total;
+    }
+
+    ReplayStats stats() const {
+        return ReplayStats{
+            .records = records_.load(std::memory_order_relaxed),
+            .sent = sent_.load(std::memory_order_relaxed),
+            .dropped = dropped_.load(std::memory_order_relaxed),
+            .skipped = skipped_.load(std::memory_order_relaxed),
+            .blocked_ns = blocked_ns_.load(std::memory_order_relaxed),
+            .max_lag_ns = max_lag_ns_.load(std::memory_order_relaxed),
+            .finished = finished_
+        };
+    }
+
+private:
+    struct Subscriber {
+        uint32_t base_addr{0};
+        uint8_t mailbox_index{0};
+    };
+
+    /// One original producer output: (message type, system, instance)
+    struct Source {
+        uint32_t work_address{0};
+        std::unique_ptr<ControlMailbox> mailbox;   // Control thread only
+        mutable Mutex mutex;
+        std::array<Subscriber, REPLAY_MAX_SUBSCRIBERS> subscribers{};  // Guarded by mutex
+        std::size_t subscriber_count{0};                               // Guarded by mutex
+    };
+
+    static std::string to_hex(uint32_t value) {
+        char text[16];
+        std::snprintf(text, sizeof(text), "%x", value);
+        return text;
+    }
+
+    Source* source_for(const LogStreamInfo& stream) {
+        // The recorded producer's WORK mailbox, which the replay takes over
+        const uint32_t address = producer_work_mailbox(stream.message_id, stream.system_id, stream.instance_id);
+        for (auto& source : sources_) {
+            if (source->work_address == address) {
+                return source.get();
+            }
+        }
+        auto source = std::make_unique<Source>();
+        source->work_address = address;
+        sources_.push_back(std::move(source));
+        return sources_.back().get();
+    }
+
+    /// Last segment whose first record was received before receive_ns
+    std::size_t find_segment(uint64_t receive_ns) const {
+        if (receive_ns == 0) {
+            return 0;
+        }
+        std::size_t lo = 0;
+        std::size_t hi = segments_.size();
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            auto first = LogSegmentReader(segments_[mid]).first_receive_ns();
+            if (first && *first < receive_ns) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // ========================================================================
+    // Subscription Protocol (control thread)
+    // ========================================================================
+
+    void control_loop() {
+        typename ControlMailbox::RawMessage request;
+        while (running_.load(std::memory_order_acquire)) {
+            bool idle = true;
+            for (auto& source : sources_) {
+                auto& mailbox = source->mailbox->underlying();
+                while (mailbox.receive_any_raw(request, Milliseconds(-1))) {
+                    idle = false;
+                    handle_request(*source, request);
+                }
+            }
+            if (idle) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    void handle_request(Source& source, const typename ControlMailbox::RawMessage& request) {
+        SystemRegistry::visit(request.header.msg_type, request.data(), [&](auto& tims_msg) {
+            auto& msg = tims_msg.payload;
+            using MsgType = std::decay_t<decltype(msg)>;
+
+            if constexpr (std::is_same_v<MsgType, SubscribeRequestPayload>) {
+                bool added = false;
+                {
+                    Lock lock(source.mutex);
+                    auto begin = source.subscribers.begin();
+                    auto end = begin + source.subscriber_count;
+                    const Subscriber sub{msg.subscriber_base_addr, msg.mailbox_index};
+                    if (std::find_if(begin, end, [&](const Subscriber& s) {
+                            return s.base_addr == sub.base_addr && s.mailbox_index == sub.mailbox_index;
+                        }) != end) {
+                        added = true;
+                    } else if (source.subscriber_count < source.subscribers.size()) {
+                        source.subscribers[source.subscriber_count++] = sub;
+                        added = true;
+                    }
+                }
+                SubscribeReplyPayload reply{
+                    .actual_period_ms = 0,
+                    .success = added,
+                    .error_code = added ? 0u : 1u  // Max subscribers exceeded
+                };
+                source.mailbox->send(reply, msg.subscriber_base_addr + static_cast<uint8_t>(MailboxType::WORK));
+            } else if constexpr (std::is_same_v<MsgType, UnsubscribeRequestPayload>) {
+                {
+                    Lock lock(source.mutex);
+                    auto begin = source.subscribers.begin();
+                    auto end = std::remove_if(begin, begin + source.subscriber_count, [&](const Subscriber& s) {
+                        return s.base_addr == msg.subscriber_base_addr;
+                    });
+                    source.subscriber_count = static_cast<std::size_t>(end - begin);
+                }
+                UnsubscribeReplyPayload reply{.success = true};
+                source.mailbox->send(reply, msg.subscriber_base_addr + static_cast<uint8_t>(MailboxType::WORK));
+            }
+        });
+    }
+
+    // ========================================================================
+    // Replay (replay thread)
+    // ========================================================================
+
+    void replay_loop() {
+        const bool paced = config_.pacing != ReplayPacing::AsFastAsPossible;
+        const double speed = config_.pacing == ReplayPacing::Scaled ? config_.speed : 1.0;
+        std::optional<uint64_t> log_origin;
+        std::chrono::steady_clock::time_point wall_origin;
+
+        std::unique_ptr<LogSegmentReader> next = open_segment(start_segment_);
+        for (std::size_t index = start_segment_; index < segments_.size() && running_; ++index) {
+            std::unique_ptr<LogSegmentReader> reader = std::move(next);
+            // Read ahead: the kernel pages in the next segment while this one replays
+            next = open_segment(index + 1);
+            if (!reader) {
+                continue;
+            }
+            if (index == start_segment_ && config_.start_ns != 0) {
+                reader->seek_time(config_.start_ns);
+            }
+
+            while (running_.load(std::memory_order_relaxed)) {
+                auto record = reader->next();
+                if (!record) {
+                    break;
+                }
+                records_.fetch_add(1, std::memory_order_relaxed);
+
+                Source* source = record->stream_id < stream_sources_.size()
+                    ? stream_sources_[record->stream_id] : nullptr;
+                if (!source) {
+                    skipped_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (paced) {
+                    if (!log_origin) {
+                        log_origin = record->receive_ns;
+                        wall_origin = std::chrono::steady_clock::now();
+                    }
+                    const auto offset = std::chrono::nanoseconds(static_cast<int64_t>(
+                        static_cast<double>(record->receive_ns - std::min(record->receive_ns, *log_origin)) / speed));
+                    if (!wait_until(wall_origin + offset)) {
+                        break;
+                    }
+                }
+                publish(*source, record->wire);
+            }
+        }
+
+        {
+            Lock lock(mutex_);
+            finished_ = running_.load();
+        }
+        cv_.notify_all();
+    }
+
+    std::unique_ptr<LogSegmentReader> open_segment(std::size_t index) const {
+        if (index >= segments_.size()) {
+            return nullptr;
+        }
+        try {
+            auto reader = std::make_unique<LogSegmentReader>(segments_[index]);
+            reader->prefetch();
+            return reader;
+        } catch (const std::exception& e) {
+            std::cerr << "[" << config_.name << "] Skipping segment: " << e.what() << "\n";
+            return nullptr;
+        }
+    }
+
+    /// Sleep until `target`; false if stopped meanwhile
+    bool wait_until(std::chrono::steady_clock::time_point target) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= target) {
+            const auto lag = static_cast<uint64_t>((now - target).count());
+            if (lag > max_lag_ns_.load(std::memory_order_relaxed)) {
+                max_lag_ns_.store(lag, std::memory_order_relaxed);
+            }
+            return running_.load(std::memory_order_relaxed);
+        }
+        UniqueLock lock(mutex_);
+        while (running_.load(std::memory_order_relaxed) && now < target) {
+            cv_.wait_for(lock, target - now);
+            now = std::chrono::steady_clock::now();
+        }
+        return running_.load(std::memory_order_relaxed);
+    }
+
+    /// Send to every subscriber of the source; full mailboxes throttle the replay
+    void publish(Source& source, std::span<const std::byte> wire) {
+        std::array<Subscriber, REPLAY_MAX_SUBSCRIBERS> subscribers;
+        std::size_t count = 0;
+        {
+            Lock lock(source.mutex);
+            count = source.subscriber_count;
+            std::copy_n(source.subscribers.begin(), count, subscribers.begin());
+        }
+
+        auto& mailbox = publish_mailbox_->underlying();
+        for (std::size_t i = 0; i < count; ++i) {
+            const uint32_t dest = subscribers[i].base_addr | subscribers[i].mailbox_index;
+            auto result = mailbox.send_raw(wire, dest);
+            if (!result && result.get_error() == MailboxError::QueueFull) {
+                result = send_blocking(wire, dest);
+            }
+            if (result) {
+                sent_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Retry a send to a full mailbox until it succeeds, max_block passes or stop()
+    MailboxResult<void> send_blocking(std::span<const std::byte> wire, uint32_t dest) {
+        auto& mailbox = publish_mailbox_->underlying();
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + config_.max_block;
+        MailboxResult<void> result = MailboxError::QueueFull;
+        for (uint32_t attempt = 0; running_.load(std::memory_order_relaxed); ++attempt) {
+            // Consumers drain in microseconds: spin briefly, then back off
+            if (attempt < 16) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            result = mailbox.send_raw(wire, dest);
+            if (result || result.get_error() != MailboxError::QueueFull ||
+                std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+        blocked_ns_.fetch_add(static_cast<uint64_t>((std::chrono::steady_clock::now() - start).count()),
+                              std::memory_order_relaxed);
+        return result;
+    }
+
+    ReplayConfig config_;
+    uint32_t base_address_;
+    std::vector<std::string> segments_;
+    std::vector<LogStreamInfo> streams_;
+    std::vector<std::unique_ptr<Source>> sources_;
+    std::vector<Source*> stream_sources_;  // Indexed by stream ID, nullptr = skipped
+    std::size_t start_segment_{0};
+
+    std::optional<PublishMailbox> publish_mailbox_;  // Replay thread only
+    std::atomic<bool> running_{false};
+    Mutex mutex_;
+    ConditionVariable cv_;
+    std::atomic<bool> finished_{false};
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> blocked_ns_{0};
+    std::atomic<uint64_t> max_lag_ns_{0};
+
+    std::optional<Thread> control_thread_;
+    std::optional<Thread> replay_thread_;
+};
+
+} // namespace commrat
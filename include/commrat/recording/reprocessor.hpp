@@ -0,0 +1,509 @@
+/**
+ * @file reprocessor.hpp
+ * @brief Parallel offline reprocessing of recordings through a module's process()
+ *
+ * Reprocessor<App, ModuleT> runs a recording (Recorder<App> log) through
+ * fresh instances of ModuleT without TiMS, threads or pacing: each record
+ * of an input stream is decoded and handed to Module::process_offline(),
+ * which runs the module's own metadata, history buffer, sync and process()
+ * code. Time::now() on the worker thread is the record's receive time
+ * (VirtualTimeScope), so time-dependent module code sees recorded time.
+ *
+ * The timeline [start, end) is cut into chunks of ReprocessConfig::chunk
+ * that are processed independently on all cores. Every chunk gets its own
+ * module instance, first fed the `warmup` before the chunk (outputs
+ * discarded) so filters and history buffers are in steady state when the
+ * chunk begins. Warm-up should cover the module's memory (filter
+ * convergence, sync tolerance); outputs are then the same as for one
+ * sequential pass.
+ *
+ * Outputs of all chunks are merged in header timestamp order and passed to
+ * the output callback and/or written as a recording (one stream per output
+ * type, addressed like the live module's outputs), so reprocessed and
+ * original runs can be compared with the same tools. Serialized outputs are
+ * held in memory until the merge.
+ *
+ * Input streams are matched by message type and the module's configured
+ * source (SingleInputConfig / MultiInputConfig::sources) against the
+ * recording's stream table.
+ */
+
+#pragma once
+
+#include "commrat/recording/log_reader.hpp"
+#include "commrat/recording/mmap_log_writer.hpp"
+#include "commrat/module/module_config.hpp"
+#include "commrat/platform/threading.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace commrat {
+
+/**
+ * @brief Reprocessing configuration
+ */
+struct ReprocessConfig {
+    std::string directory{"."};                  ///< LogWriterConfig::directory of the recording
+    std::string prefix{"commrat"};               ///< LogWriterConfig::prefix of the recording
+    uint64_t start_ns{0};                        ///< First receive time processed (0 = beginning)
+    uint64_t end_ns{0};                          ///< Receive time limit, exclusive (0 = end)
+    std::chrono::milliseconds chunk{60000};      ///< Timeline partition per work item
+    std::chrono::milliseconds warmup{5000};      ///< Input fed before each chunk, outputs discarded
+    std::size_t threads{0};                      ///< Worker threads (0 = hardware concurrency)
+    std::optional<LogWriterConfig> output;       ///< Write merged outputs as a recording
+};
+
+/**
+ * @brief Reprocessing counters
+ */
+struct ReprocessStats {
+    uint64_t chunks{0};
+    uint64_t records{0};          ///< Input records fed inside their chunk
+    uint64_t warmup_records{0};   ///< Input records fed as warm-up (fed twice overall)
+    uint64_t processed{0};        ///< process() calls inside chunks
+    uint64_t outputs{0};          ///< Output messages merged
+    uint64_t recorded_ns{0};      ///< Receive time span processed
+    uint64_t elapsed_ns{0};       ///< Wall time of run()
+};
+
+/**
+ * @brief One reprocessed output, in merge order
+ */
+struct ReprocessedMessage {
+    uint64_t timestamp;              ///< Header timestamp (merge key)
+    uint64_t receive_ns;             ///< Receive time of the input that produced it
+    uint32_t message_id;
+    std::size_t output_index;        ///< Index in the module's Outputs<...>
+    std::span<const std::byte> wire; ///< Serialized TimsMessage (App::visit)
+};
+
+/**
+ * @brief Runs a recording through ModuleT::process() on all cores
+ *
+ * @tparam App CommRaT application the recording and module use
+ * @tparam ModuleT Module with Input<T> or Inputs<...>
+ *
+ * Example:
+ * @code
+ * Reprocessor<MyApp, TrackFilter> batch(filter_config, ReprocessConfig{
+ *     .directory = "/data/run_042", .prefix = "run_042",
+ *     .chunk = Milliseconds(60000), .warmup = Milliseconds(5000),
+ *     .output = LogWriterConfig{.directory = "/data/run_042_v2", .prefix = "tracks"}
+ * });
+ * auto stats = batch.run();
+ * @endcode
+ */
+template<typename App, typename ModuleT>
+class Reprocessor {
+    using InputTypes = typename ModuleT::InputTypes;
+    using OutputTypes = typename ModuleT::OutputTypes;
+    static constexpr std::size_t input_count = std::tuple_size_v<InputTypes>;
+    static constexpr std::size_t output_count = std::tuple_size_v<OutputTypes>;
+    static_assert(input_count > 0, "Reprocessor needs a module with Input<T> or Inputs<...>");
+
+    static constexpr int no_input = -1;
+
+public:
+    using Factory = std::function<std::unique_ptr<ModuleT>(const ModuleConfig&)>;
+    using OutputCallback = std::function<void(const ReprocessedMessage&)>;
+
+    /**
+     * Opens the recording and maps its streams to the module's inputs.
+     * Throws std::runtime_error if there are no segments or no stream
+     * matches any input, std::invalid_argument for a zero chunk or an input
+     * configuration that does not fit ModuleT.
+     *
+     * @param module_config Configuration of every module instance (never started)
+     * @param factory Creates an instance; default: std::make_unique<ModuleT>(config)
+     */
+    Reprocessor(const ModuleConfig& module_config, const ReprocessConfig& config, Factory factory = {})
+        : module_config_(module_config)
+        , config_(config)
+        , factory_(factory ? std::move(factory) : Factory([](const ModuleConfig& c) {
+              return std::make_unique<ModuleT>(c);
+          }))
+        , segments_(list_log_segments(config.directory, config.prefix)) {
+        if (config_.chunk.count() <= 0) {
+            throw std::invalid_argument("[Reprocessor] chunk must be positive");
+        }
+        if (segments_.empty()) {
+            throw std::runtime_error("[Reprocessor] No segments '" + config_.prefix + "' in " + config_.directory);
+        }
+
+        LogSegmentReader first(segments_.front());
+        const auto sources = input_sources();
+        std::vector<bool> matched(input_count, false);
+        for (const auto& stream : first.streams()) {
+            int input = no_input;
+            for (std::size_t i = 0; i < input_count; ++i) {
+                if (stream.message_id == input_message_ids_[i] &&
+                    stream.system_id == sources[i].first && stream.instance_id == sources[i].second) {
+                    input = static_cast<int>(i);
+                    matched[i] = true;
+                    break;
+                }
+            }
+            if (stream.stream_id >= stream_inputs_.size()) {
+                stream_inputs_.resize(stream.stream_id + 1, no_input);
+            }
+            stream_inputs_[stream.stream_id] = input;
+        }
+        if (std::none_of(matched.begin(), matched.end(), [](bool m) { return m; })) {
+            throw std::runtime_error("[Reprocessor] No stream in the recording matches an input of " +
+                                     module_config_.name);
+        }
+        for (std::size_t i = 0; i < input_count; ++i) {
+            if (!matched[i]) {
+                std::cerr << "[Reprocessor] No stream for input " << i << " of " << module_config_.name << "\n";
+            }
+        }
+    }
+
+    Reprocessor(const Reprocessor&) = delete;
+    Reprocessor& operator=(const Reprocessor&) = delete;
+
+    /**
+     * @brief Process the recording and merge the outputs
+     *
+     * @param on_output Called for every output in timestamp order (after all chunks ran)
+     * @return Counters; rethrows the first exception of a worker
+     */
+    ReprocessStats run(const OutputCallback& on_output = {}) {
+        const auto wall_start = std::chrono::steady_clock::now();
+        ReprocessStats stats;
+
+        const auto first = LogSegmentReader(segments_.front()).first_receive_ns();
+        const auto last = last_receive_ns();
+        if (!first || !last) {
+            return stats;
+        }
+        const uint64_t begin = std::max(config_.start_ns, *first);
+        const uint64_t end = config_.end_ns != 0 ? std::min(config_.end_ns, *last + 1) : *last + 1;
+        if (begin >= end) {
+            return stats;
+        }
+        const uint64_t chunk_ns = Time::to_nanoseconds(config_.chunk);
+        const std::size_t chunk_count = static_cast<std::size_t>((end - begin + chunk_ns - 1) / chunk_ns);
+
+        chunks_.clear();
+        chunks_.resize(chunk_count);
+        for (std::size_t k = 0; k < chunk_count; ++k) {
+            chunks_[k].begin = begin + k * chunk_ns;
+            chunks_[k].end = std::min(end, chunks_[k].begin + chunk_ns);
+            chunks_[k].warmup_begin = chunks_[k].begin - std::min(chunks_[k].begin - *first,
+                                                                  Time::to_nanoseconds(config_.warmup));
+        }
+
+        next_chunk_ = 0;
+        error_flag_ = false;
+        error_ = nullptr;
+        std::size_t thread_count = config_.threads != 0 ? config_.threads
+                                                        : std::max(1u, std::thread::hardware_concurrency());
+        thread_count = std::min(thread_count, chunk_count);
+        {
+            std::vector<std::unique_ptr<Thread>> workers;
+            for (std::size_t t = 0; t < thread_count; ++t) {
+                workers.push_back(std::make_unique<Thread>(
+                    ThreadConfig{.name = "reprocess/" + std::to_string(t)}, [this]() { worker_loop(); }));
+            }
+            for (auto& worker : workers) {
+                worker->join();
+            }
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        for (const auto& chunk : chunks_) {
+            stats.records += chunk.records;
+            stats.warmup_records += chunk.warmup_records;
+            stats.processed += chunk.processed;
+        }
+        stats.chunks = chunk_count;
+        stats.outputs = merge(on_output);
+        stats.recorded_ns = end - begin;
+        stats.elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wall_start).count());
+        chunks_.clear();
+        return stats;
+    }
+
+private:
+    /// Serialized output of a chunk
+    struct Output {
+        uint64_t timestamp;
+        uint64_t receive_ns;
+        uint32_t message_id;
+        uint32_t output_index;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct Chunk {
+        uint64_t warmup_begin{0};
+        uint64_t begin{0};
+        uint64_t end{0};
+        std::vector<Output> outputs;
+        std::vector<std::byte> bytes;
+        uint64_t records{0};
+        uint64_t warmup_records{0};
+        uint64_t processed{0};
+    };
+
+    template<std::size_t... Is>
+    static constexpr std::array<uint32_t, input_count> make_input_ids(std::index_sequence<Is...>) {
+        return {App::template get_message_id<std::tuple_element_t<Is, InputTypes>>()...};
+    }
+    static constexpr std::array<uint32_t, input_count> input_message_ids_ =
+        make_input_ids(std::make_index_sequence<input_count>{});
+
+    template<std::size_t... Is>
+    static constexpr std::array<uint32_t, output_count> make_output_ids(std::index_sequence<Is...>) {
+        return {App::template get_message_id<std::tuple_element_t<Is, OutputTypes>>()...};
+    }
+    static constexpr std::array<uint32_t, output_count> output_message_ids_ =
+        make_output_ids(std::make_index_sequence<output_count>{});
+
+    /// (system, instance) of the configured source of every input
+    std::vector<std::pair<uint8_t, uint8_t>> input_sources() const {
+        std::vector<std::pair<uint8_t, uint8_t>> sources;
+        if (module_config_.has_multi_input_config()) {
+            for (const auto& source : module_config_.input_sources()) {
+                sources.emplace_back(source.system_id, source.instance_id);
+            }
+        } else if (module_config_.has_single_input()) {
+            sources.emplace_back(module_config_.source_system_id(), module_config_.source_instance_id());
+        }
+        if (sources.size() != input_count) {
+            throw std::invalid_argument("[Reprocessor] Input configuration of " + module_config_.name +
+                                        " does not match its inputs");
+        }
+        return sources;
+    }
+
+    std::optional<uint64_t> last_receive_ns() const {
+        for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+            LogSegmentReader reader(*it);
+            if (!reader.index().empty()) {
+                reader.seek_time(reader.index().back().receive_ns);
+            }
+            std::optional<uint64_t> last;
+            while (auto record = reader.next()) {
+                last = record->receive_ns;
+            }
+            if (last) {
+                return last;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /// Last segment whose first record was received before receive_ns
+    std::size_t find_segment(uint64_t receive_ns) const {
+        std::size_t lo = 0;
+        std::size_t hi = segments_.size();
+        while (hi - lo > 1) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            auto first = LogSegmentReader(segments_[mid]).first_receive_ns();
+            if (first && *first < receive_ns) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // ========================================================================
+    // Workers
+    // ========================================================================
+
+    void worker_loop() {
+        VirtualTimeScope clock;
+        while (!error_flag_.load(std::memory_order_relaxed)) {
+            const std::size_t index = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+            if (index >= chunks_.size()) {
+                return;
+            }
+            try {
+                process_chunk(chunks_[index], clock);
+            } catch (...) {
+                Lock lock(error_mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                error_flag_.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    void process_chunk(Chunk& chunk, VirtualTimeScope& clock) {
+        std::unique_ptr<ModuleT> module = factory_(module_config_);
+        bool in_chunk = false;
+
+        auto emit = [&](std::size_t output_index, auto& tims_msg) {
+            if (!in_chunk) {
+                return;
+            }
+            auto result = App::serialize(tims_msg);
+            const auto wire = result.view();
+            chunk.outputs.push_back(Output{
+                .timestamp = tims_msg.header.timestamp,
+                .receive_ns = Time::now(),
+                .message_id = tims_msg.header.msg_type,
+                .output_index = static_cast<uint32_t>(output_index),
+                .offset = chunk.bytes.size(),
+                .size = wire.size()
+            });
+            chunk.bytes.insert(chunk.bytes.end(), wire.begin(), wire.end());
+        };
+
+        for (std::size_t s = find_segment(chunk.warmup_begin); s < segments_.size(); ++s) {
+            LogSegmentReader reader(segments_[s]);
+            if (!reader.seek_time(chunk.warmup_begin)) {
+                continue;
+            }
+            while (auto record = reader.next()) {
+                if (record->receive_ns >= chunk.end) {
+                    return;
+                }
+                const int input = record->stream_id < stream_inputs_.size()
+                    ? stream_inputs_[record->stream_id] : no_input;
+                if (input == no_input) {
+                    continue;
+                }
+                in_chunk = record->receive_ns >= chunk.begin;
+                (in_chunk ? chunk.records : chunk.warmup_records)++;
+                clock.set(record->receive_ns);
+
+                App::visit(record->header().msg_type, record->wire, [&](auto& tims_msg) {
+                    if (feed(*module, static_cast<std::size_t>(input), tims_msg, emit,
+                             std::make_index_sequence<input_count>{}) && in_chunk) {
+                        ++chunk.processed;
+                    }
+                });
+            }
+        }
+    }
+
+    /// Runtime input index -> process_offline<Index>() for the matching payload type
+    template<typename Msg, typename Emit, std::size_t... Is>
+    static bool feed(ModuleT& module, std::size_t input, const Msg& tims_msg, Emit& emit,
+                     std::index_sequence<Is...>) {
+        using Payload = std::decay_t<decltype(tims_msg.payload)>;
+        bool processed = false;
+        ((void)[&] {
+            if constexpr (std::is_same_v<Payload, std::tuple_element_t<Is, InputTypes>>) {
+                if (input == Is) {
+                    processed = module.template process_offline<Is>(tims_msg, emit);
+                }
+            }
+        }(), ...);
+        return processed;
+    }
+
+    // ========================================================================
+    // Merge
+    // ========================================================================
+
+    /// k-way merge of the chunks by header timestamp (ties: earlier chunk first)
+    uint64_t merge(const OutputCallback& on_output) {
+        std::unique_ptr<MmapLogWriter> writer;
+        if (config_.output) {
+            std::vector<LogStreamInfo> streams;
+            for (std::size_t i = 0; i < output_count; ++i) {
+                const bool multi = module_config_.has_multi_output_config();
+                LogStreamInfo info{
+                    .message_id = output_message_ids_[i],
+                    .stream_id = static_cast<uint16_t>(i),
+                    .system_id = multi ? module_config_.system_id(i) : module_config_.system_id(),
+                    .instance_id = multi ? module_config_.instance_id(i) : module_config_.instance_id(),
+                    .name = {}
+                };
+                const std::string label = module_config_.name.substr(0, sizeof(info.name) - 1);
+                std::memcpy(info.name, label.data(), label.size());
+                streams.push_back(info);
+            }
+            writer = std::make_unique<MmapLogWriter>(*config_.output, streams, App::Introspection::export_all());
+        }
+
+        for (auto& chunk : chunks_) {
+            std::stable_sort(chunk.outputs.begin(), chunk.outputs.end(),
+                             [](const Output& a, const Output& b) { return a.timestamp < b.timestamp; });
+        }
+
+        using Cursor = std::pair<std::size_t, std::size_t>;  // (chunk, position)
+        auto later = [this](const Cursor& a, const Cursor& b) {
+            const uint64_t ta = chunks_[a.first].outputs[a.second].timestamp;
+            const uint64_t tb = chunks_[b.first].outputs[b.second].timestamp;
+            return ta != tb ? ta > tb : a.first > b.first;
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heads(later);
+        for (std::size_t k = 0; k < chunks_.size(); ++k) {
+            if (!chunks_[k].outputs.empty()) {
+                heads.emplace(k, 0);
+            }
+        }
+
+        uint64_t merged = 0;
+        while (!heads.empty()) {
+            const auto [k, pos] = heads.top();
+            heads.pop();
+            const Chunk& chunk = chunks_[k];
+            const Output& out = chunk.outputs[pos];
+            const std::span<const std::byte> wire(chunk.bytes.data() + out.offset, out.size);
+
+            if (writer) {
+                writer->append(static_cast<uint16_t>(out.output_index), out.receive_ns, wire);
+            }
+            if (on_output) {
+                on_output(ReprocessedMessage{
+                    .timestamp = out.timestamp,
+                    .receive_ns = out.receive_ns,
+                    .message_id = out.message_id,
+                    .output_index = out.output_index,
+                    .wire = wire
+                });
+            }
+            ++merged;
+            if (pos + 1 < chunk.outputs.size()) {
+                heads.emplace(k, pos + 1);
+            }
+        }
+        if (writer) {
+            writer->close();
+        }
+        return merged;
+    }
+
+    ModuleConfig module_config_;
+    ReprocessConfig config_;
+    Factory factory_;
+    std::vector<std::string> segments_;
+    std::vector<int> stream_inputs_;   // Stream ID -> input index (no_input = not fed)
+
+    std::vector<Chunk> chunks_;        // One writer thread per chunk during run()
+    std::atomic<std::size_t> next_chunk_{0};
+    std::atomic<bool> error_flag_{false};
+    Mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+} // namespace commrat
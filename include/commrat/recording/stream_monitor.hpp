@@ -0,0 +1,446 @@
+/**
+ * @file stream_monitor.hpp
+ * @brief Live rate, jitter, bandwidth, data age and gap statistics of streams
+ *
+ * StreamMonitor subscribes to any set of (message ID, producer) streams with
+ * the regular subscription protocol and derives its statistics from the
+ * TimsHeader alone - payloads are never deserialized, so it needs no
+ * registry and works with message IDs taken from an exported schema.
+ *
+ * Everything runs on the caller's thread: poll() drains every stream's DATA
+ * mailbox without blocking, run_for() alternates poll() with a short idle
+ * sleep. Receive times are taken when a mailbox is drained, so inter-arrival
+ * intervals have a resolution of about StreamMonitorConfig::idle_sleep.
+ *
+ * Per stream and report window:
+ * - rate and inter-arrival jitter (standard deviation of the intervals)
+ * - bandwidth (wire bytes per second)
+ * - data age: receive time - header.timestamp (same clock on one host)
+ * - sequence gaps: header.seq_number of 0 means "not sequenced"; otherwise
+ *   classified by a SequenceTracker, as for module inputs in StatsReply:
+ *   skipped numbers count as lost, duplicates, late arrivals and publisher
+ *   restarts (a 1, or far behind) as late
+ *
+ * Addressing: base address encode_address(MONITOR_TYPE_ID, system_id,
+ * instance_id, 0), WORK mailbox at base + MailboxType::WORK (subscribe
+ * replies) and one DATA mailbox per stream at base | (MailboxType::DATA + index).
+ */
+
+#pragma once
+
+#include "commrat/mailbox/registry_mailbox.hpp"
+#include "commrat/messaging/system/system_registry.hpp"
+#include "commrat/module/module_config.hpp"
+#include "commrat/module/helpers/address_helpers.hpp"
+#include "commrat/module/metrics/module_metrics.hpp"
+#include "commrat/platform/timestamp.hpp"
+#include "commrat/platform/tims_wrapper.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace commrat {
+
+/// Type byte of monitor base addresses (see RECORDER_TYPE_ID, REPLAY_TYPE_ID)
+inline constexpr uint8_t MONITOR_TYPE_ID = 0xFC;
+
+/// DATA mailbox indices run from MailboxType::DATA to 0xFF
+inline constexpr std::size_t MONITOR_MAX_STREAMS = 0x100 - static_cast<std::size_t>(MailboxType::DATA);
+
+/**
+ * @brief Monitor configuration
+ */
+struct StreamMonitorConfig {
+    std::string name{"monitor"};
+    uint8_t system_id{0};
+    uint8_t instance_id{0};
+    std::size_t mailbox_slots{256};                  ///< Receive queue depth per stream
+    std::size_t max_message_size{64 * 1024};         ///< Default receive buffer per stream
+    Microseconds idle_sleep{200};                    ///< run_for() sleep when no stream had data
+};
+
+/**
+ * @brief Statistics of one stream over one report window
+ *
+ * Durations are nanoseconds. The first interval of a window starts at the
+ * previous window's last message. Interval and age fields are 0 without
+ * messages in the window.
+ */
+struct StreamStats {
+    std::string label;
+    uint32_t message_id{0};
+    uint8_t system_id{0};
+    uint8_t instance_id{0};
+
+    double window_s{0.0};           ///< Length of the report window
+    uint64_t messages{0};
+    uint64_t bytes{0};              ///< Wire bytes, header included
+    double rate_hz{0.0};
+    double bandwidth{0.0};          ///< Bytes per second
+    double mean_interval_ns{0.0};
+    double jitter_ns{0.0};          ///< Standard deviation of the inter-arrival intervals
+    uint64_t min_interval_ns{0};
+    uint64_t max_interval_ns{0};
+    double mean_age_ns{0.0};
+    int64_t max_age_ns{0};
+    uint64_t lost{0};               ///< Sequence numbers skipped (some may still arrive late)
+    uint64_t late{0};               ///< Duplicated, reordered or restarted sequence numbers
+
+    uint64_t total_messages{0};     ///< Since start()
+    uint64_t total_lost{0};         ///< Skipped and never received, as StatsReply's lost
+    Timestamp last_receive{0};      ///< Time::now() of the last message, 0 = none yet
+};
+
+/**
+ * @brief Header-only statistics of subscribed streams, single-threaded
+ *
+ * Example:
+ * @code
+ * StreamMonitor monitor(StreamMonitorConfig{.system_id = 0, .instance_id = 7});
+ * monitor.add(MyApp::get_message_id<ImuData>(), 10, 1, "imu");
+ * monitor.add(MyApp::get_message_id<GpsData>(), 11, 1, "gps");
+ * monitor.start();
+ * for (;;) {
+ *     monitor.run_for(Milliseconds(1000));
+ *     StreamMonitor::print(monitor.report(), stdout);
+ * }
+ * @endcode
+ */
+class StreamMonitor {
+    using WorkMailbox = RegistryMailbox<SystemRegistry>;
+
+public:
+    explicit StreamMonitor(const StreamMonitorConfig& config)
+        : config_(config)
+        , base_address_(encode_address(MONITOR_TYPE_ID, config.system_id, config.instance_id, 0)) {}
+
+    ~StreamMonitor() {
+        stop();
+    }
+
+    StreamMonitor(const StreamMonitor&) = delete;
+    StreamMonitor& operator=(const StreamMonitor&) = delete;
+
+    /**
+     * @brief Add a stream to monitor (before start())
+     *
+     * @param message_id Message ID of the producer's output type
+     * @param source_system_id Producer system ID
+     * @param source_instance_id Producer instance ID
+     * @param label Name used in reports
+     * @param max_message_size Receive buffer, 0 = StreamMonitorConfig::max_message_size
+     * @return Stream index (order of the report)
+     */
+    std::size_t add(uint32_t message_id, uint8_t source_system_id, uint8_t source_instance_id,
+                    std::string_view label = {}, std::size_t max_message_size = 0) {
+        if (started_) {
+            throw std::logic_error("[StreamMonitor] add() must be called before start()");
+        }
+        if (streams_.size() >= MONITOR_MAX_STREAMS) {
+            throw std::runtime_error("[StreamMonitor] Too many streams");
+        }
+        auto stream = std::make_unique<Stream>();
+        stream->message_id = message_id;
+        stream->system_id = source_system_id;
+        stream->instance_id = source_instance_id;
+        stream->label = label.empty() ? default_label(message_id, source_system_id, source_instance_id)
+                                      : std::string(label);
+        stream->buffer.resize(std::max(max_message_size ? max_message_size : config_.max_message_size,
+                                       sizeof(TimsHeader)));
+        streams_.push_back(std::move(stream));
+        return streams_.size() - 1;
+    }
+
+    /**
+     * @brief Create the mailboxes and subscribe to all streams
+     *
+     * Throws std::runtime_error if a mailbox cannot be created.
+     */
+    void start() {
+        if (started_) {
+            return;
+        }
+
+        work_mailbox_.emplace(MailboxConfig{
+            .mailbox_id = base_address_ + static_cast<uint8_t>(MailboxType::WORK),
+            .message_slots = std::max<std::size_t>(10, streams_.size() * 2),
+            .max_message_size = SystemRegistry::max_message_size,
+            .mailbox_name = config_.name + "_work"
+        });
+        if (!work_mailbox_->start()) {
+            throw std::runtime_error("[StreamMonitor] Failed to start WORK mailbox for " + config_.name);
+        }
+
+        for (std::size_t i = 0; i < streams_.size(); ++i) {
+            Stream& stream = *streams_[i];
+            TimsConfig tims;
+            tims.mailbox_id = base_address_ | (static_cast<uint32_t>(MailboxType::DATA) + static_cast<uint32_t>(i));
+            tims.mailbox_name = config_.name + "_data_" + std::to_string(i);
+            tims.max_msg_size = stream.buffer.size();
+            tims.message_slots = config_.mailbox_slots;
+            stream.mailbox = std::make_unique<TimsWrapper>(tims);
+            if (stream.mailbox->initialize() != TimsResult::SUCCESS) {
+                throw std::runtime_error("[StreamMonitor] Failed to start DATA mailbox " +
+                                         std::to_string(i) + " for " + config_.name);
+            }
+        }
+
+        started_ = true;
+        window_start_ = Time::now();
+        for (std::size_t i = 0; i < streams_.size(); ++i) {
+            subscribe(i);
+        }
+    }
+
+    /**
+     * @brief Drain every stream's mailbox once, without blocking
+     * @return Messages received
+     */
+    std::size_t poll() {
+        if (!started_) {
+            return 0;
+        }
+        std::size_t received = 0;
+        for (auto& stream : streams_) {
+            for (;;) {
+                const ssize_t bytes = stream->mailbox->receive_raw_bytes(stream->buffer, Milliseconds(-1));
+                if (bytes <= 0) {
+                    break;
+                }
+                if (static_cast<std::size_t>(bytes) >= sizeof(TimsHeader)) {
+                    TimsHeader header;
+                    std::memcpy(&header, stream->buffer.data(), sizeof(header));
+                    stream->on_message(header, static_cast<std::size_t>(bytes), Time::now());
+                    ++received;
+                }
+            }
+        }
+        while (work_mailbox_->try_receive_any([this](auto&& msg) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(msg.payload)>, SubscribeReplyPayload>) {
+                acknowledged_ += msg.payload.success ? 1 : 0;
+            }
+        })) {
+        }
+        return received;
+    }
+
+    /**
+     * @brief Poll until `duration` has elapsed, sleeping idle_sleep when nothing arrived
+     */
+    void run_for(Milliseconds duration) {
+        const auto deadline = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (poll() == 0) {
+                std::this_thread::sleep_for(config_.idle_sleep);
+            }
+        }
+    }
+
+    /**
+     * @brief Statistics since the previous report() (or start()); starts a new window
+     */
+    std::vector<StreamStats> report() {
+        const Timestamp now = Time::now();
+        const double window_s = static_cast<double>(now - window_start_) * 1e-9;
+        window_start_ = now;
+
+        std::vector<StreamStats> result;
+        result.reserve(streams_.size());
+        for (auto& stream : streams_) {
+            result.push_back(stream->take(window_s));
+        }
+        return result;
+    }
+
+    /// Producers that acknowledged their subscription so far (replies are read by poll())
+    std::size_t acknowledged() const { return acknowledged_; }
+
+    std::size_t stream_count() const { return streams_.size(); }
+
+    /// Base address used as subscriber address towards producers
+    uint32_t base_address() const { return base_address_; }
+
+    /**
+     * @brief Unsubscribe from all streams and close the mailboxes
+     */
+    void stop() {
+        if (!started_) {
+            return;
+        }
+        started_ = false;
+        for (auto& stream : streams_) {
+            UnsubscribeRequestPayload request{.subscriber_base_addr = base_address_};
+            work_mailbox_->send(request, source_work_mailbox(*stream));
+        }
+        for (auto& stream : streams_) {
+            stream->mailbox.reset();
+        }
+        work_mailbox_.reset();
+        acknowledged_ = 0;
+    }
+
+    /**
+     * @brief Print one line per stream (rate, jitter, bandwidth, age, gaps)
+     */
+    static void print(const std::vector<StreamStats>& stats, std::FILE* out) {
+        std::fprintf(out, "%-24s %10s %10s %10s %10s %10s %10s %8s %8s\n",
+                     "stream", "rate[Hz]", "jitter[ms]", "min[ms]", "max[ms]", "bw[KiB/s]",
+                     "age[ms]", "lost", "late");
+        for (const auto& s : stats) {
+            std::fprintf(out, "%-24.24s %10.2f %10.3f %10.3f %10.3f %10.2f %10.3f %8llu %8llu\n",
+                         s.label.c_str(), s.rate_hz, s.jitter_ns * 1e-6,
+                         static_cast<double>(s.min_interval_ns) * 1e-6,
+                         static_cast<double>(s.max_interval_ns) * 1e-6,
+                         s.bandwidth / 1024.0, s.mean_age_ns * 1e-6,
+                         static_cast<unsigned long long>(s.lost), static_cast<unsigned long long>(s.late));
+        }
+        std::fflush(out);
+    }
+
+private:
+    struct Stream {
+        std::string label;
+        uint32_t message_id{0};
+        uint8_t system_id{0};
+        uint8_t instance_id{0};
+        std::unique_ptr<TimsWrapper> mailbox;
+        std::vector<std::byte> buffer;
+
+        // Current window
+        uint64_t messages{0};
+        uint64_t bytes{0};
+        uint64_t intervals{0};
+        double interval_sum{0.0};
+        double interval_sum_sq{0.0};
+        uint64_t min_interval{std::numeric_limits<uint64_t>::max()};
+        uint64_t max_interval{0};
+        double age_sum{0.0};
+        int64_t max_age{std::numeric_limits<int64_t>::min()};
+        uint64_t lost{0};
+        uint64_t late{0};
+
+        // Across windows
+        Timestamp last_receive{0};
+        SequenceTracker sequence;
+        uint64_t total_messages{0};
+
+        void on_message(const TimsHeader& header, std::size_t size, Timestamp now) {
+            ++messages;
+            bytes += size;
+            if (last_receive != 0) {
+                const uint64_t interval = now - last_receive;
+                ++intervals;
+                interval_sum += static_cast<double>(interval);
+                interval_sum_sq += static_cast<double>(interval) * static_cast<double>(interval);
+                min_interval = std::min(min_interval, interval);
+                max_interval = std::max(max_interval, interval);
+            }
+            last_receive = now;
+
+            const int64_t age = static_cast<int64_t>(now - header.timestamp);
+            age_sum += static_cast<double>(age);
+            max_age = std::max(max_age, age);
+
+            const uint64_t lost_before = sequence.lost();
+            switch (sequence.record(header.seq_number)) {
+                case SequenceTracker::Result::Gap:
+                    lost += sequence.lost() - lost_before;
+                    break;
+                case SequenceTracker::Result::Duplicate:
+                case SequenceTracker::Result::Reordered:
+                case SequenceTracker::Result::Restart:
+                    ++late;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        StreamStats take(double window_s) {
+            StreamStats s{
+                .label = label,
+                .message_id = message_id,
+                .system_id = system_id,
+                .instance_id = instance_id,
+                .window_s = window_s,
+                .messages = messages,
+                .bytes = bytes,
+                .rate_hz = window_s > 0.0 ? static_cast<double>(messages) / window_s : 0.0,
+                .bandwidth = window_s > 0.0 ? static_cast<double>(bytes) / window_s : 0.0,
+                .mean_interval_ns = 0.0,
+                .jitter_ns = 0.0,
+                .min_interval_ns = 0,
+                .max_interval_ns = 0,
+                .mean_age_ns = messages ? age_sum / static_cast<double>(messages) : 0.0,
+                .max_age_ns = messages ? max_age : 0,
+                .lost = lost,
+                .late = late,
+                .total_messages = total_messages + messages,
+                .total_lost = sequence.lost(),
+                .last_receive = last_receive
+            };
+            if (intervals > 0) {
+                const double n = static_cast<double>(intervals);
+                s.mean_interval_ns = interval_sum / n;
+                s.jitter_ns = std::sqrt(std::max(0.0, interval_sum_sq / n - s.mean_interval_ns * s.mean_interval_ns));
+                s.min_interval_ns = min_interval;
+                s.max_interval_ns = max_interval;
+            }
+
+            total_messages += messages;
+            messages = bytes = intervals = lost = late = 0;
+            interval_sum = interval_sum_sq = age_sum = 0.0;
+            min_interval = std::numeric_limits<uint64_t>::max();
+            max_interval = 0;
+            max_age = std::numeric_limits<int64_t>::min();
+            return s;
+        }
+    };
+
+    static std::string default_label(uint32_t message_id, uint8_t system_id, uint8_t instance_id) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "0x%08x@%u.%u", message_id, system_id, instance_id);
+        return label;
+    }
+
+    /// Producer's WORK mailbox of the stream
+    static uint32_t source_work_mailbox(const Stream& stream) {
+        return producer_work_mailbox(stream.message_id, stream.system_id, stream.instance_id);
+    }
+
+    void subscribe(std::size_t index) {
+        const Stream& stream = *streams_[index];
+        SubscribeRequestPayload request{
+            .subscriber_base_addr = base_address_,
+            .mailbox_index = static_cast<uint8_t>(static_cast<uint32_t>(MailboxType::DATA) + index),
+            .requested_period_ms = 0
+        };
+        const uint32_t dest = source_work_mailbox(stream);
+        if (send_subscribe_request(*work_mailbox_, request, dest)) {
+            return;
+        }
+        std::cerr << "[" << config_.name << "] Failed to subscribe " << stream.label
+                  << " (WORK mailbox 0x" << std::hex << dest << std::dec << ")\n";
+    }
+
+    StreamMonitorConfig config_;
+    uint32_t base_address_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::optional<WorkMailbox> work_mailbox_;
+    bool started_{false};
+    Timestamp window_start_{0};
+    std::size_t acknowledged_{0};
+};
+
+} // namespace commrat
@@ -10,6 +10,8 @@
 #include "commrat/messaging/system/system_registry.hpp"
 #include "commrat/platform/threading.hpp"
 #include "commrat/platform/timestamp.hpp"
+#include "commrat/platform/tracing.hpp"
+#include "commrat/recording/flight_recorder.hpp"
 
 // Module aggregator headers (reduce visual clutter)
 #include "commrat/module/module_core.hpp"      // I/O specs, traits, config
@@ -112,7 +114,7 @@ class Module
     , public MultiOutputManager<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, typename OutputTypesTuple<typename NormalizeOutput<OutputSpec_>::Type>::type>
     , public LoopExecutor<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>>
     , public InputMetadataAccessors<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>>
-    , public CommandDispatcher<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, CommandTypes...>
+    , public CommandDispatcher<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, CommandTypes...>
     
     // ========================================================================
     // Multi-Input Support (conditional - only when Inputs<T,U,V> specified)
@@ -140,7 +142,7 @@ class Module
     friend class LoopExecutor<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>>;
     friend class MultiOutputManager<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, typename OutputTypesTuple<typename NormalizeOutput<OutputSpec_>::Type>::type>;
     friend class InputMetadataAccessors<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>>;
-    friend class CommandDispatcher<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, CommandTypes...>;
+    friend class CommandDispatcher<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, CommandTypes...>;
     friend class MultiInputInfrastructure<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, typename module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::InputTypesTuple, module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::InputCount>;
     friend class MultiInputProcessor<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, typename module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::InputTypesTuple, typename module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::OutputData, typename module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::OutputTypesTuple, module_traits::ModuleTypes<UserRegistry, OutputSpec_, InputSpec_>::InputCount>;
     friend class LifecycleManager<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>>;
@@ -203,6 +205,10 @@ public:
     using OutputData = typename ModuleTypes::OutputData;
     using InputData = typename ModuleTypes::InputData;
     
+    // Payload type per input / output index (empty InputTypes for PeriodicInput/LoopInput)
+    using InputTypes = InputTypesTuple;
+    using OutputTypes = OutputTypesTuple;
+    
     // Input mode flags
     static constexpr bool has_continuous_input = ModuleTypes::has_continuous_input;
     static constexpr bool has_periodic_input = ModuleTypes::has_periodic_input;
@@ -281,12 +287,20 @@ protected:
         UserRegistry, 
         OutputData, 
         PublishMailbox,
-        Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>  // Module type for get_publish_mailbox<Index>()
+        Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>,  // Module type for get_publish_mailbox<Index>()
+        num_output_types
     >;
     PublisherType publisher_;
     
     std::atomic<bool> running_;
     
+    // Runtime metrics (recorded by the module threads, served via StatsRequest)
+    using MetricsType = ModuleMetrics<InputCount, num_output_types>;
+    MetricsType metrics_;
+    
+    // Span name of this module in exported traces (Tracer::register_name)
+    uint16_t trace_name_id_;
+    
     // Module threads
     std::optional<std::thread> data_thread_;       // Periodic/loop/continuous/multi-input processing
     std::optional<std::thread> command_thread_;     // User commands on CMD mailbox
@@ -337,12 +351,14 @@ public:
     explicit Module(const ModuleConfig& config)
         : config_(config)
         , mailbox_infrastructure_{}  // Default construct, will initialize in body
+        // Data mailbox at get_data_mbx_base(num_outputs), the index the
+        // SubscribeRequest names (SubscriptionProtocol, test_module_data_path)
         , data_mailbox_(has_continuous_input && !has_multi_input ? 
             std::make_optional<DataMailbox>(MailboxConfig{
                 .mailbox_id = commrat::get_mailbox_address<OutputData, OutputTypesTuple, UserRegistry>(
                     config.has_multi_output_config() ? config.system_id(0) : config.system_id(),
                     config.has_multi_output_config() ? config.instance_id(0) : config.instance_id(),
-                    static_cast<uint8_t>(MailboxType::DATA)),
+                    get_data_mbx_base(static_cast<uint8_t>(std::tuple_size_v<OutputTypesTuple>))),
                 .message_slots = config.message_slots,
                 .max_message_size = UserRegistry::max_message_size,
                 .send_priority = static_cast<uint8_t>(config.priority),
@@ -351,6 +367,7 @@ public:
             }) : 
             std::nullopt)
         , running_(false)
+        , trace_name_id_(Tracer::register_name(config.name))
     {
         // Initialize mailbox infrastructure in place
         initialize_mailbox_infrastructure_impl(config, std::make_index_sequence<num_output_types>{});
@@ -364,7 +381,7 @@ public:
         subscription_protocol_.set_module_name(config.name);
         
         // Initialize publisher (post-unification: uses module_ptr_ for mailboxes and subscribers)
-        // REMOVED: set_subscriber_manager() - subscribers accessed via module_ptr_->get_output_subscribers()
+        // REMOVED: set_subscriber_manager() - subscribers accessed via module_ptr_->for_each_output_subscriber()
         publisher_.set_module_ptr(this);  // For mailbox/subscriber access via module_ptr_
         publisher_.set_module_name(config.name);
         
@@ -495,6 +512,110 @@ public:
         this->MultiOutputManager<Module<UserRegistry, OutputSpec_, InputSpec_, CommandTypes...>, UserRegistry, OutputTypesTuple>::remove_subscriber(subscriber_base_addr);
     }
     
+    // ========================================================================
+    // Runtime Metrics
+    // ========================================================================
+    
+    /**
+     * @brief Runtime metrics recorded by the module threads
+     * 
+     * PUBLIC: Written by Publisher (send results), read by tooling/tests.
+     */
+    MetricsType& metrics() { return metrics_; }
+    const MetricsType& metrics() const { return metrics_; }
+    
+    /**
+     * @brief Snapshot of all runtime statistics (same data as StatsReply)
+     * 
+     * Safe to call from any thread while the module runs.
+     */
+    StatsReplyPayload collect_stats() const {
+        StatsReplyPayload stats;
+        stats.module_name = sertial::fixed_string<64>(config_.name.c_str());
+        metrics_.fill_stats(stats, Time::now());
+        stats.dropped_commands = this->dropped_commands();
+        
+        if constexpr (has_multi_input) {
+            if (this->input_mailboxes_) {
+                fill_history_stats(stats, std::make_index_sequence<MetricsType::num_inputs>{});
+            }
+        }
+        return stats;
+    }
+    
+    /**
+     * @brief Answer a StatsRequest received on a WORK mailbox
+     * 
+     * PUBLIC: Called by output_work_loop(). The reply goes to header.reply_to
+     * with the request's correlation id (requests without reply_to are ignored).
+     */
+    template<typename WorkMailboxT>
+    void handle_stats_request(const TimsHeader& request_header, WorkMailboxT& work_mbx) {
+        if (request_header.reply_to == 0) {
+            return;
+        }
+        
+        TimsMessage<StatsReplyPayload> reply_msg{
+            .header = {
+                .msg_type = SystemRegistry::template get_message_id<StatsReplyPayload>(),
+                .msg_size = 0,
+                .timestamp = Time::now(),
+                .seq_number = 0,
+                .flags = 0,
+                .correlation_id = request_header.correlation_id,
+                .reply_to = 0
+            },
+            .payload = collect_stats()
+        };
+        
+        auto result = work_mbx.underlying().send(reply_msg, request_header.reply_to);
+        if (!result) {
+            std::cerr << "[" << config_.name << "] StatsReply send failed to 0x" << std::hex
+                      << request_header.reply_to << std::dec << "\n";
+        }
+    }
+    
+    /**
+     * @brief Answer a FlightDumpRequest received on a WORK mailbox
+     * 
+     * PUBLIC: Called by the work loops. Dumps the process's FlightRecorder
+     * (if one is installed) on the work thread, then replies to
+     * header.reply_to; requests without reply_to still trigger the dump.
+     */
+    template<typename WorkMailboxT>
+    void handle_flight_dump_request(const TimsHeader& request_header, WorkMailboxT& work_mbx) {
+        FlightDumpResult dump;
+        if (FlightRecorder* recorder = FlightRecorder::active()) {
+            dump = recorder->dump();
+        }
+        if (request_header.reply_to == 0) {
+            return;
+        }
+        
+        TimsMessage<FlightDumpReplyPayload> reply_msg{
+            .header = {
+                .msg_type = SystemRegistry::template get_message_id<FlightDumpReplyPayload>(),
+                .msg_size = 0,
+                .timestamp = Time::now(),
+                .seq_number = 0,
+                .flags = 0,
+                .correlation_id = request_header.correlation_id,
+                .reply_to = 0
+            },
+            .payload = {
+                .success = dump.success,
+                .records = dump.records,
+                .path = sertial::fixed_string<128>(dump.path)
+            }
+        };
+        
+        auto result = work_mbx.underlying().send(reply_msg, request_header.reply_to);
+        if (!result) {
+            std::cerr << "[" << config_.name << "] FlightDumpReply send failed to 0x" << std::hex
+                      << request_header.reply_to << std::dec << "\n";
+        }
+    }
+    
 protected:
 
     // ========================================================================
@@ -571,6 +692,15 @@ private:
     // - start_secondary_input_threads()
     // - start_secondary_threads_impl()
     
+    // Helper: History buffer fill level of each multi-input mailbox
+    template<std::size_t... Is>
+    void fill_history_stats(StatsReplyPayload& stats, std::index_sequence<Is...>) const {
+        ((stats.inputs[Is].history_fill = static_cast<uint32_t>(
+              std::get<Is>(*this->input_mailboxes_).template history_size<std::tuple_element_t<Is, InputTypesTuple>>()),
+          stats.inputs[Is].history_capacity = static_cast<uint32_t>(
+              std::get<Is>(*this->input_mailboxes_).history_capacity())), ...);
+    }
+    
     // Multi-input processing (in MultiInputProcessor mixin)
     // - receive_primary_input<PrimaryIdx>()
     // - gather_all_inputs<PrimaryIdx>()
@@ -1,9 +1,151 @@
 #include "commrat/tims_wrapper.hpp"
+#include "commrat/platform/simulated_clock.hpp"
+#include <cerrno>
 #include <cstring>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace commrat {
 
+// ============================================================================
+// Loopback Transport (in-process TiMS stand-in)
+// ============================================================================
+
+namespace detail {
+
+/**
+ * @brief In-process mailbox: fixed number of preallocated slots
+ */
+struct LoopbackMailbox {
+    LoopbackMailbox(size_t slot_count, size_t max_msg_size)
+        : slots(slot_count, std::vector<std::byte>(max_msg_size))
+        , sizes(slot_count, 0)
+        , max_msg_size(max_msg_size) {}
+    
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::vector<std::vector<std::byte>> slots;
+    std::vector<size_t> sizes;
+    size_t head{0};
+    size_t count{0};
+    size_t counted{0};  ///< Queued messages counted as in flight by SimulatedClock
+    size_t max_msg_size;
+    bool closed{false};
+};
+
+} // namespace detail
+
+namespace {
+
+std::atomic<TimsTransport> g_transport{TimsTransport::Router};
+std::atomic<TrafficTap> g_traffic_tap{nullptr};
+
+inline void notify_tap(TrafficDirection direction, uint32_t mailbox_id, const void* data, size_t size) {
+    if (TrafficTap tap = g_traffic_tap.load(std::memory_order_acquire)) {
+        tap(direction, mailbox_id, {static_cast<const std::byte*>(data), size});
+    }
+}
+
+std::mutex g_loopback_mutex;
+std::unordered_map<uint32_t, std::shared_ptr<detail::LoopbackMailbox>> g_loopback_mailboxes;
+
+std::shared_ptr<detail::LoopbackMailbox> find_loopback(uint32_t mailbox_id) {
+    std::lock_guard<std::mutex> lock(g_loopback_mutex);
+    auto it = g_loopback_mailboxes.find(mailbox_id);
+    return it != g_loopback_mailboxes.end() ? it->second : nullptr;
+}
+
+TimsResult loopback_send(const void* data, size_t size, uint32_t dest_mailbox_id) {
+    auto dest = find_loopback(dest_mailbox_id);
+    if (!dest) {
+        return TimsResult::ERROR_SEND;  // No such mailbox
+    }
+    
+    std::lock_guard<std::mutex> lock(dest->mutex);
+    if (size > dest->max_msg_size) {
+        return TimsResult::ERROR_INVALID_MESSAGE;
+    }
+    if (dest->count == dest->slots.size()) {
+        return TimsResult::ERROR_QUEUE_FULL;
+    }
+    size_t tail = (dest->head + dest->count) % dest->slots.size();
+    std::memcpy(dest->slots[tail].data(), data, size);
+    dest->sizes[tail] = size;
+    dest->count++;
+    if (SimulatedClock::message_queued()) {
+        dest->counted++;
+    }
+    dest->not_empty.notify_one();
+    return TimsResult::SUCCESS;
+}
+
+// TiMS timeout semantics: -1ms = non-blocking, 0 = wait forever
+ssize_t loopback_receive(detail::LoopbackMailbox& mbx, void* buffer, size_t buffer_size,
+                         std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mbx.mutex);
+    auto ready = [&mbx]() { return mbx.count > 0 || mbx.closed; };
+    
+    if (timeout.count() == -1) {
+        if (!ready()) {
+            return -EAGAIN;
+        }
+    } else if (!ready()) {
+        // Idle for simulated time while blocked
+        SimulatedClock::begin_wait();
+        bool received = true;
+        if (timeout.count() == 0) {
+            mbx.not_empty.wait(lock, ready);
+        } else {
+            received = mbx.not_empty.wait_for(lock, timeout, ready);
+        }
+        SimulatedClock::end_wait();
+        if (!received) {
+            return -ETIMEDOUT;
+        }
+    }
+    
+    if (mbx.count == 0) {
+        return -EPIPE;  // Closed
+    }
+    if (mbx.counted == mbx.count) {
+        // The newest `counted` messages are counted (counting starts with the clock)
+        mbx.counted--;
+        SimulatedClock::messages_dequeued();
+    }
+    
+    size_t size = mbx.sizes[mbx.head];
+    const std::byte* slot = mbx.slots[mbx.head].data();
+    mbx.head = (mbx.head + 1) % mbx.slots.size();
+    mbx.count--;
+    
+    if (size > buffer_size) {
+        return -EMSGSIZE;  // Message dropped, like TiMS
+    }
+    std::memcpy(buffer, slot, size);
+    return static_cast<ssize_t>(size);
+}
+
+} // namespace
+
+void TimsWrapper::set_transport(TimsTransport transport) {
+    g_transport.store(transport);
+}
+
+TimsTransport TimsWrapper::transport() {
+    return g_transport.load();
+}
+
+void TimsWrapper::set_traffic_tap(TrafficTap tap) {
+    g_traffic_tap.store(tap, std::memory_order_release);
+}
+
+// ============================================================================
+// TimsWrapper
+// ============================================================================
+
 TimsWrapper::TimsWrapper(const TimsConfig& config)
     : config_(config)
     , tims_fd_(-1)
@@ -23,7 +165,8 @@ TimsWrapper::TimsWrapper(TimsWrapper&& other) noexcept
     , is_initialized_(other.is_initialized_.load())
     , messages_sent_(other.messages_sent_.load())
     , messages_received_(other.messages_received_.load())
-    , sequence_number_(other.sequence_number_) {
+    , sequence_number_(other.sequence_number_)
+    , loopback_(std::move(other.loopback_)) {
     other.tims_fd_ = -1;
     other.is_initialized_ = false;
 }
@@ -38,6 +181,7 @@ TimsWrapper& TimsWrapper::operator=(TimsWrapper&& other) noexcept {
         messages_sent_ = other.messages_sent_.load();
         messages_received_ = other.messages_received_.load();
         sequence_number_ = other.sequence_number_;
+        loopback_ = std::move(other.loopback_);
         
         other.tims_fd_ = -1;
         other.is_initialized_ = false;
@@ -50,12 +194,25 @@ TimsResult TimsWrapper::initialize() {
         return TimsResult::SUCCESS;
     }
     
+    if (transport() == TimsTransport::Loopback) {
+        std::lock_guard<std::mutex> lock(g_loopback_mutex);
+        auto& entry = g_loopback_mailboxes[config_.mailbox_id];
+        if (entry) {
+            std::cerr << "[TiMS] loopback mailbox " << config_.mailbox_id << " already exists\n";
+            return TimsResult::ERROR_INIT;
+        }
+        entry = std::make_shared<detail::LoopbackMailbox>(config_.message_slots, config_.max_msg_size);
+        loopback_ = entry;
+        is_initialized_ = true;
+        return TimsResult::SUCCESS;
+    }
+    
     std::cout << "[TiMS] Creating mailbox " << config_.mailbox_id 
               << " with max_msg_size=" << config_.max_msg_size << " bytes\n";
     
     // Create TIMS mailbox (this handles socket creation, connection to router, and mailbox init)
     tims_fd_ = tims_mbx_create(config_.mailbox_id, 
-                               10,  // message slots (adjust as needed)
+                               config_.message_slots,
                                config_.max_msg_size,
                                nullptr,  // let TIMS allocate buffer
                                0);  // buffer size (0 = auto)
@@ -75,6 +232,24 @@ void TimsWrapper::shutdown() {
         return;
     }
     
+    if (loopback_) {
+        {
+            std::lock_guard<std::mutex> lock(g_loopback_mutex);
+            g_loopback_mailboxes.erase(config_.mailbox_id);
+        }
+        {
+            // Wake blocked receivers (kept alive until destruction or re-initialize)
+            std::lock_guard<std::mutex> lock(loopback_->mutex);
+            loopback_->closed = true;
+            if (loopback_->counted > 0) {
+                // Nobody will receive them now
+                SimulatedClock::messages_dequeued(loopback_->counted);
+                loopback_->counted = 0;
+            }
+        }
+        loopback_->not_empty.notify_all();
+    }
+    
     if (tims_fd_ >= 0) {
         // Remove mailbox (this also closes the socket)
         tims_mbx_remove(tims_fd_);
@@ -85,6 +260,18 @@ void TimsWrapper::shutdown() {
 }
 
 TimsResult TimsWrapper::send_raw(const void* data, size_t size, uint32_t dest_mailbox_id) {
+    if (loopback_) {
+        if (!data || size == 0 || size > config_.max_msg_size) {
+            return TimsResult::ERROR_INVALID_MESSAGE;
+        }
+        TimsResult result = loopback_send(data, size, dest_mailbox_id);
+        if (result == TimsResult::SUCCESS) {
+            messages_sent_.fetch_add(1, std::memory_order_relaxed);
+            notify_tap(TrafficDirection::Sent, dest_mailbox_id, data, size);
+        }
+        return result;
+    }
+    
     if (!is_initialized_ || tims_fd_ < 0) {
         std::cerr << "[TiMS] send_raw: NOT INITIALIZED (is_initialized=" << is_initialized_ 
                   << ", tims_fd=" << tims_fd_ << ")\n";
@@ -116,16 +303,31 @@ TimsResult TimsWrapper::send_raw(const void* data, size_t size, uint32_t dest_ma
     ssize_t result = tims_sendmsg(tims_fd_, &head, vec, 1, 0);
     
     if (result < 0) {
+        // Destination mailbox full (TiMS reports either -errno or -1/errno)
+        int err = (result == -1) ? errno : static_cast<int>(-result);
+        if (err == ENOSPC || err == EAGAIN) {
+            return TimsResult::ERROR_QUEUE_FULL;
+        }
         return TimsResult::ERROR_SEND;
     }
     
     messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    notify_tap(TrafficDirection::Sent, dest_mailbox_id, data, size);
     
     return TimsResult::SUCCESS;
 }
 
 ssize_t TimsWrapper::receive_raw(void* buffer, size_t buffer_size, 
                                   std::chrono::milliseconds timeout) {
+    if (loopback_) {
+        ssize_t bytes = loopback_receive(*loopback_, buffer, buffer_size, timeout);
+        if (bytes > 0) {
+            messages_received_.fetch_add(1, std::memory_order_relaxed);
+            notify_tap(TrafficDirection::Received, config_.mailbox_id, buffer, static_cast<size_t>(bytes));
+        }
+        return bytes;
+    }
+    
     if (!is_initialized_ || tims_fd_ < 0) {
         return -1;
     }
@@ -157,11 +359,17 @@ ssize_t TimsWrapper::receive_raw(void* buffer, size_t buffer_size,
     tims_parse_head_byteorder(&head);
     
     messages_received_.fetch_add(1, std::memory_order_relaxed);
+    notify_tap(TrafficDirection::Received, config_.mailbox_id, buffer, static_cast<size_t>(bytes_received));
     
     return bytes_received;
 }
 
 bool TimsWrapper::has_message() const {
+    if (loopback_) {
+        std::lock_guard<std::mutex> lock(loopback_->mutex);
+        return loopback_->count > 0;
+    }
+    
     if (!is_initialized_ || tims_fd_ < 0) {
         return false;
     }
@@ -0,0 +1,96 @@
+/**
+ * @file recording_test_fixtures.hpp
+ * @brief Modules and helpers shared by the recording tests
+ *
+ * SourceA/SinkA are templated on the test's CommRaT application, which must
+ * register Message::Data<SampleA>.
+ */
+
+#pragma once
+
+#include <commrat/commrat.hpp>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+struct SampleA {
+    uint64_t seq{0};
+    double value{0.0};
+};
+
+/// Numbers its outputs 1, 2, 3, ... (seq and value)
+template<typename App>
+class SourceA : public App::template Module<commrat::Output<SampleA>, commrat::PeriodicInput> {
+public:
+    using App::template Module<commrat::Output<SampleA>, commrat::PeriodicInput>::Module;
+
+protected:
+    void process(SampleA& output) override {
+        output.seq = ++seq_;
+        output.value = static_cast<double>(seq_);
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+/// Forwards its input and collects received sequence numbers and header timestamps
+template<typename App>
+class SinkA : public App::template Module<commrat::Output<SampleA>, commrat::Input<SampleA>> {
+    using Base = typename App::template Module<commrat::Output<SampleA>, commrat::Input<SampleA>>;
+
+public:
+    SinkA(const commrat::ModuleConfig& config, std::chrono::microseconds delay = {})
+        : Base(config), delay_(delay) {}
+
+    std::vector<std::pair<uint64_t, uint64_t>> received() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+protected:
+    void process(const SampleA& input, SampleA& output) override {
+        if (delay_.count() > 0) {
+            std::this_thread::sleep_for(delay_);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        received_.emplace_back(input.seq, this->template get_input_metadata<0>().timestamp);
+        output = input;
+    }
+
+private:
+    std::chrono::microseconds delay_;
+    mutable std::mutex mutex_;
+    std::vector<std::pair<uint64_t, uint64_t>> received_;
+};
+
+/// Empty path commrat_test_<suite>_<pid>_<name> in the temp directory (not created)
+inline std::string make_test_dir(const char* suite, const char* name) {
+    auto dir = std::filesystem::temp_directory_path() /
+               (std::string("commrat_test_") + suite + "_" + std::to_string(::getpid()) + "_" + name);
+    std::filesystem::remove_all(dir);
+    return dir.string();
+}
+
+inline commrat::ModuleConfig periodic_config(const char* name, uint8_t system_id,
+                                             std::chrono::milliseconds period) {
+    return commrat::ModuleConfig{
+        .name = name,
+        .outputs = commrat::SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = commrat::NoInputConfig{},
+        .period = period
+    };
+}
+
+inline commrat::ModuleConfig sink_config(const char* name, uint8_t system_id, uint8_t source_system) {
+    return commrat::ModuleConfig{
+        .name = name,
+        .outputs = commrat::SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = commrat::SingleInputConfig{.source_system_id = source_system, .source_instance_id = 0}
+    };
+}
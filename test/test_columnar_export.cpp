@@ -0,0 +1,278 @@
+/**
+ * @file test_columnar_export.cpp
+ * @brief Test columnar export of recordings
+ *
+ * Validates:
+ * - Field table: nested structs, std::array, fixed_vector (of scalars and
+ *   of structs), fixed_string, enums; header columns first
+ * - Column files hold the recorded values in record order, across segments
+ *   and batch boundaries
+ * - List columns: offsets (rows + 1, starting at 0) and concatenated values
+ * - Manifest lists every column; streams are filtered and time-limited
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/columnar_export.hpp>
+#include <commrat/recording/mmap_log_writer.hpp>
+#include "recording_test_fixtures.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace commrat;
+
+enum class ScanMode : uint8_t { Idle = 0, Sweep = 1, Fixed = 2 };
+
+struct Pose {
+    double x{0.0};
+    double y{0.0};
+    float yaw{0.0f};
+};
+
+struct Scan {
+    uint64_t id{0};
+    Pose pose;
+    std::array<float, 3> accel{};
+    sertial::fixed_vector<float, 16> ranges;
+    sertial::fixed_vector<Pose, 4> landmarks;
+    sertial::fixed_string<32> frame;
+    ScanMode mode{ScanMode::Idle};
+    bool valid{false};
+};
+
+struct Tick {
+    uint32_t count{0};
+};
+
+using ColumnarApp = CommRaT<
+    Message::Data<Scan>,
+    Message::Data<Tick>
+>;
+
+namespace {
+
+constexpr uint64_t origin = 5'000'000'000;
+constexpr uint64_t scan_period = 1'000'000;
+constexpr uint64_t scans = 3000;
+
+Scan make_scan(uint64_t i) {
+    Scan scan;
+    scan.id = i;
+    scan.pose = Pose{.x = 0.5 * static_cast<double>(i), .y = -static_cast<double>(i), .yaw = 0.25f};
+    scan.accel = {static_cast<float>(i), 1.0f, 9.81f};
+    for (uint64_t r = 0; r < i % 5; ++r) {
+        scan.ranges.push_back(static_cast<float>(i * 10 + r));
+    }
+    for (uint64_t l = 0; l < i % 3; ++l) {
+        scan.landmarks.push_back(Pose{.x = static_cast<double>(i), .y = static_cast<double>(l), .yaw = 0.0f});
+    }
+    scan.frame = sertial::fixed_string<32>(i % 2 ? "lidar" : "map");
+    scan.mode = static_cast<ScanMode>(i % 3);
+    scan.valid = i % 4 != 0;
+    return scan;
+}
+
+void write_recording(const std::string& dir) {
+    const std::array<LogStreamInfo, 2> streams{{
+        {.message_id = ColumnarApp::get_message_id<Scan>(), .stream_id = 0,
+         .system_id = 10, .instance_id = 0, .name = "scan"},
+        {.message_id = ColumnarApp::get_message_id<Tick>(), .stream_id = 1,
+         .system_id = 11, .instance_id = 2, .name = ""}
+    }};
+    MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "src",
+                                         .segment_size = 256 * 1024, .prefault = false},
+                         streams, ColumnarApp::Introspection::export_all());
+    for (uint64_t i = 0; i < scans; ++i) {
+        TimsMessage<Scan> msg{};
+        msg.header.timestamp = origin + i * scan_period - 1000;
+        msg.header.seq_number = static_cast<uint32_t>(i);
+        msg.payload = make_scan(i);
+        auto wire = ColumnarApp::serialize(msg);
+        writer.append(0, origin + i * scan_period, wire.view());
+
+        if (i % 10 == 0) {
+            TimsMessage<Tick> tick{};
+            tick.header.timestamp = origin + i * scan_period;
+            tick.payload.count = static_cast<uint32_t>(i / 10);
+            auto tick_wire = ColumnarApp::serialize(tick);
+            writer.append(1, origin + i * scan_period + 1, tick_wire.view());
+        }
+    }
+}
+
+template<typename T>
+std::vector<T> read_column(const std::filesystem::path& file) {
+    std::ifstream in(file, std::ios::binary);
+    assert(in);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    assert(bytes.size() % sizeof(T) == 0);
+    std::vector<T> values(bytes.size() / sizeof(T));
+    std::memcpy(values.data(), bytes.data(), bytes.size());
+    return values;
+}
+
+std::string read_text(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    std::stringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Columnar Export Tests ===\n\n";
+
+    // Test 1: Field table
+    {
+        std::cout << "Test 1: Field table\n";
+
+        const ColumnarLayout& layout = columnar_layout<Scan>();
+        std::vector<std::string> names;
+        for (const auto& column : layout.columns) {
+            names.push_back(column.name);
+        }
+        assert((names == std::vector<std::string>{
+            "timestamp", "seq_number", "id", "pose.x", "pose.y", "pose.yaw", "accel", "ranges",
+            "landmarks.x", "landmarks.y", "landmarks.yaw", "frame", "mode", "valid"}));
+        assert(layout.skipped.empty());
+        assert(layout.row_size == sizeof(TimsMessage<Scan>));
+
+        TimsMessage<Scan> msg{};
+        const auto* base = reinterpret_cast<const std::byte*>(&msg);
+        auto offset_of = [&](const void* field) {
+            return static_cast<uint32_t>(reinterpret_cast<const std::byte*>(field) - base);
+        };
+        assert(layout.columns[0].offset == offset_of(&msg.header.timestamp));
+        assert(layout.columns[3].offset == offset_of(&msg.payload.pose.x));
+        assert(layout.columns[5].offset == offset_of(&msg.payload.pose.yaw));
+        assert(std::string(layout.columns[5].dtype) == "<f4");
+        assert(layout.columns[6].count == 3 && layout.columns[6].stride == sizeof(float));
+        assert(std::string(layout.columns[12].dtype) == "|u1");   // enum : uint8_t
+        assert(std::string(layout.columns[13].dtype) == "|b1");
+
+        assert(layout.lists.size() == 3);
+        assert(layout.lists[0].name == "ranges" && layout.columns[7].list == 0);
+        assert(layout.lists[1].name == "landmarks" && layout.lists[1].element_size == sizeof(Pose));
+        assert(layout.columns[10].list == 1 && layout.columns[10].offset == offsetof(Pose, yaw));
+        assert(layout.lists[2].string && layout.lists[2].offset == offset_of(&msg.payload.frame));
+
+        std::cout << "  " << layout.columns.size() << " columns, " << layout.lists.size() << " lists\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    const std::string dir = make_test_dir("columnar", "src");
+    write_recording(dir);
+    assert(list_log_segments(dir, "src").size() > 2);
+
+    // Test 2: All streams, values in record order
+    {
+        std::cout << "Test 2: Export columns\n";
+
+        const std::string out = make_test_dir("columnar", "out");
+        ColumnarExporter<ColumnarApp> exporter(ColumnarExportConfig{
+            .directory = dir, .prefix = "src", .output_directory = out, .batch_rows = 256});
+        auto stats = exporter.run();
+        assert(stats.streams == 2);
+        assert(stats.rows == scans + scans / 10);
+        assert(stats.skipped_records == 0);
+
+        const std::filesystem::path scan_dir = std::filesystem::path(out) / "scan_10_0";
+        auto timestamp = read_column<uint64_t>(scan_dir / "timestamp.bin");
+        auto receive = read_column<uint64_t>(scan_dir / "receive_ns.bin");
+        auto seq = read_column<uint32_t>(scan_dir / "seq_number.bin");
+        auto id = read_column<uint64_t>(scan_dir / "id.bin");
+        auto x = read_column<double>(scan_dir / "pose.x.bin");
+        auto yaw = read_column<float>(scan_dir / "pose.yaw.bin");
+        auto accel = read_column<float>(scan_dir / "accel.bin");
+        auto mode = read_column<uint8_t>(scan_dir / "mode.bin");
+        auto valid = read_column<uint8_t>(scan_dir / "valid.bin");
+        assert(timestamp.size() == scans && receive.size() == scans && seq.size() == scans);
+        assert(accel.size() == 3 * scans);
+        for (uint64_t i = 0; i < scans; ++i) {
+            const Scan expected = make_scan(i);
+            assert(receive[i] == origin + i * scan_period);
+            assert(timestamp[i] == receive[i] - 1000);
+            assert(seq[i] == i && id[i] == i);
+            assert(x[i] == expected.pose.x && yaw[i] == expected.pose.yaw);
+            assert(accel[3 * i] == expected.accel[0] && accel[3 * i + 2] == expected.accel[2]);
+            assert(mode[i] == static_cast<uint8_t>(expected.mode));
+            assert(valid[i] == (expected.valid ? 1 : 0));
+        }
+
+        // Lists
+        auto range_offsets = read_column<uint64_t>(scan_dir / "ranges.offsets.bin");
+        auto ranges = read_column<float>(scan_dir / "ranges.bin");
+        auto landmark_offsets = read_column<uint64_t>(scan_dir / "landmarks.offsets.bin");
+        auto landmark_y = read_column<double>(scan_dir / "landmarks.y.bin");
+        auto frame_offsets = read_column<uint64_t>(scan_dir / "frame.offsets.bin");
+        auto frames = read_column<char>(scan_dir / "frame.bin");
+        assert(range_offsets.size() == scans + 1 && range_offsets[0] == 0);
+        assert(range_offsets.back() == ranges.size());
+        assert(landmark_offsets.back() == landmark_y.size());
+        assert(frame_offsets.back() == frames.size());
+        for (uint64_t i = 0; i < scans; ++i) {
+            const Scan expected = make_scan(i);
+            assert(range_offsets[i + 1] - range_offsets[i] == expected.ranges.size());
+            for (std::size_t r = 0; r < expected.ranges.size(); ++r) {
+                assert(ranges[range_offsets[i] + r] == expected.ranges[r]);
+            }
+            assert(landmark_offsets[i + 1] - landmark_offsets[i] == expected.landmarks.size());
+            for (std::size_t l = 0; l < expected.landmarks.size(); ++l) {
+                assert(landmark_y[landmark_offsets[i] + l] == expected.landmarks[l].y);
+            }
+            const std::string frame(frames.data() + frame_offsets[i], frames.data() + frame_offsets[i + 1]);
+            assert(frame == expected.frame.view());
+        }
+
+        // Unnamed stream and manifest
+        char tick_name[32];
+        std::snprintf(tick_name, sizeof(tick_name), "0x%08x_11_2", ColumnarApp::get_message_id<Tick>());
+        const std::filesystem::path tick_dir = std::filesystem::path(out) / tick_name;
+        auto counts = read_column<uint32_t>(tick_dir / "count.bin");
+        assert(counts.size() == scans / 10 && counts.back() == scans / 10 - 1);
+
+        const std::string manifest = read_text(scan_dir / "columns.json");
+        assert(manifest.find("\"rows\": 3000") != std::string::npos);
+        assert(manifest.find("{\"name\": \"pose.x\", \"file\": \"pose.x.bin\", \"dtype\": \"<f8\", \"shape\": []") != std::string::npos);
+        assert(manifest.find("\"name\": \"accel\", \"file\": \"accel.bin\", \"dtype\": \"<f4\", \"shape\": [3]") != std::string::npos);
+        assert(manifest.find("\"offsets\": \"landmarks.offsets\", \"kind\": \"list\"") != std::string::npos);
+        assert(manifest.find("\"offsets\": \"frame.offsets\", \"kind\": \"string\"") != std::string::npos);
+        assert(manifest.find("\"name\": \"ranges.offsets\", \"file\": \"ranges.offsets.bin\", \"dtype\": \"<u8\", "
+                             "\"shape\": [], \"length\": 3001") != std::string::npos);
+
+        std::cout << "  " << stats.rows << " rows, " << stats.bytes << " column bytes in "
+                  << stats.elapsed_ns / 1000 << " us\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(out);
+    }
+
+    // Test 3: Stream filter and time range
+    {
+        std::cout << "Test 3: Filter and time range\n";
+
+        const std::string out = make_test_dir("columnar", "filtered");
+        ColumnarExporter<ColumnarApp> exporter(ColumnarExportConfig{
+            .directory = dir, .prefix = "src", .output_directory = out,
+            .start_ns = origin + 1000 * scan_period, .end_ns = origin + 2000 * scan_period,
+            .stream_filter = [](const LogStreamInfo& info) { return info.system_id == 10; }});
+        auto stats = exporter.run();
+        assert(stats.streams == 1 && stats.rows == 1000);
+
+        const std::filesystem::path scan_dir = std::filesystem::path(out) / "scan_10_0";
+        auto id = read_column<uint64_t>(scan_dir / "id.bin");
+        assert(id.size() == 1000 && id.front() == 1000 && id.back() == 1999);
+        assert(std::distance(std::filesystem::directory_iterator(out), std::filesystem::directory_iterator()) == 1);
+
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(out);
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "=== All Columnar Export Tests PASSED ===\n";
+    return 0;
+}
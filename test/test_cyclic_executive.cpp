@@ -0,0 +1,397 @@
+/**
+ * @file test_cyclic_executive.cpp
+ * @brief Test the static cyclic executive
+ *
+ * Validates:
+ * - Schedule validation (periods/offsets on the minor frame grid, unknown
+ *   and unbound slots) and the major frame
+ * - A source -> filter chain runs in one minor frame: the filter processes
+ *   every source message in the frame it was released, output timestamps
+ *   are release times
+ * - Slots with offsets run in their frames only; a multi-input module
+ *   polls its primary and syncs its secondary from history
+ * - Frame overruns are detected, reported and skipped frames keep the
+ *   schedule on the frame grid
+ * - Time::sleep_until() (frame releases) wakes at, never before, the
+ *   deadline for monotonic and wall clock sources
+ * - stop() returns promptly while the first release is a long major frame
+ *   away, and under simulated time without the controller
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/module/lifecycle/cyclic_executive.hpp>
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace commrat;
+
+struct Tick {
+    uint64_t seq{0};
+};
+
+struct Filtered {
+    uint64_t seq{0};
+};
+
+struct Slow {
+    uint64_t seq{0};
+};
+
+struct Fused {
+    uint64_t tick_seq{0};
+    uint64_t slow_seq{0};
+};
+
+using CyclicApp = CommRaT<
+    Message::Data<Tick>,
+    Message::Data<Filtered>,
+    Message::Data<Slow>,
+    Message::Data<Fused>
+>;
+
+class TickSource : public CyclicApp::Module<Output<Tick>, PeriodicInput> {
+public:
+    using CyclicApp::Module<Output<Tick>, PeriodicInput>::Module;
+
+    std::chrono::microseconds busy{0};
+
+protected:
+    void process(Tick& output) override {
+        if (busy.count() > 0) {
+            std::this_thread::sleep_for(busy);
+        }
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class SlowSource : public CyclicApp::Module<Output<Slow>, PeriodicInput> {
+public:
+    using CyclicApp::Module<Output<Slow>, PeriodicInput>::Module;
+
+protected:
+    void process(Slow& output) override {
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+/// (input timestamp, time of process()) of every filtered message
+using Sample = std::pair<uint64_t, uint64_t>;
+
+class Filter : public CyclicApp::Module<Output<Filtered>, Input<Tick>> {
+public:
+    using CyclicApp::Module<Output<Filtered>, Input<Tick>>::Module;
+
+    std::vector<Sample> samples() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return samples_;
+    }
+
+protected:
+    void process(const Tick& input, Filtered& output) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.emplace_back(get_input_metadata<0>().timestamp, Time::now());
+        output.seq = input.seq;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Sample> samples_;
+};
+
+class Fusion : public CyclicApp::Module<Output<Fused>, Inputs<Filtered, Slow>> {
+public:
+    using CyclicApp::Module<Output<Fused>, Inputs<Filtered, Slow>>::Module;
+
+    std::vector<uint64_t> primary_timestamps() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return timestamps_;
+    }
+
+protected:
+    void process(const Filtered& filtered, const Slow& slow, Fused& output) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timestamps_.push_back(get_input_metadata<0>().timestamp);
+        output = Fused{.tick_seq = filtered.seq, .slow_seq = slow.seq};
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<uint64_t> timestamps_;
+};
+
+namespace {
+
+constexpr uint64_t minor_ns = 2'000'000;
+
+ModuleConfig source_config(const char* name, uint8_t system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = NoInputConfig{}
+    };
+}
+
+CyclicScheduleConfig test_schedule(std::vector<ScheduleSlot> slots) {
+    return CyclicScheduleConfig{
+        .name = "test_cyclic",
+        .minor_frame = Microseconds(2000),
+        .slots = std::move(slots),
+        .priority = ThreadPriority::NORMAL,
+        .policy = SchedulingPolicy::NORMAL
+    };
+}
+
+template<typename Fn>
+bool throws_invalid(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Cyclic Executive Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Schedule validation
+    {
+        std::cout << "Test 1: Schedule validation\n";
+
+        CyclicExecutive valid(test_schedule({
+            {.module = "a", .period = Microseconds(2000)},
+            {.module = "b", .period = Microseconds(6000), .offset = Microseconds(4000)},
+            {.module = "c", .period = Microseconds(8000)}
+        }));
+        assert(valid.major_frame_ns() == 24'000'000);
+        assert(valid.frames_per_major() == 12);
+
+        assert(throws_invalid([] { CyclicExecutive e(test_schedule({{.module = "a", .period = Microseconds(3000)}})); }));
+        assert(throws_invalid([] {
+            CyclicExecutive e(test_schedule({{.module = "a", .period = Microseconds(4000), .offset = Microseconds(4000)}}));
+        }));
+        assert(throws_invalid([] {
+            CyclicExecutive e(test_schedule({{.module = "a", .period = Microseconds(4000), .offset = Microseconds(1000)}}));
+        }));
+        assert(throws_invalid([] {
+            CyclicExecutive e(test_schedule({
+                {.module = "a", .period = Microseconds(2000)},
+                {.module = "a", .period = Microseconds(4000)}
+            }));
+        }));
+
+        TickSource source(source_config("CycUnbound", 70));
+        assert(throws_invalid([&] { valid.add("missing", source); }));
+        valid.add("a", source);
+        assert(throws_invalid([&] { valid.add("a", source); }));
+
+        bool unbound = false;
+        try {
+            valid.start();
+        } catch (const std::logic_error&) {
+            unbound = true;
+        }
+        assert(unbound && !valid.is_running());
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Chain in one frame, offsets, multi-input
+    {
+        std::cout << "Test 2: Source -> filter -> fusion on one thread\n";
+
+        TickSource tick(source_config("CycTick", 71));
+        SlowSource slow(source_config("CycSlow", 72));
+        Filter filter(ModuleConfig{
+            .name = "CycFilter",
+            .outputs = SimpleOutputConfig{.system_id = 73, .instance_id = 0},
+            .inputs = SingleInputConfig{.source_system_id = 71, .source_instance_id = 0}
+        });
+        Fusion fusion(ModuleConfig{
+            .name = "CycFusion",
+            .outputs = SimpleOutputConfig{.system_id = 74, .instance_id = 0},
+            .inputs = MultiInputConfig{
+                .sources = {
+                    {.system_id = 73, .instance_id = 0},
+                    {.system_id = 72, .instance_id = 0}
+                },
+                .history_buffer_size = 100,
+                .sync_tolerance = std::chrono::milliseconds(20)
+            }
+        });
+
+        // Data-flow order; slow runs every 5th frame, 2 frames into its period
+        CyclicExecutive executive(test_schedule({
+            {.module = "tick", .period = Microseconds(2000)},
+            {.module = "slow", .period = Microseconds(10000), .offset = Microseconds(4000)},
+            {.module = "filter", .period = Microseconds(2000)},
+            {.module = "fusion", .period = Microseconds(2000)}
+        }));
+        executive.add("tick", tick);
+        executive.add("slow", slow);
+        executive.add("filter", filter);
+        executive.add("fusion", fusion);
+        assert(executive.frames_per_major() == 5);
+
+        executive.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        executive.stop();
+        assert(!tick.is_running() && !fusion.is_running());
+
+        const auto stats = executive.stats();
+        const auto samples = filter.samples();
+        const auto fused = fusion.primary_timestamps();
+        std::cout << "  " << stats.frames << " frames, " << stats.overruns << " overruns, max frame "
+                  << stats.max_frame_ns / 1000 << "us, " << samples.size() << " filtered, "
+                  << fused.size() << " fused\n";
+
+        assert(stats.frames > 50);
+        assert(stats.slots.size() == 4 && stats.slots[0].module == "tick");
+        assert(stats.slots[0].releases == stats.frames);
+        assert(stats.slots[0].processed == stats.frames);
+        assert(stats.slots[1].releases > 0 && stats.slots[1].releases <= stats.frames / 5 + 1);
+        assert(stats.slots[2].processed == samples.size());
+        assert(stats.slots[3].processed == fused.size());
+
+        // Output timestamps are release times on the frame grid
+        assert(!samples.empty() && !fused.empty());
+        for (const auto& [input_ts, processed_at] : samples) {
+            assert(input_ts % minor_ns == 0);
+            assert(processed_at >= input_ts);
+        }
+        for (uint64_t ts : fused) {
+            assert(ts % minor_ns == 0);
+        }
+
+        if (stats.overruns == 0) {
+            // Every tick after the subscription is filtered in its own frame
+            for (std::size_t i = 0; i < samples.size(); ++i) {
+                assert(samples[i].second - samples[i].first < minor_ns);
+                if (i > 0) {
+                    assert(samples[i].first - samples[i - 1].first == minor_ns);
+                }
+            }
+            assert(samples.size() + 10 >= stats.frames);
+        }
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Overrun detection
+    {
+        std::cout << "Test 3: Overruns are detected and skipped\n";
+
+        TickSource tick(source_config("CycOverrun", 75));
+        tick.busy = std::chrono::microseconds(5000);
+
+        CyclicExecutive executive(test_schedule({{.module = "tick", .period = Microseconds(2000)}}));
+        executive.add("tick", tick);
+
+        std::mutex mutex;
+        std::vector<FrameOverrun> reported;
+        executive.on_overrun([&](const FrameOverrun& overrun) {
+            std::lock_guard<std::mutex> lock(mutex);
+            reported.push_back(overrun);
+        });
+
+        executive.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        executive.stop();
+
+        const auto stats = executive.stats();
+        std::cout << "  " << stats.frames << " frames, " << stats.overruns << " overruns, "
+                  << stats.skipped_frames << " skipped\n";
+        assert(stats.frames > 0);
+        assert(stats.overruns == stats.frames);
+        assert(stats.skipped_frames >= 2 * stats.overruns);
+        assert(stats.max_frame_ns >= 5'000'000);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(reported.size() == stats.overruns);
+        for (const auto& overrun : reported) {
+            assert(overrun.release_ns % minor_ns == 0);
+            assert(overrun.end_ns > overrun.release_ns + minor_ns);
+            assert(overrun.skipped >= 2);
+        }
+        for (std::size_t i = 1; i < reported.size(); ++i) {
+            // Next release after the skipped ones
+            assert(reported[i].release_ns == reported[i - 1].release_ns + (reported[i - 1].skipped + 1) * minor_ns);
+        }
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Release sleeps
+    {
+        std::cout << "Test 4: Time::sleep_until() per clock source\n";
+
+        for (auto source : {Time::ClockSource::STEADY_CLOCK, Time::ClockSource::MONOTONIC_CLOCK,
+                            Time::ClockSource::TSC, Time::ClockSource::SYSTEM_CLOCK}) {
+            Time::set_clock_source(source);
+            uint64_t max_late = 0;
+            for (int i = 0; i < 20; ++i) {
+                const uint64_t deadline = Time::next_tick(Time::now() + 500'000, minor_ns, 0);
+                Time::sleep_until(deadline);
+                const uint64_t woke = Time::now();
+                assert(woke >= deadline);
+                max_late = std::max(max_late, woke - deadline);
+            }
+            const uint64_t before = Time::now();
+            Time::sleep_until(before - 1'000'000);  // Already passed
+            assert(Time::now() - before < 1'000'000);
+            std::cout << "  source " << static_cast<int>(source) << ": max " << max_late / 1000 << "us late\n";
+        }
+        Time::set_clock_source(Time::ClockSource::STEADY_CLOCK);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 5: Stop before and between releases
+    {
+        std::cout << "Test 5: stop() does not wait for the release\n";
+
+        // Major frame 1s: the first release is up to 1s away
+        TickSource tick(source_config("CycStop", 76));
+        CyclicExecutive executive(test_schedule({{.module = "tick", .period = Microseconds(1'000'000)}}));
+        executive.add("tick", tick);
+        executive.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto stop_start = std::chrono::steady_clock::now();
+        executive.stop();
+        const auto stop_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - stop_start).count();
+        std::cout << "  real time: stop() took " << stop_ms << "ms\n";
+        assert(stop_ms < 100);
+
+        // Simulated time advances only between frames and stop() needs no controller
+        constexpr uint64_t sim_start_ns = 1'000 * minor_ns;
+        Time::set_clock_source(Time::ClockSource::SIMULATED);
+        SimulatedClock::reset(sim_start_ns);
+        TickSource sim_tick(source_config("CycSimStop", 77));
+        CyclicExecutive sim_executive(test_schedule({{.module = "tick", .period = Microseconds(2000)}}));
+        sim_executive.add("tick", sim_tick);
+        sim_executive.start();
+        const auto run = SimulatedClock::run_until(sim_start_ns + 10 * minor_ns);
+        sim_executive.stop();
+        const auto stats = sim_executive.stats();
+        std::cout << "  simulated time: " << stats.frames << " frames in 10 minor frames\n";
+        assert(run.forced == 0);
+        assert(stats.frames == 10);
+        assert(stats.overruns == 0);
+        Time::set_clock_source(Time::ClockSource::STEADY_CLOCK);
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Cyclic Executive Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,252 @@
+/**
+ * @file test_flight_recorder.cpp
+ * @brief Test the in-memory flight recorder and its dump triggers
+ *
+ * Validates:
+ * - Sent and received module traffic is captured and dumped as a readable
+ *   recording (stream per direction/type/mailbox, LOG_FLAG_* set)
+ * - Ring wrap-around keeps only the most recent records, all intact
+ * - The time window limits what is dumped
+ * - Dumps on SIGUSR1, on FlightDumpRequest to a module, and on a fatal
+ *   signal (child process aborts)
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/flight_recorder.hpp>
+#include <commrat/recording/log_reader.hpp>
+#include <commrat/mailbox/request_client.hpp>
+#include "recording_test_fixtures.hpp"
+#include <cassert>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace commrat;
+
+using FlightApp = CommRaT<
+    Message::Data<SampleA>
+>;
+
+namespace {
+
+constexpr uint8_t source_system = 70;
+
+std::string make_dump_dir(const char* name) {
+    const std::string dir = make_test_dir("flight", name);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+/// Sequence numbers of SampleA records in a dump, per direction flag
+struct DumpContents {
+    std::vector<uint64_t> sent;
+    std::vector<uint64_t> received;
+    std::size_t records{0};
+    std::size_t streams{0};
+};
+
+DumpContents read_dump(const std::string& path) {
+    DumpContents contents;
+    LogSegmentReader reader(path);
+    contents.streams = reader.streams().size();
+    while (auto record = reader.next()) {
+        ++contents.records;
+        const LogStreamInfo* stream = reader.stream(record->stream_id);
+        assert(stream != nullptr);
+        assert(record->header().msg_type == stream->message_id);
+        const bool sent = record->flags == LOG_FLAG_SENT;
+        assert(sent || record->flags == LOG_FLAG_RECEIVED);
+        assert(std::string(stream->name).starts_with(sent ? "tx 0x" : "rx 0x"));
+
+        FlightApp::visit(stream->message_id, record->wire, [&](auto& msg) {
+            using Payload = std::decay_t<decltype(msg.payload)>;
+            if constexpr (std::is_same_v<Payload, SampleA>) {
+                (sent ? contents.sent : contents.received).push_back(msg.payload.seq);
+            }
+        });
+    }
+    return contents;
+}
+
+bool consecutive(const std::vector<uint64_t>& seqs) {
+    for (std::size_t i = 1; i < seqs.size(); ++i) {
+        if (seqs[i] != seqs[i - 1] + 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Pred>
+bool wait_for(Pred pred, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Flight Recorder Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1 (first: forks before this process starts any thread)
+    {
+        std::cout << "Test 1: Dump on fatal signal\n";
+
+        const std::string dir = make_dump_dir("fatal");
+        const pid_t child = ::fork();
+        if (child == 0) {
+            FlightRecorder flight(FlightRecorderConfig{.directory = dir, .prefix = "crash",
+                                                       .buffer_bytes = 1024 * 1024, .dump_on_sigusr1 = false});
+            FlightApp::Mailbox<SampleA> a(MailboxConfig{.mailbox_id = 0x7001, .mailbox_name = "a"});
+            FlightApp::Mailbox<SampleA> b(MailboxConfig{.mailbox_id = 0x7002, .mailbox_name = "b"});
+            a.start();
+            b.start();
+            for (uint64_t seq = 1; seq <= 5; ++seq) {
+                SampleA sample{.seq = seq};
+                a.send(sample, 0x7002);
+                b.template receive<SampleA>();
+            }
+            std::abort();
+        }
+        int status = 0;
+        ::waitpid(child, &status, 0);
+        assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+
+        auto dumps = list_log_segments(dir, "crash_" + std::to_string(child) + "_0");
+        assert(dumps.size() == 1);
+        auto contents = read_dump(dumps[0]);
+        assert((contents.sent == std::vector<uint64_t>{1, 2, 3, 4, 5}));
+        assert((contents.received == std::vector<uint64_t>{1, 2, 3, 4, 5}));
+        assert(contents.streams == 2);
+
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    // Test 2: Module traffic, dump() and FlightDumpRequest
+    {
+        std::cout << "Test 2: Module traffic and dump command\n";
+
+        const std::string dir = make_dump_dir("modules");
+        FlightRecorder flight(FlightRecorderConfig{.directory = dir, .prefix = "mod",
+                                                   .buffer_bytes = 4 * 1024 * 1024,
+                                                   .schema = FlightApp::Introspection::export_all()});
+        assert(FlightRecorder::active() == &flight);
+
+        SourceA<FlightApp> source(periodic_config("FlightSource", source_system, std::chrono::milliseconds(1)));
+        SinkA<FlightApp> sink(sink_config("FlightSink", 71, source_system));
+        source.start();
+        sink.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        auto result = flight.dump();
+        assert(result.success);
+        auto contents = read_dump(result.path);
+        assert(contents.sent.size() >= 50);
+        assert(!contents.received.empty());
+        assert(consecutive(contents.sent));
+        assert(consecutive(contents.received));
+        LogSegmentReader reader(result.path);
+        assert(reader.schema() == FlightApp::Introspection::export_all());
+
+        // Same dump through a module's WORK mailbox
+        RequestClient<SystemRegistry> client(MailboxConfig{
+            .mailbox_id = 0x7100,
+            .max_message_size = SystemRegistry::max_message_size,
+            .mailbox_name = "FlightClient"
+        });
+        client.start();
+        const uint32_t source_work = producer_work_mailbox(FlightApp::get_message_id<SampleA>(), source_system, 0);
+        auto reply = client.send_request(FlightDumpRequestPayload{}, source_work,
+                                         std::chrono::milliseconds(2000)).get();
+        assert(reply && reply->success);
+        assert(std::filesystem::exists(std::string(reply->path.view())));
+        assert(std::string(reply->path.view()) != result.path);
+        client.stop();
+
+        sink.stop();
+        source.stop();
+        assert(flight.stats().captured > 0);
+
+        std::cout << "  " << contents.records << " records in " << contents.streams << " streams, "
+                  << "command dump: " << reply->records << " records\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+    assert(FlightRecorder::active() == nullptr);
+
+    // Test 3: Ring wrap-around and time window
+    {
+        std::cout << "Test 3: Wrap-around and window\n";
+
+        const std::string dir = make_dump_dir("wrap");
+        FlightRecorder flight(FlightRecorderConfig{.directory = dir, .prefix = "wrap",
+                                                   .buffer_bytes = 64 * 1024, .max_records = 64,
+                                                   .window = std::chrono::milliseconds(100),
+                                                   .dump_on_sigusr1 = false});
+        FlightApp::Mailbox<SampleA> a(MailboxConfig{.mailbox_id = 0x7201, .mailbox_name = "wrap_a"});
+        FlightApp::Mailbox<SampleA> b(MailboxConfig{.mailbox_id = 0x7202, .mailbox_name = "wrap_b"});
+        a.start();
+        b.start();
+        for (uint64_t seq = 1; seq <= 1000; ++seq) {
+            SampleA sample{.seq = seq};
+            a.send(sample, 0x7202);
+            b.template receive<SampleA>();
+        }
+
+        auto contents = read_dump(flight.dump().path);
+        assert(contents.records <= 64);
+        assert(contents.records >= 60);
+        assert(consecutive(contents.sent) && consecutive(contents.received));
+        assert(contents.received.back() == 1000);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        auto expired = flight.dump();
+        assert(expired.success && expired.records == 0);
+
+        std::cout << "  kept " << contents.records << " of 2000 records\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    // Test 4: SIGUSR1
+    {
+        std::cout << "Test 4: Dump on SIGUSR1\n";
+
+        const std::string dir = make_dump_dir("sigusr1");
+        FlightRecorder flight(FlightRecorderConfig{.directory = dir, .prefix = "usr",
+                                                   .buffer_bytes = 1024 * 1024});
+        FlightApp::Mailbox<SampleA> a(MailboxConfig{.mailbox_id = 0x7301, .mailbox_name = "usr_a"});
+        FlightApp::Mailbox<SampleA> b(MailboxConfig{.mailbox_id = 0x7302, .mailbox_name = "usr_b"});
+        a.start();
+        b.start();
+        SampleA sample{.seq = 42};
+        a.send(sample, 0x7302);
+        b.template receive<SampleA>();
+
+        ::raise(SIGUSR1);
+        const std::string prefix = "usr_" + std::to_string(::getpid()) + "_0";
+        bool dumped = wait_for([&] {
+            auto dumps = list_log_segments(dir, prefix);
+            return !dumps.empty() && flight.stats().dumps == 1 && read_dump(dumps[0]).records == 2;
+        }, std::chrono::milliseconds(2000));
+        assert(dumped);
+
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    std::cout << "=== All Flight Recorder Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,493 @@
+/**
+ * @file test_hot_path_allocations.cpp
+ * @brief Verify that module loops do not allocate in steady state
+ *
+ * Interposes malloc/calloc/realloc (operator new allocates through malloc)
+ * and counts allocations of every thread except the test's main thread
+ * while a measurement window is open. Each scenario starts real modules on
+ * the loopback transport, lets them reach steady state, then asserts zero
+ * allocations over several hundred loop iterations:
+ * - periodic loop -> continuous loop -> continuous loop
+ * - multi-input loop (primary + secondary, history buffers)
+ * - multi-output periodic loop with one subscriber per output
+ * - command loop: FIFO, latest-wins and request/reply commands, plus the
+ *   requester's receive_any_raw()
+ *
+ * On failure the first allocation call sites are printed with thread name,
+ * size and backtrace (resolve with addr2line or c++filt).
+ *
+ * Requires glibc (__libc_malloc).
+ */
+
+#include <commrat/commrat.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <execinfo.h>
+#include <iostream>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace commrat;
+
+// ============================================================================
+// Allocation Interposer
+// ============================================================================
+
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+}
+
+namespace {
+
+struct AllocationSite {
+    long tid{0};
+    char thread_name[16]{};
+    std::size_t size{0};
+    std::array<void*, 24> frames{};
+    int depth{0};
+};
+
+constexpr std::size_t max_reported_sites = 4;
+
+std::atomic<bool> g_armed{false};
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint32_t> g_site_count{0};
+std::array<AllocationSite, max_reported_sites> g_sites{};
+
+thread_local bool t_untracked = false;  // Main thread, set in main()
+thread_local bool t_in_hook = false;    // backtrace() may allocate
+
+void note_allocation(std::size_t size) {
+    if (!g_armed.load(std::memory_order_relaxed) || t_untracked || t_in_hook) {
+        return;
+    }
+    t_in_hook = true;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const uint32_t index = g_site_count.fetch_add(1, std::memory_order_relaxed);
+    if (index < g_sites.size()) {
+        auto& site = g_sites[index];
+        site.tid = static_cast<long>(syscall(SYS_gettid));
+        pthread_getname_np(pthread_self(), site.thread_name, sizeof(site.thread_name));
+        site.size = size;
+        site.depth = backtrace(site.frames.data(), static_cast<int>(site.frames.size()));
+    }
+    t_in_hook = false;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(std::size_t size) noexcept {
+    note_allocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+    note_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept {
+    note_allocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+namespace {
+
+/**
+ * @brief Counts allocations of all tracked threads while open
+ */
+class AllocationWindow {
+public:
+    AllocationWindow() {
+        g_allocations.store(0);
+        g_site_count.store(0);
+        g_armed.store(true);
+    }
+
+    ~AllocationWindow() { close(); }
+
+    uint64_t close() {
+        g_armed.store(false);
+        return g_allocations.load();
+    }
+};
+
+/**
+ * @brief Track the main thread's allocations inside a scope
+ */
+struct TrackedScope {
+    TrackedScope() { t_untracked = false; }
+    ~TrackedScope() { t_untracked = true; }
+};
+
+void report_sites() {
+    const uint32_t count = std::min<uint32_t>(g_site_count.load(), max_reported_sites);
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto& site = g_sites[i];
+        std::cerr << "  allocation of " << site.size << " bytes on thread " << site.tid
+                  << " (" << site.thread_name << "):\n";
+        backtrace_symbols_fd(site.frames.data(), site.depth, STDERR_FILENO);
+    }
+}
+
+/**
+ * @brief Assert zero allocations over a measured number of loop iterations
+ */
+void check_scenario(const char* name, uint64_t iterations, uint64_t allocations) {
+    std::cout << "  " << iterations << " iterations, " << allocations << " allocations\n";
+    if (allocations != 0) {
+        std::cerr << "[" << name << "] " << allocations << " allocation(s) in steady state, first call sites:\n";
+        report_sites();
+    }
+    assert(iterations >= 100);
+    assert(allocations == 0);
+    std::cout << "  PASS\n\n";
+}
+
+// ============================================================================
+// Application
+// ============================================================================
+
+struct SampleA {
+    uint64_t seq{0};
+    double value{0.0};
+};
+
+struct SampleB {
+    uint64_t seq{0};
+    std::array<float, 8> values{};
+};
+
+struct TuneCmd {
+    float gain{1.0f};
+};
+
+struct SetpointCmd {
+    float target{0.0f};
+};
+
+struct GetStateCmd {
+    uint32_t token{0};
+};
+
+struct StateReply {
+    uint32_t token{0};
+    float gain{0.0f};
+    float target{0.0f};
+};
+
+using GetStateReq = Message::Command<GetStateCmd>;
+
+using AllocApp = CommRaT<
+    Message::Data<SampleA>,
+    Message::Data<SampleB>,
+    Message::Command<TuneCmd>,
+    Message::Command<SetpointCmd, Coalesce::Latest>,
+    GetStateReq,
+    Message::Reply<GetStateReq, StateReply>
+>;
+
+constexpr auto period = std::chrono::milliseconds(1);
+constexpr auto warmup = std::chrono::milliseconds(300);
+constexpr auto measure = std::chrono::milliseconds(500);
+
+class SourceA : public AllocApp::Module<Output<SampleA>, PeriodicInput> {
+public:
+    using AllocApp::Module<Output<SampleA>, PeriodicInput>::Module;
+
+protected:
+    void process(SampleA& output) override {
+        output.seq = ++seq_;
+        output.value = static_cast<double>(seq_) * 0.5;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class SourceB : public AllocApp::Module<Output<SampleB>, PeriodicInput> {
+public:
+    using AllocApp::Module<Output<SampleB>, PeriodicInput>::Module;
+
+protected:
+    void process(SampleB& output) override {
+        output.seq = ++seq_;
+        output.values.fill(static_cast<float>(seq_));
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class FilterA : public AllocApp::Module<Output<SampleA>, Input<SampleA>> {
+public:
+    using AllocApp::Module<Output<SampleA>, Input<SampleA>>::Module;
+
+protected:
+    void process(const SampleA& input, SampleA& output) override {
+        output = input;
+        output.value *= 2.0;
+    }
+};
+
+class Fusion : public AllocApp::Module<Output<SampleA>, Inputs<SampleA, SampleB>> {
+public:
+    using AllocApp::Module<Output<SampleA>, Inputs<SampleA, SampleB>>::Module;
+
+protected:
+    void process(const SampleA& a, const SampleB& b, SampleA& output) override {
+        output.seq = a.seq;
+        output.value = a.value + static_cast<double>(b.values[0]);
+    }
+};
+
+class DualSource : public AllocApp::Module<Outputs<SampleA, SampleB>, PeriodicInput> {
+public:
+    using AllocApp::Module<Outputs<SampleA, SampleB>, PeriodicInput>::Module;
+
+protected:
+    void process(SampleA& a, SampleB& b) override {
+        ++seq_;
+        a.seq = seq_;
+        b.seq = seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class SinkB : public AllocApp::Module<Output<SampleB>, Input<SampleB>> {
+public:
+    using AllocApp::Module<Output<SampleB>, Input<SampleB>>::Module;
+
+protected:
+    void process(const SampleB& input, SampleB& output) override {
+        output = input;
+    }
+};
+
+class CommandTarget
+    : public AllocApp::Module<Output<SampleA>, PeriodicInput, TuneCmd, SetpointCmd, GetStateCmd> {
+public:
+    using AllocApp::Module<Output<SampleA>, PeriodicInput, TuneCmd, SetpointCmd, GetStateCmd>::Module;
+
+    uint64_t commands() const { return commands_.load(); }
+
+    void on_command(const TuneCmd& cmd) override {
+        gain_ = cmd.gain;
+        commands_.fetch_add(1);
+    }
+
+    void on_command(const SetpointCmd& cmd) override {
+        target_ = cmd.target;
+        commands_.fetch_add(1);
+    }
+
+    StateReply on_command(const GetStateCmd& cmd) override {
+        commands_.fetch_add(1);
+        return StateReply{.token = cmd.token, .gain = gain_, .target = target_};
+    }
+
+protected:
+    void process(SampleA& output) override {
+        output.value = static_cast<double>(gain_) * target_;
+    }
+
+private:
+    std::atomic<uint64_t> commands_{0};
+    float gain_{1.0f};
+    float target_{0.0f};
+};
+
+ModuleConfig source_config(const char* name, uint8_t system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = NoInputConfig{},
+        .period = period
+    };
+}
+
+ModuleConfig input_config(const char* name, uint8_t system_id, uint8_t source_system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = SingleInputConfig{.source_system_id = source_system_id, .source_instance_id = 0}
+    };
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Hot Path Allocation Tests ===\n\n";
+    t_untracked = true;
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // First backtrace() loads the unwinder (allocates); do it outside any window
+    std::array<void*, 4> frames{};
+    backtrace(frames.data(), static_cast<int>(frames.size()));
+
+    // Test 1: Periodic and continuous loops
+    {
+        std::cout << "Test 1: Periodic -> continuous -> continuous\n";
+        SourceA source(source_config("AllocSource", 10));
+        FilterA filter(input_config("AllocFilter", 11, 10));
+        FilterA sink(input_config("AllocSink", 12, 11));
+        source.start();
+        filter.start();
+        sink.start();
+        std::this_thread::sleep_for(warmup);
+
+        const uint64_t before = source.metrics().iterations() + filter.metrics().iterations() +
+                                sink.metrics().iterations();
+        AllocationWindow window;
+        std::this_thread::sleep_for(measure);
+        const uint64_t allocations = window.close();
+        const uint64_t iterations = source.metrics().iterations() + filter.metrics().iterations() +
+                                    sink.metrics().iterations() - before;
+
+        sink.stop();
+        filter.stop();
+        source.stop();
+        check_scenario("periodic/continuous", iterations, allocations);
+    }
+
+    // Test 2: Multi-input loop
+    {
+        std::cout << "Test 2: Multi-input (primary + secondary history)\n";
+        SourceA source_a(source_config("AllocPrimary", 20));
+        SourceB source_b(source_config("AllocSecondary", 21));
+        Fusion fusion(ModuleConfig{
+            .name = "AllocFusion",
+            .outputs = SimpleOutputConfig{.system_id = 22, .instance_id = 0},
+            .inputs = MultiInputConfig{
+                .sources = {
+                    {.system_id = 20, .instance_id = 0},
+                    {.system_id = 21, .instance_id = 0}
+                },
+                .history_buffer_size = 100,
+                .sync_tolerance = std::chrono::milliseconds(20)
+            }
+        });
+        source_a.start();
+        source_b.start();
+        fusion.start();
+        std::this_thread::sleep_for(warmup);
+
+        const uint64_t before = fusion.metrics().iterations();
+        AllocationWindow window;
+        std::this_thread::sleep_for(measure);
+        const uint64_t allocations = window.close();
+        const uint64_t iterations = fusion.metrics().iterations() - before;
+
+        fusion.stop();
+        source_b.stop();
+        source_a.stop();
+        check_scenario("multi-input", iterations, allocations);
+    }
+
+    // Test 3: Multi-output loop
+    {
+        std::cout << "Test 3: Multi-output -> one subscriber per output\n";
+        DualSource source(source_config("AllocDual", 30));
+        FilterA sink_a(input_config("AllocDualA", 31, 30));
+        SinkB sink_b(input_config("AllocDualB", 32, 30));
+        source.start();
+        sink_a.start();
+        sink_b.start();
+        std::this_thread::sleep_for(warmup);
+
+        const uint64_t before = sink_a.metrics().iterations() + sink_b.metrics().iterations();
+        AllocationWindow window;
+        std::this_thread::sleep_for(measure);
+        const uint64_t allocations = window.close();
+        const uint64_t iterations = sink_a.metrics().iterations() + sink_b.metrics().iterations() - before;
+
+        sink_b.stop();
+        sink_a.stop();
+        source.stop();
+        check_scenario("multi-output", iterations, allocations);
+    }
+
+    // Test 4: Command loop (FIFO, latest-wins, request/reply)
+    {
+        std::cout << "Test 4: Command loop\n";
+        CommandTarget target(source_config("AllocCommands", 40));
+        target.start();
+
+        AllocApp::Mailbox<GetStateCmd> requester(MailboxConfig{
+            .mailbox_id = 0x00E00001,
+            .message_slots = 10,
+            .max_message_size = AllocApp::max_message_size,
+            .send_priority = 10,
+            .realtime = false,
+            .mailbox_name = "alloc_requester"
+        });
+        bool started = static_cast<bool>(requester.start());
+        assert(started);
+        const uint32_t cmd_mailbox = target.get_cmd_mailbox_public<0>().get_underlying_mailbox().mailbox_id();
+
+        uint32_t token = 0;
+        uint64_t replies = 0;
+        auto exchange = [&]() {
+            TuneCmd tune{.gain = 2.0f};
+            requester.send(tune, cmd_mailbox);
+            for (int i = 0; i < 4; ++i) {
+                SetpointCmd setpoint{.target = static_cast<float>(i)};
+                requester.send(setpoint, cmd_mailbox);
+            }
+            TimsMessage<GetStateCmd> request{
+                .header = {
+                    .msg_type = AllocApp::get_message_id<GetStateCmd>(),
+                    .msg_size = 0,
+                    .timestamp = Time::now(),
+                    .seq_number = 0,
+                    .flags = 0,
+                    .correlation_id = ++token,
+                    .reply_to = requester.mailbox_id()
+                },
+                .payload = {.token = token}
+            };
+            requester.underlying().send(request, cmd_mailbox);
+
+            TrackedScope tracked;  // Reply path of the requester must not allocate either
+            auto reply = requester.underlying().receive_any_raw(std::chrono::milliseconds(100));
+            if (reply && reply->header.msg_type == AllocApp::get_message_id<StateReply>()) {
+                ++replies;
+            }
+        };
+
+        for (int i = 0; i < 20; ++i) {
+            exchange();
+        }
+
+        const uint64_t before = target.commands();
+        AllocationWindow window;
+        const auto end = std::chrono::steady_clock::now() + measure;
+        while (std::chrono::steady_clock::now() < end) {
+            exchange();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const uint64_t allocations = window.close();
+        const uint64_t commands = target.commands() - before;
+
+        std::cout << "  " << replies << " replies\n";
+        assert(replies > 20);
+        requester.stop();
+        target.stop();
+        check_scenario("command", commands, allocations);
+    }
+
+    std::cout << "=== All Hot Path Allocation Tests PASSED ===\n";
+    return 0;
+}
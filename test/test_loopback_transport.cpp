@@ -0,0 +1,156 @@
+/**
+ * @file test_loopback_transport.cpp
+ * @brief Test the in-process loopback transport (no TiMS router required)
+ *
+ * Validates:
+ * - Typed send/receive between two mailboxes
+ * - receive_any() dispatch
+ * - try_receive() on an empty mailbox
+ * - QueueFull when the destination slots are exhausted
+ * - Unknown destinations and duplicate mailbox IDs
+ * - stop() wakes a blocked receiver
+ */
+
+#include <commrat/commrat.hpp>
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace commrat;
+
+struct PingData {
+    uint64_t seq{0};
+};
+
+struct PongData {
+    uint32_t value{0};
+};
+
+using TestRegistry = MessageRegistry<
+    MessageDefinition<PingData, MessagePrefix::UserDefined, UserSubPrefix::Data>,
+    MessageDefinition<PongData, MessagePrefix::UserDefined, UserSubPrefix::Data>
+>;
+using TestMailbox = RegistryMailbox<TestRegistry>;
+
+MailboxConfig make_config(uint32_t id) {
+    return MailboxConfig{
+        .mailbox_id = id,
+        .message_slots = 10,
+        .max_message_size = TestRegistry::max_message_size,
+        .send_priority = 10,
+        .realtime = false,
+        .mailbox_name = "loopback_test"
+    };
+}
+
+int main() {
+    std::cout << "=== Loopback Transport Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+    assert(TimsWrapper::transport() == TimsTransport::Loopback);
+
+    TestMailbox tx(make_config(0x7000));
+    TestMailbox rx(make_config(0x7001));
+    bool started = tx.start() && rx.start();
+    assert(started);
+
+    // Test 1: Send/receive
+    {
+        std::cout << "Test 1: Send and receive\n";
+
+        PingData ping{.seq = 42};
+        bool sent = static_cast<bool>(tx.send(ping, rx.mailbox_id(), 1234));
+        assert(sent);
+        auto received = rx.receive<PingData>();
+        assert(received);
+        assert(received->payload.seq == 42);
+        assert(received->header.timestamp == 1234);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: receive_any / try_receive
+    {
+        std::cout << "Test 2: receive_any and try_receive\n";
+
+        auto empty = rx.try_receive<PingData>();
+        assert(!empty && empty.error() == MailboxError::Timeout);
+
+        PongData pong{.value = 7};
+        bool sent = static_cast<bool>(tx.send(pong, rx.mailbox_id()));
+        assert(sent);
+        uint32_t value = 0;
+        auto dispatched = rx.receive_any([&](auto&& msg) {
+            using MsgT = std::decay_t<decltype(msg)>;
+            if constexpr (std::is_same_v<MsgT, TimsMessage<PongData>>) {
+                value = msg.payload.value;
+            }
+        });
+        assert(dispatched && value == 7);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Bounded slots
+    {
+        std::cout << "Test 3: QueueFull when slots are exhausted\n";
+
+        PingData ping{};
+        int sent = 0;
+        while (tx.send(ping, rx.mailbox_id())) {
+            sent++;
+            assert(sent <= 10);
+        }
+        assert(sent == 10);
+        auto full = tx.send(ping, rx.mailbox_id());
+        assert(full.get_error() == MailboxError::QueueFull);
+
+        // Draining frees the slots
+        while (rx.try_receive<PingData>()) {
+            sent--;
+        }
+        assert(sent == 0);
+        bool resent = static_cast<bool>(tx.send(ping, rx.mailbox_id()));
+        auto drained = rx.try_receive<PingData>();
+        assert(resent && drained);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Addressing errors
+    {
+        std::cout << "Test 4: Unknown destination and duplicate ID\n";
+
+        PingData ping{};
+        auto unknown = tx.send(ping, 0x7FFF);
+        assert(!unknown && unknown.get_error() == MailboxError::NetworkError);
+
+        TestMailbox duplicate(make_config(0x7001));
+        auto duplicate_start = duplicate.start();
+        assert(!duplicate_start);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 5: stop() wakes a blocked receiver
+    {
+        std::cout << "Test 5: stop() wakes blocked receiver\n";
+
+        TestMailbox blocking(make_config(0x7002));
+        bool blocking_started = static_cast<bool>(blocking.start());
+        assert(blocking_started);
+        std::thread receiver([&]() {
+            auto result = blocking.receive<PingData>();
+            assert(!result);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto start = std::chrono::steady_clock::now();
+        blocking.stop();
+        receiver.join();
+        assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Loopback Transport Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file test_module_data_path.cpp
+ * @brief Regression tests for the module data path (loopback transport)
+ *
+ * Validates:
+ * - A single-input module opens its data mailbox at
+ *   get_data_mbx_base(num_outputs), the index its SubscribeRequest asks
+ *   producers to send to (it used to open MailboxType::DATA and never
+ *   received anything)
+ * - Send-only output mailboxes are sized for their send types, so payloads
+ *   larger than the old fixed 64-byte buffer are published and received
+ */
+
+#include <commrat/commrat.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace commrat;
+
+struct Small {
+    uint64_t value{0};
+};
+
+/// Far larger than the old 64-byte send-only buffer
+struct Frame {
+    uint64_t seq{0};
+    std::array<uint8_t, 1024> pixels{};
+};
+
+using PathApp = CommRaT<
+    Message::Data<Small>,
+    Message::Data<Frame>
+>;
+
+/// No commands: its CMD mailbox is send-only
+class FrameSource : public PathApp::Module<Output<Frame>, PeriodicInput> {
+public:
+    using PathApp::Module<Output<Frame>, PeriodicInput>::Module;
+
+protected:
+    void process(Frame& output) override {
+        output.seq = ++seq_;
+        output.pixels.fill(static_cast<uint8_t>(seq_));
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class FrameSink : public PathApp::Module<Output<Small>, Input<Frame>> {
+public:
+    using PathApp::Module<Output<Small>, Input<Frame>>::Module;
+
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> corrupt{0};
+
+protected:
+    void process(const Frame& input, Small& output) override {
+        for (uint8_t p : input.pixels) {
+            if (p != static_cast<uint8_t>(input.seq)) {
+                ++corrupt;
+                break;
+            }
+        }
+        output.value = input.seq;
+        ++received;
+    }
+};
+
+namespace {
+
+ModuleConfig sink_config(const char* name, uint8_t system_id, uint8_t source_system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = SingleInputConfig{.source_system_id = source_system_id, .source_instance_id = 0}
+    };
+}
+
+bool wait_for(const std::atomic<uint64_t>& counter, uint64_t count) {
+    for (int i = 0; i < 200 && counter < count; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return counter >= count;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Module Data Path Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Data mailbox index matches the subscription
+    {
+        std::cout << "Test 1: Single-input data mailbox address\n";
+
+        // Hand-made producer of Frame on system 82: receives the subscription,
+        // then sends to the address it names
+        constexpr uint32_t producer_base =
+            ((PathApp::get_message_id<Frame>() & 0xFFFF) << 16) | (82u << 8);
+        RegistryMailbox<SystemRegistry> producer_work(MailboxConfig{
+            .mailbox_id = producer_base + static_cast<uint8_t>(MailboxType::WORK),
+            .mailbox_name = "path_producer_work"
+        });
+        bool started = static_cast<bool>(producer_work.start());
+        PathApp::Mailbox<Frame> sender(MailboxConfig{
+            .mailbox_id = producer_base + 0x20,
+            .mailbox_name = "path_producer_send"
+        });
+        started = static_cast<bool>(sender.start()) && started;
+        assert(started);
+
+        FrameSink sink(sink_config("PathAddrSink", 83, 82));
+        sink.start();
+        auto request = producer_work.receive_for<SubscribeRequestPayload>(std::chrono::milliseconds(2000));
+        assert(request);
+        assert(request->payload.mailbox_index == get_data_mbx_base(1));
+        assert(request->payload.mailbox_index != static_cast<uint8_t>(MailboxType::DATA));
+
+        Frame frame{.seq = 7};
+        frame.pixels.fill(7);
+        bool sent = static_cast<bool>(
+            sender.send(frame, request->payload.subscriber_base_addr | request->payload.mailbox_index));
+        assert(sent);
+        bool received = wait_for(sink.received, 1);
+        assert(received && sink.corrupt == 0);
+
+        sink.stop();
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Large payloads through a send-only output mailbox
+    {
+        std::cout << "Test 2: Send-only mailbox sizing\n";
+
+        using SendOnlyFrame = TypedMailbox<PathApp::Registry, SendOnlyTypes<Frame>>;
+        static_assert(SendOnlyFrame::max_message_size >=
+                      sertial::Message<TimsMessage<Frame>>::max_buffer_size);
+        static_assert(SendOnlyFrame::max_message_size > 64);
+
+        FrameSource source(ModuleConfig{
+            .name = "PathSource",
+            .outputs = SimpleOutputConfig{.system_id = 84, .instance_id = 0},
+            .inputs = NoInputConfig{},
+            .period = std::chrono::milliseconds(5)
+        });
+        FrameSink sink(sink_config("PathSizeSink", 85, 84));
+        source.start();
+        sink.start();
+        bool received = wait_for(sink.received, 10);
+        sink.stop();
+        source.stop();
+
+        std::cout << "  received " << sink.received << " frames of " << sizeof(Frame) << " bytes\n";
+        assert(received && sink.corrupt == 0);
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Module Data Path Tests PASSED ===\n";
+    return 0;
+}
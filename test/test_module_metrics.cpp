@@ -0,0 +1,218 @@
+/**
+ * @file test_module_metrics.cpp
+ * @brief Test per-module runtime metrics (no TiMS required)
+ *
+ * Validates:
+ * - Cache-line padding of per-thread metrics
+ * - Log-linear histogram buckets and percentiles
+ * - Loop interval / period jitter recording
+ * - Per-input and per-subscriber counters (drops on QueueFull)
+ * - Thread CPU time while attached and after detach
+ * - StatsReply snapshot via fill_stats()
+ */
+
+#include "commrat/module/metrics/module_metrics.hpp"
+#include "commrat/messaging/system/system_registry.hpp"
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace commrat;
+
+int main() {
+    std::cout << "=== Module Metrics Tests ===\n\n";
+
+    // Test 1: Padding
+    {
+        std::cout << "Test 1: Cache-line padding\n";
+
+        static_assert(alignof(PaddedCounter) == cache_line_size);
+        static_assert(sizeof(PaddedCounter) == cache_line_size);
+        static_assert(alignof(LatencyHistogram) == cache_line_size);
+        static_assert(alignof(ThreadCpuClock) == cache_line_size);
+        static_assert(alignof(ModuleMetrics<3, 1>::InputCounters) == cache_line_size);
+        static_assert(alignof(ModuleMetrics<3, 1>::SubscriberCounters) == cache_line_size);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Histogram buckets
+    {
+        std::cout << "Test 2: Histogram bucket layout\n";
+
+        // Exact below 8, then 8 sub-buckets per power of two
+        for (uint64_t v = 0; v < 16; ++v) {
+            assert(LatencyHistogram::bucket_index(v) == v);
+            assert(LatencyHistogram::bucket_upper_bound(v) == v);
+        }
+        static_assert(LatencyHistogram::bucket_index(UINT64_MAX) == LatencyHistogram::num_buckets - 1);
+
+        // Every value lies within its bucket, relative error <= 12.5%
+        for (uint64_t v : {17ull, 100ull, 1'000ull, 123'456ull, 10'000'000ull, 1ull << 40}) {
+            std::size_t idx = LatencyHistogram::bucket_index(v);
+            uint64_t upper = LatencyHistogram::bucket_upper_bound(idx);
+            uint64_t lower = LatencyHistogram::bucket_upper_bound(idx - 1) + 1;
+            assert(v >= lower && v <= upper);
+            assert(static_cast<double>(upper - lower) <= 0.125 * static_cast<double>(lower));
+        }
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Percentiles
+    {
+        std::cout << "Test 3: Histogram percentiles\n";
+
+        LatencyHistogram hist;
+        assert(hist.summary().count == 0);
+        assert(hist.percentile(0.5) == 0);
+
+        for (uint64_t v = 1; v <= 1000; ++v) {
+            hist.record(v * 1000);  // 1us .. 1ms
+        }
+
+        LatencyStats stats = hist.summary();
+        assert(stats.count == 1000);
+        assert(stats.min_ns == 1000);
+        assert(stats.max_ns == 1'000'000);
+        assert(stats.mean_ns == 500'500);
+        assert(stats.p50_ns >= 500'000 && stats.p50_ns <= 500'000 * 9 / 8);
+        assert(stats.p99_ns >= 990'000 && stats.p99_ns <= 1'000'000);
+        assert(stats.p999_ns <= stats.max_ns);
+
+        // Merging per-thread histograms keeps count, extremes and mean
+        LatencyHistogram other;
+        other.record(10);
+        other.record(2'000'000);
+        LatencyHistogram merged;
+        merged.merge(hist);
+        merged.merge(other);
+        LatencyStats merged_stats = merged.summary();
+        assert(merged_stats.count == 1002);
+        assert(merged_stats.min_ns == 10);
+        assert(merged_stats.max_ns == 2'000'000);
+        assert(merged_stats.mean_ns == (500'500 * 1000 + 2'000'010) / 1002);
+
+        std::cout << "  p50=" << stats.p50_ns << "ns p99=" << stats.p99_ns << "ns\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Loop, input and subscriber metrics
+    {
+        std::cout << "Test 4: Loop, input and subscriber metrics\n";
+
+        auto metrics = std::make_unique<ModuleMetrics<2, 1>>();
+        metrics->mark_started(1'000);
+
+        // Periodic loop with 10ms period, 0.5ms late on the second iteration
+        metrics->record_loop_start(1'000'000, 10'000'000);
+        metrics->record_loop_start(11'500'000, 10'000'000);
+        metrics->record_loop_start(21'500'000, 10'000'000);
+        metrics->record_process_time(100, 350);
+        assert(metrics->iterations() == 3);
+        assert(metrics->loop_interval().count() == 2);
+        assert(metrics->period_jitter().summary().max_ns == 500'000);
+        assert(metrics->process_time().summary().min_ns == 250);
+
+        metrics->record_receive(0, true);
+        metrics->record_receive(0, true);
+        metrics->record_receive(1, false);
+        metrics->record_receive(7, true);  // Out of range: ignored
+        metrics->record_sync_failure();
+
+        metrics->record_send(0x1000, MailboxResult<void>());
+        metrics->record_send(0x1000, MailboxResult<void>(MailboxError::QueueFull));
+        metrics->record_send(0x2000, MailboxResult<void>(MailboxError::NetworkError));
+
+        StatsReplyPayload stats;
+        metrics->fill_stats(stats, 2'000);
+        assert(stats.uptime_ns == 1'000);
+        assert(stats.iterations == 3);
+        assert(stats.sync_failures == 1);
+        assert(stats.inputs.size() == 2);
+        assert(stats.inputs[0].received == 2 && stats.inputs[0].receive_errors == 0);
+        assert(stats.inputs[1].received == 0 && stats.inputs[1].receive_errors == 1);
+
+        assert(stats.subscribers.size() == 2);
+        assert(stats.subscribers[0].dest_mailbox == 0x1000);
+        assert(stats.subscribers[0].sent == 1);
+        assert(stats.subscribers[0].send_failures == 1);
+        assert(stats.subscribers[0].drops == 1);
+        assert(stats.subscribers[1].send_failures == 1);
+        assert(stats.subscribers[1].drops == 0);
+
+        // Subscriber table is bounded
+        for (uint32_t dest = 1; dest <= max_stats_subscribers + 4; ++dest) {
+            metrics->record_send(0x10000 + dest, MailboxResult<void>());
+        }
+        assert(metrics->untracked_sends() == 6);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 5: Thread CPU time
+    {
+        std::cout << "Test 5: Thread CPU time\n";
+
+        auto metrics = std::make_unique<ModuleMetrics<0, 1>>();
+        std::atomic<bool> attached{false};
+        std::atomic<bool> done{false};
+
+        std::thread worker([&]() {
+            auto scope = metrics->data_thread_scope();
+            attached = true;
+            // Burn ~20ms of CPU
+            volatile uint64_t sink = 0;
+            struct timespec start, now;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+            do {
+                for (int i = 0; i < 10'000; ++i) sink = sink + i;
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+            } while ((now.tv_sec - start.tv_sec) * 1'000'000'000 + (now.tv_nsec - start.tv_nsec) < 20'000'000);
+            while (!done) {
+                std::this_thread::yield();
+            }
+        });
+
+        while (!attached) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // Read from another thread while the worker is alive
+        StatsReplyPayload live;
+        metrics->fill_stats(live, 0);
+        assert(live.threads.size() == 1);
+        assert(std::string(live.threads[0].name.c_str()) == "data");
+        assert(live.threads[0].cpu_time_ns >= 20'000'000);
+
+        done = true;
+        worker.join();
+
+        // Final value kept after the thread exited
+        StatsReplyPayload after;
+        metrics->fill_stats(after, 0);
+        assert(after.threads.size() == 1);
+        assert(after.threads[0].cpu_time_ns >= live.threads[0].cpu_time_ns);
+
+        std::cout << "  data thread CPU: " << after.threads[0].cpu_time_ns / 1'000 << "us\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 6: Stats messages registered as request/reply pair
+    {
+        std::cout << "Test 6: StatsRequest/StatsReply registration\n";
+
+        static_assert(SystemRegistry::has_reply<StatsRequestPayload>);
+        static_assert(std::is_same_v<SystemRegistry::reply_type_for<StatsRequestPayload>, StatsReplyPayload>);
+        constexpr uint32_t req_id = SystemRegistry::get_message_id<StatsRequestPayload>();
+        static_assert(((req_id >> 16) & 0xFF) == static_cast<uint8_t>(SystemSubPrefix::Control));
+
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Module Metrics Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file test_recorder.cpp
+ * @brief Test the memory-mapped log writer, segment reader and Recorder
+ *
+ * Validates:
+ * - MmapLogWriter round trip across segment rollovers (content, order,
+ *   stream table, schema, no spare file left behind)
+ * - Oversized records are dropped, not truncated
+ * - Segments can be read while they are being written
+ * - Recorder<App> subscribes to module streams on the loopback transport
+ *   and records every message without gaps
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/recorder.hpp>
+#include <commrat/recording/log_reader.hpp>
+#include "recording_test_fixtures.hpp"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+
+struct SampleB {
+    uint64_t seq{0};
+    std::array<float, 64> values{};
+};
+
+using RecApp = CommRaT<
+    Message::Data<SampleA>,
+    Message::Data<SampleB>
+>;
+
+class SourceB : public RecApp::Module<Output<SampleB>, PeriodicInput> {
+public:
+    using RecApp::Module<Output<SampleB>, PeriodicInput>::Module;
+
+protected:
+    void process(SampleB& output) override {
+        output.seq = ++seq_;
+        output.values.fill(static_cast<float>(seq_));
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+namespace {
+
+/// Record payload: sequence number followed by a byte pattern derived from it
+std::vector<std::byte> make_record(uint32_t seq) {
+    std::vector<std::byte> data(8 + (seq * 37) % 1000);
+    std::memcpy(data.data(), &seq, sizeof(seq));
+    for (std::size_t i = 8; i < data.size(); ++i) {
+        data[i] = static_cast<std::byte>((seq + i) & 0xFF);
+    }
+    return data;
+}
+
+LogStreamInfo make_stream(uint16_t id, const char* name) {
+    LogStreamInfo info{.message_id = 0x1000u + id, .stream_id = id,
+                       .system_id = static_cast<uint8_t>(id + 1), .instance_id = 0, .name = {}};
+    std::strncpy(info.name, name, sizeof(info.name) - 1);
+    return info;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Recorder Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Writer/reader round trip across segment rollovers
+    {
+        std::cout << "Test 1: Round trip with segment rollover\n";
+
+        const std::string dir = make_test_dir("recorder", "roundtrip");
+        const std::vector<LogStreamInfo> streams{make_stream(0, "alpha"), make_stream(1, "beta")};
+        const std::string schema = R"([{"commrat":{"message_id":4096}}])";
+        constexpr uint32_t count = 2000;
+
+        LogWriterStats stats;
+        {
+            MmapLogWriter writer(LogWriterConfig{
+                .directory = dir,
+                .prefix = "rt",
+                .segment_size = 128 * 1024,
+                .sync_interval = std::chrono::milliseconds(5),
+                .prefault = false
+            }, streams, schema);
+
+            for (uint32_t seq = 0; seq < count; ++seq) {
+                auto data = make_record(seq);
+                bool ok = writer.append(static_cast<uint16_t>(seq % 2), 1000 + seq, data);
+                assert(ok);
+            }
+            writer.close();
+            stats = writer.stats();
+        }
+        assert(stats.records == count);
+        assert(stats.dropped == 0);
+        assert(stats.segments > 5);
+
+        auto segments = list_log_segments(dir, "rt");
+        assert(segments.size() == stats.segments);
+        // Only segment files remain (spare was discarded)
+        assert(static_cast<std::size_t>(std::distance(std::filesystem::directory_iterator(dir),
+                                                      std::filesystem::directory_iterator{})) == segments.size());
+
+        uint32_t expected = 0;
+        for (std::size_t s = 0; s < segments.size(); ++s) {
+            LogSegmentReader reader(segments[s]);
+            assert(reader.header().segment_index == s);
+            assert(reader.schema() == schema);
+            assert(reader.streams().size() == 2);
+            assert(std::string(reader.streams()[1].name) == "beta");
+            assert(reader.stream(1)->message_id == 0x1001);
+
+            while (auto record = reader.next()) {
+                auto data = make_record(expected);
+                assert(record->stream_id == expected % 2);
+                assert(record->receive_ns == 1000 + expected);
+                assert(record->wire.size() == data.size());
+                assert(std::memcmp(record->wire.data(), data.data(), data.size()) == 0);
+                ++expected;
+            }
+        }
+        assert(expected == count);
+
+        std::cout << "  " << count << " records in " << segments.size() << " segments ("
+                  << stats.inline_rollovers << " inline rollovers)\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    // Test 2: Oversized records are dropped
+    {
+        std::cout << "Test 2: Oversized record\n";
+
+        const std::string dir = make_test_dir("recorder", "oversized");
+        MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "big",
+                                             .segment_size = 128 * 1024, .prefault = false}, {}, "[]");
+        std::vector<std::byte> huge(128 * 1024);
+        bool ok = writer.append(0, 0, huge);
+        assert(!ok);
+        assert(writer.stats().dropped == 1);
+        assert(writer.stats().records == 0);
+
+        std::cout << "  PASS\n\n";
+        writer.close();
+        std::filesystem::remove_all(dir);
+    }
+
+    // Test 3: Reading a segment while it is written
+    {
+        std::cout << "Test 3: Live segment read\n";
+
+        const std::string dir = make_test_dir("recorder", "live");
+        MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "live",
+                                             .segment_size = 1024 * 1024, .prefault = false}, {}, "[]");
+        for (uint32_t seq = 0; seq < 10; ++seq) {
+            auto data = make_record(seq);
+            writer.append(0, seq, data);
+        }
+
+        LogSegmentReader reader(list_log_segments(dir, "live").at(0));
+        uint32_t seen = 0;
+        while (reader.next()) {
+            ++seen;
+        }
+        assert(seen == 10);
+
+        auto data = make_record(10);
+        writer.append(0, 10, data);
+        auto record = reader.next();
+        assert(record && record->receive_ns == 10);
+        assert(!reader.next());
+
+        std::cout << "  PASS\n\n";
+        writer.close();
+        std::filesystem::remove_all(dir);
+    }
+
+    // Test 4: Recorder end-to-end on module streams
+    {
+        std::cout << "Test 4: Recorder on module streams\n";
+
+        const std::string dir = make_test_dir("recorder", "modules");
+        SourceA<RecApp> source_a(periodic_config("RecSourceA", 50, std::chrono::milliseconds(1)));
+        SourceB source_b(periodic_config("RecSourceB", 51, std::chrono::milliseconds(2)));
+        source_a.start();
+        source_b.start();
+
+        Recorder<RecApp> recorder(RecorderConfig{
+            .name = "TestRecorder",
+            .system_id = 90,
+            .instance_id = 1,
+            .log = {.directory = dir, .prefix = "mod", .segment_size = 1024 * 1024, .prefault = false}
+        });
+        const uint16_t stream_a = recorder.record<SampleA>(50, 0, "source_a");
+        const uint16_t stream_b = recorder.record<SampleB>(51, 0, "source_b");
+        recorder.start();
+        bool subscribed = recorder.wait_for_subscriptions(std::chrono::milliseconds(2000));
+        assert(subscribed);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        recorder.stop();
+        source_a.stop();
+        source_b.stop();
+
+        const auto stats = recorder.stats();
+        assert(stats.dropped == 0);
+
+        uint64_t records[2] = {0, 0};
+        uint64_t last_seq[2] = {0, 0};
+        for (const auto& path : list_log_segments(dir, "mod")) {
+            LogSegmentReader reader(path);
+            assert(reader.streams().size() == 2);
+            while (auto record = reader.next()) {
+                const LogStreamInfo* stream = reader.stream(record->stream_id);
+                assert(stream != nullptr);
+                assert(record->header().msg_type == stream->message_id);
+
+                uint64_t seq = 0;
+                bool decoded = RecApp::visit(stream->message_id, record->wire, [&](auto& msg) {
+                    seq = msg.payload.seq;
+                });
+                assert(decoded);
+                // Every published message recorded: consecutive sequence numbers
+                auto& last = last_seq[record->stream_id];
+                assert(last == 0 || seq == last + 1);
+                last = seq;
+                ++records[record->stream_id];
+            }
+        }
+        assert(records[stream_a] + records[stream_b] == stats.records);
+        assert(records[stream_a] >= 100);
+        assert(records[stream_b] >= 50);
+
+        std::cout << "  stream A: " << records[stream_a] << " records, stream B: "
+                  << records[stream_b] << " records, " << stats.bytes << " bytes\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    std::cout << "=== All Recorder Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file test_replay.cpp
+ * @brief Test log seek index and Replayer
+ *
+ * Validates:
+ * - Finished segments carry a sparse seek index; seek_time() finds the
+ *   first record at or after a receive time, with and without the index
+ * - Replayer republishes a recording to a consumer that subscribes to the
+ *   original producer address, with the recorded header timestamps
+ * - Real-time and scaled pacing follow the recorded receive times
+ * - A slow consumer throttles an as-fast-as-possible replay without drops
+ * - seek() starts the replay at a receive time
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/recorder.hpp>
+#include <commrat/recording/replayer.hpp>
+#include "recording_test_fixtures.hpp"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+
+using ReplayApp = CommRaT<
+    Message::Data<SampleA>
+>;
+
+namespace {
+
+constexpr uint8_t source_system = 60;
+
+/// Record ~`duration` of SourceA at 2ms; returns (seq, header timestamp) of every record
+std::vector<std::pair<uint64_t, uint64_t>> record_source(const std::string& dir,
+                                                         std::chrono::milliseconds duration) {
+    SourceA<ReplayApp> source(periodic_config("ReplaySource", source_system, std::chrono::milliseconds(2)));
+    source.start();
+
+    Recorder<ReplayApp> recorder(RecorderConfig{
+        .name = "ReplayRecorder", .system_id = 92, .instance_id = 1,
+        .log = {.directory = dir, .prefix = "src", .segment_size = 1024 * 1024, .prefault = false}
+    });
+    recorder.record<SampleA>(source_system, 0, "source_a");
+    recorder.start();
+    bool subscribed = recorder.wait_for_subscriptions(std::chrono::milliseconds(2000));
+    assert(subscribed);
+    std::this_thread::sleep_for(duration);
+    recorder.stop();
+    source.stop();
+
+    std::vector<std::pair<uint64_t, uint64_t>> records;
+    for (const auto& path : list_log_segments(dir, "src")) {
+        LogSegmentReader reader(path);
+        while (auto record = reader.next()) {
+            ReplayApp::visit(record->header().msg_type, record->wire, [&](auto& msg) {
+                records.emplace_back(msg.payload.seq, msg.header.timestamp);
+            });
+        }
+    }
+    return records;
+}
+
+/// Replay the recording to one sink; returns what the sink received and the replay duration
+struct ReplayRun {
+    std::vector<std::pair<uint64_t, uint64_t>> received;
+    ReplayStats stats;
+    std::chrono::milliseconds elapsed{0};
+};
+
+ReplayRun replay_to_sink(const std::string& dir, ReplayPacing pacing, double speed,
+                         std::chrono::microseconds sink_delay = {}, uint64_t seek_ns = 0) {
+    Replayer<ReplayApp> replay(ReplayConfig{
+        .name = "TestReplay", .system_id = 93, .instance_id = 1,
+        .directory = dir, .prefix = "src",
+        .pacing = pacing, .speed = speed
+    });
+    if (seek_ns != 0) {
+        replay.seek(seek_ns);
+    }
+    replay.start();
+
+    SinkA<ReplayApp> sink(sink_config("ReplaySink", 61, source_system), sink_delay);
+    sink.start();
+    bool subscribed = replay.wait_for_subscribers(1, std::chrono::milliseconds(2000));
+    assert(subscribed);
+
+    const auto start = std::chrono::steady_clock::now();
+    replay.play();
+    bool finished = replay.wait_until_finished(std::chrono::milliseconds(10000));
+    assert(finished);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100 + 20 * sink_delay.count() / 1000));
+
+    ReplayRun run{.received = sink.received(), .stats = replay.stats(), .elapsed = elapsed};
+    sink.stop();
+    replay.stop();
+    return run;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Replay Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Seek index
+    {
+        std::cout << "Test 1: Seek index\n";
+
+        const std::string dir = make_test_dir("replay", "index");
+        constexpr uint32_t count = 20000;
+        std::vector<std::byte> data(200);
+        {
+            MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "ix",
+                                                 .segment_size = 1024 * 1024, .prefault = false}, {}, "[]");
+            for (uint32_t seq = 0; seq < count; ++seq) {
+                std::memcpy(data.data(), &seq, sizeof(seq));
+                writer.append(0, 1000 + uint64_t{seq} * 10, data);
+            }
+            writer.close();
+        }
+
+        auto segments = list_log_segments(dir, "ix");
+        assert(segments.size() > 2);
+        for (const auto& path : segments) {
+            LogSegmentReader reader(path);
+            assert(!reader.index().empty());
+            assert(reader.index().front().offset == reader.header().data_offset);
+
+            const uint64_t first = *reader.first_receive_ns();
+            uint32_t records = 0;
+            while (reader.next()) {
+                ++records;
+            }
+            const uint64_t last = first + uint64_t{records - 1} * 10;
+
+            for (uint64_t t : {first, first + 5, first + 10 * (records / 2), last}) {
+                bool found = reader.seek_time(t);
+                assert(found);
+                auto record = reader.next();
+                assert(record && record->receive_ns >= t && record->receive_ns < t + 10);
+            }
+            assert(!reader.seek_time(last + 1));
+            assert(!reader.next());
+        }
+
+        // Unfinished segment: indexed on the fly
+        MmapLogWriter live(LogWriterConfig{.directory = dir, .prefix = "live",
+                                           .segment_size = 1024 * 1024, .prefault = false}, {}, "[]");
+        for (uint32_t seq = 0; seq < 1000; ++seq) {
+            live.append(0, 1000 + uint64_t{seq} * 10, data);
+        }
+        LogSegmentReader reader(list_log_segments(dir, "live").at(0));
+        assert(reader.index().empty());
+        bool found = reader.seek_time(5005);
+        assert(found);
+        assert(reader.next()->receive_ns == 5010);
+        live.close();
+
+        std::cout << "  " << count << " records in " << segments.size() << " indexed segments\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(dir);
+    }
+
+    const std::string dir = make_test_dir("replay", "replay");
+    const auto recorded = record_source(dir, std::chrono::milliseconds(400));
+    assert(recorded.size() >= 100);
+    const uint64_t recorded_span_ms = (recorded.back().second - recorded.front().second) / 1000000;
+
+    // Test 2: As fast as possible, consumer subscribes to the original producer
+    {
+        std::cout << "Test 2: Replay as fast as possible\n";
+
+        auto run = replay_to_sink(dir, ReplayPacing::AsFastAsPossible, 1.0);
+        assert(run.stats.finished);
+        assert(run.stats.records == recorded.size());
+        assert(run.stats.dropped == 0);
+        assert(run.received == recorded);  // Same messages, order and header timestamps
+
+        std::cout << "  " << run.received.size() << " messages in " << run.elapsed.count()
+                  << " ms (recorded over " << recorded_span_ms << " ms)\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Real-time and scaled pacing
+    {
+        std::cout << "Test 3: Paced replay\n";
+
+        auto realtime = replay_to_sink(dir, ReplayPacing::RealTime, 1.0);
+        assert(realtime.received == recorded);
+        assert(realtime.elapsed.count() + 20 >= static_cast<int64_t>(recorded_span_ms));
+        assert(realtime.elapsed.count() <= static_cast<int64_t>(recorded_span_ms) * 3 / 2 + 50);
+
+        auto fast = replay_to_sink(dir, ReplayPacing::Scaled, 4.0);
+        assert(fast.received == recorded);
+        assert(fast.elapsed.count() + 20 >= static_cast<int64_t>(recorded_span_ms / 4));
+        assert(fast.elapsed.count() < realtime.elapsed.count());
+
+        std::cout << "  real time: " << realtime.elapsed.count() << " ms, 4x: " << fast.elapsed.count()
+                  << " ms, recorded span " << recorded_span_ms << " ms\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Slow consumer throttles the replay
+    {
+        std::cout << "Test 4: Backpressure\n";
+
+        auto run = replay_to_sink(dir, ReplayPacing::AsFastAsPossible, 1.0, std::chrono::microseconds(500));
+        assert(run.stats.dropped == 0);
+        assert(run.stats.blocked_ns > 0);
+        assert(run.received == recorded);
+
+        std::cout << "  blocked " << run.stats.blocked_ns / 1000000 << " ms, no drops\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 5: Seek
+    {
+        std::cout << "Test 5: Seek\n";
+
+        LogSegmentReader reader(list_log_segments(dir, "src").at(0));
+        std::vector<uint64_t> receive_times;
+        while (auto record = reader.next()) {
+            receive_times.push_back(record->receive_ns);
+        }
+        const std::size_t half = receive_times.size() / 2;
+
+        auto run = replay_to_sink(dir, ReplayPacing::AsFastAsPossible, 1.0, {}, receive_times[half]);
+        assert(run.received.size() == recorded.size() - half);
+        assert(run.received.front() == recorded[half]);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "=== All Replay Tests PASSED ===\n";
+    return 0;
+}
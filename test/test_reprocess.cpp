@@ -0,0 +1,311 @@
+/**
+ * @file test_reprocess.cpp
+ * @brief Test parallel offline reprocessing of recordings
+ *
+ * Validates:
+ * - A recording runs through the module's process() without TiMS, with
+ *   Time::now() at the recorded receive times
+ * - Chunked parallel runs with warm-up give exactly the outputs of one
+ *   sequential pass (single input and synchronized multi-input)
+ * - Outputs are merged in timestamp order and can be written as a recording
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/reprocessor.hpp>
+#include "recording_test_fixtures.hpp"
+#include <array>
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace commrat;
+
+struct SampleB {
+    uint64_t seq{0};
+    double value{0.0};
+};
+
+struct Filtered {
+    uint64_t seq{0};
+    double mean{0.0};
+    uint64_t now_ns{0};
+};
+
+struct Fused {
+    uint64_t seq_a{0};
+    uint64_t seq_b{0};
+};
+
+using ReprocessApp = CommRaT<
+    Message::Data<SampleA>,
+    Message::Data<SampleB>,
+    Message::Data<Filtered>,
+    Message::Data<Fused>
+>;
+
+/// Moving average over the last 8 samples (state spans 8 inputs)
+class MeanFilter : public ReprocessApp::Module<Output<Filtered>, Input<SampleA>> {
+public:
+    using ReprocessApp::Module<Output<Filtered>, Input<SampleA>>::Module;
+
+protected:
+    void process(const SampleA& input, Filtered& output) override {
+        window_[count_++ % window_.size()] = input.value;
+        const std::size_t n = std::min<std::size_t>(count_, window_.size());
+        double sum = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sum += window_[i];
+        }
+        output = Filtered{.seq = input.seq, .mean = sum / static_cast<double>(n), .now_ns = Time::now()};
+    }
+
+private:
+    std::array<double, 8> window_{};
+    std::size_t count_{0};
+};
+
+class Fusion : public ReprocessApp::Module<Output<Fused>, Inputs<SampleA, SampleB>> {
+public:
+    using ReprocessApp::Module<Output<Fused>, Inputs<SampleA, SampleB>>::Module;
+
+protected:
+    void process(const SampleA& a, const SampleB& b, Fused& output) override {
+        output = Fused{.seq_a = a.seq, .seq_b = b.seq};
+    }
+};
+
+namespace {
+
+constexpr uint8_t system_a = 80;
+constexpr uint8_t system_b = 81;
+
+/// Recording as Recorder<ReprocessApp> writes it: A every 2 ms, B every 3 ms
+template<typename T>
+void append_sample(MmapLogWriter& writer, uint16_t stream_id, uint64_t seq, uint64_t receive_ns) {
+    TimsMessage<T> msg{};
+    msg.header.timestamp = receive_ns - 100000;  // Generated 100 us before receipt
+    msg.header.seq_number = static_cast<uint32_t>(seq);
+    msg.payload.seq = seq;
+    msg.payload.value = static_cast<double>((seq * 7919) % 101);
+    auto wire = ReprocessApp::serialize(msg);
+    writer.append(stream_id, receive_ns, wire.view());
+}
+
+void write_recording(const std::string& dir, std::chrono::milliseconds duration) {
+    const std::array<LogStreamInfo, 2> streams{{
+        {.message_id = ReprocessApp::get_message_id<SampleA>(), .stream_id = 0,
+         .system_id = system_a, .instance_id = 0, .name = "a"},
+        {.message_id = ReprocessApp::get_message_id<SampleB>(), .stream_id = 1,
+         .system_id = system_b, .instance_id = 0, .name = "b"}
+    }};
+    MmapLogWriter writer(LogWriterConfig{.directory = dir, .prefix = "src",
+                                         .segment_size = 256 * 1024, .prefault = false},
+                         streams, ReprocessApp::Introspection::export_all());
+
+    constexpr uint64_t origin = 1'000'000'000'000;
+    const uint64_t end = origin + Time::to_nanoseconds(duration);
+    uint64_t seq_a = 1;
+    uint64_t seq_b = 1;
+    for (uint64_t t = origin; t < end; t += 1000000) {
+        if ((t - origin) % 2000000 == 0) {
+            append_sample<SampleA>(writer, 0, seq_a++, t);
+        }
+        if ((t - origin) % 3000000 == 0) {
+            append_sample<SampleB>(writer, 1, seq_b++, t + 1);
+        }
+    }
+    writer.close();
+}
+
+ModuleConfig filter_config() {
+    return ModuleConfig{
+        .name = "MeanFilter",
+        .outputs = SimpleOutputConfig{.system_id = 82, .instance_id = 0},
+        .inputs = SingleInputConfig{.source_system_id = system_a, .source_instance_id = 0}
+    };
+}
+
+ModuleConfig fusion_config() {
+    return ModuleConfig{
+        .name = "Fusion",
+        .outputs = SimpleOutputConfig{.system_id = 83, .instance_id = 0},
+        .inputs = MultiInputConfig{
+            .sources = {
+                {.system_id = system_a, .instance_id = 0},
+                {.system_id = system_b, .instance_id = 0}
+            },
+            .history_buffer_size = 100,
+            .sync_tolerance = std::chrono::milliseconds(10)
+        }
+    };
+}
+
+template<typename Payload, typename ModuleT>
+std::pair<std::vector<TimsMessage<Payload>>, ReprocessStats> reprocess(const std::string& dir,
+                                                                       const ModuleConfig& config,
+                                                                       ReprocessConfig reprocess_config) {
+    reprocess_config.directory = dir;
+    reprocess_config.prefix = "src";
+    Reprocessor<ReprocessApp, ModuleT> batch(config, reprocess_config);
+
+    std::vector<TimsMessage<Payload>> outputs;
+    auto stats = batch.run([&](const ReprocessedMessage& out) {
+        ReprocessApp::visit(out.message_id, out.wire, [&](auto& msg) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(msg.payload)>, Payload>) {
+                outputs.push_back(msg);
+            }
+        });
+    });
+    return {outputs, stats};
+}
+
+bool same_filtered(const std::vector<TimsMessage<Filtered>>& a, const std::vector<TimsMessage<Filtered>>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].header.timestamp != b[i].header.timestamp || a[i].payload.seq != b[i].payload.seq ||
+            a[i].payload.mean != b[i].payload.mean || a[i].payload.now_ns != b[i].payload.now_ns) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Reprocess Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    const std::string dir = make_test_dir("reprocess", "src");
+    write_recording(dir, std::chrono::milliseconds(20000));
+
+    // Input records: seq -> receive time
+    std::map<uint64_t, uint64_t> a_receive_ns;
+    std::size_t b_records = 0;
+    for (const auto& path : list_log_segments(dir, "src")) {
+        LogSegmentReader reader(path);
+        while (auto record = reader.next()) {
+            ReprocessApp::visit(record->header().msg_type, record->wire, [&](auto& msg) {
+                using Payload = std::decay_t<decltype(msg.payload)>;
+                if constexpr (std::is_same_v<Payload, SampleA>) {
+                    a_receive_ns[msg.payload.seq] = record->receive_ns;
+                } else if constexpr (std::is_same_v<Payload, SampleB>) {
+                    ++b_records;
+                }
+            });
+        }
+    }
+    assert(a_receive_ns.size() == 10000 && b_records == 6667);
+    assert(list_log_segments(dir, "src").size() > 2);
+
+    // Test 1: Sequential pass with virtual time
+    std::vector<TimsMessage<Filtered>> sequential;
+    {
+        std::cout << "Test 1: Sequential pass\n";
+
+        auto [outputs, stats] = reprocess<Filtered, MeanFilter>(
+            dir, filter_config(), ReprocessConfig{.chunk = std::chrono::milliseconds(3600000), .threads = 1});
+        assert(stats.chunks == 1);
+        assert(stats.warmup_records == 0);
+        assert(outputs.size() == a_receive_ns.size());
+        assert(stats.processed == outputs.size() && stats.outputs == outputs.size());
+        for (const auto& out : outputs) {
+            assert(out.payload.now_ns == a_receive_ns.at(out.payload.seq));  // Virtual clock
+        }
+        sequential = std::move(outputs);
+
+        std::cout << "  " << stats.records << " records, " << stats.outputs << " outputs\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Parallel chunks with warm-up match the sequential pass
+    {
+        std::cout << "Test 2: Parallel chunks\n";
+
+        auto [outputs, stats] = reprocess<Filtered, MeanFilter>(
+            dir, filter_config(), ReprocessConfig{.chunk = std::chrono::milliseconds(500),
+                                                  .warmup = std::chrono::milliseconds(20), .threads = 4});
+        assert(stats.chunks == 40);
+        assert(stats.warmup_records > 0);
+        assert(same_filtered(outputs, sequential));
+
+        // Without enough warm-up the filter state differs at chunk starts
+        auto [cold, cold_stats] = reprocess<Filtered, MeanFilter>(
+            dir, filter_config(), ReprocessConfig{.chunk = std::chrono::milliseconds(500),
+                                                  .warmup = std::chrono::milliseconds(0), .threads = 4});
+        assert(cold.size() == sequential.size());
+        assert(!same_filtered(cold, sequential));
+
+        std::cout << "  " << stats.chunks << " chunks, " << stats.warmup_records << " warm-up records\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Multi-input module
+    {
+        std::cout << "Test 3: Multi-input sync\n";
+
+        auto [one, one_stats] = reprocess<Fused, Fusion>(
+            dir, fusion_config(), ReprocessConfig{.chunk = std::chrono::milliseconds(3600000), .threads = 1});
+        auto [many, many_stats] = reprocess<Fused, Fusion>(
+            dir, fusion_config(), ReprocessConfig{.chunk = std::chrono::milliseconds(700),
+                                                  .warmup = std::chrono::milliseconds(30), .threads = 3});
+        assert(one.size() == a_receive_ns.size() - 1);  // First A arrives before any B
+        assert(one.size() == many.size());
+        for (std::size_t i = 0; i < one.size(); ++i) {
+            assert(one[i].header.timestamp == many[i].header.timestamp);
+            assert(one[i].payload.seq_a == many[i].payload.seq_a);
+            assert(one[i].payload.seq_b == many[i].payload.seq_b);
+            assert(one[i].payload.seq_b != 0);
+        }
+
+        std::cout << "  " << one.size() << " fused outputs\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Merged outputs written as a recording
+    {
+        std::cout << "Test 4: Output recording\n";
+
+        const std::string out_dir = make_test_dir("reprocess", "out");
+        Reprocessor<ReprocessApp, MeanFilter> batch(filter_config(), ReprocessConfig{
+            .directory = dir, .prefix = "src",
+            .chunk = std::chrono::milliseconds(1000), .warmup = std::chrono::milliseconds(20),
+            .output = LogWriterConfig{.directory = out_dir, .prefix = "filtered", .prefault = false}
+        });
+        auto stats = batch.run();
+
+        std::size_t count = 0;
+        uint64_t last_timestamp = 0;
+        for (const auto& path : list_log_segments(out_dir, "filtered")) {
+            LogSegmentReader reader(path);
+            assert(reader.streams().size() == 1);
+            assert(reader.streams()[0].message_id == ReprocessApp::get_message_id<Filtered>());
+            assert(reader.streams()[0].system_id == 82);
+            while (auto record = reader.next()) {
+                assert(record->header().timestamp >= last_timestamp);
+                last_timestamp = record->header().timestamp;
+                ReprocessApp::visit(record->header().msg_type, record->wire, [&](auto& msg) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(msg.payload)>, Filtered>) {
+                        assert(msg.payload.seq == sequential[count].payload.seq);
+                        assert(record->receive_ns == msg.payload.now_ns);
+                    }
+                });
+                ++count;
+            }
+        }
+        assert(count == stats.outputs && count == sequential.size());
+
+        std::cout << "  " << count << " records, " << stats.recorded_ns / 1000000 << " ms recorded, "
+                  << stats.elapsed_ns / 1000000 << " ms elapsed\n";
+        std::cout << "  PASS\n\n";
+        std::filesystem::remove_all(out_dir);
+    }
+
+    std::filesystem::remove_all(dir);
+    std::cout << "=== All Reprocess Tests PASSED ===\n";
+    return 0;
+}
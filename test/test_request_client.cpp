@@ -0,0 +1,174 @@
+/**
+ * @file test_request_client.cpp
+ * @brief Test pipelined request/reply (RequestClient) on the loopback transport
+ *
+ * Validates:
+ * - Replies are matched by correlation ID, also out of order
+ * - Any free slot takes a new request: a long-running request does not
+ *   block later requests whose IDs share its slot index
+ * - QueueFull only when all MaxInFlight slots are busy
+ * - Timeouts free their slots, late replies count as unmatched
+ * - A reply payload also published as data resolves to its first definition
+ */
+
+#include <commrat/commrat.hpp>
+#include <cassert>
+#include <future>
+#include <type_traits>
+#include <iostream>
+#include <vector>
+
+using namespace commrat;
+
+namespace {
+
+constexpr uint32_t client_mailbox = 0x7401;
+constexpr uint32_t server_mailbox = 0x7402;
+
+/**
+ * @brief Answers StatsRequests when told to, in any order
+ */
+class Server {
+public:
+    Server() : mailbox_(MailboxConfig{
+        .mailbox_id = server_mailbox,
+        .max_message_size = SystemRegistry::max_message_size,
+        .mailbox_name = "ReqServer"
+    }) {
+        mailbox_.start();
+    }
+
+    /// Headers of the next n requests
+    std::vector<TimsHeader> collect(std::size_t n) {
+        std::vector<TimsHeader> headers;
+        while (headers.size() < n) {
+            auto msg = mailbox_.receive_for<StatsRequestPayload>(std::chrono::milliseconds(1000));
+            assert(msg);
+            headers.push_back(msg->header);
+        }
+        return headers;
+    }
+
+    void reply(const TimsHeader& request, uint64_t iterations) {
+        TimsMessage<StatsReplyPayload> msg{
+            .header = {
+                .msg_type = SystemRegistry::get_message_id<StatsReplyPayload>(),
+                .msg_size = 0,
+                .timestamp = Time::now(),
+                .seq_number = 0,
+                .flags = 0,
+                .correlation_id = request.correlation_id,
+                .reply_to = 0
+            },
+            .payload = {}
+        };
+        msg.payload.iterations = iterations;
+        bool sent = static_cast<bool>(mailbox_.underlying().send(msg, request.reply_to));
+        assert(sent);
+    }
+
+private:
+    RegistryMailbox<SystemRegistry> mailbox_;
+};
+
+// The same payload as a data stream and as a reply: lookups by payload type
+// resolve to the first definition, the reply pairing stays intact
+struct SensorStatus {
+    uint32_t state{0};
+};
+
+struct GetStatusCmd {
+    uint32_t sensor{0};
+};
+
+using StatusData = Message::Data<SensorStatus, MessagePrefix::UserDefined, 0x10>;
+using GetStatusReq = Message::Command<GetStatusCmd>;
+using GetStatusRep = Message::Reply<GetStatusReq, SensorStatus>;
+using SharedPayloadRegistry = MessageRegistry<StatusData, GetStatusReq, GetStatusRep>;
+
+static_assert(SharedPayloadRegistry::get_message_id<SensorStatus>() ==
+              user_message_id(UserSubPrefix::Data, 0x10));
+static_assert(std::is_same_v<SharedPayloadRegistry::reply_type_for<GetStatusCmd>, SensorStatus>);
+
+} // namespace
+
+int main() {
+    std::cout << "=== Request Client Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    Server server;
+    RequestClient<SystemRegistry, 4> client(MailboxConfig{
+        .mailbox_id = client_mailbox,
+        .max_message_size = SystemRegistry::max_message_size,
+        .mailbox_name = "ReqClient"
+    });
+    bool started = static_cast<bool>(client.start());
+    assert(started);
+
+    // Test 1: Out-of-order replies
+    {
+        std::cout << "Test 1: Replies matched by correlation ID\n";
+
+        std::vector<std::future<MailboxResult<StatsReplyPayload>>> replies;
+        for (int i = 0; i < 3; ++i) {
+            replies.push_back(client.send_request(StatsRequestPayload{}, server_mailbox));
+        }
+        auto requests = server.collect(3);
+        server.reply(requests[2], 2);
+        server.reply(requests[0], 0);
+        server.reply(requests[1], 1);
+        for (uint64_t i = 0; i < 3; ++i) {
+            auto reply = replies[i].get();
+            assert(reply && reply->iterations == i);
+        }
+        assert(client.in_flight() == 0);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Slot allocation independent of the correlation ID
+    {
+        std::cout << "Test 2: Long request does not block its slot index\n";
+
+        // One request outlives MaxInFlight - 1 short ones that time out
+        auto slow = client.send_request(StatsRequestPayload{}, server_mailbox, Milliseconds(5000));
+        std::vector<std::future<MailboxResult<StatsReplyPayload>>> short_lived;
+        for (int i = 0; i < 3; ++i) {
+            short_lived.push_back(client.send_request(StatsRequestPayload{}, server_mailbox, Milliseconds(20)));
+        }
+        for (auto& f : short_lived) {
+            auto result = f.get();
+            assert(result.error() == MailboxError::Timeout);
+        }
+        assert(client.timeouts() == 3 && client.in_flight() == 1);
+
+        // The first of these has the slow request's ID + MaxInFlight
+        std::vector<std::future<MailboxResult<StatsReplyPayload>>> next;
+        for (int i = 0; i < 3; ++i) {
+            next.push_back(client.send_request(StatsRequestPayload{}, server_mailbox));
+        }
+        assert(client.in_flight() == 4);
+        auto full = client.send_request(StatsRequestPayload{}, server_mailbox);
+        auto rejected = full.get();
+        assert(rejected.error() == MailboxError::QueueFull);
+
+        auto requests = server.collect(7);  // slow, 3 expired, 3 new
+        for (std::size_t i = 4; i < 7; ++i) {
+            server.reply(requests[i], i);
+        }
+        for (std::size_t i = 0; i < 3; ++i) {
+            auto reply = next[i].get();
+            assert(reply && reply->iterations == i + 4);
+        }
+        server.reply(requests[1], 99);  // Expired
+        server.reply(requests[0], 42);
+        auto reply = slow.get();
+        assert(reply && reply->iterations == 42);
+        assert(client.unmatched_replies() == 1);
+        assert(client.in_flight() == 0);
+        std::cout << "  PASS\n\n";
+    }
+
+    client.stop();
+    std::cout << "=== All Request Client Tests PASSED ===\n";
+    return 0;
+}
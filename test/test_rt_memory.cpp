@@ -0,0 +1,194 @@
+/**
+ * @file test_rt_memory.cpp
+ * @brief Test memory locking and prefaulting for realtime startup
+ *
+ * Validates:
+ * - Prefaulted thread stacks and heap no longer fault when used
+ * - Stack prefault size from ThreadConfig::stack_size, clamped to the real stack
+ * - Module threads fault in their stacks once enabled by setup_rt_memory()
+ * - mlockall succeeds or reports why (needs CAP_IPC_LOCK / RLIMIT_MEMLOCK)
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/module_main.hpp>
+#include <commrat/platform/rt_memory.hpp>
+#include <cassert>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <thread>
+
+using namespace commrat;
+
+struct Tick {
+    uint64_t count{0};
+};
+
+using MemApp = CommRaT<
+    Message::Data<Tick>
+>;
+
+/// Records page faults of its process() calls, the first one included
+class FaultCounter : public MemApp::Module<Output<Tick>, PeriodicInput> {
+public:
+    using MemApp::Module<Output<Tick>, PeriodicInput>::Module;
+
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<uint64_t> faults{0};
+
+protected:
+    void process(Tick& output) override {
+        const uint64_t before = thread_page_faults();
+        prefault_stack(256 * 1024);     // Deep stack use, e.g. large local buffers
+        faults += thread_page_faults() - before;
+        output.count = ++iterations;
+    }
+};
+
+namespace {
+
+constexpr std::size_t KiB = 1024;
+constexpr std::size_t MiB = 1024 * KiB;
+
+/// Page faults caused by using bytes of stack on the calling thread
+uint64_t stack_use_faults(std::size_t bytes) {
+    const uint64_t before = thread_page_faults();
+    prefault_stack(bytes);
+    return thread_page_faults() - before;
+}
+
+uint64_t locked_kib() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmLck:")) {
+            return std::stoull(line.substr(6));
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== RT Memory Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+    const uint64_t pages = 512 * KiB / detail::page_size();
+
+    // Test 1: Stack prefaulting
+    {
+        std::cout << "Test 1: Thread stack prefault\n";
+
+        // Both threads alive at once so they cannot share a cached stack
+        std::promise<void> done;
+        std::shared_future<void> cold_may_exit = done.get_future().share();
+        uint64_t cold_faults = 0;
+        std::thread cold([&]() {
+            prefault_thread_stack();    // Off: no-op
+            cold_faults = stack_use_faults(512 * KiB);
+            cold_may_exit.wait();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        set_thread_stack_prefault(1 * MiB);
+        uint64_t warm_faults = 0;
+        std::thread warm([&]() {
+            prefault_thread_stack();
+            warm_faults = stack_use_faults(512 * KiB);
+        });
+        warm.join();
+        done.set_value();
+        cold.join();
+
+        std::cout << "  512 KiB of stack: " << cold_faults << " faults cold, " << warm_faults << " prefaulted\n";
+        assert(cold_faults >= pages / 2);
+        assert(warm_faults < 8);
+
+        // ThreadConfig::stack_size sizes the prefault; clamped to the real stack
+        assert(current_stack_size() >= 1 * MiB);
+        uint64_t sized_faults = 0;
+        std::size_t real_stack = 0;
+        {
+            Thread sized(ThreadConfig{.name = "sized", .stack_size = 768 * KiB}, [&]() {
+                sized_faults = stack_use_faults(512 * KiB);
+            });
+            Thread oversized(ThreadConfig{.name = "oversized", .stack_size = 1024 * MiB}, [&]() {
+                real_stack = current_stack_size();
+            });
+        }
+        assert(sized_faults < 8);
+        assert(real_stack > 0 && real_stack < 1024 * MiB);
+        set_thread_stack_prefault(0);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Heap prefaulting
+    {
+        std::cout << "Test 2: Heap prefault\n";
+
+        assert(tune_malloc());
+        assert(prefault_heap(64 * MiB));
+        const uint64_t before = thread_page_faults();
+        auto* block = static_cast<volatile unsigned char*>(std::malloc(32 * MiB));
+        assert(block);
+        for (std::size_t offset = 0; offset < 32 * MiB; offset += detail::page_size()) {
+            block[offset] = 1;
+        }
+        const uint64_t faults = thread_page_faults() - before;
+        std::free(const_cast<unsigned char*>(block));
+
+        std::cout << "  32 MiB allocated and written after prefault: " << faults << " faults\n";
+        assert(faults < 64);    // vs. 8192 pages cold
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Module threads via setup_rt_memory()
+    {
+        std::cout << "Test 3: Module with stack prefault\n";
+
+        RtMemoryConfig memory;
+        memory.stack_prefault = 1 * MiB;
+        assert(setup_rt_memory(memory));
+        assert(thread_stack_prefault() == 1 * MiB);
+
+        FaultCounter module(ModuleConfig{
+            .name = "FaultCounter",
+            .outputs = SimpleOutputConfig{.system_id = 80, .instance_id = 0},
+            .inputs = NoInputConfig{},
+            .period = std::chrono::milliseconds(2)
+        });
+        module.start();
+        while (module.iterations < 20) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        module.stop();
+        set_thread_stack_prefault(0);
+
+        std::cout << "  " << module.iterations << " iterations, " << module.faults << " faults\n";
+        assert(module.faults < 8);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Locking
+    {
+        std::cout << "Test 4: mlockall\n";
+
+        std::string error;
+        if (lock_memory(error)) {
+            assert(locked_kib() > 0);
+            std::cout << "  Locked " << locked_kib() << " KiB\n";
+            ::munlockall();
+        } else {
+            assert(!error.empty());
+            std::cout << "  Not permitted here: " << error << "\n";
+            RtMemoryConfig memory;
+            memory.lock_memory = true;
+            assert(!setup_rt_memory(memory));
+        }
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All RT Memory Tests PASSED ===\n";
+    return 0;
+}
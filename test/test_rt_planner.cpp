@@ -0,0 +1,208 @@
+/**
+ * @file test_rt_planner.cpp
+ * @brief Test rate-monotonic priority and CPU planning
+ *
+ * Validates:
+ * - Priorities follow the period (rate-monotonic), equal periods share one
+ * - Response-time analysis matches hand-computed response times and
+ *   detects an overloaded CPU
+ * - Modules are spread over CPUs by utilization
+ * - RtPlan::apply() writes ModuleConfig::data_thread, non-realtime modules
+ *   keep default scheduling
+ * - The planner keeps no references to the added configs
+ * - A module's data thread runs on its configured CPU
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/module/rt_planner.hpp>
+#include <cassert>
+#include <atomic>
+#include <iostream>
+#include <sched.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+
+struct Sample {
+    int32_t cpu{-1};
+};
+
+using PlannerApp = CommRaT<Message::Data<Sample>>;
+
+class CpuProbe : public PlannerApp::Module<Output<Sample>, PeriodicInput> {
+public:
+    using PlannerApp::Module<Output<Sample>, PeriodicInput>::Module;
+
+    std::atomic<int> last_cpu{-1};
+
+protected:
+    void process(Sample& output) override {
+        output.cpu = sched_getcpu();
+        last_cpu = output.cpu;
+    }
+};
+
+namespace {
+
+ModuleConfig rt_module(const char* name, int period_ms, bool realtime = true) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = 90, .instance_id = 0},
+        .inputs = NoInputConfig{},
+        .period = std::chrono::milliseconds(period_ms),
+        .realtime = realtime
+    };
+}
+
+const RtTaskPlan& task(const RtPlan& plan, const std::string& name) {
+    for (const auto& t : plan.tasks) {
+        if (t.module == name) {
+            return t;
+        }
+    }
+    throw std::out_of_range(name);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== RT Planner Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Rate-monotonic priorities and response times on one CPU
+    {
+        std::cout << "Test 1: Priorities and response-time analysis\n";
+
+        ModuleConfig fast = rt_module("fast", 1);
+        ModuleConfig mid = rt_module("mid", 10);
+        ModuleConfig mid2 = rt_module("mid2", 10);
+        ModuleConfig slow = rt_module("slow", 100);
+        ModuleConfig ui = rt_module("ui", 50, false);
+
+        RateMonotonicPlanner planner({.cost_margin = 1.0});
+        planner.add(slow, Milliseconds(20));
+        planner.add(mid, Microseconds(2000));
+        planner.add(fast, Microseconds(200));
+        planner.add(ui, Milliseconds(5));
+        planner.add(mid2, Microseconds(1000));
+        assert(planner.size() == 5);
+
+        const RtPlan plan = planner.plan();
+        assert(plan.schedulable);
+        assert(plan.cores.size() == 1 && plan.cores[0].cpu == -1);
+        assert(plan.tasks[0].module == "slow");  // add() order
+
+        assert(task(plan, "fast").priority == 90);
+        assert(task(plan, "mid").priority == 89 && task(plan, "mid2").priority == 89);
+        assert(task(plan, "slow").priority == 88);
+        assert(task(plan, "ui").priority == 0 && task(plan, "ui").cpu == -1);
+
+        // R_fast = 0.2ms; R_mid = 2 + 1 (mid2) + ceil(R/1) * 0.2 = 3.8ms
+        assert(task(plan, "fast").response_ns == 200'000);
+        assert(task(plan, "mid").response_ns == 3'800'000);
+        // R_slow = 20 + ceil(R/1) * 0.2 + ceil(R/10) * (2 + 1): fixpoint 20 + 8 + 12 = 40ms
+        assert(task(plan, "slow").response_ns == 40'000'000);
+
+        bool applied = plan.apply(fast) && plan.apply(ui);
+        assert(applied);
+        assert(fast.data_thread.value().rt_priority.value() == 90);
+        assert(fast.data_thread.value().cpu_affinity.value() == -1);
+        assert(ui.data_thread.value().rt_priority.value() == 0);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Overload and spreading over CPUs
+    {
+        std::cout << "Test 2: Overload detection and CPU spreading\n";
+
+        ModuleConfig a = rt_module("a", 1);
+        ModuleConfig b = rt_module("b", 2);
+        ModuleConfig c = rt_module("c", 4);
+
+        // 0.6 + 0.5 + 0.25 > 1 on one CPU
+        RateMonotonicPlanner single({.cost_margin = 1.0});
+        single.add(a, Microseconds(600));
+        single.add(b, Microseconds(1000));
+        single.add(c, Microseconds(1000));
+        const RtPlan overloaded = single.plan();
+        assert(!overloaded.schedulable);
+        assert(task(overloaded, "a").schedulable);
+        assert(!task(overloaded, "c").schedulable);
+
+        RateMonotonicPlanner spread({.cores = {0, 1}, .cost_margin = 1.0});
+        spread.add(a, Microseconds(600));
+        spread.add(b, Microseconds(1000));
+        spread.add(c, Microseconds(1000));
+        const RtPlan plan = spread.plan();
+        assert(plan.schedulable);
+        assert(plan.cores.size() == 2);
+        assert(task(plan, "a").cpu != task(plan, "b").cpu);
+        for (const auto& core : plan.cores) {
+            assert(core.utilization <= 1.0);
+        }
+        bool applied = plan.apply(a);
+        assert(applied);
+        assert(a.data_thread.value().cpu_affinity.value() == task(plan, "a").cpu);
+        ModuleConfig unplanned = rt_module("unplanned", 1);
+        unplanned.data_thread = DataThreadConfig{.rt_priority = 5, .cpu_affinity = 1};
+        applied = plan.apply(unplanned);
+        assert(!applied && unplanned.data_thread.value().rt_priority.value() == 5);
+
+        // The margin is part of the analysed cost
+        RateMonotonicPlanner margin({.cores = {0, 1}, .cost_margin = 2.0});
+        margin.add(a, Microseconds(600));
+        assert(!margin.plan().schedulable);
+
+        bool rejected = false;
+        try {
+            RateMonotonicPlanner duplicate;
+            duplicate.add(a, Microseconds(1));
+            duplicate.add(a, Microseconds(1));
+        } catch (const std::invalid_argument&) {
+            rejected = true;
+        }
+        assert(rejected);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Configs may move after add()
+    {
+        std::cout << "Test 3: Planning configs held in a growing vector\n";
+
+        std::vector<ModuleConfig> configs;
+        configs.push_back(rt_module("first", 1));
+        RateMonotonicPlanner planner({.cost_margin = 1.0});
+        planner.add(configs.back(), Microseconds(100));
+        for (int i = 0; i < 16; ++i) {
+            configs.push_back(rt_module("filler", 100, false));  // Reallocates
+        }
+        configs.front().name = "renamed";  // Not seen by the planner
+
+        const RtPlan plan = planner.plan();
+        assert(plan.tasks.size() == 1 && plan.tasks[0].module == "first");
+        assert(plan.tasks[0].period_ns == 1'000'000 && plan.tasks[0].priority == 90);
+        ModuleConfig first = rt_module("first", 1);
+        bool applied = plan.apply(first);
+        assert(applied && first.data_thread.value().rt_priority.value() == 90);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: Data thread honours the planned CPU
+    {
+        std::cout << "Test 4: Data thread CPU pinning\n";
+
+        ModuleConfig config = rt_module("PlannerProbe", 5, false);
+        config.data_thread = DataThreadConfig{.rt_priority = 0, .cpu_affinity = 0};
+        CpuProbe probe(config);
+        probe.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        probe.stop();
+        assert(probe.last_cpu == 0);
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All RT Planner Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,341 @@
+/**
+ * @file test_rt_sync.cpp
+ * @brief Test the realtime synchronization primitives
+ *
+ * Validates:
+ * - Mutex/SharedMutex/ConditionVariable select the priority inheritance
+ *   backend unless COMMRAT_SYNC_STD is defined
+ * - FutexConditionVariable: ping-pong handoff, wait_for timeout,
+ *   notify_all wakes every waiter (requeue-PI with Mutex), works with Mutex
+ *   and PiSharedMutex locks
+ * - SharedMutex readers do not block each other, readers exclude writers
+ * - PiSharedMutex excludes readers from writers and prefers a waiting
+ *   writer over new readers
+ * - PiMutex reports relocking and unlocking by a non-owner as system_error
+ * - PiMutex bounds priority inversion: a low priority owner preempted by a
+ *   busy medium priority thread is boosted when a high priority thread
+ *   blocks on the lock (needs SCHED_FIFO and 2 CPUs, skipped otherwise)
+ */
+
+#include <commrat/platform/threading.hpp>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace commrat;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t thread_cpu_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/// Burn CPU time of the calling thread (only advances while it runs)
+void spin_cpu(std::chrono::milliseconds duration) {
+    const uint64_t end = thread_cpu_ns() + static_cast<uint64_t>(duration.count()) * 1'000'000;
+    while (thread_cpu_ns() < end) {
+    }
+}
+
+bool make_fifo(int priority, int cpu) {
+    return set_current_thread_scheduling(priority, cpu);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== RT Sync Tests ===\n\n";
+
+    // Test 1: Backend selection
+    {
+        std::cout << "Test 1: Backend selection\n";
+#if defined(COMMRAT_SYNC_STD)
+        static_assert(std::is_same_v<Mutex, StdMutex>);
+        static_assert(std::is_same_v<SharedMutex, StdSharedMutex>);
+        static_assert(std::is_same_v<ConditionVariable, StdConditionVariable>);
+        std::cout << "  std backend\n";
+#else
+        static_assert(std::is_same_v<Mutex, PiMutex>);
+        static_assert(std::is_same_v<SharedMutex, PiSharedMutex>);
+        static_assert(std::is_same_v<ConditionVariable, FutexConditionVariable>);
+        std::cout << "  priority inheritance backend\n";
+#endif
+        Mutex mutex;
+        const bool locked = mutex.try_lock();
+        bool other_locked = true;
+        std::thread([&] { other_locked = mutex.try_lock(); }).join();
+        assert(locked && !other_locked);
+        mutex.unlock();
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Condition variable handoff, timeout, notify_all
+    {
+        std::cout << "Test 2: ConditionVariable\n";
+
+        Mutex mutex;
+        ConditionVariable cv;
+        int turn = 0;  // Even: ping, odd: pong
+        constexpr int rounds = 2000;
+
+        std::thread pong([&] {
+            for (int i = 0; i < rounds; ++i) {
+                UniqueLock lock(mutex);
+                cv.wait(lock, [&] { return turn % 2 == 1; });
+                ++turn;
+                cv.notify_all();
+            }
+        });
+        for (int i = 0; i < rounds; ++i) {
+            UniqueLock lock(mutex);
+            cv.wait(lock, [&] { return turn % 2 == 0; });
+            ++turn;
+            cv.notify_all();
+        }
+        pong.join();
+        assert(turn == 2 * rounds);
+
+        {
+            UniqueLock lock(mutex);
+            const auto start = Clock::now();
+            const std::cv_status status = cv.wait_for(lock, std::chrono::milliseconds(20));
+            const auto waited = Clock::now() - start;
+            assert(status == std::cv_status::no_timeout || waited >= std::chrono::milliseconds(19));
+            assert(lock.owns_lock());
+        }
+
+        int released = 0;
+        bool go = false;
+        std::vector<std::thread> waiters;
+        for (int i = 0; i < 4; ++i) {
+            waiters.emplace_back([&] {
+                UniqueLock lock(mutex);
+                cv.wait(lock, [&] { return go; });
+                ++released;
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        {
+            Lock lock(mutex);
+            go = true;
+        }
+        cv.notify_all();
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+        assert(released == 4);
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Concurrent readers
+    {
+        std::cout << "Test 3: SharedMutex readers\n";
+
+        SharedMutex mutex;
+        std::atomic<bool> first_in{false};
+        std::atomic<bool> second_in{false};
+        std::atomic<bool> release{false};
+
+        std::thread first([&] {
+            SharedLock lock(mutex);
+            first_in = true;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+        while (!first_in) {
+            std::this_thread::yield();
+        }
+        // A serializing lock lets the second reader in only after release
+        std::thread second([&] {
+            SharedLock lock(mutex);
+            second_in = true;
+        });
+        const auto deadline = Clock::now() + std::chrono::seconds(2);
+        while (!second_in && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const bool concurrent = second_in;
+        const bool writer_blocked = !mutex.try_lock();
+        release = true;
+        first.join();
+        second.join();
+        assert(concurrent && writer_blocked);
+        const bool writer_admitted = mutex.try_lock();
+        assert(writer_admitted);
+        mutex.unlock();
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: PiSharedMutex and FutexConditionVariable on a shared lock
+    {
+        std::cout << "Test 4: PiSharedMutex\n";
+
+        PiSharedMutex mutex;
+        FutexConditionVariable cv;
+        uint64_t a = 0;
+        uint64_t b = 0;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> torn{0};
+
+        std::thread writer([&] {
+            for (int i = 0; i < 100000; ++i) {
+                std::unique_lock<PiSharedMutex> lock(mutex);
+                ++a;
+                ++b;
+            }
+            stop = true;
+        });
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 2; ++r) {
+            readers.emplace_back([&] {
+                while (!stop) {
+                    std::shared_lock<PiSharedMutex> lock(mutex);
+                    if (a != b) {
+                        ++torn;
+                    }
+                }
+            });
+        }
+        writer.join();
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(torn == 0 && a == 100000);
+
+        // A waiting writer holds off new readers
+        mutex.lock_shared();
+        std::atomic<bool> written{false};
+        std::thread waiting_writer([&] {
+            std::unique_lock<PiSharedMutex> lock(mutex);
+            written = true;
+        });
+        const auto deadline = Clock::now() + std::chrono::seconds(2);
+        bool writer_queued = false;
+        while (!writer_queued && Clock::now() < deadline) {
+            writer_queued = !mutex.try_lock_shared();
+            if (!writer_queued) {
+                mutex.unlock_shared();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        assert(writer_queued && !written);
+        mutex.unlock_shared();
+        waiting_writer.join();
+        assert(written);
+
+        bool ready = false;
+        std::thread notifier([&] {
+            std::unique_lock<PiSharedMutex> lock(mutex);
+            ready = true;
+            cv.notify_one();
+        });
+        {
+            std::unique_lock<PiSharedMutex> lock(mutex);
+            const bool woken = cv.wait_for(lock, std::chrono::seconds(5), [&] { return ready; });
+            assert(woken);
+        }
+        notifier.join();
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 5: Misuse is reported, not ignored
+    {
+        std::cout << "Test 5: PiMutex errors\n";
+
+        PiMutex mutex;
+        mutex.lock();
+        bool relock_reported = false;
+        try {
+            mutex.lock();
+        } catch (const std::system_error& e) {
+            relock_reported = e.code() == std::errc::resource_deadlock_would_occur;
+        }
+        assert(relock_reported);
+
+        bool foreign_unlock_reported = false;
+        std::thread([&] {
+            try {
+                mutex.unlock();
+            } catch (const std::system_error& e) {
+                foreign_unlock_reported = e.code() == std::errc::operation_not_permitted;
+            }
+        }).join();
+        assert(foreign_unlock_reported);
+        mutex.unlock();
+        const bool relocked = mutex.try_lock();
+        assert(relocked);
+        mutex.unlock();
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 6: Priority inheritance bounds the inversion
+    {
+        std::cout << "Test 6: PiMutex priority inheritance\n";
+
+        std::atomic<int> permitted{-1};
+        std::thread([&] {
+            permitted = make_fifo(1, -1) ? 1 : 0;
+        }).join();
+        if (std::thread::hardware_concurrency() < 2 || permitted != 1) {
+            std::cout << "  SKIP (needs SCHED_FIFO permission and 2 CPUs)\n\n";
+        } else {
+            make_fifo(0, 1);  // Main thread off CPU 0
+            PiMutex mutex;
+            std::atomic<bool> locked{false};
+            std::atomic<bool> medium_done{false};
+            std::chrono::nanoseconds high_wait{0};
+
+            // All three on CPU 0, the main thread coordinates from another CPU
+            std::thread low([&] {
+                make_fifo(10, 0);
+                mutex.lock();
+                locked = true;
+                spin_cpu(std::chrono::milliseconds(10));  // Needs CPU 0 to finish
+                mutex.unlock();
+            });
+            while (!locked) {
+                std::this_thread::yield();
+            }
+            std::thread medium([&] {
+                make_fifo(20, 0);
+                const auto end = Clock::now() + std::chrono::milliseconds(300);
+                while (Clock::now() < end) {
+                }
+                medium_done = true;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            std::thread high([&] {
+                make_fifo(30, 0);
+                const auto start = Clock::now();
+                mutex.lock();
+                high_wait = Clock::now() - start;
+                mutex.unlock();
+            });
+            high.join();
+            const bool before_medium = !medium_done;
+            medium.join();
+            low.join();
+
+            const auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(high_wait).count();
+            std::cout << "  high priority thread waited " << wait_ms << "ms\n";
+            // Without inheritance the owner runs only after medium's 300ms
+            assert(before_medium);
+            assert(wait_ms < 150);
+        }
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All RT Sync Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * @file test_schema_decoder.cpp
+ * @brief Test decoding messages from exported schemas, without compile-time types
+ *
+ * Validates:
+ * - export_all() carries a DecodePlan per type that SchemaDecoder loads
+ * - Every leaf (header, nested struct, std::array, fixed_vector of scalars
+ *   and of structs, fixed_string, enum, bool, signed) decodes to the value
+ *   the typed registry deserializes
+ * - Raw bytes from receive_any_raw() and from a recording's embedded schema
+ * - JSON and CSV emitters
+ * - Unknown types and truncated buffers are rejected
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/introspection/schema_decoder.hpp>
+#include <commrat/recording/log_reader.hpp>
+#include <commrat/recording/mmap_log_writer.hpp>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+using namespace commrat;
+
+enum class Gear : int16_t { Reverse = -1, Neutral = 0, Drive = 1 };
+
+struct Wheel {
+    float speed{0.0f};
+    int32_t ticks{0};
+};
+
+struct Vehicle {
+    uint64_t id{0};
+    Wheel front;
+    std::array<double, 3> position{};
+    sertial::fixed_vector<float, 8> samples;
+    sertial::fixed_vector<Wheel, 4> wheels;
+    sertial::fixed_string<24> driver;
+    Gear gear{Gear::Neutral};
+    bool braking{false};
+    int8_t trim{0};
+};
+
+struct Ping {
+    uint32_t count{0};
+};
+
+using DecodeApp = CommRaT<
+    Message::Data<Vehicle>,
+    Message::Data<Ping>
+>;
+
+namespace {
+
+Vehicle make_vehicle(uint64_t i) {
+    Vehicle v;
+    v.id = i;
+    v.front = Wheel{.speed = 0.5f * static_cast<float>(i), .ticks = -static_cast<int32_t>(i)};
+    v.position = {1.0 * static_cast<double>(i), -2.5, 1e9 + static_cast<double>(i)};
+    for (uint64_t s = 0; s < i % 6; ++s) {
+        v.samples.push_back(static_cast<float>(i) + 0.25f * static_cast<float>(s));
+    }
+    for (uint64_t w = 0; w < i % 5; ++w) {
+        v.wheels.push_back(Wheel{.speed = static_cast<float>(w), .ticks = static_cast<int32_t>(i * 100 + w)});
+    }
+    v.driver = sertial::fixed_string<24>(i % 2 ? "ada" : "grace \"g\"");
+    v.gear = static_cast<Gear>(static_cast<int>(i % 3) - 1);
+    v.braking = i % 2 == 0;
+    v.trim = static_cast<int8_t>(-static_cast<int>(i % 7));
+    return v;
+}
+
+std::vector<std::byte> wire_of(uint64_t i) {
+    TimsMessage<Vehicle> msg{};
+    msg.header.timestamp = 1000 + i;
+    msg.header.seq_number = static_cast<uint32_t>(i);
+    msg.payload = make_vehicle(i);
+    auto result = DecodeApp::serialize(msg);
+    auto view = result.view();
+    return std::vector<std::byte>(view.begin(), view.end());
+}
+
+/// Compare a decoded Vehicle with the typed one
+void check(const DecodedMessage& msg, uint64_t i) {
+    const Vehicle v = make_vehicle(i);
+    assert(msg.message_id == DecodeApp::get_message_id<Vehicle>());
+    assert(msg.find("timestamp")->as_uint() == 1000 + i);
+    assert(msg.find("seq_number")->as_uint() == i);
+    assert(msg.find("id")->as_uint() == v.id);
+    assert(msg.find("front.speed")->as_double() == v.front.speed);
+    assert(msg.find("front.ticks")->as_int() == v.front.ticks);
+
+    const FieldValue* position = msg.find("position");
+    assert(position->count == 3);
+    for (uint32_t k = 0; k < 3; ++k) {
+        assert(position->as_double(k) == v.position[k]);
+    }
+    const FieldValue* samples = msg.find("samples");
+    assert(samples->count == v.samples.size());
+    for (uint32_t k = 0; k < samples->count; ++k) {
+        assert(samples->as_double(k) == v.samples[k]);
+    }
+    const FieldValue* speeds = msg.find("wheels.speed");
+    const FieldValue* ticks = msg.find("wheels.ticks");
+    assert(speeds->count == v.wheels.size() && ticks->count == v.wheels.size());
+    for (uint32_t k = 0; k < ticks->count; ++k) {
+        assert(speeds->as_double(k) == v.wheels[k].speed);
+        assert(ticks->as_int(k) == v.wheels[k].ticks);
+    }
+    assert(msg.find("driver")->kind == FieldKind::String);
+    assert(msg.find("driver")->text() == v.driver.view());
+    assert(msg.find("gear")->as_int() == static_cast<int>(v.gear));
+    assert(msg.find("braking")->kind == FieldKind::Bool);
+    assert((msg.find("braking")->as_uint() != 0) == v.braking);
+    assert(msg.find("trim")->as_int() == v.trim);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Schema Decoder Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    const std::string schema = DecodeApp::Introspection::export_all();
+    SchemaDecoder decoder(schema);
+
+    // Test 1: Plans from the exported schema
+    {
+        std::cout << "Test 1: Load exported schema\n";
+
+        assert(decoder.size() == 2);
+        assert(decoder.knows(DecodeApp::get_message_id<Vehicle>()));
+        assert(decoder.knows(DecodeApp::get_message_id<Ping>()));
+        assert(!decoder.knows(0x12345678));
+
+        const DecodePlan plan = make_decode_plan<Vehicle>();
+        assert(plan.skipped.empty());
+        assert(plan.lists.size() == 3);
+        std::vector<std::string> names;
+        for (const auto& field : plan.fields) {
+            names.push_back(field.name);
+        }
+        assert((names == std::vector<std::string>{
+            "timestamp", "seq_number", "id", "front.speed", "front.ticks", "position", "samples",
+            "wheels.speed", "wheels.ticks", "driver", "gear", "braking", "trim"}));
+
+        std::cout << "  " << plan.fields.size() << " fields, " << plan.lists.size() << " lists\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Decode serialized messages, all field kinds
+    {
+        std::cout << "Test 2: Decode wire bytes\n";
+
+        DecodedMessage msg;
+        for (uint64_t i = 0; i < 200; ++i) {
+            const auto wire = wire_of(i);
+            bool decoded = decoder.decode(wire, msg);
+            assert(decoded);
+            check(msg, i);
+        }
+
+        const auto wire = wire_of(7);
+        bool header_cut = decoder.decode(std::span<const std::byte>(wire.data(), 20), msg);
+        bool payload_cut = decoder.decode(std::span<const std::byte>(wire.data(), sizeof(TimsHeader) + 4), msg);
+        bool unknown_id = decoder.decode(0x12345678, wire, msg);
+        assert(!header_cut && !payload_cut && !unknown_id);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: receive_any_raw() and a recording's embedded schema
+    {
+        std::cout << "Test 3: Raw mailbox and recording\n";
+
+        DecodeApp::Mailbox<Vehicle> a(MailboxConfig{.mailbox_id = 0x7401, .mailbox_name = "decode_a"});
+        DecodeApp::Mailbox<Vehicle> b(MailboxConfig{.mailbox_id = 0x7402, .mailbox_name = "decode_b"});
+        a.start();
+        b.start();
+        Vehicle vehicle = make_vehicle(3);
+        bool sent = static_cast<bool>(a.send(vehicle, 0x7402));
+        assert(sent);
+        auto raw = b.underlying().receive_any_raw(std::chrono::milliseconds(1000));
+        assert(raw);
+        DecodedMessage msg;
+        bool decoded = decoder.decode(raw->data(), msg);
+        assert(decoded);
+        assert(msg.find("id")->as_uint() == 3);
+        assert(msg.find("wheels.ticks")->count == 3 && msg.find("wheels.ticks")->as_int(2) == 302);
+
+        const auto dir = std::filesystem::temp_directory_path() /
+                         ("commrat_test_schema_decoder_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(dir);
+        {
+            const std::array<LogStreamInfo, 1> streams{{
+                {.message_id = DecodeApp::get_message_id<Vehicle>(), .stream_id = 0,
+                 .system_id = 1, .instance_id = 0, .name = "vehicle"}
+            }};
+            MmapLogWriter writer(LogWriterConfig{.directory = dir.string(), .prefix = "rec", .prefault = false},
+                                 streams, schema);
+            for (uint64_t i = 0; i < 100; ++i) {
+                writer.append(0, 5000 + i, wire_of(i));
+            }
+        }
+        auto segments = list_log_segments(dir.string(), "rec");
+        assert(segments.size() == 1);
+        LogSegmentReader reader(segments[0]);
+        SchemaDecoder from_recording{std::string(reader.schema())};
+        uint64_t i = 0;
+        while (auto record = reader.next()) {
+            decoded = from_recording.decode(record->wire, msg);
+            assert(decoded);
+            check(msg, i++);
+        }
+        assert(i == 100);
+        std::filesystem::remove_all(dir);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 4: JSON and CSV
+    {
+        std::cout << "Test 4: JSON and CSV\n";
+
+        DecodedMessage msg;
+        const auto wire = wire_of(2);
+        bool decoded = decoder.decode(wire, msg);
+        assert(decoded);
+
+        std::string json;
+        SchemaDecoder::append_json(msg, json);
+        const std::string type = *decoder.type_name(msg.message_id);
+        const std::string expected_json =
+            "{\"type\":\"" + type + "\",\"message_id\":" + std::to_string(msg.message_id) +
+            ",\"timestamp\":1002,\"seq_number\":2,\"id\":2,\"front.speed\":1,\"front.ticks\":-2,"
+            "\"position\":[2,-2.5,1000000002],\"samples\":[2,2.25],"
+            "\"wheels.speed\":[0,1],\"wheels.ticks\":[200,201],"
+            "\"driver\":\"grace \\\"g\\\"\",\"gear\":1,\"braking\":true,\"trim\":-2}";
+        assert(json == expected_json);
+
+        std::string csv;
+        decoder.append_csv_header(msg.message_id, csv);
+        assert(csv == "timestamp,seq_number,id,front.speed,front.ticks,position,samples,"
+                      "wheels.speed,wheels.ticks,driver,gear,braking,trim");
+        csv.clear();
+        SchemaDecoder::append_csv(msg, csv);
+        assert(csv == "1002,2,2,1,-2,\"2 -2.5 1000000002\",\"2 2.25\",\"0 1\",\"200 201\","
+                      "\"grace \"\"g\"\"\",1,true,-2");
+
+        // Throughput: decode + JSON
+        constexpr int iterations = 100000;
+        std::string line;
+        const auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < iterations; ++n) {
+            decoder.decode(wire, msg);
+            line.clear();
+            SchemaDecoder::append_json(msg, line);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << static_cast<uint64_t>(iterations / seconds) << " messages/s decoded to JSON\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Schema Decoder Tests PASSED ===\n";
+    return 0;
+}
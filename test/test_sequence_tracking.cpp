@@ -0,0 +1,253 @@
+/**
+ * @file test_sequence_tracking.cpp
+ * @brief Test publisher sequence numbers and per-input gap detection
+ *
+ * Validates:
+ * - SequenceTracker classification: in order, gaps, late arrivals filling a
+ *   gap (reordered), duplicates, wrap-around past 0, publisher restarts;
+ *   late numbers from before the first one received leave lost() alone
+ * - Modules number every output and subscribers see consecutive numbers
+ * - Lost, duplicated and reordered counters in input metadata and StatsReply
+ *   for messages injected by a hand-made producer (loopback transport)
+ */
+
+#include <commrat/commrat.hpp>
+#include <cassert>
+#include <initializer_list>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+
+struct Sample {
+    uint64_t value{0};
+};
+
+using SeqApp = CommRaT<
+    Message::Data<Sample>
+>;
+
+class Source : public SeqApp::Module<Output<Sample>, PeriodicInput> {
+public:
+    using SeqApp::Module<Output<Sample>, PeriodicInput>::Module;
+
+protected:
+    void process(Sample& output) override {
+        output.value = ++value_;
+    }
+
+private:
+    uint64_t value_{0};
+};
+
+/// Keeps the input metadata of every message
+class Sink : public SeqApp::Module<Output<Sample>, Input<Sample>> {
+public:
+    using SeqApp::Module<Output<Sample>, Input<Sample>>::Module;
+
+    struct Seen {
+        uint64_t value;
+        uint32_t sequence_number;
+        uint64_t lost;
+        uint64_t duplicated;
+        uint64_t reordered;
+    };
+
+    std::vector<Seen> seen() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return seen_;
+    }
+
+protected:
+    void process(const Sample& input, Sample& output) override {
+        auto meta = get_input_metadata<0>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        seen_.push_back(Seen{input.value, meta.sequence_number, meta.lost, meta.duplicated, meta.reordered});
+        output = input;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Seen> seen_;
+};
+
+namespace {
+
+using Result = SequenceTracker::Result;
+using Results = std::vector<Result>;
+
+/// Feed numbers to a tracker, return how each was classified
+Results record_all(SequenceTracker& tracker, std::initializer_list<uint32_t> sequence) {
+    Results results;
+    for (uint32_t seq : sequence) {
+        results.push_back(tracker.record(seq));
+    }
+    return results;
+}
+
+ModuleConfig sink_config(const char* name, uint8_t system_id, uint8_t source_system_id) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = SingleInputConfig{.source_system_id = source_system_id, .source_instance_id = 0}
+    };
+}
+
+bool wait_for(const Sink& sink, std::size_t count) {
+    for (int i = 0; i < 200 && sink.seen().size() < count; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return sink.seen().size() >= count;
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Sequence Tracking Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Tracker classification
+    {
+        std::cout << "Test 1: SequenceTracker\n";
+
+        SequenceTracker tracker;
+        auto results = record_all(tracker, {0, 5, 6, 9});   // First number starts counting, 7 and 8 missing
+        assert(results == (Results{Result::Unsequenced, Result::InOrder, Result::InOrder, Result::Gap}));
+        assert(tracker.lost() == 2);
+        results = record_all(tracker, {8});
+        assert(results == Results{Result::Reordered});
+        assert(tracker.lost() == 1 && tracker.reordered() == 1);
+        results = record_all(tracker, {8, 9, 6});
+        assert(results == Results(3, Result::Duplicate));
+        assert(tracker.duplicated() == 3);
+        results = record_all(tracker, {10, 7});
+        assert(results == (Results{Result::InOrder, Result::Reordered}));
+        assert(tracker.lost() == 0 && tracker.reordered() == 2);
+
+        // A gap wider than the window: the old numbers are forgotten
+        results = record_all(tracker, {200});
+        assert(results == Results{Result::Gap});
+        assert(tracker.lost() == 189);
+        // Far behind, then the publisher started over
+        results = record_all(tracker, {11, 12, 1, 2});
+        assert(results == (Results{Result::Restart, Result::InOrder, Result::Restart, Result::InOrder}));
+        assert(tracker.restarts() == 2);
+
+        // Wrap-around skips 0
+        SequenceTracker wrap;
+        results = record_all(wrap, {UINT32_MAX - 1, UINT32_MAX, 1, 3});
+        assert(results == (Results{Result::InOrder, Result::InOrder, Result::InOrder, Result::Gap}));
+        assert(wrap.lost() == 1);
+        results = record_all(wrap, {UINT32_MAX, 2});
+        assert(results == (Results{Result::Duplicate, Result::Reordered}));
+        assert(wrap.lost() == 0 && wrap.restarts() == 0);
+
+        // Joined mid-stream, first two swapped: 3 was never counted as lost
+        SequenceTracker joined;
+        results = record_all(joined, {5, 3, 4, 3});
+        assert(results == (Results{Result::InOrder, Result::Reordered, Result::Reordered, Result::Duplicate}));
+        assert(joined.lost() == 0 && joined.reordered() == 2 && joined.duplicated() == 1);
+        // Same after a restart: only the gap after it counts
+        SequenceTracker resynced;
+        results = record_all(resynced, {100, 20, 18, 22, 21});
+        assert(results == (Results{Result::InOrder, Result::Restart, Result::Reordered, Result::Gap,
+                                   Result::Reordered}));
+        assert(resynced.lost() == 0 && resynced.restarts() == 1 && resynced.reordered() == 2);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Module outputs are numbered
+    {
+        std::cout << "Test 2: Consecutive sequence numbers between modules\n";
+
+        Source source(ModuleConfig{
+            .name = "SeqSource",
+            .outputs = SimpleOutputConfig{.system_id = 70, .instance_id = 0},
+            .inputs = NoInputConfig{},
+            .period = std::chrono::milliseconds(2)
+        });
+        Sink sink(sink_config("SeqSink", 71, 70));
+        source.start();
+        sink.start();
+        bool received = wait_for(sink, 50);
+        sink.stop();
+        source.stop();
+        assert(received);
+
+        const auto seen = sink.seen();
+        for (std::size_t i = 1; i < seen.size(); ++i) {
+            assert(seen[i].sequence_number == seen[i - 1].sequence_number + 1);
+            assert(seen[i].value == seen[i - 1].value + 1);
+        }
+        // Numbering starts with the first output, before anyone subscribed
+        assert(seen.front().sequence_number == seen.front().value);
+        assert(seen.back().lost == 0 && seen.back().duplicated == 0 && seen.back().reordered == 0);
+
+        std::cout << "  " << seen.size() << " messages, sequence " << seen.front().sequence_number
+                  << ".." << seen.back().sequence_number << "\n";
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Loss, duplicates and reordering reach input metadata and stats
+    {
+        std::cout << "Test 3: Injected loss, duplicate and reordering\n";
+
+        // Hand-made producer of Sample on system 72: receives the subscription,
+        // then sends crafted headers
+        constexpr uint32_t producer_base =
+            ((SeqApp::get_message_id<Sample>() & 0xFFFF) << 16) | (72u << 8);
+        RegistryMailbox<SystemRegistry> producer_work(MailboxConfig{
+            .mailbox_id = producer_base + static_cast<uint8_t>(MailboxType::WORK),
+            .mailbox_name = "fake_producer_work"
+        });
+        const bool work_started = static_cast<bool>(producer_work.start());
+        assert(work_started);
+        TimsConfig config;
+        config.mailbox_id = producer_base + 0x20;
+        config.mailbox_name = "fake_producer_send";
+        TimsWrapper sender(config);
+        const TimsResult initialized = sender.initialize();
+        assert(initialized == TimsResult::SUCCESS);
+
+        Sink sink(sink_config("SeqGapSink", 73, 72));
+        sink.start();
+        auto request = producer_work.receive_for<SubscribeRequestPayload>(std::chrono::milliseconds(2000));
+        assert(request);
+        const uint32_t dest = request->payload.subscriber_base_addr | request->payload.mailbox_index;
+
+        const std::vector<uint32_t> sequence{1, 2, 4, 3, 3, 5, 8};
+        for (std::size_t i = 0; i < sequence.size(); ++i) {
+            TimsMessage<Sample> msg{};
+            msg.header.timestamp = Time::now();
+            msg.header.seq_number = sequence[i];
+            msg.payload.value = i;
+            auto wire = SeqApp::serialize(msg);
+            const TimsResult sent = sender.send_raw_bytes(wire.view(), dest);
+            assert(sent == TimsResult::SUCCESS);
+        }
+        bool received = wait_for(sink, sequence.size());
+        assert(received);
+
+        const auto seen = sink.seen();
+        assert(seen[2].sequence_number == 4 && seen[2].lost == 1);
+        assert(seen[3].lost == 0 && seen[3].reordered == 1);
+        assert(seen[4].duplicated == 1);
+        assert(seen[6].lost == 2 && seen[6].duplicated == 1 && seen[6].reordered == 1);
+
+        StatsReplyPayload stats{};
+        sink.metrics().fill_stats(stats, Time::now());
+        assert(stats.inputs.size() == 1);
+        assert(stats.inputs[0].received == sequence.size());
+        assert(stats.inputs[0].lost == 2 && stats.inputs[0].duplicated == 1 && stats.inputs[0].reordered == 1);
+
+        sink.stop();
+        sender.shutdown();
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Sequence Tracking Tests PASSED ===\n";
+    return 0;
+}
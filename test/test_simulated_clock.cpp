@@ -0,0 +1,225 @@
+/**
+ * @file test_simulated_clock.cpp
+ * @brief Test simulated time driven by a quiescence-based controller
+ *
+ * Validates:
+ * - Time::now()/sleep() follow SimulatedClock; run_until() wakes sleepers
+ *   at their exact times and ends at the requested time
+ * - A periodic -> multi-input pipeline runs many times faster than real
+ *   time with exact timestamps, never forcing an advance
+ * - Two runs produce identical results (secondaries of the same instant
+ *   are always in history before the primary is processed)
+ * - stop() does not wait for the controller
+ */
+
+#include <commrat/commrat.hpp>
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace commrat;
+
+struct Fast {
+    uint64_t seq{0};
+};
+
+struct Slow {
+    uint64_t seq{0};
+};
+
+using SimApp = CommRaT<
+    Message::Data<Fast>,
+    Message::Data<Slow>
+>;
+
+class FastSource : public SimApp::Module<Output<Fast>, PeriodicInput> {
+public:
+    using SimApp::Module<Output<Fast>, PeriodicInput>::Module;
+
+protected:
+    void process(Fast& output) override {
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class SlowSource : public SimApp::Module<Output<Slow>, PeriodicInput> {
+public:
+    using SimApp::Module<Output<Slow>, PeriodicInput>::Module;
+
+protected:
+    void process(Slow& output) override {
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+/// (fast timestamp, slow timestamp, fast seq, slow seq) of every fused pair
+using Fused = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>;
+
+class Fusion : public SimApp::Module<Output<Fast>, Inputs<Fast, Slow>> {
+public:
+    using SimApp::Module<Output<Fast>, Inputs<Fast, Slow>>::Module;
+
+    std::vector<Fused> fused() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fused_;
+    }
+
+protected:
+    void process(const Fast& fast, const Slow& slow, Fast& output) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fused_.emplace_back(get_input_metadata<0>().timestamp, get_input_metadata<1>().timestamp,
+                            fast.seq, slow.seq);
+        output = fast;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Fused> fused_;
+};
+
+namespace {
+
+constexpr uint64_t ms = 1'000'000;
+constexpr uint64_t start_ns = 1'000 * ms;
+
+ModuleConfig source_config(const char* name, uint8_t system_id, std::chrono::milliseconds period) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = NoInputConfig{},
+        .period = period
+    };
+}
+
+/// Run the pipeline for duration_ms of simulated time
+std::vector<Fused> run_pipeline(uint64_t duration_ms, SimulatedClock::RunStats& stats, double& real_seconds) {
+    SimulatedClock::reset(start_ns);
+    FastSource fast(source_config("SimFast", 90, std::chrono::milliseconds(10)));
+    SlowSource slow(source_config("SimSlow", 91, std::chrono::milliseconds(20)));
+    Fusion fusion(ModuleConfig{
+        .name = "SimFusion",
+        .outputs = SimpleOutputConfig{.system_id = 92, .instance_id = 0},
+        .inputs = MultiInputConfig{
+            .sources = {
+                {.system_id = 90, .instance_id = 0},
+                {.system_id = 91, .instance_id = 0}
+            },
+            .history_buffer_size = 100,
+            .sync_tolerance = std::chrono::milliseconds(15)
+        }
+    });
+    fast.start();
+    slow.start();
+    fusion.start();
+
+    const auto real_start = std::chrono::steady_clock::now();
+    stats = SimulatedClock::run_until(start_ns + duration_ms * ms);
+    real_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start).count();
+    assert(Time::now() == start_ns + duration_ms * ms);
+
+    fusion.stop();
+    slow.stop();
+    fast.stop();
+    return fusion.fused();
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Simulated Clock Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+    Time::set_clock_source(Time::ClockSource::SIMULATED);
+
+    // Test 1: Sleepers and the controller
+    {
+        std::cout << "Test 1: Sleep and run_until\n";
+
+        SimulatedClock::reset(start_ns);
+        assert(Time::now() == start_ns);
+
+        std::atomic<bool> running{true};
+        std::vector<uint64_t> wakes;
+        std::thread sleeper = start_thread([&]() {
+            while (running) {
+                wakes.push_back(Time::now());
+                Time::sleep(std::chrono::milliseconds(10), running);
+            }
+        });
+
+        auto stats = SimulatedClock::run_until(start_ns + 35 * ms);
+        assert(Time::now() == start_ns + 35 * ms);
+        assert(stats.steps == 3 && stats.forced == 0);
+        assert(SimulatedClock::next_wakeup() == start_ns + 40 * ms);
+
+        // Stop without advancing time
+        running = false;
+        SimulatedClock::interrupt();
+        sleeper.join();
+        assert((wakes == std::vector<uint64_t>{start_ns, start_ns + 10 * ms, start_ns + 20 * ms, start_ns + 30 * ms}));
+        assert(SimulatedClock::busy() == 0);
+        assert(SimulatedClock::next_wakeup() == SimulatedClock::never);
+
+        // Time::sleep_until() on a non-participant, driven from another thread
+        std::thread controller([]() { SimulatedClock::run_until(start_ns + 100 * ms); });
+        Time::sleep_until(start_ns + 50 * ms);
+        assert(Time::now() >= start_ns + 50 * ms);
+        controller.join();
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Pipeline, faster than real time and exact
+    std::vector<Fused> first;
+    {
+        std::cout << "Test 2: Periodic sources into a multi-input module\n";
+
+        constexpr uint64_t duration_ms = 5000;
+        SimulatedClock::RunStats stats;
+        double real_seconds = 0.0;
+        first = run_pipeline(duration_ms, stats, real_seconds);
+
+        std::cout << "  " << duration_ms / 1000.0 << " s simulated in " << real_seconds << " s, "
+                  << stats.steps << " steps, " << first.size() << " fused\n";
+        assert(stats.forced == 0);
+        assert(real_seconds < duration_ms / 1000.0 / 2);
+
+        // Subscribed at start_ns, after both sources published once: the
+        // first fast message (start + 10ms) has no slow one to sync with yet
+        assert(first.size() == duration_ms / 10 - 1);
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            const auto [fast_ts, slow_ts, fast_seq, slow_seq] = first[i];
+            assert(fast_ts == start_ns + (i + 2) * 10 * ms);
+            assert(fast_seq == i + 3);
+            // Newest slow message at or before the fast one, also when both share the instant
+            assert(slow_ts == fast_ts - (fast_ts - start_ns) % (20 * ms));
+            assert(slow_seq == (slow_ts - start_ns) / (20 * ms) + 1);
+        }
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 3: Reproducible
+    {
+        std::cout << "Test 3: Second run gives identical results\n";
+
+        SimulatedClock::RunStats stats;
+        double real_seconds = 0.0;
+        const auto second = run_pipeline(5000, stats, real_seconds);
+        assert(second == first);
+        std::cout << "  PASS\n\n";
+    }
+
+    Time::set_clock_source(Time::ClockSource::STEADY_CLOCK);
+    assert(!SimulatedClock::enabled());
+
+    std::cout << "=== All Simulated Clock Tests PASSED ===\n";
+    return 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file test_stream_monitor.cpp
+ * @brief Test the header-only stream monitor
+ *
+ * Validates:
+ * - StreamMonitor subscribes to module streams on the loopback transport and
+ *   reports rate, bandwidth, intervals and data age from one thread
+ * - Sequence gaps: skipped numbers count as lost, older ones as late,
+ *   unsequenced (0) messages are ignored, a publisher restart is followed
+ *   at once; total_lost only counts numbers still missing
+ * - Windows reset on report(), totals do not
+ */
+
+#include <commrat/commrat.hpp>
+#include <commrat/recording/stream_monitor.hpp>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace commrat;
+
+struct Fast {
+    uint64_t seq{0};
+    double value{0.0};
+};
+
+struct Slow {
+    uint64_t seq{0};
+    std::array<float, 256> values{};
+};
+
+using MonApp = CommRaT<
+    Message::Data<Fast>,
+    Message::Data<Slow>
+>;
+
+class FastSource : public MonApp::Module<Output<Fast>, PeriodicInput> {
+public:
+    using MonApp::Module<Output<Fast>, PeriodicInput>::Module;
+
+protected:
+    void process(Fast& output) override {
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+class SlowSource : public MonApp::Module<Output<Slow>, PeriodicInput> {
+public:
+    using MonApp::Module<Output<Slow>, PeriodicInput>::Module;
+
+protected:
+    void process(Slow& output) override {
+        output.seq = ++seq_;
+    }
+
+private:
+    uint64_t seq_{0};
+};
+
+namespace {
+
+ModuleConfig periodic_config(const char* name, uint8_t system_id, std::chrono::milliseconds period) {
+    return ModuleConfig{
+        .name = name,
+        .outputs = SimpleOutputConfig{.system_id = system_id, .instance_id = 0},
+        .inputs = NoInputConfig{},
+        .period = period
+    };
+}
+
+/// Send a Fast message with the given header sequence number straight to a mailbox
+void send_sequenced(TimsWrapper& sender, uint32_t dest, uint32_t seq) {
+    TimsMessage<Fast> msg{};
+    msg.header.msg_type = MonApp::get_message_id<Fast>();
+    msg.header.timestamp = Time::now();
+    msg.header.seq_number = seq;
+    auto result = MonApp::serialize(msg);
+    auto result_code = sender.send_raw_bytes(result.view(), dest);
+    assert(result_code == TimsResult::SUCCESS);
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Stream Monitor Tests ===\n\n";
+    TimsWrapper::set_transport(TimsTransport::Loopback);
+
+    // Test 1: Module streams
+    {
+        std::cout << "Test 1: Rate, bandwidth and age of module streams\n";
+
+        FastSource fast(periodic_config("MonFast", 60, std::chrono::milliseconds(2)));
+        SlowSource slow(periodic_config("MonSlow", 61, std::chrono::milliseconds(20)));
+        fast.start();
+        slow.start();
+
+        StreamMonitor monitor(StreamMonitorConfig{.name = "TestMonitor", .system_id = 1, .instance_id = 2});
+        monitor.add(MonApp::get_message_id<Fast>(), 60, 0, "fast");
+        monitor.add(MonApp::get_message_id<Slow>(), 61, 0);
+        monitor.start();
+
+        monitor.run_for(std::chrono::milliseconds(200));
+        assert(monitor.acknowledged() == 2);
+        monitor.report();   // Discard the subscription transient
+
+        monitor.run_for(std::chrono::milliseconds(1000));
+        const auto stats = monitor.report();
+        StreamMonitor::print(stats, stdout);
+        monitor.stop();
+        fast.stop();
+        slow.stop();
+
+        assert(stats.size() == 2);
+        const StreamStats& f = stats[0];
+        const StreamStats& s = stats[1];
+        assert(f.label == "fast");
+        assert(s.label.find("@61.0") != std::string::npos);
+
+        // Loose bounds: CI machines are noisy
+        assert(f.rate_hz > 250.0 && f.rate_hz < 750.0);
+        assert(s.rate_hz > 25.0 && s.rate_hz < 75.0);
+        assert(std::abs(f.mean_interval_ns - 2e6) < 1e6);
+        assert(f.min_interval_ns <= f.max_interval_ns);
+        assert(f.jitter_ns >= 0.0 && f.jitter_ns < 2e6);
+        assert(f.bytes == f.messages * (f.bytes / f.messages));     // Fixed-size messages
+        assert(s.bytes / s.messages > 1024);
+        assert(std::abs(s.bandwidth - s.rate_hz * static_cast<double>(s.bytes / s.messages)) < 1.0);
+        assert(f.mean_age_ns >= 0.0 && f.mean_age_ns < 50e6);
+        assert(f.max_age_ns >= static_cast<int64_t>(f.mean_age_ns));
+        assert(f.total_messages > f.messages);
+        assert(f.lost == 0 && f.late == 0);
+
+        std::cout << "  PASS\n\n";
+    }
+
+    // Test 2: Sequence gaps
+    {
+        std::cout << "Test 2: Lost and late sequence numbers\n";
+
+        StreamMonitor monitor(StreamMonitorConfig{.name = "SeqMonitor", .system_id = 3, .instance_id = 0});
+        monitor.add(MonApp::get_message_id<Fast>(), 62, 0, "seq");
+        monitor.start();    // Nobody answers the subscription; messages are sent directly
+
+        TimsConfig config;
+        config.mailbox_id = 0x7501;
+        config.mailbox_name = "seq_sender";
+        TimsWrapper sender(config);
+        const TimsResult initialized = sender.initialize();
+        assert(initialized == TimsResult::SUCCESS);
+        const uint32_t data = monitor.base_address() | static_cast<uint32_t>(MailboxType::DATA);
+
+        for (uint32_t seq : {0u, 0u, 1u, 2u, 3u, 6u, 7u, 5u, 8u, 8u, 10u}) {
+            send_sequenced(sender, data, seq);
+        }
+        std::size_t polled = monitor.poll();
+        assert(polled == 11);
+        auto stats = monitor.report();
+        assert(stats[0].messages == 11);
+        assert(stats[0].lost == 3);     // 4, 5 (arrived late) and 9
+        assert(stats[0].late == 2);     // 5 and the second 8
+
+        // Far behind is a restart and resynchronizes, wrap-around is not a
+        // gap; windows reset, totals accumulate
+        for (uint32_t seq : {3000u, 0xFFFFFFFEu, 0xFFFFFFFFu, 1u, 2u}) {
+            send_sequenced(sender, data, seq);
+        }
+        polled = monitor.poll();
+        assert(polled == 5);
+        stats = monitor.report();
+        assert(stats[0].messages == 5);
+        assert(stats[0].lost == 3000 - 11);
+        assert(stats[0].late == 1);
+        // 5 arrived late: still missing are 4, 9 and 11..2999
+        assert(stats[0].total_messages == 16 && stats[0].total_lost == 2 + 3000 - 11);
+
+        send_sequenced(sender, data, 3);
+        monitor.poll();
+        stats = monitor.report();
+        assert(stats[0].lost == 0 && stats[0].late == 0);
+        // One interval, measured from the previous window's last message
+        assert(stats[0].min_interval_ns == stats[0].max_interval_ns && stats[0].jitter_ns == 0.0);
+
+        stats = monitor.report();
+        assert(stats[0].messages == 0 && stats[0].rate_hz == 0.0 && stats[0].last_receive != 0);
+
+        // A publisher restarted long before the old number is followed at once
+        for (uint32_t seq : {1u, 2u, 4u}) {
+            send_sequenced(sender, data, seq);
+        }
+        monitor.poll();
+        stats = monitor.report();
+        assert(stats[0].late == 1);     // The restart
+        assert(stats[0].lost == 1);     // 3 of the new sequence
+
+        sender.shutdown();
+        std::cout << "  PASS\n\n";
+    }
+
+    std::cout << "=== All Stream Monitor Tests PASSED ===\n";
+    return 0;
+}
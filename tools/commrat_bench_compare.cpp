@@ -0,0 +1,676 @@
+/**
+ * @file commrat_bench_compare.cpp
+ * @brief Store benchmark baselines and compare new runs against them
+ *
+ * Reads the JSON written by the benchmarks (--json, see docs/BENCHMARKS.md).
+ * A baseline is a set of runs of the same benchmark(s); every run contributes
+ * one sample per result and metric (mean, p50, p90, p99, p999, throughput,
+ * success rate, module CPU). For each metric the candidate runs are compared
+ * against the baseline runs with a one-sided Mann-Whitney U test. A metric
+ * regresses if its median changed in the bad direction by more than the
+ * metric's threshold and the change is significant (p <= alpha).
+ *
+ * With too few runs for the test to ever reach alpha (< 3 per side at
+ * alpha 0.05), the threshold alone decides and the p column shows "-".
+ *
+ * Usage:
+ *   commrat_bench_compare store <baseline.json> <run.json> [run.json ...]
+ *   commrat_bench_compare compare <baseline.json> <run.json> [run.json ...]
+ *                         [--threshold METRIC=PERCENT] [--alpha P]
+ *                         [--min-delta-ns N] [--filter SUBSTRING] [--all]
+ *
+ * compare accepts a baseline written by store or a single run as baseline.
+ * Exit code: 0 = no regression, 1 = regression, 2 = usage or input error.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// ============================================================================
+// Minimal JSON Reader
+// ============================================================================
+
+struct Json {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type{Type::Null};
+    bool boolean{false};
+    double number{0.0};
+    std::string string;
+    std::vector<Json> array;
+    std::vector<std::pair<std::string, Json>> object;
+
+    const Json* find(const std::string& key) const {
+        for (const auto& [name, value] : object) {
+            if (name == key) {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+
+    bool parse(Json& out) {
+        if (!parse_value(out)) {
+            return false;
+        }
+        skip_whitespace();
+        return pos_ == text_.size();
+    }
+
+    std::size_t position() const { return pos_; }
+
+private:
+    void skip_whitespace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool consume_literal(const char* literal) {
+        const std::string word(literal);
+        if (text_.compare(pos_, word.size(), word) != 0) {
+            return false;
+        }
+        pos_ += word.size();
+        return true;
+    }
+
+    bool parse_value(Json& out) {
+        skip_whitespace();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        const char c = text_[pos_];
+        if (c == '{') {
+            return parse_object(out);
+        }
+        if (c == '[') {
+            return parse_array(out);
+        }
+        if (c == '"') {
+            out.type = Json::Type::String;
+            return parse_string(out.string);
+        }
+        if (c == 't' || c == 'f') {
+            out.type = Json::Type::Bool;
+            out.boolean = c == 't';
+            return consume_literal(out.boolean ? "true" : "false");
+        }
+        if (c == 'n') {
+            out.type = Json::Type::Null;
+            return consume_literal("null");
+        }
+        const char* begin = text_.c_str() + pos_;
+        char* end = nullptr;
+        out.type = Json::Type::Number;
+        out.number = std::strtod(begin, &end);
+        if (end == begin) {
+            return false;
+        }
+        pos_ += static_cast<std::size_t>(end - begin);
+        return true;
+    }
+
+    bool parse_string(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        while (pos_ < text_.size()) {
+            const char c = text_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (c == '\\' && pos_ < text_.size()) {
+                const char escaped = text_[pos_++];
+                switch (escaped) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': pos_ += 4; out += '?'; break;  // Not used by the benchmarks
+                    default: out += escaped; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        return false;
+    }
+
+    bool parse_array(Json& out) {
+        out.type = Json::Type::Array;
+        consume('[');
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            out.array.emplace_back();
+            if (!parse_value(out.array.back())) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool parse_object(Json& out) {
+        out.type = Json::Type::Object;
+        consume('{');
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            std::string key;
+            skip_whitespace();
+            if (!parse_string(key) || !consume(':')) {
+                return false;
+            }
+            out.object.emplace_back(std::move(key), Json{});
+            if (!parse_value(out.object.back().second)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    const std::string& text_;
+    std::size_t pos_{0};
+};
+
+bool read_file(const std::string& path, std::string& text) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << "\n";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+/**
+ * @brief Load the benchmark runs of a file: a single run or a stored baseline
+ */
+bool load_runs(const std::string& path, std::vector<Json>& runs) {
+    std::string text;
+    if (!read_file(path, text)) {
+        return false;
+    }
+    Json root;
+    JsonParser parser(text);
+    if (!parser.parse(root) || root.type != Json::Type::Object) {
+        std::cerr << path << ": invalid JSON near offset " << parser.position() << "\n";
+        return false;
+    }
+    if (const Json* stored = root.find("runs"); stored != nullptr && stored->type == Json::Type::Array) {
+        runs.insert(runs.end(), stored->array.begin(), stored->array.end());
+        return true;
+    }
+    if (root.find("results") != nullptr) {
+        runs.push_back(std::move(root));
+        return true;
+    }
+    std::cerr << path << " is neither a benchmark run nor a baseline\n";
+    return false;
+}
+
+// ============================================================================
+// Samples
+// ============================================================================
+
+enum class Better { Lower, Higher };
+
+struct MetricSpec {
+    const char* name;           ///< Metric name, also the --threshold key
+    Better better;
+    double threshold_percent;   ///< Default regression threshold
+    bool latency;               ///< Subject to --min-delta-ns
+};
+
+// max is a single sample per run and too noisy to gate on
+constexpr MetricSpec METRICS[] = {
+    {"mean", Better::Lower, 10.0, true},
+    {"p50", Better::Lower, 10.0, true},
+    {"p90", Better::Lower, 15.0, true},
+    {"p99", Better::Lower, 20.0, true},
+    {"p999", Better::Lower, 30.0, true},
+    {"throughput", Better::Higher, 10.0, false},
+    {"success_rate", Better::Higher, 1.0, false},
+    {"cpu", Better::Lower, 20.0, false},  // One metric per module: cpu.<module>
+};
+
+const MetricSpec& spec_of(const std::string& metric) {
+    const std::string base = metric.rfind("cpu.", 0) == 0 ? "cpu" : metric;
+    for (const auto& spec : METRICS) {
+        if (base == spec.name) {
+            return spec;
+        }
+    }
+    return METRICS[0];
+}
+
+/// Result name -> metric -> one value per run
+using SampleSet = std::map<std::string, std::map<std::string, std::vector<double>>>;
+
+struct RunSet {
+    SampleSet samples;
+    std::map<std::string, bool> incomplete;  ///< Result incomplete in any run
+    std::vector<std::string> transports;
+    std::size_t runs{0};
+};
+
+void add_run(const Json& run, RunSet& set) {
+    const Json* benchmark = run.find("benchmark");
+    const Json* transport = run.find("transport");
+    const Json* results = run.find("results");
+    if (transport != nullptr &&
+        std::find(set.transports.begin(), set.transports.end(), transport->string) == set.transports.end()) {
+        set.transports.push_back(transport->string);
+    }
+    ++set.runs;
+    if (results == nullptr) {
+        return;
+    }
+
+    for (const auto& result : results->array) {
+        const Json* name = result.find("name");
+        if (name == nullptr) {
+            continue;
+        }
+        // Benchmarks may share result names, keep them apart
+        const std::string key = (benchmark != nullptr ? benchmark->string + "/" : "") + name->string;
+        auto& metrics = set.samples[key];
+
+        if (const Json* complete = result.find("complete"); complete != nullptr && !complete->boolean) {
+            set.incomplete[key] = true;
+        }
+        if (const Json* latency = result.find("latency_ns"); latency != nullptr) {
+            const Json* count = latency->find("count");
+            if (count == nullptr || count->number > 0) {
+                for (const char* metric : {"mean", "p50", "p90", "p99", "p999"}) {
+                    if (const Json* value = latency->find(metric); value != nullptr) {
+                        metrics[metric].push_back(value->number);
+                    }
+                }
+            }
+        }
+        if (const Json* throughput = result.find("throughput_per_s"); throughput != nullptr) {
+            metrics["throughput"].push_back(throughput->number);
+        }
+        if (const Json* success = result.find("success_rate"); success != nullptr) {
+            metrics["success_rate"].push_back(success->number);
+        }
+        if (const Json* cpu = result.find("module_cpu_percent"); cpu != nullptr) {
+            for (const auto& [module, percent] : cpu->object) {
+                metrics["cpu." + module].push_back(percent.number);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const std::size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+/**
+ * @brief One-sided Mann-Whitney U test: P(candidate is not greater than baseline)
+ *
+ * U counts the (baseline, candidate) pairs with candidate > baseline (ties
+ * count 1/2). Without ties and for small samples the p-value is exact (null
+ * distribution of U by recurrence); otherwise the normal approximation with
+ * tie and continuity correction is used.
+ *
+ * @return p-value of observing U or larger under the null hypothesis
+ */
+double mann_whitney_greater(const std::vector<double>& baseline, const std::vector<double>& candidate) {
+    const std::size_t n1 = baseline.size();
+    const std::size_t n2 = candidate.size();
+    double u = 0.0;
+    bool ties = false;
+    for (double b : baseline) {
+        for (double c : candidate) {
+            if (c > b) {
+                u += 1.0;
+            } else if (c == b) {
+                u += 0.5;
+                ties = true;
+            }
+        }
+    }
+
+    if (!ties && n1 <= 20 && n2 <= 20) {
+        // counts[m][k][u]: arrangements of m baseline / k candidate values with statistic u
+        const std::size_t max_u = n1 * n2;
+        std::vector<std::vector<std::vector<double>>> counts(
+            n1 + 1, std::vector<std::vector<double>>(n2 + 1, std::vector<double>(max_u + 1, 0.0)));
+        for (std::size_t m = 0; m <= n1; ++m) {
+            for (std::size_t k = 0; k <= n2; ++k) {
+                if (m == 0 || k == 0) {
+                    counts[m][k][0] = 1.0;
+                    continue;
+                }
+                for (std::size_t v = 0; v <= m * k; ++v) {
+                    // Largest value is a candidate (beats all m baseline values) or a baseline value
+                    const double with_candidate = v >= m ? counts[m][k - 1][v - m] : 0.0;
+                    counts[m][k][v] = with_candidate + counts[m - 1][k][v];
+                }
+            }
+        }
+        double total = 0.0;
+        double tail = 0.0;
+        const auto observed = static_cast<std::size_t>(u);
+        for (std::size_t v = 0; v <= max_u; ++v) {
+            total += counts[n1][n2][v];
+            if (v >= observed) {
+                tail += counts[n1][n2][v];
+            }
+        }
+        return tail / total;
+    }
+
+    // Normal approximation with tie correction
+    std::vector<double> all(baseline);
+    all.insert(all.end(), candidate.begin(), candidate.end());
+    std::sort(all.begin(), all.end());
+    double tie_term = 0.0;
+    for (std::size_t i = 0; i < all.size();) {
+        std::size_t j = i;
+        while (j < all.size() && all[j] == all[i]) {
+            ++j;
+        }
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+    const double n = static_cast<double>(n1 + n2);
+    const double mean = static_cast<double>(n1 * n2) / 2.0;
+    const double variance = static_cast<double>(n1 * n2) / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return 1.0;  // All values equal
+    }
+    const double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/// Smallest one-sided p-value the exact test can produce: 1 / C(n1 + n2, n1)
+double min_p_value(std::size_t n1, std::size_t n2) {
+    double combinations = 1.0;
+    for (std::size_t i = 1; i <= n1; ++i) {
+        combinations = combinations * static_cast<double>(n2 + i) / static_cast<double>(i);
+    }
+    return 1.0 / combinations;
+}
+
+// ============================================================================
+// Commands
+// ============================================================================
+
+int store(const std::string& path, const std::vector<std::string>& inputs) {
+    std::ostringstream runs;
+    std::size_t count = 0;
+    for (const auto& input : inputs) {
+        std::vector<Json> loaded;
+        std::string text;
+        if (!load_runs(input, loaded) || !read_file(input, text)) {
+            return 2;
+        }
+        if (loaded.size() != 1) {
+            std::cerr << input << ": store expects benchmark runs, not baselines\n";
+            return 2;
+        }
+        const auto last = text.find_last_not_of(" \t\r\n");
+        runs << (count == 0 ? "\n" : ",\n") << text.substr(0, last + 1);
+        ++count;
+    }
+
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Cannot write " << path << "\n";
+        return 2;
+    }
+    out << "{\"commrat_baseline\": 1, \"runs\": [" << runs.str() << "\n]}\n";
+    std::cout << "Stored " << count << " run(s) in " << path << "\n";
+    return out.good() ? 0 : 2;
+}
+
+struct CompareOptions {
+    std::map<std::string, double> thresholds;  ///< Overrides, percent
+    double alpha{0.05};
+    double min_delta_ns{50.0};
+    std::string filter;
+    bool all{false};
+};
+
+std::string join(const std::vector<std::string>& values) {
+    std::string joined;
+    for (const auto& value : values) {
+        joined += (joined.empty() ? "" : ",") + value;
+    }
+    return joined.empty() ? "?" : joined;
+}
+
+int compare(const std::string& baseline_path, const std::vector<std::string>& candidate_paths,
+            const CompareOptions& options) {
+    std::vector<Json> baseline_runs;
+    std::vector<Json> candidate_runs;
+    if (!load_runs(baseline_path, baseline_runs)) {
+        return 2;
+    }
+    for (const auto& path : candidate_paths) {
+        if (!load_runs(path, candidate_runs)) {
+            return 2;
+        }
+    }
+    RunSet baseline;
+    RunSet candidate;
+    for (const auto& run : baseline_runs) {
+        add_run(run, baseline);
+    }
+    for (const auto& run : candidate_runs) {
+        add_run(run, candidate);
+    }
+
+    std::cout << "Baseline: " << baseline.runs << " run(s) (" << join(baseline.transports)
+              << "), candidate: " << candidate.runs << " run(s) (" << join(candidate.transports) << ")\n";
+    if (baseline.transports != candidate.transports) {
+        std::cout << "WARNING: transports differ, results are not comparable\n";
+    }
+    const bool powered = min_p_value(baseline.runs, candidate.runs) <= options.alpha;
+    if (!powered) {
+        std::cout << "WARNING: too few runs for significance at alpha " << options.alpha
+                  << ", thresholds only (use >= 3 runs per side)\n";
+    }
+    std::cout << "\n" << std::left << std::setw(56) << "Result / metric" << std::right
+              << std::setw(14) << "baseline" << std::setw(14) << "candidate"
+              << std::setw(10) << "change" << std::setw(8) << "p" << "  status\n"
+              << std::string(110, '-') << "\n";
+
+    std::size_t regressions = 0;
+    std::size_t improvements = 0;
+    std::size_t compared = 0;
+    std::vector<std::string> missing;
+
+    for (const auto& [result, base_metrics] : baseline.samples) {
+        if (!options.filter.empty() && result.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        auto cand_it = candidate.samples.find(result);
+        if (cand_it == candidate.samples.end()) {
+            missing.push_back(result);
+            continue;
+        }
+        if (candidate.incomplete.count(result) != 0 && baseline.incomplete.count(result) == 0) {
+            std::cout << std::left << std::setw(56) << result << std::right << std::setw(46) << ""
+                      << "  REGRESSION (incomplete)\n";
+            ++regressions;
+        }
+
+        for (const auto& [metric, base_values] : base_metrics) {
+            auto values_it = cand_it->second.find(metric);
+            if (values_it == cand_it->second.end() || base_values.empty() || values_it->second.empty()) {
+                continue;
+            }
+            const auto& cand_values = values_it->second;
+            const MetricSpec& spec = spec_of(metric);
+            const auto override_it = options.thresholds.find(metric.rfind("cpu.", 0) == 0 ? "cpu" : metric);
+            const double threshold = override_it != options.thresholds.end() ? override_it->second
+                                                                            : spec.threshold_percent;
+
+            const double base_median = median(base_values);
+            const double cand_median = median(cand_values);
+            double change = 0.0;
+            if (base_median != 0.0) {
+                change = 100.0 * (cand_median - base_median) / std::fabs(base_median);
+            } else if (cand_median != 0.0) {
+                change = std::copysign(std::numeric_limits<double>::infinity(), cand_median);
+            }
+            // Positive = worse
+            const double worse = spec.better == Better::Lower ? change : -change;
+            const double p_worse = spec.better == Better::Lower ? mann_whitney_greater(base_values, cand_values)
+                                                                : mann_whitney_greater(cand_values, base_values);
+            const double p_better = spec.better == Better::Lower ? mann_whitney_greater(cand_values, base_values)
+                                                                 : mann_whitney_greater(base_values, cand_values);
+            const bool large = !spec.latency || std::fabs(cand_median - base_median) >= options.min_delta_ns;
+            ++compared;
+
+            const char* status = "ok";
+            double p = std::min(p_worse, p_better);
+            if (large && worse > threshold && (!powered || p_worse <= options.alpha)) {
+                status = "REGRESSION";
+                p = p_worse;
+                ++regressions;
+            } else if (large && -worse > threshold && (!powered || p_better <= options.alpha)) {
+                status = "improved";
+                p = p_better;
+                ++improvements;
+            } else if (!options.all) {
+                continue;
+            }
+
+            std::cout << std::left << std::setw(56) << (result + "  " + metric) << std::right
+                      << std::fixed << std::setprecision(metric == "success_rate" ? 4 : 1)
+                      << std::setw(14) << base_median << std::setw(14) << cand_median
+                      << std::setprecision(1) << std::showpos << std::setw(9) << change << "%"
+                      << std::noshowpos;
+            if (powered) {
+                std::cout << std::setprecision(3) << std::setw(8) << p;
+            } else {
+                std::cout << std::setw(8) << "-";
+            }
+            std::cout << "  " << status << "\n";
+        }
+    }
+
+    std::vector<std::string> added;
+    for (const auto& [result, metrics] : candidate.samples) {
+        if (baseline.samples.count(result) == 0 &&
+            (options.filter.empty() || result.find(options.filter) != std::string::npos)) {
+            added.push_back(result);
+        }
+    }
+
+    std::cout << "\n" << compared << " metric(s) compared: " << regressions << " regression(s), "
+              << improvements << " improvement(s)\n";
+    if (!missing.empty()) {
+        std::cout << "Not in candidate: " << join(missing) << "\n";
+    }
+    if (!added.empty()) {
+        std::cout << "Not in baseline: " << join(added) << "\n";
+    }
+    return regressions > 0 ? 1 : 0;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " store <baseline.json> <run.json> [run.json ...]\n"
+              << "       " << program << " compare <baseline.json> <run.json> [run.json ...]\n"
+              << "           [--threshold METRIC=PERCENT] [--alpha P] [--min-delta-ns N]\n"
+              << "           [--filter SUBSTRING] [--all]\n"
+              << "Metrics: mean p50 p90 p99 p999 throughput success_rate cpu\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    const std::string command = argv[1];
+    const std::string baseline = argv[2];
+    std::vector<std::string> runs;
+    CompareOptions options;
+
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--threshold" && has_value) {
+            const std::string spec = argv[++i];
+            const auto eq = spec.find('=');
+            if (eq == std::string::npos) {
+                print_usage(argv[0]);
+                return 2;
+            }
+            options.thresholds[spec.substr(0, eq)] = std::strtod(spec.c_str() + eq + 1, nullptr);
+        } else if (arg == "--alpha" && has_value) {
+            options.alpha = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--min-delta-ns" && has_value) {
+            options.min_delta_ns = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--all") {
+            options.all = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            runs.push_back(arg);
+        }
+    }
+
+    if (runs.empty()) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (command == "store") {
+        return store(baseline, runs);
+    }
+    if (command == "compare") {
+        return compare(baseline, runs, options);
+    }
+    print_usage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file commrat_monitor.cpp
+ * @brief Live rate, jitter, bandwidth, data age and gaps of running streams
+ *
+ * Subscribes to the given producer streams like any consumer module and
+ * prints one StreamMonitor report per interval. Only message headers are
+ * inspected, so no message types need to be compiled in: streams are named
+ * by message ID or by payload type name from an exported schema
+ * (IntrospectionHelper::export_all() / write_schemas_json()).
+ *
+ * Usage:
+ *   commrat_monitor [options] STREAM [STREAM ...]
+ *
+ *   STREAM   <type>@<system>[.<instance>][:label]
+ *            type: payload type name from --schema, or a message ID (0x... or decimal)
+ *
+ *   --schema <file>      Schema JSON used to resolve type names and message sizes
+ *   --interval <ms>      Report period (default 1000)
+ *   --count <n>          Exit after n reports (default 0 = until Ctrl-C)
+ *   --id <sys>.<inst>    Monitor address (default 0.0; use distinct IDs for concurrent monitors)
+ *
+ * Example:
+ *   commrat_monitor --schema schemas.json ImuData@10.1:imu 0x01000002@11
+ */
+
+#include <commrat/recording/stream_monitor.hpp>
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The parts of a schema entry the monitor needs
+struct SchemaEntry {
+    struct Metadata {
+        uint32_t message_id{0};
+        std::string payload_type;
+        std::size_t max_message_size{0};
+    };
+    Metadata commrat;
+};
+
+struct StreamArg {
+    uint32_t message_id{0};
+    uint8_t system_id{0};
+    uint8_t instance_id{0};
+    std::string label;
+    std::size_t max_message_size{0};
+};
+
+std::atomic<bool> g_stop{false};
+
+void on_signal(int) {
+    g_stop = true;
+}
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--schema file] [--interval ms] [--count n] [--id sys.inst]"
+              << " <type>@<system>[.<instance>][:label] ...\n";
+}
+
+bool parse_number(const std::string& text, unsigned long max, unsigned long& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtoul(text.c_str(), &end, 0);
+    return *end == '\0' && value <= max;
+}
+
+/// "<sys>[.<inst>]"
+bool parse_address(const std::string& text, uint8_t& system_id, uint8_t& instance_id) {
+    const auto dot = text.find('.');
+    unsigned long sys = 0;
+    unsigned long inst = 0;
+    if (!parse_number(text.substr(0, dot), 0xFF, sys) ||
+        (dot != std::string::npos && !parse_number(text.substr(dot + 1), 0xFF, inst))) {
+        return false;
+    }
+    system_id = static_cast<uint8_t>(sys);
+    instance_id = static_cast<uint8_t>(inst);
+    return true;
+}
+
+/// Schema entry by payload type name, with or without namespace
+const SchemaEntry* find_type(const std::vector<SchemaEntry>& schema, const std::string& name) {
+    for (const auto& entry : schema) {
+        const std::string& type = entry.commrat.payload_type;
+        if (type == name ||
+            (type.size() > name.size() + 2 && type.ends_with(name) &&
+             type.compare(type.size() - name.size() - 2, 2, "::") == 0)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool parse_stream(const std::string& text, const std::vector<SchemaEntry>& schema, StreamArg& stream) {
+    const auto at = text.find('@');
+    if (at == std::string::npos || at == 0) {
+        return false;
+    }
+    const auto colon = text.find(':', at);
+    const std::string type = text.substr(0, at);
+    if (!parse_address(text.substr(at + 1, colon == std::string::npos ? std::string::npos : colon - at - 1),
+                       stream.system_id, stream.instance_id)) {
+        return false;
+    }
+    stream.label = colon == std::string::npos ? text : text.substr(colon + 1);
+
+    unsigned long id = 0;
+    if (parse_number(type, 0xFFFFFFFF, id)) {
+        stream.message_id = static_cast<uint32_t>(id);
+        for (const auto& entry : schema) {
+            if (entry.commrat.message_id == stream.message_id) {
+                stream.max_message_size = entry.commrat.max_message_size;
+            }
+        }
+        return true;
+    }
+    const SchemaEntry* entry = find_type(schema, type);
+    if (!entry) {
+        std::cerr << "Unknown type '" << type << "'" << (schema.empty() ? " (no --schema given)" : "") << "\n";
+        return false;
+    }
+    stream.message_id = entry->commrat.message_id;
+    stream.max_message_size = entry->commrat.max_message_size;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<SchemaEntry> schema;
+    std::vector<std::string> stream_texts;
+    long interval_ms = 1000;
+    unsigned long count = 0;
+    uint8_t system_id = 0;
+    uint8_t instance_id = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--schema" && has_value) {
+            std::ifstream in(argv[++i]);
+            if (!in) {
+                std::cerr << "Cannot open " << argv[i] << "\n";
+                return 1;
+            }
+            std::stringstream buffer;
+            buffer << in.rdbuf();
+            auto parsed = rfl::json::read<std::vector<SchemaEntry>>(buffer.str());
+            if (!parsed) {
+                std::cerr << argv[i] << " is not a CommRaT schema file\n";
+                return 1;
+            }
+            schema = std::move(parsed.value());
+        } else if (arg == "--interval" && has_value) {
+            unsigned long value = 0;
+            if (!parse_number(argv[++i], 3600 * 1000, value) || value == 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            interval_ms = static_cast<long>(value);
+        } else if (arg == "--count" && has_value) {
+            if (!parse_number(argv[++i], ~0ul, count)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--id" && has_value) {
+            if (!parse_address(argv[++i], system_id, instance_id)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg.starts_with("--")) {
+            usage(argv[0]);
+            return 1;
+        } else {
+            stream_texts.push_back(arg);
+        }
+    }
+    if (stream_texts.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    commrat::StreamMonitor monitor(commrat::StreamMonitorConfig{
+        .name = "commrat_monitor", .system_id = system_id, .instance_id = instance_id
+    });
+    for (const auto& text : stream_texts) {
+        StreamArg stream;
+        if (!parse_stream(text, schema, stream)) {
+            std::cerr << "Invalid stream '" << text << "'\n";
+            usage(argv[0]);
+            return 1;
+        }
+        monitor.add(stream.message_id, stream.system_id, stream.instance_id, stream.label,
+                    stream.max_message_size);
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    try {
+        monitor.start();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    for (unsigned long reports = 0; !g_stop && (count == 0 || reports < count); ++reports) {
+        // Short slices so Ctrl-C is honored within ~100 ms
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(interval_ms);
+        while (!g_stop && std::chrono::steady_clock::now() < end) {
+            monitor.run_for(std::min(std::chrono::duration_cast<commrat::Milliseconds>(
+                                         end - std::chrono::steady_clock::now()),
+                                     commrat::Milliseconds(100)));
+        }
+        std::printf("\n[%lu] subscribed %zu/%zu\n", reports + 1, monitor.acknowledged(), monitor.stream_count());
+        commrat::StreamMonitor::print(monitor.report(), stdout);
+    }
+    monitor.stop();
+    return 0;
+}
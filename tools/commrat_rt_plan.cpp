@@ -0,0 +1,225 @@
+/**
+ * @file commrat_rt_plan.cpp
+ * @brief Rate-monotonic priorities and CPUs for a host's module configs
+ *
+ * Loads the JSON configs of all modules on a host, runs
+ * RateMonotonicPlanner (priorities by period, CPUs by utilization,
+ * response-time analysis) and prints the plan. With --write the planned
+ * data_thread priority and CPU are written back into the config files.
+ *
+ * Usage:
+ *   commrat_rt_plan [options] --cost <module>=<us>[@<period_ms>] ... CONFIG.json ...
+ *
+ *   --cost <module>=<us>[@<period_ms>]
+ *                       Worst-case process() cost (e.g. StatsReply process_time
+ *                       max_ns / 1000). period_ms overrides config.period, use it
+ *                       for input-driven modules. Required for realtime modules.
+ *   --cores <list>      Isolated CPUs, e.g. 2,3 (default: one unpinned CPU)
+ *   --margin <factor>   Cost margin (default 1.2)
+ *   --priorities <hi>-<lo>
+ *                       SCHED_FIFO range handed out (default 90-10)
+ *   --write             Write data_thread into the config files
+ *
+ * Exit code 2 if the plan is not schedulable (nothing is written).
+ *
+ * Example:
+ *   commrat_rt_plan --cores 2,3 --cost imu=120 --cost fusion=800@10 imu.json fusion.json logger.json
+ */
+
+#include <commrat/module/rt_planner.hpp>
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Cost {
+    unsigned long cost_us{0};
+    unsigned long period_ms{0};      ///< 0 = config.period
+};
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--cores list] [--margin factor] [--priorities hi-lo] [--write]"
+              << " --cost <module>=<us>[@<period_ms>] ... <config.json> ...\n";
+}
+
+bool parse_number(const std::string& text, unsigned long max, unsigned long& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtoul(text.c_str(), &end, 0);
+    return *end == '\0' && value <= max;
+}
+
+/// "<module>=<us>[@<period_ms>]"
+bool parse_cost(const std::string& text, std::map<std::string, Cost>& costs) {
+    const auto eq = text.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        return false;
+    }
+    const auto at = text.find('@', eq);
+    Cost cost;
+    if (!parse_number(text.substr(eq + 1, at == std::string::npos ? std::string::npos : at - eq - 1),
+                      ~0ul, cost.cost_us) ||
+        (at != std::string::npos && (!parse_number(text.substr(at + 1), ~0ul, cost.period_ms) || cost.period_ms == 0))) {
+        return false;
+    }
+    costs[text.substr(0, eq)] = cost;
+    return true;
+}
+
+/// "2,3"
+bool parse_cores(const std::string& text, std::vector<int>& cores) {
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        const auto comma = text.find(',', begin);
+        unsigned long cpu = 0;
+        if (!parse_number(text.substr(begin, comma == std::string::npos ? std::string::npos : comma - begin),
+                          1023, cpu)) {
+            return false;
+        }
+        cores.push_back(static_cast<int>(cpu));
+        if (comma == std::string::npos) {
+            break;
+        }
+        begin = comma + 1;
+    }
+    return true;
+}
+
+/// "90-10"
+bool parse_priorities(const std::string& text, int& highest, int& lowest) {
+    const auto dash = text.find('-');
+    unsigned long hi = 0;
+    unsigned long lo = 0;
+    if (dash == std::string::npos || !parse_number(text.substr(0, dash), 99, hi) ||
+        !parse_number(text.substr(dash + 1), 99, lo)) {
+        return false;
+    }
+    highest = static_cast<int>(hi);
+    lowest = static_cast<int>(lo);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    commrat::RtPlannerConfig planner_config;
+    std::map<std::string, Cost> costs;
+    std::vector<std::string> files;
+    bool write = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--cost" && has_value) {
+            if (!parse_cost(argv[++i], costs)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--cores" && has_value) {
+            if (!parse_cores(argv[++i], planner_config.cores)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--margin" && has_value) {
+            planner_config.cost_margin = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--priorities" && has_value) {
+            if (!parse_priorities(argv[++i], planner_config.highest_priority, planner_config.lowest_priority)) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--write") {
+            write = true;
+        } else if (arg.starts_with("--")) {
+            usage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<commrat::ModuleConfig> configs;
+    configs.reserve(files.size());
+    for (const auto& file : files) {
+        auto loaded = rfl::json::load<commrat::ModuleConfig>(file);
+        if (!loaded) {
+            std::cerr << "Cannot load " << file << ": " << loaded.error()->what() << "\n";
+            return 1;
+        }
+        configs.push_back(std::move(loaded.value()));
+    }
+
+    try {
+        commrat::RateMonotonicPlanner planner(planner_config);
+        for (auto& config : configs) {
+            const auto it = costs.find(config.name);
+            if (it == costs.end()) {
+                if (config.realtime) {
+                    std::cerr << "No --cost for realtime module '" << config.name << "'\n";
+                    return 1;
+                }
+                planner.add(config, commrat::Microseconds(0));
+                continue;
+            }
+            std::optional<commrat::Milliseconds> period;
+            if (it->second.period_ms != 0) {
+                period = commrat::Milliseconds(it->second.period_ms);
+            }
+            planner.add(config, commrat::Microseconds(it->second.cost_us), period);
+        }
+
+        const commrat::RtPlan plan = planner.plan();
+        std::printf("%-24s %10s %10s %5s %4s %12s %s\n", "module", "period_us", "cost_us", "prio", "cpu",
+                    "response_us", "");
+        for (const auto& task : plan.tasks) {
+            if (!task.realtime) {
+                std::printf("%-24s %10lu %10lu %5s %4s %12s\n", task.module.c_str(),
+                            static_cast<unsigned long>(task.period_ns / 1000),
+                            static_cast<unsigned long>(task.cost_ns / 1000), "-", "-", "-");
+                continue;
+            }
+            std::printf("%-24s %10lu %10lu %5d %4d %12lu %s\n", task.module.c_str(),
+                        static_cast<unsigned long>(task.period_ns / 1000),
+                        static_cast<unsigned long>(task.cost_ns / 1000), task.priority, task.cpu,
+                        static_cast<unsigned long>(task.response_ns / 1000),
+                        task.schedulable ? "ok" : "DEADLINE MISS");
+        }
+        for (const auto& core : plan.cores) {
+            std::printf("cpu %3d: %zu modules, utilization %.1f%%\n", core.cpu, core.modules,
+                        core.utilization * 100.0);
+        }
+        if (!plan.schedulable) {
+            std::printf("Not schedulable\n");
+            return 2;
+        }
+
+        if (write) {
+            for (std::size_t i = 0; i < files.size(); ++i) {
+                plan.apply(configs[i]);
+                std::ofstream out(files[i]);
+                out << rfl::json::write(configs[i], rfl::json::pretty) << "\n";
+                if (!out) {
+                    std::cerr << "Cannot write " << files[i] << "\n";
+                    return 1;
+                }
+            }
+            std::printf("Wrote %zu configs\n", files.size());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file commrat_trace_merge.cpp
+ * @brief Merge per-process CommRaT traces into one Chrome/Perfetto trace
+ *
+ * Each module process writes its own trace (ModuleConfig::trace_file or
+ * Tracer::write_chrome_trace). Events keep their pid/tid and timestamps
+ * (Time::now(), same clock in all processes of a host), so concatenating the
+ * event arrays yields one timeline in which publish -> receive flow arrows
+ * connect the modules of a causal chain.
+ *
+ * Usage: commrat_trace_merge <output.json> <trace1.json> [trace2.json ...]
+ * Open the output in ui.perfetto.dev or chrome://tracing.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Extract the contents of the "traceEvents" array (without brackets)
+ */
+bool extract_events(const std::string& path, std::string& events) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << "\n";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    auto key = text.find("\"traceEvents\"");
+    auto open = key == std::string::npos ? std::string::npos : text.find('[', key);
+    auto close = text.rfind(']');
+    if (open == std::string::npos || close == std::string::npos || close < open) {
+        std::cerr << path << " is not a Chrome JSON trace\n";
+        return false;
+    }
+
+    events = text.substr(open + 1, close - open - 1);
+    // Trim whitespace so empty traces do not produce dangling commas
+    auto first = events.find_first_not_of(" \t\r\n");
+    auto last = events.find_last_not_of(" \t\r\n");
+    events = first == std::string::npos ? std::string{} : events.substr(first, last - first + 1);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.json> <trace1.json> [trace2.json ...]\n";
+        return 1;
+    }
+
+    std::ofstream out(argv[1]);
+    if (!out) {
+        std::cerr << "Cannot write " << argv[1] << "\n";
+        return 1;
+    }
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (int i = 2; i < argc; ++i) {
+        std::string events;
+        if (!extract_events(argv[i], events)) {
+            return 1;
+        }
+        if (events.empty()) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n") << events;
+        first = false;
+    }
+    out << "\n]}\n";
+
+    std::cout << "Merged " << (argc - 2) << " trace(s) into " << argv[1] << "\n";
+    return out.good() ? 0 : 1;
+}